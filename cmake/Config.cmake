@@ -1,5 +1,6 @@
 option(CZ_EXCESS_WARNINGS "Whether to compile the program with potentially excessive warnings" OFF)
 option(CZ_STATIC_ANALYSIS "Whether to perform static analysis on the program during compilation" OFF)
+option(CZ_USDT_PROBES     "Whether to compile the program with USDT probes for perf, bpftrace, and SystemTap" OFF)
 
 set(USING_CYGWIN  "$<BOOL:${CYGWIN}>")
 set(USING_DARWIN  "$<BOOL:${APPLE}>")
@@ -7,6 +8,17 @@ set(USING_MINGW   "$<BOOL:${MINGW}>")
 set(USING_UNIX    "$<BOOL:${UNIX}>")
 set(USING_WINDOWS "$<BOOL:${WIN32}>")
 
+if(CZ_USDT_PROBES)
+	include(CheckIncludeFile)
+	check_include_file(sys/sdt.h HAVE_SYS_SDT_H)
+
+	if(NOT HAVE_SYS_SDT_H)
+		message(WARNING "sys/sdt.h not found - USDT probes will not be compiled")
+	endif()
+endif()
+
+set(USING_USDT_PROBES "$<AND:$<BOOL:${CZ_USDT_PROBES}>,$<BOOL:${HAVE_SYS_SDT_H}>>")
+
 include(cmake/Definitions.cmake)
 include(cmake/Headers.cmake)
 include(cmake/Libraries.cmake)
@@ -55,6 +55,13 @@ set(MACRO_DEFINITIONS
 	# Disable stdc assertions when not in Debug config
 	"$<$<NOT:$<CONFIG:DEBUG>>:NDEBUG=1>"
 
+	# Define CZ_RUNTIME_SHADERS as 1 if runtime shader compilation is enabled, and as 0 otherwise
+	"CZ_RUNTIME_SHADERS=$<BOOL:${CZ_RUNTIME_SHADERS}>"
+	# Define CZ_EMBED_SHADERS as 1 if the compiled shaders are embedded in the executable, and as 0 otherwise
+	"CZ_EMBED_SHADERS=$<BOOL:${CZ_EMBED_SHADERS}>"
+	# Define CZ_USDT_PROBES as 1 if USDT probes are compiled into the program, and as 0 otherwise
+	"CZ_USDT_PROBES=${USING_USDT_PROBES}"
+
 	# Platform-specific definitions
 	"$<${USING_DARWIN}:${MACRO_DEFINITIONS_DARWIN}>"
 	"$<${USING_MINGW}:${MACRO_DEFINITIONS_MINGW}>"
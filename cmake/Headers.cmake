@@ -12,14 +12,25 @@ set(INCLUDE_HEADERS_DARWIN
 	<IOKit/pwr_mgt/IOPMLib.h$<ANGLE-R>
 )
 
+set(INCLUDE_HEADERS_RUNTIME_SHADERS
+	<glslang/Include/glslang_c_interface.h$<ANGLE-R>
+	<glslang/Public/resource_limits_c.h$<ANGLE-R>
+	<spirv-tools/libspirv.h$<ANGLE-R>
+)
+
 set(INCLUDE_HEADERS_UNIX
 	<dirent.h$<ANGLE-R>
 	<fcntl.h$<ANGLE-R>
 	<unistd.h$<ANGLE-R>
 
+	<arpa/inet.h$<ANGLE-R>
+	<netinet/in.h$<ANGLE-R>
+
+	<sys/socket.h$<ANGLE-R>
 	<sys/stat.h$<ANGLE-R>
 	<sys/types.h$<ANGLE-R>
 	<sys/uio.h$<ANGLE-R>
+	<sys/un.h$<ANGLE-R>
 )
 
 set(INCLUDE_HEADERS_WINDOWS
@@ -82,10 +93,12 @@ set(INCLUDE_HEADERS
 	"$<${USING_WINDOWS}:${INCLUDE_HEADERS_WINDOWS}>"
 
 	# Optional headers
+	"$<$<BOOL:${CZ_RUNTIME_SHADERS}>:${INCLUDE_HEADERS_RUNTIME_SHADERS}>"
 	"$<$<BOOL:${HAVE_STDCOUNTOF_H}>:<stdcountof.h$<ANGLE-R>>"
 	"$<$<BOOL:${HAVE_SYS_FILE_H}>:<sys/file.h$<ANGLE-R>>"
 	"$<$<BOOL:${HAVE_SYS_MMAN_H}>:<sys/mman.h$<ANGLE-R>>"
 	"$<$<BOOL:${HAVE_SYS_PARAM_H}>:<sys/param.h$<ANGLE-R>>"
 	"$<$<BOOL:${HAVE_SYS_SELECT_H}>:<sys/select.h$<ANGLE-R>>"
 	"$<$<BOOL:${HAVE_SYS_SYSCALL_H}>:<sys/syscall.h$<ANGLE-R>>"
+	"$<${USING_USDT_PROBES}:<sys/sdt.h$<ANGLE-R>>"
 )
@@ -1,6 +1,17 @@
 set(THREADS_PREFER_PTHREAD_FLAG ON)
 find_package(Threads REQUIRED)
 
+if(CZ_RUNTIME_SHADERS)
+	find_package(glslang 15 CONFIG REQUIRED)
+	find_package(SPIRV-Tools-opt CONFIG REQUIRED)
+endif()
+
+set(LINK_LIBRARIES_RUNTIME_SHADERS
+	glslang::glslang
+	glslang::glslang-default-resource-limits
+	SPIRV-Tools-opt
+)
+
 set(LINK_LIBRARIES_DARWIN
 	"$<LINK_LIBRARY:FRAMEWORK,CoreFoundation>"
 	"$<LINK_LIBRARY:FRAMEWORK,IOKit>"
@@ -17,4 +28,7 @@ set(LINK_LIBRARIES
 
 	# Platform-specific libraries
 	"$<${USING_DARWIN}:${LINK_LIBRARIES_DARWIN}>"
+
+	# Optional libraries
+	"$<$<BOOL:${CZ_RUNTIME_SHADERS}>:${LINK_LIBRARIES_RUNTIME_SHADERS}>"
 )
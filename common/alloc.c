@@ -253,6 +253,103 @@ static enum CzResult realloc_align_zero_win32(
 }
 #endif
 
+/**********************************************************************************************************************
+ * POSIX implementation                                                                                               *
+ **********************************************************************************************************************/
+
+#define HUGE_SIZE_POSIX(size) ( ((size) + CZ_HUGE_PAGE_SIZE - 1) & ~(CZ_HUGE_PAGE_SIZE - 1) )
+
+#if defined(MAP_ANONYMOUS)
+#define HAVE_alloc_huge_posix ( \
+	CZ_WRAP_MMAP &&             \
+	CZ_WRAP_MUNMAP )
+#else
+#define HAVE_alloc_huge_posix ( 0 )
+#endif
+
+#if HAVE_alloc_huge_posix
+/* 
+ * Maps 'size' bytes rounded up to a multiple of CZ_HUGE_PAGE_SIZE and sets 'memory' to point to the mapping. The
+ * mapping is aligned to CZ_HUGE_PAGE_SIZE and its contents are zeroed out. The mapping is backed by huge pages if any
+ * are reserved, and is otherwise advised to be backed by transparent huge pages. Controlled failure occurs if:
+ * - 'size' is zero.
+ * - 'size' is greater than PTRDIFF_MAX.
+ */
+CZ_NONNULL_ARGS() CZ_WR_ACCESS(1)
+static enum CzResult alloc_huge_posix(void* restrict* memory, size_t size)
+{
+	if CZ_NOEXPECT (!size)
+		return CZ_RESULT_BAD_SIZE;
+	if CZ_NOEXPECT (size > PTRDIFF_MAX)
+		return CZ_RESULT_BAD_SIZE;
+
+	void* map;
+	size_t mapSize = HUGE_SIZE_POSIX(size);
+	int prot = PROT_READ | PROT_WRITE;
+	int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+	enum CzResult ret;
+
+#if defined(MAP_HUGETLB)
+	int hugeFlags = flags | MAP_HUGETLB;
+#if defined(MAP_HUGE_SHIFT)
+	hugeFlags |= 21 << MAP_HUGE_SHIFT; // Request pages of CZ_HUGE_PAGE_SIZE rather than the default huge page size
+#endif
+
+	ret = czWrap_mmap(&map, NULL, mapSize, prot, hugeFlags, -1, 0);
+	if (!ret) {
+		*memory = map;
+		return CZ_RESULT_SUCCESS;
+	}
+#endif
+
+	// Map an extra huge page, so the mapping can be trimmed to begin on a huge page boundary
+	size_t padSize = mapSize + CZ_HUGE_PAGE_SIZE;
+	ret = czWrap_mmap(&map, NULL, padSize, prot, flags, -1, 0);
+	if CZ_NOEXPECT (ret)
+		return ret;
+
+	char* addr = (char*) map;
+	char* alignedAddr = (char*) HUGE_SIZE_POSIX((uintptr_t) addr);
+	size_t headSize = (size_t) (alignedAddr - addr);
+	size_t tailSize = CZ_HUGE_PAGE_SIZE - headSize;
+
+	if (headSize) {
+		ret = czWrap_munmap(addr, headSize);
+		if CZ_NOEXPECT (ret) {
+			munmap(addr, padSize);
+			return ret;
+		}
+	}
+	if (tailSize) {
+		ret = czWrap_munmap(alignedAddr + mapSize, tailSize);
+		if CZ_NOEXPECT (ret) {
+			munmap(alignedAddr, mapSize + tailSize);
+			return ret;
+		}
+	}
+
+#if CZ_WRAP_MADVISE && defined(MADV_HUGEPAGE)
+	czWrap_madvise(alignedAddr, mapSize, MADV_HUGEPAGE); // Only advice, so failure is not an error
+#endif
+
+	*memory = alignedAddr;
+	return CZ_RESULT_SUCCESS;
+}
+#endif
+
+#define HAVE_free_huge_posix ( HAVE_alloc_huge_posix )
+
+#if HAVE_free_huge_posix
+/* 
+ * Unmaps the mapping of 'size' bytes, rounded up to a multiple of CZ_HUGE_PAGE_SIZE, pointed to by 'memory'.
+ */
+CZ_NONNULL_ARGS()
+static enum CzResult free_huge_posix(void* memory, size_t size)
+{
+	return czWrap_munmap(memory, HUGE_SIZE_POSIX(size));
+}
+#endif
+
 /**********************************************************************************************************************
  * Standard C implementation                                                                                          *
  **********************************************************************************************************************/
@@ -508,6 +605,38 @@ static enum CzResult realloc_align_zero_stdc(
 	return free_align_stdc(oldMemory);
 }
 
+/* 
+ * Allocates 'size' bytes and sets 'memory' to point to the allocation. The allocation is aligned to CZ_HUGE_PAGE_SIZE.
+ * The contents of the allocation are uninitialised. Controlled failure occurs if:
+ * - 'size' is zero.
+ * - 'size' is greater than PTRDIFF_MAX.
+ */
+CZ_NONNULL_ARGS() CZ_WR_ACCESS(1)
+static enum CzResult alloc_huge_stdc(void* restrict* memory, size_t size)
+{
+	return alloc_align_stdc(memory, size, CZ_HUGE_PAGE_SIZE, 0);
+}
+
+/* 
+ * Allocates 'size' bytes and sets 'memory' to point to the allocation. The allocation is aligned to CZ_HUGE_PAGE_SIZE.
+ * The contents of the allocation are zeroed out. Controlled failure occurs if:
+ * - 'size' is zero.
+ * - 'size' is greater than PTRDIFF_MAX.
+ */
+CZ_NONNULL_ARGS() CZ_WR_ACCESS(1)
+static enum CzResult alloc_huge_zero_stdc(void* restrict* memory, size_t size)
+{
+	return alloc_align_zero_stdc(memory, size, CZ_HUGE_PAGE_SIZE, 0);
+}
+
+/* 
+ * Deallocates the allocation pointed to by 'memory'.
+ */
+static enum CzResult free_huge_stdc(void* memory)
+{
+	return free_align_stdc(memory);
+}
+
 /**********************************************************************************************************************
  * API function definitions                                                                                           *
  **********************************************************************************************************************/
@@ -717,3 +846,59 @@ void czFreeAlign(void* memory)
 	czFreeAlign_stdc(memory);
 #endif
 }
+
+#define HAVE_czAllocHuge_posix ( HAVE_alloc_huge_posix )
+
+#if HAVE_czAllocHuge_posix
+CZ_COPY_ATTR(czAllocHuge)
+static enum CzResult czAllocHuge_posix(void* restrict* memory, size_t size, struct CzAllocFlags flags)
+{
+	(void) flags; // Anonymous mappings are always zeroed out
+	return alloc_huge_posix(memory, size);
+}
+#endif
+
+CZ_COPY_ATTR(czAllocHuge)
+static enum CzResult czAllocHuge_stdc(void* restrict* memory, size_t size, struct CzAllocFlags flags)
+{
+	if (flags.zeroInitialise)
+		return alloc_huge_zero_stdc(memory, size);
+	return alloc_huge_stdc(memory, size);
+}
+
+enum CzResult czAllocHuge(void* restrict* memory, size_t size, struct CzAllocFlags flags)
+{
+#if HAVE_czAllocHuge_posix
+	return czAllocHuge_posix(memory, size, flags);
+#else
+	return czAllocHuge_stdc(memory, size, flags);
+#endif
+}
+
+#define HAVE_czFreeHuge_posix ( HAVE_free_huge_posix )
+
+#if HAVE_czFreeHuge_posix
+CZ_COPY_ATTR(czFreeHuge)
+static void czFreeHuge_posix(void* memory, size_t size)
+{
+	if (memory)
+		free_huge_posix(memory, size);
+}
+#endif
+
+CZ_COPY_ATTR(czFreeHuge)
+static void czFreeHuge_stdc(void* memory, size_t size)
+{
+	(void) size;
+	if (memory)
+		free_huge_stdc(memory);
+}
+
+void czFreeHuge(void* memory, size_t size)
+{
+#if HAVE_czFreeHuge_posix
+	czFreeHuge_posix(memory, size);
+#else
+	czFreeHuge_stdc(memory, size);
+#endif
+}
@@ -28,6 +28,11 @@
 
 #include "def.h"
 
+/**
+ * @brief The size of a huge page, and the alignment of allocations made by @ref czAllocHuge.
+ */
+#define CZ_HUGE_PAGE_SIZE ( (size_t) 1 << 21 )
+
 /**
  * @brief Specifies the behaviour of allocation functions.
  * 
@@ -252,3 +257,55 @@ enum CzResult czReallocAlign(
  * @warning Any further access of the freed memory will result in undefined behaviour.
  */
 void czFreeAlign(void* memory);
+
+/**
+ * @brief Dynamically allocates a block of memory backed by huge pages.
+ * 
+ * Allocates @p size bytes of contiguous memory, rounded up to a multiple of @ref CZ_HUGE_PAGE_SIZE, and synchronously
+ * writes the memory address of the first byte of the allocation to @p memory. The allocation is aligned to
+ * @ref CZ_HUGE_PAGE_SIZE bytes. Where supported, the allocation is mapped directly from the system and backed by huge
+ * pages, which reduces the number of TLB misses when accessing it. If no huge pages are reserved, the system is instead
+ * advised to back the allocation with transparent huge pages, if any. If @p size is zero or greater than
+ * @c PTRDIFF_MAX, failure occurs. On failure, the contents of @p memory are unchanged.
+ * 
+ * The members of @p flags can optionally specify the following behaviour.
+ * - If @p flags.zeroInitialise is set, the contents of the allocation are initialised to zero. Otherwise, the contents
+ *   are initially undefined.
+ * - @p flags.freeOnFail is ignored.
+ * 
+ * Thread-safety is guaranteed for an invocation @b A to @ref czAllocHuge if the following conditions are satisfied.
+ * - For any concurrent invocation @b B to @ref czAlloc, @ref czRealloc, @ref czAllocAlign, @ref czReallocAlign, or
+ *   @ref czAllocHuge, the @p memory arguments of @b A and @b B are nonoverlapping in memory. If overlap does occur, the
+ *   contents of the overlapping memory are undefined.
+ * 
+ * @param[out] memory The memory to write the address of the allocation to.
+ * @param[in] size The size of the allocation.
+ * @param[in] flags Binary flags describing additional behaviour.
+ * 
+ * @retval CZ_RESULT_SUCCESS The operation was successful.
+ * @retval CZ_RESULT_BAD_SIZE @p size was zero or greater than @c PTRDIFF_MAX.
+ * @retval CZ_RESULT_NO_MEMORY Sufficient memory was unable to be allocated.
+ * 
+ * @pre @p memory is nonnull.
+ * 
+ * @note On success, failing to free the allocation via @ref czFreeHuge will result in a memory leak.
+ */
+CZ_NONNULL_ARGS(1) CZ_WR_ACCESS(1)
+enum CzResult czAllocHuge(void* restrict* memory, size_t size, struct CzAllocFlags flags);
+
+/**
+ * @brief Frees a dynamically allocated block of memory backed by huge pages.
+ * 
+ * Deallocates the contiguous dynamic memory allocation of size @p size whose first byte is located at the memory
+ * address @p memory. If @p memory is null, nothing happens.
+ * 
+ * Thread-safety is guaranteed for any set of concurrent invocations.
+ * 
+ * @param[in] memory The address of the allocation.
+ * @param[in] size The size of the allocation, as passed to @ref czAllocHuge.
+ * 
+ * @pre @p memory was allocated via @ref czAllocHuge.
+ * 
+ * @warning Any further access of the freed memory will result in undefined behaviour.
+ */
+void czFreeHuge(void* memory, size_t size);
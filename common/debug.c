@@ -20,19 +20,20 @@
 #include "file.h"
 #include "util.h"
 
-struct CzVulkanCallbackData czgCallbackData = {.func = "", .file = "", .line = 0};
+_Thread_local struct CzVulkanCallbackData czgCallbackData = {.func = "", .file = "", .line = 0};
 
 static const char* gAllocLogPath = NULL;
 static const char* gDebugLogPath = NULL;
 static enum CzColourLevel gColourLevel = CZ_COLOUR_LEVEL_NONE;
 
-static CzU64 gDebugCallbackCount = 0;
-static CzU64 gAllocCount = 0;
-static CzU64 gReallocCount = 0;
-static CzU64 gFreeCount = 0;
-static CzU64 gInternalAllocCount = 0;
-static CzU64 gInternalFreeCount = 0;
-static size_t gTotalAllocSize = 0;
+// Callbacks can be invoked from several threads at once
+static _Atomic CzU64 gDebugCallbackCount = 0;
+static _Atomic CzU64 gAllocCount = 0;
+static _Atomic CzU64 gReallocCount = 0;
+static _Atomic CzU64 gFreeCount = 0;
+static _Atomic CzU64 gInternalAllocCount = 0;
+static _Atomic CzU64 gInternalFreeCount = 0;
+static _Atomic size_t gTotalAllocSize = 0;
 
 bool init_debug_logfile(const char* filename)
 {
@@ -305,18 +306,19 @@ VkBool32 debug_callback(
 	void* pUserData)
 {
 	double time = program_time();
-	struct CzVulkanCallbackData data = *(struct CzVulkanCallbackData*) pUserData;
+	struct CzVulkanCallbackData data = czgCallbackData;
+	(void) pUserData;
 
-	gDebugCallbackCount++;
+	CzU64 callbackCount = atomic_fetch_add(&gDebugCallbackCount, 1) + 1;
 
 	if (messageSeverity == VK_DEBUG_UTILS_MESSAGE_SEVERITY_ERROR_BIT_EXT) {
 		log_debug_callback(
-			stderr, time, messageSeverity, messageTypes, pCallbackData, gDebugCallbackCount, data.func, data.file,
+			stderr, time, messageSeverity, messageTypes, pCallbackData, callbackCount, data.func, data.file,
 			data.line);
 	}
 	else if (messageTypes & ~(VkDebugUtilsMessageTypeFlagsEXT) VK_DEBUG_UTILS_MESSAGE_TYPE_GENERAL_BIT_EXT) {
 		log_debug_callback(
-			stdout, time, messageSeverity, messageTypes, pCallbackData, gDebugCallbackCount, data.func, data.file,
+			stdout, time, messageSeverity, messageTypes, pCallbackData, callbackCount, data.func, data.file,
 			data.line);
 	}
 
@@ -327,7 +329,7 @@ VkBool32 debug_callback(
 	if CZ_NOEXPECT (!file) { FOPEN_FAILURE(file, path, mode); return VK_FALSE; }
 
 	log_debug_callback(
-		file, time, messageSeverity, messageTypes, pCallbackData, gDebugCallbackCount, data.func, data.file, data.line);
+		file, time, messageSeverity, messageTypes, pCallbackData, callbackCount, data.func, data.file, data.line);
 
 	fclose(file);
 	return VK_FALSE;
@@ -412,12 +414,13 @@ static void log_allocation_callback(
 void* allocation_callback(void* pUserData, size_t size, size_t alignment, VkSystemAllocationScope allocationScope)
 {
 	double time = program_time();
-	struct CzVulkanCallbackData data = *(struct CzVulkanCallbackData*) pUserData;
+	struct CzVulkanCallbackData data = czgCallbackData;
+	(void) pUserData;
 
 	void* memory = size ? aligned_malloc(size, alignment) : NULL;
 
-	gAllocCount++;
-	gTotalAllocSize += size;
+	CzU64 allocCount = atomic_fetch_add(&gAllocCount, 1) + 1;
+	size_t totalAllocSize = atomic_fetch_add(&gTotalAllocSize, size) + size;
 
 	const char* path = gAllocLogPath;
 	const char* mode = "a";
@@ -426,7 +429,7 @@ void* allocation_callback(void* pUserData, size_t size, size_t alignment, VkSyst
 	if CZ_NOEXPECT (!file) { FOPEN_FAILURE(file, path, mode); return memory; }
 
 	log_allocation_callback(
-		file, time, gAllocCount, data.func, data.file, data.line, gTotalAllocSize, size, alignment, allocationScope,
+		file, time, allocCount, data.func, data.file, data.line, totalAllocSize, size, alignment, allocationScope,
 		memory);
 
 	fclose(file);
@@ -476,7 +479,8 @@ void* reallocation_callback(
 	void* pUserData, void* pOriginal, size_t size, size_t alignment, VkSystemAllocationScope allocationScope)
 {
 	double time = program_time();
-	struct CzVulkanCallbackData data = *(struct CzVulkanCallbackData*) pUserData;
+	struct CzVulkanCallbackData data = czgCallbackData;
+	(void) pUserData;
 
 	size_t originalSize = 0;
 	void* memory = NULL;
@@ -493,9 +497,11 @@ void* reallocation_callback(
 		memory = aligned_malloc(size, alignment);
 	}
 
-	gReallocCount++;
-	gTotalAllocSize -= originalSize;
-	gTotalAllocSize += size;
+	// Wraps around when shrinking, so the total is still correct
+	size_t sizeChange = size - originalSize;
+
+	CzU64 reallocCount = atomic_fetch_add(&gReallocCount, 1) + 1;
+	size_t totalAllocSize = atomic_fetch_add(&gTotalAllocSize, sizeChange) + sizeChange;
 
 	const char* path = gAllocLogPath;
 	const char* mode = "a";
@@ -504,7 +510,7 @@ void* reallocation_callback(
 	if CZ_NOEXPECT (!file) { FOPEN_FAILURE(file, path, mode); return memory; }
 
 	log_reallocation_callback(
-		file, time, gReallocCount, data.func, data.file, data.line, gTotalAllocSize, originalSize, size, alignment,
+		file, time, reallocCount, data.func, data.file, data.line, totalAllocSize, originalSize, size, alignment,
 		allocationScope, pOriginal, memory);
 
 	fclose(file);
@@ -543,7 +549,8 @@ static void log_free_callback(
 void free_callback(void* pUserData, void* pMemory)
 {
 	double time = program_time();
-	struct CzVulkanCallbackData data = *(struct CzVulkanCallbackData*) pUserData;
+	struct CzVulkanCallbackData data = czgCallbackData;
+	(void) pUserData;
 
 	size_t size = 0;
 
@@ -552,8 +559,8 @@ void free_callback(void* pUserData, void* pMemory)
 		aligned_free(pMemory);
 	}
 
-	gFreeCount++;
-	gTotalAllocSize -= size;
+	CzU64 freeCount = atomic_fetch_add(&gFreeCount, 1) + 1;
+	size_t totalAllocSize = atomic_fetch_sub(&gTotalAllocSize, size) - size;
 
 	const char* path = gAllocLogPath;
 	const char* mode = "a";
@@ -561,7 +568,7 @@ void free_callback(void* pUserData, void* pMemory)
 	FILE* file = fopen(path, mode);
 	if CZ_NOEXPECT (!file) { FOPEN_FAILURE(file, path, mode); return; }
 
-	log_free_callback(file, time, gFreeCount, data.func, data.file, data.line, gTotalAllocSize, size, pMemory);
+	log_free_callback(file, time, freeCount, data.func, data.file, data.line, totalAllocSize, size, pMemory);
 	fclose(file);
 }
 
@@ -597,9 +604,10 @@ void internal_allocation_callback(
 	void* pUserData, size_t size, VkInternalAllocationType allocationType, VkSystemAllocationScope allocationScope)
 {
 	double time = program_time();
-	struct CzVulkanCallbackData data = *(struct CzVulkanCallbackData*) pUserData;
+	struct CzVulkanCallbackData data = czgCallbackData;
+	(void) pUserData;
 
-	gInternalAllocCount++;
+	CzU64 internalAllocCount = atomic_fetch_add(&gInternalAllocCount, 1) + 1;
 
 	const char* path = gAllocLogPath;
 	const char* mode = "a";
@@ -608,7 +616,7 @@ void internal_allocation_callback(
 	if CZ_NOEXPECT (!file) { FOPEN_FAILURE(file, path, mode); return; }
 
 	log_internal_allocation_callback(
-		file, time, gInternalAllocCount, data.func, data.file, data.line, size, allocationType, allocationScope);
+		file, time, internalAllocCount, data.func, data.file, data.line, size, allocationType, allocationScope);
 
 	fclose(file);
 }
@@ -645,9 +653,10 @@ void internal_free_callback(
 	void* pUserData, size_t size, VkInternalAllocationType allocationType, VkSystemAllocationScope allocationScope)
 {
 	double time = program_time();
-	struct CzVulkanCallbackData data = *(struct CzVulkanCallbackData*) pUserData;
+	struct CzVulkanCallbackData data = czgCallbackData;
+	(void) pUserData;
 
-	gInternalFreeCount++;
+	CzU64 internalFreeCount = atomic_fetch_add(&gInternalFreeCount, 1) + 1;
 
 	const char* path = gAllocLogPath;
 	const char* mode = "a";
@@ -656,7 +665,7 @@ void internal_free_callback(
 	if CZ_NOEXPECT (!file) { FOPEN_FAILURE(file, path, mode); return; }
 
 	log_internal_free_callback(
-		file, time, gInternalFreeCount, data.func, data.file, data.line, size, allocationType, allocationScope);
+		file, time, internalFreeCount, data.func, data.file, data.line, size, allocationType, allocationScope);
 
 	fclose(file);
 }
@@ -736,6 +745,28 @@ void log_pjoin_failure(CzU32 line, int res)
 		line, time, res);
 }
 
+void log_pmutex_failure(CzU32 line, int res)
+{
+	double time = program_time();
+
+	log_error(
+		stderr,
+		"Thread failure at line %" PRIu32 " (%.3fms)\n"
+		"Failed function call 'pthread_mutex_init' with %d\n",
+		line, time, res);
+}
+
+void log_pcond_failure(CzU32 line, int res)
+{
+	double time = program_time();
+
+	log_error(
+		stderr,
+		"Thread failure at line %" PRIu32 " (%.3fms)\n"
+		"Failed function call 'pthread_cond_init' with %d\n",
+		line, time, res);
+}
+
 void log_vkinit_failure(CzU32 line, VkResult res)
 {
 	double time = program_time();
@@ -26,7 +26,8 @@ struct CzVulkanCallbackData
 	CzU32 line;
 };
 
-extern struct CzVulkanCallbackData czgCallbackData;
+// Latest Vulkan function called by each thread. Vulkan invokes callbacks on the calling thread, so they read this copy.
+extern _Thread_local struct CzVulkanCallbackData czgCallbackData;
 
 // Initialisation functions
 
@@ -65,6 +66,10 @@ CZ_COLD
 void log_pcancel_failure(CzU32 line, int res);
 CZ_COLD
 void log_pjoin_failure(CzU32 line, int res);
+CZ_COLD
+void log_pmutex_failure(CzU32 line, int res);
+CZ_COLD
+void log_pcond_failure(CzU32 line, int res);
 
 CZ_COLD
 void log_vkinit_failure(CzU32 line, VkResult res);
@@ -110,6 +115,8 @@ void VKAPI_CALL internal_free_callback(
 #define PCREATE_FAILURE(res) log_pcreate_failure(__LINE__, (int) (res))
 #define PCANCEL_FAILURE(res) log_pcancel_failure(__LINE__, (int) (res))
 #define PJOIN_FAILURE(res)   log_pjoin_failure(__LINE__, (int) (res))
+#define PMUTEX_FAILURE(res)  log_pmutex_failure(__LINE__, (int) (res))
+#define PCOND_FAILURE(res)   log_pcond_failure(__LINE__, (int) (res))
 
 #define VKINIT_FAILURE(res)  log_vkinit_failure(__LINE__, (VkResult) (res))
 #define VULKAN_FAILURE(func) log_vulkan_failure(__LINE__, vkres, #func)
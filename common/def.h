@@ -1637,9 +1637,20 @@
 
 #define CZ_MS_PER_CLOCK ( 1000.0 / CLOCKS_PER_SEC )
 
+#define CZ_CHUNKS_PER_WORKGROUP 8
+#define CZ_TUNING_LOOP_COUNT    4
+#define CZ_RAMP_UP_INOUT_COUNT  2
+#define CZ_MEMORY_PROBE_SIZE    ( 16 * CZ_MIB_SIZE )
+
 #define CZ_DEBUG_LOG_NAME      "debug.log"
-#define CZ_PIPELINE_CACHE_NAME "pipeline_cache.bin"
 #define CZ_PROGRESS_FILE_NAME  "position.txt"
+#define CZ_SHADER_SOURCE_NAME  "./glsl/shader.comp"
+#define CZ_KERNEL_SOURCE_NAME  "./glsl/kernel.h"
+#define CZ_VARIANT_CACHE_NAME  "variant_cache.bin"
+#define CZ_TUNING_CACHE_NAME   "tuning_cache.bin"
+
+#define CZ_PIPELINE_CACHE_PREFIX  "pipeline_cache"
+#define CZ_PIPELINE_BINARY_PREFIX "pipeline_binary"
 
 // Helper macros
 
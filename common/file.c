@@ -2607,6 +2607,81 @@ enum CzResult czTrimFile(const char* restrict path, size_t size, size_t offset,
 	return ret;
 }
 
+#define HAVE_czRenameFile_win32 ( \
+	CZ_WRAP_MOVE_FILE_EX_W &&     \
+	HAVE_widen_path_win32 )
+
+#if HAVE_czRenameFile_win32
+CZ_COPY_ATTR(czRenameFile)
+static enum CzResult czRenameFile_win32(PCSTR oldPath, PCSTR newPath)
+{
+	PWSTR wideOldPath;
+	enum CzResult ret = widen_path_win32(&wideOldPath, oldPath);
+	if CZ_NOEXPECT (ret)
+		return ret;
+
+	PWSTR wideNewPath;
+	ret = widen_path_win32(&wideNewPath, newPath);
+	if CZ_NOEXPECT (ret) {
+		czFree(wideOldPath);
+		return ret;
+	}
+
+	// Unlike rename, MoveFileExW only replaces an existing file when asked to
+	DWORD flags = MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH;
+	ret = czWrap_MoveFileExW(wideOldPath, wideNewPath, flags);
+	czFree(wideNewPath);
+	czFree(wideOldPath);
+	return ret;
+}
+#endif
+
+#define HAVE_czRenameFile_stdc ( CZ_WRAP_RENAME )
+
+#if HAVE_czRenameFile_stdc
+CZ_COPY_ATTR(czRenameFile)
+static enum CzResult czRenameFile_stdc(const char* restrict oldPath, const char* restrict newPath)
+{
+	return czWrap_rename(oldPath, newPath);
+}
+#endif
+
+enum CzResult czRenameFile(const char* restrict oldPath, const char* restrict newPath, struct CzFileFlags flags)
+{
+	enum CzResult ret;
+	const char* resolvedOldPath = oldPath;
+	const char* resolvedNewPath = newPath;
+	char* allocOldPath = NULL;
+	char* allocNewPath = NULL;
+
+	if (flags.relativeToExe) {
+		ret = alloc_resolve_path(&allocOldPath, oldPath);
+		if CZ_NOEXPECT (ret)
+			return ret;
+		if (allocOldPath)
+			resolvedOldPath = allocOldPath;
+
+		ret = alloc_resolve_path(&allocNewPath, newPath);
+		if CZ_NOEXPECT (ret) {
+			czFree(allocOldPath);
+			return ret;
+		}
+		if (allocNewPath)
+			resolvedNewPath = allocNewPath;
+	}
+
+#if HAVE_czRenameFile_win32
+	ret = czRenameFile_win32(resolvedOldPath, resolvedNewPath);
+#elif HAVE_czRenameFile_stdc
+	ret = czRenameFile_stdc(resolvedOldPath, resolvedNewPath);
+#else
+	ret = CZ_RESULT_NO_SUPPORT;
+#endif
+	czFree(allocNewPath);
+	czFree(allocOldPath);
+	return ret;
+}
+
 #define HAVE_czStreamIsTerminal_win32 ( \
 	CZ_WRAP_FILENO &&                   \
 	CZ_WRAP_GET_OSFHANDLE )
@@ -533,6 +533,50 @@ enum CzResult czClearFile(const char* path, size_t size, size_t offset, struct C
 CZ_NONNULL_ARGS() CZ_NULTERM_ARG(1) CZ_RD_ACCESS(1)
 enum CzResult czTrimFile(const char* path, size_t size, size_t offset, struct CzFileFlags flags);
 
+/**
+ * @brief Renames a file.
+ * 
+ * Synchronously renames the file located at @p oldPath to @p newPath. If a file already exists at @p newPath, it is
+ * replaced. On platforms where this replacement is atomic, any concurrent reader of @p newPath observes either the
+ * previous file or the renamed file, but never a partially written file. If @p oldPath and @p newPath locate different
+ * filesystems, failure may occur. On failure, the files located at @p oldPath and @p newPath are unchanged.
+ * 
+ * The members of @p flags can optionally specify the following behaviour.
+ * - If @p flags.relativeToExe is set and @p oldPath or @p newPath is a relative filepath, that path is interpreted as
+ *   relative to the executable file of the program. Otherwise if a path is relative, it is interpreted as relative to
+ *   the current working directory of the program.
+ * - @p flags.openSymLink is ignored.
+ * 
+ * Thread-safety is guaranteed for an invocation @b A to @ref czRenameFile if the following conditions are satisfied.
+ * - For any concurrent invocation @b B to @ref czWriteFile, @ref czInsertFile, @ref czRewriteFile, @ref czClearFile,
+ *   @ref czTrimFile, or @ref czRenameFile, the @p path, @p oldPath, and @p newPath arguments of @b B locate system
+ *   resources distinct from the @p oldPath argument of @b A. If they locate the same resource, the behaviour is
+ *   undefined.
+ * 
+ * @param[in] oldPath The path to the file.
+ * @param[in] newPath The new path to the file.
+ * @param[in] flags Binary flags describing additional behaviour.
+ * 
+ * @retval CZ_RESULT_SUCCESS The operation was successful.
+ * @retval CZ_RESULT_INTERNAL_ERROR An unexpected or unintended internal event occurred.
+ * @retval CZ_RESULT_BAD_ACCESS Permission to rename the file was denied.
+ * @retval CZ_RESULT_BAD_ADDRESS @p oldPath or @p newPath was an invalid pointer.
+ * @retval CZ_RESULT_BAD_FILE The file type was invalid or unsupported, or the paths located different filesystems.
+ * @retval CZ_RESULT_BAD_IO A low-level IO operation failed when renaming the file.
+ * @retval CZ_RESULT_BAD_PATH @p oldPath or @p newPath was an invalid or unsupported filepath.
+ * @retval CZ_RESULT_IN_USE The file was already in use by the system.
+ * @retval CZ_RESULT_NO_DISK The filesystem or secondary storage unit was full.
+ * @retval CZ_RESULT_NO_FILE The file did not exist.
+ * @retval CZ_RESULT_NO_MEMORY Sufficient memory was unable to be allocated.
+ * @retval CZ_RESULT_NO_QUOTA The block or inode quota was exhausted.
+ * @retval CZ_RESULT_NO_SUPPORT The operation was unsupported by the platform.
+ * 
+ * @pre @p oldPath is nonnull and NUL-terminated.
+ * @pre @p newPath is nonnull and NUL-terminated.
+ */
+CZ_NONNULL_ARGS() CZ_NULTERM_ARG(1) CZ_NULTERM_ARG(2) CZ_RD_ACCESS(1) CZ_RD_ACCESS(2)
+enum CzResult czRenameFile(const char* oldPath, const char* newPath, struct CzFileFlags flags);
+
 /**
  * @brief Determines if an IO stream is a terminal.
  * 
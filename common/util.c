@@ -32,6 +32,36 @@ double program_time(void)
 	return (double) t * CZ_MS_PER_CLOCK;
 }
 
+// Unlike program_time, not summed across threads nor paused while blocked, so suited to timing waits and parallel work
+double wall_time(void)
+{
+#if CZ_WIN32
+	LARGE_INTEGER counter;
+	QueryPerformanceCounter(&counter);
+	return wall_time_at((CzU64) counter.QuadPart);
+#elif CZ_POSIX_MONOTONIC_CLOCK >= 0
+	struct timespec t;
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return (double) t.tv_sec * 1000 + (double) t.tv_nsec / 1000000;
+#else
+	struct timespec t;
+	timespec_get(&t, TIME_UTC);
+	return (double) t.tv_sec * 1000 + (double) t.tv_nsec / 1000000;
+#endif
+}
+
+// Convert a timestamp of CZ_WALL_TIME_DOMAIN, such as from vkGetCalibratedTimestampsKHR, to the clock of wall_time
+double wall_time_at(CzU64 timestamp)
+{
+#if CZ_WIN32
+	LARGE_INTEGER frequency;
+	QueryPerformanceFrequency(&frequency);
+	return (double) timestamp * 1000 / (double) frequency.QuadPart;
+#else
+	return (double) timestamp / 1000000;
+#endif
+}
+
 enum CzEndianness get_endianness(void)
 {
 	int x = 1;
@@ -83,11 +113,6 @@ CzU32 floor_pow2(CzU32 x)
 #endif
 }
 
-double get_benchmark(clock_t start, clock_t end)
-{
-	return (double) (end - start) * CZ_MS_PER_CLOCK;
-}
-
 bool set_debug_name(VkDevice device, VkObjectType type, CzU64 handle, const char* name)
 {
 	VkResult vkres;
@@ -170,10 +195,8 @@ bool save_pipeline_cache(VkDevice device, VkPipelineCache cache, const char* fil
 	VK_CALLR(vkGetPipelineCacheData, device, cache, &dataSize, data);
 	if CZ_NOEXPECT (vkres) { goto err_free_data; }
 
-	struct CzFileFlags fileFlags = {0};
-	fileFlags.relativeToExe = true;
-	czres = czRewriteFile(filename, data, dataSize, fileFlags);
-	if CZ_NOEXPECT (czres) { goto err_free_data; }
+	bool bres = replace_file(filename, data, dataSize);
+	if CZ_NOEXPECT (!bres) { goto err_free_data; }
 
 	czFree(data);
 	return true;
@@ -183,6 +206,46 @@ bool save_pipeline_cache(VkDevice device, VkPipelineCache cache, const char* fil
 	return false;
 }
 
+bool replace_file(const char* filename, const void* data, size_t size)
+{
+	/*
+	 * Write to a temporary file first, so an interrupted write never leaves a truncated file behind. The temporary file
+	 * is named after the process and a count within it, so concurrent runs and threads never write to the same one.
+	 */
+	static atomic_uint tempCount;
+
+#if CZ_WIN32
+	unsigned long processId = (unsigned long) GetCurrentProcessId();
+#elif CZ_POSIX_VERSION >= 0
+	unsigned long processId = (unsigned long) getpid();
+#else
+	unsigned long processId = 0;
+#endif
+
+	unsigned tempIndex = atomic_fetch_add_explicit(&tempCount, 1, memory_order_relaxed);
+	size_t nameSize = strlen(filename) + 48; // Room for ".<pid>.<count>.tmp"
+
+	char* restrict tempName;
+	struct CzAllocFlags allocFlags = {0};
+	enum CzResult czres = czAlloc((void**) &tempName, nameSize, allocFlags);
+	if CZ_NOEXPECT (czres) { return false; }
+
+	sprintf(tempName, "%s.%lu.%u.tmp", filename, processId, tempIndex);
+
+	struct CzFileFlags fileFlags = {0};
+	fileFlags.relativeToExe = true;
+
+	// On POSIX and Windows, also syncs the file to disk as it is closed, so the rename never exposes unwritten contents
+	czres = czRewriteFile(tempName, data, size, fileFlags);
+	if CZ_NOEXPECT (czres) { czFree(tempName); return false; }
+
+	czres = czRenameFile(tempName, filename, fileFlags);
+	if CZ_NOEXPECT (czres) { czFree(tempName); return false; }
+
+	czFree(tempName);
+	return true;
+}
+
 bool read_text(const char* filename, const char* format, ...)
 {
 	va_list args;
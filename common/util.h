@@ -19,10 +19,23 @@
 
 #include "def.h"
 
+// Host time domain of wall_time, as named by VK_KHR_calibrated_timestamps
+#if CZ_WIN32
+#define CZ_WALL_TIME_DOMAIN VK_TIME_DOMAIN_QUERY_PERFORMANCE_COUNTER_KHR
+#elif CZ_POSIX_MONOTONIC_CLOCK >= 0
+#define CZ_WALL_TIME_DOMAIN VK_TIME_DOMAIN_CLOCK_MONOTONIC_KHR
+#else
+#define CZ_WALL_TIME_DOMAIN VK_TIME_DOMAIN_MAX_ENUM_KHR // No calibrateable domain
+#endif
+
 CZ_NONNULL_RET CZ_USE_RET
 char* stime(void);
 CZ_USE_RET
 double program_time(void);
+CZ_USE_RET
+double wall_time(void);
+CZ_USE_RET
+double wall_time_at(CzU64 timestamp);
 
 CZ_CONST CZ_USE_RET
 enum CzEndianness get_endianness(void);
@@ -32,9 +45,6 @@ CzU32 ceil_pow2(CzU32 x);
 CZ_CONST CZ_USE_RET
 CzU32 floor_pow2(CzU32 x);
 
-CZ_CONST CZ_USE_RET
-double get_benchmark(clock_t start, clock_t end);
-
 CZ_NONNULL_ARGS(1) CZ_NULTERM_ARG(4) CZ_RD_ACCESS(4)
 bool set_debug_name(VkDevice device, VkObjectType type, CzU64 handle, const char* name);
 
@@ -49,6 +59,9 @@ bool get_buffer_requirements_main4(
 CZ_NONNULL_ARGS() CZ_NULTERM_ARG(3) CZ_RD_ACCESS(3)
 bool save_pipeline_cache(VkDevice device, VkPipelineCache cache, const char* filename);
 
+CZ_NONNULL_ARGS() CZ_NULTERM_ARG(1) CZ_RD_ACCESS(1) CZ_RD_ACCESS(2, 3)
+bool replace_file(const char* filename, const void* data, size_t size);
+
 CZ_SCANF(2, 3) CZ_NONNULL_ARGS() CZ_NULTERM_ARG(1) CZ_NULTERM_ARG(2) CZ_RD_ACCESS(1) CZ_RD_ACCESS(2)
 bool read_text(const char* filename, const char* format, ...);
 
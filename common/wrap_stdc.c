@@ -1795,3 +1795,155 @@ enum CzResult czWrap_remove(const char* path)
 #endif
 }
 #endif
+
+#if CZ_WRAP_RENAME
+enum CzResult czWrap_rename(const char* oldPath, const char* newPath)
+{
+	int r = rename(oldPath, newPath);
+	if CZ_EXPECT (!r)
+		return CZ_RESULT_SUCCESS;
+
+#if CZ_DARWIN
+	switch (errno) {
+	case EACCES:
+	case EPERM:
+	case EROFS:
+		return CZ_RESULT_BAD_ACCESS;
+	case EFAULT:
+		return CZ_RESULT_BAD_ADDRESS;
+	case EEXIST:
+	case EISDIR:
+	case ENOTEMPTY:
+	case EXDEV:
+		return CZ_RESULT_BAD_FILE;
+	case EIO:
+		return CZ_RESULT_BAD_IO;
+	case EINVAL:
+	case ELOOP:
+	case ENAMETOOLONG:
+	case ENOTDIR:
+		return CZ_RESULT_BAD_PATH;
+	case EBUSY:
+		return CZ_RESULT_IN_USE;
+	case ENOSPC:
+		return CZ_RESULT_NO_DISK;
+	case ENOENT:
+		return CZ_RESULT_NO_FILE;
+	case EDQUOT:
+		return CZ_RESULT_NO_QUOTA;
+	default:
+		return CZ_RESULT_INTERNAL_ERROR;
+	}
+#elif CZ_GNU_LINUX
+	switch (errno) {
+	case EACCES:
+	case EPERM:
+	case EROFS:
+		return CZ_RESULT_BAD_ACCESS;
+	case EFAULT:
+		return CZ_RESULT_BAD_ADDRESS;
+	case EEXIST:
+	case EISDIR:
+	case EMLINK:
+	case ENOTEMPTY:
+	case EXDEV:
+		return CZ_RESULT_BAD_FILE;
+	case EIO:
+		return CZ_RESULT_BAD_IO;
+	case EINVAL:
+	case ELOOP:
+	case ENAMETOOLONG:
+	case ENOTDIR:
+		return CZ_RESULT_BAD_PATH;
+	case ENOENT:
+		if (!oldPath[0] || !newPath[0])
+			return CZ_RESULT_BAD_PATH;
+		return CZ_RESULT_NO_FILE;
+	case EBUSY:
+		return CZ_RESULT_IN_USE;
+	case ENOSPC:
+		return CZ_RESULT_NO_DISK;
+	case ENOMEM:
+		return CZ_RESULT_NO_MEMORY;
+	case EDQUOT:
+		return CZ_RESULT_NO_QUOTA;
+	default:
+		return CZ_RESULT_INTERNAL_ERROR;
+	}
+#elif CZ_FREE_BSD
+	switch (errno) {
+	case EACCES:
+	case EPERM:
+	case EROFS:
+		return CZ_RESULT_BAD_ACCESS;
+	case EFAULT:
+		return CZ_RESULT_BAD_ADDRESS;
+	case EINTEGRITY:
+	case EISDIR:
+	case ENOTEMPTY:
+	case EXDEV:
+		return CZ_RESULT_BAD_FILE;
+	case EIO:
+		return CZ_RESULT_BAD_IO;
+	case EINVAL:
+	case ELOOP:
+	case ENAMETOOLONG:
+	case ENOTDIR:
+		return CZ_RESULT_BAD_PATH;
+	case EBUSY:
+		return CZ_RESULT_IN_USE;
+	case ENOSPC:
+		return CZ_RESULT_NO_DISK;
+	case ENOENT:
+		return CZ_RESULT_NO_FILE;
+	case EDQUOT:
+		return CZ_RESULT_NO_QUOTA;
+	default:
+		return CZ_RESULT_INTERNAL_ERROR;
+	}
+#elif CZ_POSIX_VERSION >= CZ_POSIX_1988 || CZ_XOPEN_VERSION >= CZ_XPG_1989
+	switch (errno) {
+	case EACCES:
+	case EPERM:
+	case EROFS:
+		return CZ_RESULT_BAD_ACCESS;
+	case EEXIST:
+	case EISDIR:
+	case EMLINK:
+	case ENOTEMPTY:
+	case EXDEV:
+		return CZ_RESULT_BAD_FILE;
+#if CZ_POSIX_VERSION >= CZ_POSIX_2001 || CZ_XOPEN_VERSION >= CZ_SUS_2001
+	case EIO:
+		return CZ_RESULT_BAD_IO;
+#endif
+	case EINVAL:
+	case ENAMETOOLONG:
+	case ENOTDIR:
+		return CZ_RESULT_BAD_PATH;
+#if CZ_POSIX_VERSION >= CZ_POSIX_2001 || CZ_XOPEN_VERSION >= CZ_SUS_2001
+	case ELOOP:
+		return CZ_RESULT_BAD_PATH;
+#endif
+	case ENOENT:
+		if (!oldPath[0] || !newPath[0])
+			return CZ_RESULT_BAD_PATH;
+		return CZ_RESULT_NO_FILE;
+	case EBUSY:
+		return CZ_RESULT_IN_USE;
+	case ENOSPC:
+		return CZ_RESULT_NO_DISK;
+#if CZ_POSIX_VERSION >= CZ_POSIX_2001 || CZ_XOPEN_VERSION >= CZ_SUS_2001
+	case ETXTBSY:
+		return CZ_RESULT_IN_USE;
+#endif
+	default:
+		return CZ_RESULT_INTERNAL_ERROR;
+	}
+#else
+	if (!oldPath[0] || !newPath[0])
+		return CZ_RESULT_BAD_PATH;
+	return CZ_RESULT_INTERNAL_ERROR;
+#endif
+}
+#endif
@@ -957,3 +957,52 @@ enum CzResult czWrap_fflush(FILE* stream);
 CZ_NONNULL_ARGS(1) CZ_NULTERM_ARG(1) CZ_RD_ACCESS(1)
 enum CzResult czWrap_remove(const char* path);
 #endif
+
+/**
+ * @def CZ_WRAP_RENAME
+ * 
+ * @brief Specifies whether @c rename is defined.
+ */
+#if !defined(CZ_WRAP_RENAME)
+#if (                                    \
+		CZ_FREE_BSD &&                   \
+		CZ_FREE_BSD_USE_STDC_1989) ||    \
+	CZ_STDC_VERSION >= CZ_STDC_1989 ||   \
+	CZ_POSIX_VERSION >= CZ_POSIX_1988 || \
+	CZ_XOPEN_VERSION >= CZ_XPG_1989
+#define CZ_WRAP_RENAME 1
+#else
+#define CZ_WRAP_RENAME 0
+#endif
+#endif
+
+#if CZ_WRAP_RENAME
+/**
+ * @brief Wraps @c rename.
+ * 
+ * Calls @c rename with @p oldPath and @p newPath.
+ * 
+ * @param[in] oldPath The first argument to pass to @c rename.
+ * @param[in] newPath The second argument to pass to @c rename.
+ * 
+ * @retval CZ_RESULT_SUCCESS The operation was successful.
+ * @retval CZ_RESULT_INTERNAL_ERROR An unexpected or unintended internal event occurred.
+ * @retval CZ_RESULT_BAD_ACCESS Permission to rename the file was denied.
+ * @retval CZ_RESULT_BAD_ADDRESS @p oldPath or @p newPath was an invalid pointer.
+ * @retval CZ_RESULT_BAD_FILE The file type was invalid or unsupported, or the files were on different filesystems.
+ * @retval CZ_RESULT_BAD_IO A low-level IO operation failed when renaming the file.
+ * @retval CZ_RESULT_BAD_PATH @p oldPath or @p newPath was an invalid or unsupported filepath.
+ * @retval CZ_RESULT_IN_USE The file was already in use by the system.
+ * @retval CZ_RESULT_NO_DISK The filesystem or secondary storage unit was full.
+ * @retval CZ_RESULT_NO_FILE The file did not exist.
+ * @retval CZ_RESULT_NO_MEMORY Sufficient memory was unable to be allocated.
+ * @retval CZ_RESULT_NO_QUOTA The block or inode quota was exhausted.
+ * 
+ * @pre @p oldPath is nonnull and NUL-terminated.
+ * @pre @p newPath is nonnull and NUL-terminated.
+ * 
+ * @note This function is only defined if @ref CZ_WRAP_RENAME is defined as a nonzero value.
+ */
+CZ_NONNULL_ARGS(1, 2) CZ_NULTERM_ARG(1) CZ_NULTERM_ARG(2) CZ_RD_ACCESS(1) CZ_RD_ACCESS(2)
+enum CzResult czWrap_rename(const char* oldPath, const char* newPath);
+#endif
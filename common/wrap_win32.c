@@ -1603,6 +1603,133 @@ enum CzResult czWrap_RemoveDirectoryW(LPCWSTR lpPathName)
 }
 #endif
 
+#if CZ_WRAP_MOVE_FILE_EX_W
+enum CzResult czWrap_MoveFileExW(LPCWSTR lpExistingFileName, LPCWSTR lpNewFileName, DWORD dwFlags)
+{
+	BOOL r = MoveFileExW(lpExistingFileName, lpNewFileName, dwFlags);
+	if CZ_EXPECT (r)
+		return CZ_RESULT_SUCCESS;
+
+	DWORD err = GetLastError();
+	switch (err) {
+	case ERROR_ACCESS_DENIED:
+	case ERROR_NETWORK_ACCESS_DENIED:
+		return CZ_RESULT_BAD_ACCESS;
+	case ERROR_INVALID_ADDRESS:
+		return CZ_RESULT_BAD_ADDRESS;
+	case ERROR_ALREADY_EXISTS:
+	case ERROR_BAD_DEV_TYPE:
+	case ERROR_BAD_FILE_TYPE:
+	case ERROR_BAD_PIPE:
+	case ERROR_BROKEN_PIPE:
+	case ERROR_COMPRESSED_FILE_NOT_SUPPORTED:
+	case ERROR_DATA_CHECKSUM_ERROR:
+	case ERROR_DIRECTORY_NOT_SUPPORTED:
+	case ERROR_EA_FILE_CORRUPT:
+	case ERROR_EA_LIST_INCONSISTENT:
+	case ERROR_EA_TABLE_FULL:
+	case ERROR_FILE_EXISTS:
+	case ERROR_FILE_TOO_LARGE:
+	case ERROR_INVALID_EA_NAME:
+	case ERROR_MORE_DATA:
+	case ERROR_NO_DATA:
+	case ERROR_NOT_ALLOWED_ON_SYSTEM_FILE:
+	case ERROR_NOT_SAME_DEVICE:
+	case ERROR_PIPE_LOCAL:
+	case ERROR_PIPE_NOT_CONNECTED:
+	case ERROR_RESIDENT_FILE_NOT_SUPPORTED:
+	case ERROR_VIRUS_DELETED:
+	case ERROR_VIRUS_INFECTED:
+		return CZ_RESULT_BAD_FILE;
+	case ERROR_ADAP_HDW_ERR:
+	case ERROR_BAD_REM_ADAP:
+	case ERROR_DISK_CHANGE:
+	case ERROR_IMAGE_SUBSYSTEM_NOT_PRESENT:
+	case ERROR_INTERMIXED_KERNEL_EA_OPERATION:
+	case ERROR_INVALID_CAP:
+	case ERROR_INVALID_TARGET_HANDLE:
+	case ERROR_MAX_THRDS_REACHED:
+	case ERROR_NET_WRITE_FAULT:
+	case ERROR_NO_MORE_SEARCH_HANDLES:
+	case ERROR_NO_VOLUME_LABEL:
+	case ERROR_NOT_READ_FROM_COPY:
+	case ERROR_READ_FAULT:
+	case ERROR_REQ_NOT_ACCEP:
+	case ERROR_SECURITY_STREAM_IS_INCONSISTENT:
+	case ERROR_TOO_MANY_CMDS:
+	case ERROR_TOO_MANY_NAMES:
+	case ERROR_TOO_MANY_SESS:
+	case ERROR_TOO_MANY_TCBS:
+	case ERROR_UNDEFINED_SCOPE:
+	case ERROR_UNEXP_NET_ERR:
+	case ERROR_VC_DISCONNECTED:
+	case ERROR_WRITE_FAULT:
+	case ERROR_WRONG_DISK:
+		return CZ_RESULT_BAD_IO;
+	case ERROR_BAD_ARGUMENTS:
+	case ERROR_BAD_DEVICE_PATH:
+	case ERROR_BAD_NET_NAME:
+	case ERROR_BAD_PATHNAME:
+	case ERROR_BUFFER_OVERFLOW:
+	case ERROR_DIR_NOT_ROOT:
+	case ERROR_DIRECTORY:
+	case ERROR_FILENAME_EXCED_RANGE:
+	case ERROR_INVALID_FIELD_IN_PARAMETER_LIST:
+	case ERROR_INVALID_NAME:
+	case ERROR_INVALID_PARAMETER:
+	case ERROR_LABEL_TOO_LONG:
+	case ERROR_META_EXPANSION_TOO_LONG:
+	case ERROR_PATH_NOT_FOUND:
+	case ERROR_SHORT_NAMES_NOT_ENABLED_ON_VOLUME:
+		return CZ_RESULT_BAD_PATH;
+	case ERROR_BUSY:
+	case ERROR_DRIVE_LOCKED:
+	case ERROR_FILE_CHECKED_OUT:
+	case ERROR_LOCK_VIOLATION:
+	case ERROR_LOCKED:
+	case ERROR_NETWORK_BUSY:
+	case ERROR_NOT_READY:
+	case ERROR_OPERATION_IN_PROGRESS:
+	case ERROR_PATH_BUSY:
+	case ERROR_PIPE_BUSY:
+	case ERROR_REDIR_PAUSED:
+	case ERROR_SHARING_PAUSED:
+	case ERROR_SHARING_VIOLATION:
+		return CZ_RESULT_IN_USE;
+	case ERROR_DISK_FULL:
+	case ERROR_DISK_RESOURCES_EXHAUSTED:
+	case ERROR_DISK_TOO_FRAGMENTED:
+	case ERROR_HANDLE_DISK_FULL:
+		return CZ_RESULT_NO_DISK;
+	case ERROR_BAD_NETPATH:
+	case ERROR_DEV_NOT_EXIST:
+	case ERROR_DEVICE_UNREACHABLE:
+	case ERROR_FILE_NOT_FOUND:
+	case ERROR_MOD_NOT_FOUND:
+	case ERROR_NETNAME_DELETED:
+	case ERROR_PROC_NOT_FOUND:
+		return CZ_RESULT_NO_FILE;
+	case ERROR_DEVICE_NO_RESOURCES:
+	case ERROR_NOT_ENOUGH_MEMORY:
+	case ERROR_OUTOFMEMORY:
+	case ERROR_OUT_OF_STRUCTURES:
+		return CZ_RESULT_NO_MEMORY;
+	case ERROR_BAD_COMMAND:
+	case ERROR_BAD_DRIVER_LEVEL:
+	case ERROR_BAD_NET_RESP:
+	case ERROR_CALL_NOT_IMPLEMENTED:
+	case ERROR_DEVICE_FEATURE_NOT_SUPPORTED:
+	case ERROR_DEVICE_SUPPORT_IN_PROGRESS:
+	case ERROR_EAS_NOT_SUPPORTED:
+	case ERROR_NOT_REDUNDANT_STORAGE:
+	case ERROR_NOT_SUPPORTED:
+		return CZ_RESULT_NO_SUPPORT;
+	default:
+		return CZ_RESULT_INTERNAL_ERROR;
+	}
+}
+#endif
+
 #if CZ_WRAP_CREATE_FILE_MAPPING_W
 enum CzResult czWrap_CreateFileMappingW(
 	LPHANDLE res,
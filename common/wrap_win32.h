@@ -911,6 +911,51 @@ CZ_NONNULL_ARGS(1) CZ_NULTERM_ARG(1) CZ_RD_ACCESS(1)
 enum CzResult czWrap_RemoveDirectoryW(LPCWSTR lpPathName);
 #endif
 
+/**
+ * @def CZ_WRAP_MOVE_FILE_EX_W
+ * 
+ * @brief Specifies whether @c MoveFileExW is defined.
+ */
+#if !defined(CZ_WRAP_MOVE_FILE_EX_W)
+#if CZ_WIN32
+#define CZ_WRAP_MOVE_FILE_EX_W 1
+#else
+#define CZ_WRAP_MOVE_FILE_EX_W 0
+#endif
+#endif
+
+#if CZ_WRAP_MOVE_FILE_EX_W
+/**
+ * @brief Wraps @c MoveFileExW.
+ * 
+ * Calls @c MoveFileExW with @p lpExistingFileName, @p lpNewFileName, and @p dwFlags.
+ * 
+ * @param[in] lpExistingFileName The first argument to pass to @c MoveFileExW.
+ * @param[in] lpNewFileName The second argument to pass to @c MoveFileExW.
+ * @param[in] dwFlags The third argument to pass to @c MoveFileExW.
+ * 
+ * @retval CZ_RESULT_SUCCESS The operation was successful.
+ * @retval CZ_RESULT_INTERNAL_ERROR An unexpected or unintended internal event occurred.
+ * @retval CZ_RESULT_BAD_ACCESS Permission to move the file was denied.
+ * @retval CZ_RESULT_BAD_ADDRESS @p lpExistingFileName or @p lpNewFileName was an invalid pointer.
+ * @retval CZ_RESULT_BAD_FILE The file type was invalid or unsupported, or the destination already existed.
+ * @retval CZ_RESULT_BAD_IO A low-level IO operation failed when moving the file.
+ * @retval CZ_RESULT_BAD_PATH @p lpExistingFileName or @p lpNewFileName was an invalid or unsupported filepath.
+ * @retval CZ_RESULT_IN_USE The file was already in use by the system.
+ * @retval CZ_RESULT_NO_DISK The filesystem or secondary storage unit was full.
+ * @retval CZ_RESULT_NO_FILE The file did not exist.
+ * @retval CZ_RESULT_NO_MEMORY Sufficient memory was unable to be allocated.
+ * @retval CZ_RESULT_NO_SUPPORT The operation was unsupported by the platform.
+ * 
+ * @pre @p lpExistingFileName is nonnull and NUL-terminated.
+ * @pre @p lpNewFileName is NUL-terminated.
+ * 
+ * @note This function is only defined if @ref CZ_WRAP_MOVE_FILE_EX_W is defined as a nonzero value.
+ */
+CZ_NONNULL_ARGS(1) CZ_NULTERM_ARG(1) CZ_NULTERM_ARG(2) CZ_RD_ACCESS(1) CZ_RD_ACCESS(2)
+enum CzResult czWrap_MoveFileExW(LPCWSTR lpExistingFileName, LPCWSTR lpNewFileName, DWORD dwFlags);
+#endif
+
 /**
  * @def CZ_WRAP_CREATE_FILE_MAPPING_W
  * 
@@ -37,6 +37,11 @@ void dyrecord_destroy_stub(void* record)
 	dyrecord_destroy(record);
 }
 
+void dyring_destroy_stub(void* ring)
+{
+	dyring_destroy(ring);
+}
+
 void dystring_destroy_stub(void* string)
 {
 	dystring_destroy(string);
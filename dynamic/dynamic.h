@@ -27,6 +27,7 @@
 #include "dyarray.h"
 #include "dyqueue.h"
 #include "dyrecord.h"
+#include "dyring.h"
 #include "dystring.h"
 
 /**
@@ -69,6 +70,16 @@ void dyqueue_destroy_stub(void* queue);
  */
 void dyrecord_destroy_stub(void* record);
 
+/**
+ * @brief FreeCallback compatible version of @ref dyring_destroy.
+ * 
+ * Calls @ref dyring_destroy with @p ring. Can be used as the free callback when recording a ring queue to a dynamic
+ * record.
+ * 
+ * @param[in,out] ring The ring queue.
+ */
+void dyring_destroy_stub(void* ring);
+
 /**
  * @brief FreeCallback compatible version of @ref dystring_destroy.
  * 
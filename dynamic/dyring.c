@@ -0,0 +1,115 @@
+/* 
+ * Copyright (C) 2025 Seth McDonald
+ * 
+ * This file is part of Collatz Conjecture Simulator.
+ * 
+ * Collatz Conjecture Simulator is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ * 
+ * Collatz Conjecture Simulator is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE. See the GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License along with Collatz Conjecture
+ * Simulator. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "dyring.h"
+
+#define DYRING_LINE_SIZE 64 // Assumed cache line size
+
+struct DyRing_
+{
+	alignas(DYRING_LINE_SIZE) atomic_size_t head; // Number of elements ever dequeued (written by consumer)
+	alignas(DYRING_LINE_SIZE) atomic_size_t tail; // Number of elements ever enqueued (written by producer)
+	alignas(DYRING_LINE_SIZE) size_t size; // Number of bytes per element
+	size_t mask; // Number of elements that fit in raw array, minus one
+	char* restrict raw; // Raw array
+};
+
+void dyring_destroy(struct DyRing_* restrict ring)
+{
+	if CZ_NOEXPECT (!ring) { return; }
+
+	czFree(ring->raw);
+	czFreeAlign(ring);
+}
+
+struct DyRing_* dyring_create(size_t size, size_t count)
+{
+	CZ_ASSUME(size != 0);
+	CZ_ASSUME(count != 0);
+
+	// Capacity is a power of 2 so that indices wrap with a mask
+	size_t capacity = 1;
+	while (capacity < count) {
+		capacity *= 2;
+	}
+
+	struct DyRing_* restrict ring;
+	struct CzAllocFlags flags = {0};
+
+	size_t alignment = alignof(struct DyRing_);
+	size_t offset = 0;
+
+	enum CzResult czres = czAllocAlign((void* restrict*) &ring, sizeof(*ring), alignment, offset, flags);
+	if CZ_NOEXPECT (czres) { return NULL; }
+
+	czres = czAlloc((void* restrict*) &ring->raw, capacity * size, flags);
+	if CZ_NOEXPECT (czres) { goto err_free_ring; }
+
+	atomic_init(&ring->head, 0);
+	atomic_init(&ring->tail, 0);
+
+	ring->size = size;
+	ring->mask = capacity - 1;
+
+	return ring;
+
+err_free_ring:
+	czFreeAlign(ring);
+	return NULL;
+}
+
+bool dyring_push(struct DyRing_* restrict ring, const void* restrict value)
+{
+	CZ_ASSUME(ring->size != 0);
+
+	size_t size = ring->size;
+	size_t mask = ring->mask;
+
+	size_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed); // Only written by this thread
+	size_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+
+	if (tail - head > mask) {
+		return false;
+	}
+
+	void* element = ring->raw + (tail & mask) * size;
+	memcpy(element, value, size);
+
+	atomic_store_explicit(&ring->tail, tail + 1, memory_order_release); // Publish element to consumer
+	return true;
+}
+
+bool dyring_pop(struct DyRing_* restrict ring, void* restrict value)
+{
+	CZ_ASSUME(ring->size != 0);
+
+	size_t size = ring->size;
+	size_t mask = ring->mask;
+
+	size_t head = atomic_load_explicit(&ring->head, memory_order_relaxed); // Only written by this thread
+	size_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+
+	if (head == tail) {
+		return false;
+	}
+
+	const void* element = ring->raw + (head & mask) * size;
+	memcpy(value, element, size);
+
+	atomic_store_explicit(&ring->head, head + 1, memory_order_release); // Return slot to producer
+	return true;
+}
@@ -0,0 +1,103 @@
+/* 
+ * Copyright (C) 2025 Seth McDonald
+ * 
+ * This file is part of Collatz Conjecture Simulator.
+ * 
+ * Collatz Conjecture Simulator is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ * 
+ * Collatz Conjecture Simulator is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE. See the GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License along with Collatz Conjecture
+ * Simulator. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file
+ * 
+ * @brief The types and functions for lock-free single-producer single-consumer ring queues.
+ */
+
+#pragma once
+
+#include "common.h"
+
+/**
+ * @brief Handle for a fixed capacity FIFO ring queue shared between one producer thread and one consumer thread.
+ */
+typedef struct DyRing_* DyRing;
+
+/**
+ * @brief Destroys a ring queue.
+ * 
+ * Destroys @p ring and frees all associated memory. If @p ring is null, nothing happens.
+ * 
+ * @param[in,out] ring The ring queue.
+ * 
+ * @warning Once @p ring has been destroyed, any further usage of @p ring will result in undefined behaviour.
+ */
+void dyring_destroy(DyRing ring);
+
+/**
+ * @brief Creates a new ring queue.
+ * 
+ * Creates an empty ring queue able to hold at least @p count elements at once. Failure can occur if sufficient memory
+ * is unable to be allocated.
+ * 
+ * @param[in] size The number of bytes per element.
+ * @param[in] count The minimum number of elements the ring queue can hold.
+ * 
+ * @return The new ring queue, or null on failure.
+ * 
+ * @pre @p size is nonzero.
+ * @pre @p count is nonzero.
+ * 
+ * @note Failing to destroy the returned ring queue may result in a memory leak.
+ */
+CZ_FREE(dyring_destroy, 1) CZ_USE_RET
+DyRing dyring_create(size_t size, size_t count);
+
+/**
+ * @brief Adds an element to a ring queue.
+ * 
+ * Enqueues an element to the back of @p ring. The element is initialised as a copy of the value pointed to by
+ * @p value. If @p ring is full, nothing happens and failure occurs. Never blocks.
+ * 
+ * Thread-safety is guaranteed for an invocation to @ref dyring_push concurrent with an invocation to
+ * @ref dyring_pop, but not with another invocation to @ref dyring_push on the same ring queue.
+ * 
+ * @param[in,out] ring The ring queue.
+ * @param[in] value The initialising value.
+ * 
+ * @retval true on success.
+ * @retval false if @p ring was full.
+ * 
+ * @pre @p ring is nonnull.
+ * @pre @p value is nonnull.
+ */
+CZ_NONNULL_ARGS() CZ_RW_ACCESS(1) CZ_RD_ACCESS(2)
+bool dyring_push(DyRing ring, const void* value);
+
+/**
+ * @brief Removes an element from a ring queue.
+ * 
+ * Dequeues an element from the front of @p ring. The element is copied into the memory pointed to by @p value. If
+ * @p ring is empty, nothing happens and failure occurs. Never blocks.
+ * 
+ * Thread-safety is guaranteed for an invocation to @ref dyring_pop concurrent with an invocation to
+ * @ref dyring_push, but not with another invocation to @ref dyring_pop on the same ring queue.
+ * 
+ * @param[in,out] ring The ring queue.
+ * @param[out] value The memory to write the element to.
+ * 
+ * @retval true on success.
+ * @retval false if @p ring was empty.
+ * 
+ * @pre @p ring is nonnull.
+ * @pre @p value is nonnull.
+ */
+CZ_NONNULL_ARGS() CZ_RW_ACCESS(1) CZ_WR_ACCESS(2)
+bool dyring_pop(DyRing ring, void* value);
@@ -0,0 +1,33 @@
+# Generates a C source file embedding the SPIR-V of each shader variant in the executable
+# Expects INPUTS (comma-separated paths of the SPIR-V files), BASE_DIR (directory of the executable), and OUTPUT
+
+string(REPLACE "," ";" INPUTS "${INPUTS}")
+
+set(CONTENT "// Generated by shader/embed.cmake from the compiled shaders\n\n#include \"spirv.h\"\n")
+set(ENTRIES "")
+set(INDEX 0)
+
+foreach(INPUT ${INPUTS})
+	file(READ ${INPUT} CODE HEX)
+	file(RELATIVE_PATH NAME ${BASE_DIR} ${INPUT})
+
+	# SPIR-V is a stream of words, written in the byte order given by its magic number (0x07230203)
+	set(BYTE "([0-9a-f][0-9a-f])")
+	string(SUBSTRING "${CODE}" 0 8 MAGIC)
+
+	if(MAGIC STREQUAL "03022307")
+		string(REGEX REPLACE "${BYTE}${BYTE}${BYTE}${BYTE}" "0x\\4\\3\\2\\1," CODE "${CODE}")
+	else()
+		string(REGEX REPLACE "${BYTE}${BYTE}${BYTE}${BYTE}" "0x\\1\\2\\3\\4," CODE "${CODE}")
+	endif()
+
+	string(APPEND CONTENT "\nstatic const CzU32 shader${INDEX}[] = {${CODE}};\n")
+	string(APPEND ENTRIES "\t{\"./${NAME}\", shader${INDEX}, sizeof(shader${INDEX})},\n")
+
+	math(EXPR INDEX "${INDEX} + 1")
+endforeach()
+
+string(APPEND CONTENT "\nconst struct CzEmbeddedShader czgEmbeddedShaders[] = {\n${ENTRIES}};\n")
+string(APPEND CONTENT "\nconst size_t czgEmbeddedShaderCount = ${INDEX};\n")
+
+file(WRITE ${OUTPUT} "${CONTENT}")
@@ -0,0 +1,319 @@
+/*
+ * Copyright (C) 2025 Seth McDonald
+ *
+ * This file is part of Collatz Conjecture Simulator.
+ *
+ * Collatz Conjecture Simulator is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Collatz Conjecture Simulator is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE. See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with Collatz Conjecture
+ * Simulator. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Collatz kernel arithmetic on 128-bit values, written once and compiled both as GLSL (by shader.comp) and as C17 (by
+ * the host). In GLSL, CzKernel32 and CzKernel64 are uvec4 and u64vec2. In C, they are structs of CzU32 and CzU64 limbs
+ * with the same memory layout. Functions return the number of steps taken, leaving the step count type to the caller.
+ */
+
+#if defined(__STDC_VERSION__)
+
+typedef struct CzKernel32
+{
+	CzU32 limbs[4];
+} CzKernel32;
+
+typedef struct CzKernel64
+{
+	CzU64 limbs[2];
+} CzKernel64;
+
+#define CZ_KERNEL_FUNC            static inline
+#define CZ_KERNEL_INOUT(T, name)  T* restrict name
+#define CZ_KERNEL_IN(T, name)     const T* restrict name
+#define CZ_KERNEL_LIMB(n, i)      ( (n)->limbs[i] )
+#define CZ_KERNEL_U32(x)          ( (CzU32) (x) )
+#define CZ_KERNEL_U64(x)          ( (CzU64) (x) )
+#define CZ_KERNEL_FINDLSB(x)      kernel_findlsb(x)
+#define CZ_KERNEL_UNROLL
+
+CZ_KERNEL_FUNC CzU32 kernel_findlsb(CzU32 x)
+{
+	if (!x) {
+		return UINT32_MAX; // Same as findLSB (GLSL)
+	}
+#if CZ_HAS_BUILTIN(ctz) && UINT32_MAX == UINT_MAX
+	return (CzU32) __builtin_ctz(x);
+#else
+	CzU32 lsb = 0;
+	for (; !(x & 1); x >>= 1) { lsb++; }
+	return lsb;
+#endif
+}
+
+#else
+
+#define CzU32      uint32_t
+#define CzU64      uint64_t
+#define CzKernel32 uvec4
+#define CzKernel64 u64vec2
+
+#define CZ_KERNEL_FUNC
+#define CZ_KERNEL_INOUT(T, name)  inout T name
+#define CZ_KERNEL_IN(T, name)     in T name
+#define CZ_KERNEL_LIMB(n, i)      ( (n)[i] )
+#define CZ_KERNEL_U32(x)          uint32_t(x)
+#define CZ_KERNEL_U64(x)          uint64_t(x)
+#define CZ_KERNEL_FINDLSB(x)      uint32_t(findLSB(x))
+#define CZ_KERNEL_UNROLL          ATTR_UNROLL
+
+#endif
+
+
+// Return whether n is even
+CZ_KERNEL_FUNC bool kernel_iseven32(CZ_KERNEL_IN(CzKernel32, n))
+{
+	return (CZ_KERNEL_LIMB(n, 0) & 1U) == 0U;
+}
+
+CZ_KERNEL_FUNC bool kernel_iseven64(CZ_KERNEL_IN(CzKernel64, n))
+{
+	return (CZ_KERNEL_LIMB(n, 0) & 1U) == 0U;
+}
+
+
+// Return whether n is 1
+CZ_KERNEL_FUNC bool kernel_isone32(CZ_KERNEL_IN(CzKernel32, n))
+{
+	return CZ_KERNEL_LIMB(n, 0) == 1U && CZ_KERNEL_LIMB(n, 1) == 0U && CZ_KERNEL_LIMB(n, 2) == 0U &&
+		CZ_KERNEL_LIMB(n, 3) == 0U;
+}
+
+CZ_KERNEL_FUNC bool kernel_isone64(CZ_KERNEL_IN(CzKernel64, n))
+{
+	return CZ_KERNEL_LIMB(n, 0) == 1U && CZ_KERNEL_LIMB(n, 1) == 0U;
+}
+
+
+// 3n + 1, computed as n + (2n + 1)
+CZ_KERNEL_FUNC CzU32 kernel_up_le32(CZ_KERNEL_INOUT(CzKernel32, n))
+{
+	CzU32 shifted = 1;
+	CzU32 carry = 0;
+
+	CZ_KERNEL_UNROLL
+	for (CzU32 i = 0; i < 4; i++) {
+		CzU32 limb = CZ_KERNEL_LIMB(n, i);
+		CzU32 addend = (limb << 1) | shifted;
+		shifted = limb >> 31;
+
+		CzU32 sum = limb + addend;
+		CzU32 overflow = CZ_KERNEL_U32(sum < addend);
+		sum += carry;
+		carry = overflow | CZ_KERNEL_U32(sum < carry);
+
+		CZ_KERNEL_LIMB(n, i) = sum;
+	}
+
+	return 1;
+}
+
+CZ_KERNEL_FUNC CzU32 kernel_up_be32(CZ_KERNEL_INOUT(CzKernel32, n))
+{
+	CzU32 shifted = 1;
+	CzU32 carry = 0;
+
+	CZ_KERNEL_UNROLL
+	for (CzU32 j = 0; j < 4; j++) {
+		CzU32 i = 3 - j;
+		CzU32 limb = CZ_KERNEL_LIMB(n, i);
+		CzU32 addend = (limb << 1) | shifted;
+		shifted = limb >> 31;
+
+		CzU32 sum = limb + addend;
+		CzU32 overflow = CZ_KERNEL_U32(sum < addend);
+		sum += carry;
+		carry = overflow | CZ_KERNEL_U32(sum < carry);
+
+		CZ_KERNEL_LIMB(n, i) = sum;
+	}
+
+	return 1;
+}
+
+CZ_KERNEL_FUNC CzU32 kernel_up_le64(CZ_KERNEL_INOUT(CzKernel64, n))
+{
+	CzU64 shifted = 1;
+	CzU64 carry = 0;
+
+	CZ_KERNEL_UNROLL
+	for (CzU32 i = 0; i < 2; i++) {
+		CzU64 limb = CZ_KERNEL_LIMB(n, i);
+		CzU64 addend = (limb << 1) | shifted;
+		shifted = limb >> 63;
+
+		CzU64 sum = limb + addend;
+		CzU64 overflow = CZ_KERNEL_U64(sum < addend);
+		sum += carry;
+		carry = overflow | CZ_KERNEL_U64(sum < carry);
+
+		CZ_KERNEL_LIMB(n, i) = sum;
+	}
+
+	return 1;
+}
+
+CZ_KERNEL_FUNC CzU32 kernel_up_be64(CZ_KERNEL_INOUT(CzKernel64, n))
+{
+	CzU64 shifted = 1;
+	CzU64 carry = 0;
+
+	CZ_KERNEL_UNROLL
+	for (CzU32 j = 0; j < 2; j++) {
+		CzU32 i = 1 - j;
+		CzU64 limb = CZ_KERNEL_LIMB(n, i);
+		CzU64 addend = (limb << 1) | shifted;
+		shifted = limb >> 63;
+
+		CzU64 sum = limb + addend;
+		CzU64 overflow = CZ_KERNEL_U64(sum < addend);
+		sum += carry;
+		carry = overflow | CZ_KERNEL_U64(sum < carry);
+
+		CZ_KERNEL_LIMB(n, i) = sum;
+	}
+
+	return 1;
+}
+
+
+// n/2 for each factor of 2 (up to 31 factors of 2)
+CZ_KERNEL_FUNC CzU32 kernel_down_le32(CZ_KERNEL_INOUT(CzKernel32, n))
+{
+	CzU32 factors = CZ_KERNEL_FINDLSB(CZ_KERNEL_LIMB(n, 0)) & 31U;
+
+	CZ_KERNEL_UNROLL
+	for (CzU32 i = 0; i < 3; i++) {
+		CzU32 right = CZ_KERNEL_LIMB(n, i) >> factors;
+		CzU32 left = CZ_KERNEL_LIMB(n, i + 1) << (32 - factors);
+		CZ_KERNEL_LIMB(n, i) = right | left;
+	}
+
+	CZ_KERNEL_LIMB(n, 3) >>= factors;
+	return factors;
+}
+
+CZ_KERNEL_FUNC CzU32 kernel_down_be32(CZ_KERNEL_INOUT(CzKernel32, n))
+{
+	CzU32 factors = CZ_KERNEL_FINDLSB(CZ_KERNEL_LIMB(n, 0)) & 31U;
+
+	CZ_KERNEL_UNROLL
+	for (CzU32 i = 3; i > 0; i--) {
+		CzU32 right = CZ_KERNEL_LIMB(n, i) >> factors;
+		CzU32 left = CZ_KERNEL_LIMB(n, i - 1) << (32 - factors);
+		CZ_KERNEL_LIMB(n, i) = right | left;
+	}
+
+	CZ_KERNEL_LIMB(n, 0) >>= factors;
+	return factors;
+}
+
+CZ_KERNEL_FUNC CzU32 kernel_down_le64(CZ_KERNEL_INOUT(CzKernel64, n))
+{
+	// findLSB (GLSL) => FindILsb (SPIR-V), which is limited to 32-bit width components
+	CzU32 factors = CZ_KERNEL_FINDLSB(CZ_KERNEL_U32(CZ_KERNEL_LIMB(n, 0))) & 31U;
+
+	CzU64 right = CZ_KERNEL_LIMB(n, 0) >> factors;
+	CzU64 left = CZ_KERNEL_LIMB(n, 1) << (64 - factors);
+
+	CZ_KERNEL_LIMB(n, 0) = right | left;
+	CZ_KERNEL_LIMB(n, 1) >>= factors;
+	return factors;
+}
+
+CZ_KERNEL_FUNC CzU32 kernel_down_be64(CZ_KERNEL_INOUT(CzKernel64, n))
+{
+	CzU32 factors = CZ_KERNEL_FINDLSB(CZ_KERNEL_U32(CZ_KERNEL_LIMB(n, 0))) & 31U;
+
+	CzU64 right = CZ_KERNEL_LIMB(n, 1) >> factors;
+	CzU64 left = CZ_KERNEL_LIMB(n, 0) << (64 - factors);
+
+	CZ_KERNEL_LIMB(n, 1) = right | left;
+	CZ_KERNEL_LIMB(n, 0) >>= factors;
+	return factors;
+}
+
+
+// Iterate odd n until reaching 1, returning the total stopping time
+CZ_KERNEL_FUNC CzU32 kernel_iterate_le32(CZ_KERNEL_INOUT(CzKernel32, n))
+{
+	CzU32 count = 0;
+
+	do {
+		count += kernel_up_le32(n);
+
+		do {
+			count += kernel_down_le32(n);
+		}
+		while (kernel_iseven32(n));
+	}
+	while (!kernel_isone32(n));
+
+	return count;
+}
+
+CZ_KERNEL_FUNC CzU32 kernel_iterate_be32(CZ_KERNEL_INOUT(CzKernel32, n))
+{
+	CzU32 count = 0;
+
+	do {
+		count += kernel_up_be32(n);
+
+		do {
+			count += kernel_down_be32(n);
+		}
+		while (kernel_iseven32(n));
+	}
+	while (!kernel_isone32(n));
+
+	return count;
+}
+
+CZ_KERNEL_FUNC CzU32 kernel_iterate_le64(CZ_KERNEL_INOUT(CzKernel64, n))
+{
+	CzU32 count = 0;
+
+	do {
+		count += kernel_up_le64(n);
+
+		do {
+			count += kernel_down_le64(n);
+		}
+		while (kernel_iseven64(n));
+	}
+	while (!kernel_isone64(n));
+
+	return count;
+}
+
+CZ_KERNEL_FUNC CzU32 kernel_iterate_be64(CZ_KERNEL_INOUT(CzKernel64, n))
+{
+	CzU32 count = 0;
+
+	do {
+		count += kernel_up_be64(n);
+
+		do {
+			count += kernel_down_be64(n);
+		}
+		while (kernel_iseven64(n));
+	}
+	while (!kernel_isone64(n));
+
+	return count;
+}
@@ -20,16 +20,32 @@
 struct CzConfig czgConfig = {
 	.allocLogPath = NULL,
 	.capturePath = NULL,
+	.tracePath = NULL,
+	.metricsPath = NULL,
+	.prometheusAddress = NULL,
+	.statsName = NULL,
 	.outputLevel = CZ_OUTPUT_LEVEL_DEFAULT,
 	.colourLevel = CZ_COLOUR_LEVEL_TTY,
 	.iterSize = 128,
 	.maxLoops = ULLONG_MAX,
+	.pipelineDepth = 1,
+	.readThreads = 4,
+	.inoutDispatches = 1,
+	.latencyInterval = 0,
 	.maxMemory = .4f,
 	.preferInt16 = false,
 	.preferInt64 = false,
+	.autoVariant = false,
+	.tune = false,
 	.extensionLayers = false,
 	.profileLayers = false,
 	.validationLayers = false,
 	.restart = false,
-	.queryBenchmarks = true
+	.queryBenchmarks = true,
+	.continuous = false,
+	.jit = false,
+	.rampUp = false,
+	.hugePages = false,
+	.instrument = false,
+	.pipelineStats = false
 };
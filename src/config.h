@@ -23,16 +23,26 @@ struct CzConfig
 {
 	const char* allocLogPath;
 	const char* capturePath;
+	const char* tracePath;
+	const char* metricsPath;
+	const char* prometheusAddress;
+	const char* statsName;
 
 	enum CzOutputLevel outputLevel;
 	enum CzColourLevel colourLevel;
 
 	unsigned long iterSize;
 	unsigned long long maxLoops;
+	unsigned long pipelineDepth;
+	unsigned long readThreads;
+	unsigned long inoutDispatches;
+	unsigned long latencyInterval;
 	float maxMemory;
 
 	bool preferInt16;
 	bool preferInt64;
+	bool autoVariant;
+	bool tune;
 
 	bool extensionLayers;
 	bool profileLayers;
@@ -40,6 +50,12 @@ struct CzConfig
 
 	bool restart;
 	bool queryBenchmarks;
+	bool continuous;
+	bool jit;
+	bool rampUp;
+	bool hugePages;
+	bool instrument;
+	bool pipelineStats;
 };
 
 extern struct CzConfig czgConfig;
@@ -0,0 +1,65 @@
+/* 
+ * Copyright (C) 2025 Seth McDonald
+ * 
+ * This file is part of Collatz Conjecture Simulator.
+ * 
+ * Collatz Conjecture Simulator is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ * 
+ * Collatz Conjecture Simulator is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE. See the GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License along with Collatz Conjecture
+ * Simulator. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "cpu.h"
+#include "kernel.h"
+
+
+CzU32 cpu_stop_time(CzU128 startValue)
+{
+	CZ_ASSUME(startValue % 2 == 1);
+
+	CzKernel64 n;
+	memcpy(&n, &startValue, sizeof(n));
+
+	enum CzEndianness endianness = get_endianness();
+	CzU32 stopTime;
+
+	if (endianness == CZ_ENDIANNESS_LITTLE) {
+		stopTime = kernel_iterate_le64(&n);
+	}
+	else {
+		stopTime = kernel_iterate_be64(&n);
+	}
+
+	return stopTime;
+}
+
+bool cpu_check_outbuffer(
+	const CzU16* restrict mappedOutBuffer, CzU128 firstStartValue, CzU64 valuesPerInout, CzU32 sampleCount)
+{
+	CZ_ASSUME(firstStartValue % 4 == 3);
+
+	CzU32 checkCount = (CzU32) (sampleCount < valuesPerInout ? sampleCount : valuesPerInout);
+	CzU128 startValue = firstStartValue;
+
+	for (CzU32 i = 0; i < checkCount; i++) {
+		CzU16 stopTime = (CzU16) cpu_stop_time(startValue);
+
+		if CZ_NOEXPECT (mappedOutBuffer[i] != stopTime) {
+			log_warning(
+				stdout, "Stopping time mismatch for 0x%016" PRIx64 "%016" PRIx64 " (GPU %" PRIu16 ", CPU %" PRIu16 ")",
+				CZ_U128_UPPER(startValue), CZ_U128_LOWER(startValue), mappedOutBuffer[i], stopTime);
+
+			return false;
+		}
+
+		startValue += 4;
+	}
+
+	return true;
+}
@@ -0,0 +1,31 @@
+/* 
+ * Copyright (C) 2025 Seth McDonald
+ * 
+ * This file is part of Collatz Conjecture Simulator.
+ * 
+ * Collatz Conjecture Simulator is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ * 
+ * Collatz Conjecture Simulator is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE. See the GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License along with Collatz Conjecture
+ * Simulator. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "common.h"
+
+// The host-side counterparts of the shader's 128-bit Collatz kernel, built from the same source (shader/kernel.h)
+
+// Return the total stopping time of an odd starting value, as computed by the 128-bit shader
+CzU32 cpu_stop_time(CzU128 startValue);
+
+// Compare the first sampleCount total stopping times of an out-buffer against those computed on the host
+// Returns true if all sampled stopping times agree
+CZ_NONNULL_ARGS()
+bool cpu_check_outbuffer(
+	const CzU16* mappedOutBuffer, CzU128 firstStartValue, CzU64 valuesPerInout, CzU32 sampleCount);
@@ -0,0 +1,416 @@
+/* 
+ * Copyright (C) 2025 Seth McDonald
+ * 
+ * This file is part of Collatz Conjecture Simulator.
+ * 
+ * Collatz Conjecture Simulator is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ * 
+ * Collatz Conjecture Simulator is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE. See the GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License along with Collatz Conjecture
+ * Simulator. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "exporter.h"
+
+// Values of the latest snapshot, either totals over every main loop iteration or of the latest iteration alone
+enum ExporterValue
+{
+	EXPORTER_VALUE_LOOPS,
+	EXPORTER_VALUE_VALUES,
+	EXPORTER_VALUE_STEPS,
+	EXPORTER_VALUE_RECORDS,
+	EXPORTER_VALUE_READ,
+	EXPORTER_VALUE_WRITE,
+	EXPORTER_VALUE_COMPUTE,
+	EXPORTER_VALUE_TRANSFER,
+	EXPORTER_VALUE_IDLE_COMPUTE,
+	EXPORTER_VALUE_IDLE_TRANSFER,
+	EXPORTER_VALUE_VALUES_PER_SECOND,
+	EXPORTER_VALUE_STEPS_PER_SECOND,
+	EXPORTER_VALUE_MAIN_LOOP,
+	EXPORTER_VALUE_IDLE_COMPUTE_RATIO,
+	EXPORTER_VALUE_IDLE_TRANSFER_RATIO,
+	EXPORTER_VALUE_BEST_STOP_TIME,
+	EXPORTER_VALUE_CURRENT_VALUE,
+	EXPORTER_VALUE_INOUTS,
+	EXPORTER_VALUE_STAGES,
+	EXPORTER_VALUE_VALUES_PER_INOUT,
+	EXPORTER_VALUE_COUNT,
+};
+
+// Sample of a metric family, in the order of enum ExporterValue
+struct ExporterSample
+{
+	const char* name;
+	const char* type;
+	const char* help;
+	const char* labels; // Or NULL if none.
+};
+
+static const struct ExporterSample gSamples[EXPORTER_VALUE_COUNT] = {
+	{"cltz_loops_total", "counter", "Main loop iterations completed.", NULL},
+	{"cltz_values_total", "counter", "Starting values tested.", NULL},
+	{"cltz_steps_total", "counter", "Collatz steps taken by the device.", NULL},
+	{"cltz_records", "gauge", "Starting values found with a longer total stopping time than all before them.", NULL},
+	{"cltz_host_seconds_total", "counter", "Time spent by the host on inout-buffers.", "task=\"read\""},
+	{"cltz_host_seconds_total", "counter", "Time spent by the host on inout-buffers.", "task=\"write\""},
+	{"cltz_device_seconds_total", "counter", "Time spent executing on the device.", "queue=\"compute\""},
+	{"cltz_device_seconds_total", "counter", "Time spent executing on the device.", "queue=\"transfer\""},
+	{"cltz_idle_seconds_total", "counter", "Time spent waiting on the device.", "queue=\"compute\""},
+	{"cltz_idle_seconds_total", "counter", "Time spent waiting on the device.", "queue=\"transfer\""},
+	{"cltz_values_per_second", "gauge", "Speed of the latest main loop iteration.", NULL},
+	{"cltz_steps_per_second", "gauge", "Collatz steps per second of the latest main loop iteration.", NULL},
+	{"cltz_main_loop_seconds", "gauge", "Duration of the latest main loop iteration.", NULL},
+	{"cltz_idle_ratio", "gauge", "Fraction of the latest main loop iteration waiting.", "queue=\"compute\""},
+	{"cltz_idle_ratio", "gauge", "Fraction of the latest main loop iteration waiting.", "queue=\"transfer\""},
+	{"cltz_best_stop_time", "gauge", "Longest total stopping time found.", NULL},
+	{"cltz_current_value", "gauge", "First starting value yet to be tested, approximately.", NULL},
+	{"cltz_inout_buffers", "gauge", "Inout-buffers in the memory layout.", NULL},
+	{"cltz_staging_regions", "gauge", "Host visible staging regions per inout-buffer.", NULL},
+	{"cltz_values_per_inout", "gauge", "Starting values per inout-buffer.", NULL},
+};
+
+/*
+ * The snapshot is guarded by a sequence lock. The main thread makes gSequence odd while it stores a snapshot, and the
+ * listener thread retries any read which overlapped a store. So publishing never waits on a scrape.
+ */
+static atomic_uint_fast32_t gSequence;
+static _Atomic double gValues[EXPORTER_VALUE_COUNT];
+
+static bool gListening = false;
+
+#if CZ_UNIX
+static pthread_t gListenThread;
+static int gListenSocket = -1;
+static const char* gSocketPath = NULL; // Unix domain socket path, or NULL if listening on a TCP port
+#endif
+
+void exporter_publish(const struct LoopMetrics* metrics)
+{
+	if (!gListening) {
+		return;
+	}
+
+	double values[EXPORTER_VALUE_COUNT];
+
+	for (CzU32 i = 0; i < EXPORTER_VALUE_COUNT; i++) {
+		values[i] = atomic_load_explicit(&gValues[i], memory_order_relaxed);
+	}
+
+	double mainLoop = metrics->mainLoop / 1000;
+
+	values[EXPORTER_VALUE_LOOPS] += 1;
+	values[EXPORTER_VALUE_VALUES] += (double) metrics->valueCount;
+	values[EXPORTER_VALUE_STEPS] += (double) metrics->stepCount;
+	values[EXPORTER_VALUE_RECORDS] = (double) metrics->recordCount;
+	values[EXPORTER_VALUE_READ] += metrics->read / 1000;
+	values[EXPORTER_VALUE_WRITE] += metrics->write / 1000;
+	values[EXPORTER_VALUE_COMPUTE] += metrics->compute / 1000;
+	values[EXPORTER_VALUE_TRANSFER] += metrics->transfer / 1000;
+	values[EXPORTER_VALUE_IDLE_COMPUTE] += metrics->idleCompute / 1000;
+	values[EXPORTER_VALUE_IDLE_TRANSFER] += metrics->idleTransfer / 1000;
+	values[EXPORTER_VALUE_VALUES_PER_SECOND] = metrics->valuesPerSecond;
+	values[EXPORTER_VALUE_STEPS_PER_SECOND] = metrics->stepsPerSecond;
+	values[EXPORTER_VALUE_MAIN_LOOP] = mainLoop;
+	values[EXPORTER_VALUE_IDLE_COMPUTE_RATIO] = metrics->idleCompute / 1000 / mainLoop;
+	values[EXPORTER_VALUE_IDLE_TRANSFER_RATIO] = metrics->idleTransfer / 1000 / mainLoop;
+	values[EXPORTER_VALUE_BEST_STOP_TIME] = (double) metrics->bestStopTime;
+	values[EXPORTER_VALUE_CURRENT_VALUE] = (double) metrics->currentValue;
+	values[EXPORTER_VALUE_INOUTS] = (double) metrics->inoutsPerHeap;
+	values[EXPORTER_VALUE_STAGES] = (double) metrics->stagesPerInout;
+	values[EXPORTER_VALUE_VALUES_PER_INOUT] = (double) metrics->valuesPerInout;
+
+	CzU32 sequence = (CzU32) atomic_load_explicit(&gSequence, memory_order_relaxed);
+	atomic_store_explicit(&gSequence, sequence + 1, memory_order_relaxed);
+	atomic_thread_fence(memory_order_release);
+
+	for (CzU32 i = 0; i < EXPORTER_VALUE_COUNT; i++) {
+		atomic_store_explicit(&gValues[i], values[i], memory_order_relaxed);
+	}
+
+	atomic_store_explicit(&gSequence, sequence + 2, memory_order_release);
+}
+
+#if CZ_UNIX
+// Copy the latest snapshot, retrying while it is being stored
+static void read_snapshot(double* restrict values)
+{
+	while (true) {
+		CzU32 sequence = (CzU32) atomic_load_explicit(&gSequence, memory_order_acquire);
+
+		if (sequence & 1) {
+			continue;
+		}
+
+		for (CzU32 i = 0; i < EXPORTER_VALUE_COUNT; i++) {
+			values[i] = atomic_load_explicit(&gValues[i], memory_order_relaxed);
+		}
+
+		atomic_thread_fence(memory_order_acquire);
+
+		if (atomic_load_explicit(&gSequence, memory_order_relaxed) == sequence) {
+			return;
+		}
+	}
+}
+
+// Write the snapshot to buffer in the Prometheus text exposition format, returning the length written
+static size_t format_snapshot(char* restrict buffer, size_t size, const double* restrict values)
+{
+	size_t length = 0;
+
+	for (CzU32 i = 0; i < EXPORTER_VALUE_COUNT && length < size; i++) {
+		const struct ExporterSample* sample = &gSamples[i];
+		int ires;
+
+		// Samples of the same family are adjacent, and the family is only described before the first
+		if (!i || strcmp(sample->name, gSamples[i - 1].name)) {
+			ires = snprintf(
+				buffer + length, size - length, "# HELP %s %s\n# TYPE %s %s\n",
+				sample->name, sample->help, sample->name, sample->type);
+
+			if CZ_NOEXPECT (ires < 0) { return 0; }
+			length += (size_t) ires;
+
+			if CZ_NOEXPECT (length >= size) { return 0; }
+		}
+
+		if (sample->labels) {
+			ires = snprintf(buffer + length, size - length, "%s{%s} %.17g\n", sample->name, sample->labels, values[i]);
+		}
+		else {
+			ires = snprintf(buffer + length, size - length, "%s %.17g\n", sample->name, values[i]);
+		}
+
+		if CZ_NOEXPECT (ires < 0) { return 0; }
+		length += (size_t) ires;
+	}
+
+	if CZ_NOEXPECT (length >= size) { return 0; }
+
+	return length;
+}
+
+// Send all size bytes of data to the client, returning whether successful
+static bool send_all(int client, const char* restrict data, size_t size)
+{
+#if defined(MSG_NOSIGNAL)
+	int flags = MSG_NOSIGNAL; // A client disconnecting early is not worth a SIGPIPE
+#else
+	int flags = 0;
+#endif
+
+	while (size) {
+		ssize_t sent = send(client, data, size, flags);
+		if CZ_NOEXPECT (sent < 0 && errno == EINTR) { continue; }
+		if CZ_NOEXPECT (sent <= 0) { return false; }
+
+		data += sent;
+		size -= (size_t) sent;
+	}
+
+	return true;
+}
+
+// Answer a single HTTP request with the latest snapshot
+static void serve_scrape(int client)
+{
+	// A stalled client must not keep the listener thread from further scrapes
+	struct timeval timeout = {1, 0};
+	setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+	char request[1024];
+	ssize_t received = recv(client, request, sizeof(request) - 1, 0);
+	if CZ_NOEXPECT (received <= 0) { return; }
+
+	request[received] = '\0';
+
+	if CZ_NOEXPECT (strncmp(request, "GET ", 4)) {
+		const char* response =
+			"HTTP/1.1 405 Method Not Allowed\r\n"
+			"Allow: GET\r\n"
+			"Content-Length: 0\r\n"
+			"Connection: close\r\n"
+			"\r\n";
+
+		send_all(client, response, strlen(response));
+		return;
+	}
+
+	double values[EXPORTER_VALUE_COUNT];
+	read_snapshot(values);
+
+	char body[4096];
+	size_t bodySize = format_snapshot(body, sizeof(body), values);
+
+	char header[256];
+	int ires = snprintf(
+		header, sizeof(header),
+		"HTTP/1.1 200 OK\r\n"
+		"Content-Type: text/plain; version=0.0.4; charset=utf-8\r\n"
+		"Content-Length: %zu\r\n"
+		"Connection: close\r\n"
+		"\r\n",
+		bodySize);
+
+	if CZ_NOEXPECT (ires < 0 || (size_t) ires >= sizeof(header)) { return; }
+
+	bool bres = send_all(client, header, (size_t) ires);
+	if CZ_NOEXPECT (!bres) { return; }
+
+	send_all(client, body, bodySize);
+}
+
+// Accept and answer scrapes one at a time, until cancelled by exporter_fini
+static void* serve_scrapes(void* ptr)
+{
+	(void) ptr;
+
+	while (true) {
+		int client = accept(gListenSocket, NULL, NULL); // Cancellation point
+		if CZ_NOEXPECT (client < 0 && (errno == EINTR || errno == ECONNABORTED)) { continue; }
+		if CZ_NOEXPECT (client < 0) { break; }
+
+		// Not cancelled mid-scrape, so the client socket is always closed
+		int cancelState;
+		pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, &cancelState);
+
+		serve_scrape(client);
+		close(client);
+
+		pthread_setcancelstate(cancelState, NULL);
+	}
+
+	return NULL;
+}
+
+// Create a socket listening on the localhost TCP port given by address
+static int listen_port(const char* restrict address)
+{
+	char* end;
+	unsigned long port = strtoul(address, &end, 10);
+
+	if CZ_NOEXPECT (*end || !port || port > UINT16_MAX) {
+		log_error(stderr, "Invalid port '%s' to listen on", address);
+		return -1;
+	}
+
+	int listenSocket = socket(AF_INET, SOCK_STREAM, 0);
+	if CZ_NOEXPECT (listenSocket < 0) { return -1; }
+
+	// Allow an immediate restart to listen on the same port
+	int reuse = 1;
+	setsockopt(listenSocket, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+	// Only scrapes from the same machine are served
+	struct sockaddr_in socketAddress = {0};
+	socketAddress.sin_family = AF_INET;
+	socketAddress.sin_port = htons((uint16_t) port);
+	socketAddress.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+	int ires = bind(listenSocket, (struct sockaddr*) &socketAddress, sizeof(socketAddress));
+	if CZ_NOEXPECT (ires) { close(listenSocket); return -1; }
+
+	return listenSocket;
+}
+
+// Create a socket listening on the Unix domain socket path given by address
+static int listen_path(const char* restrict address)
+{
+	struct sockaddr_un socketAddress = {0};
+	socketAddress.sun_family = AF_UNIX;
+
+	size_t length = strlen(address);
+
+	if CZ_NOEXPECT (length >= sizeof(socketAddress.sun_path)) {
+		log_error(stderr, "Socket path '%s' is too long to listen on", address);
+		return -1;
+	}
+
+	memcpy(socketAddress.sun_path, address, length + 1);
+
+	// Remove a socket left behind by an earlier run, but nothing else
+	struct stat fileInfo;
+	int ires = stat(address, &fileInfo);
+
+	if (!ires && S_ISSOCK(fileInfo.st_mode)) {
+		unlink(address);
+	}
+
+	int listenSocket = socket(AF_UNIX, SOCK_STREAM, 0);
+	if CZ_NOEXPECT (listenSocket < 0) { return -1; }
+
+	ires = bind(listenSocket, (struct sockaddr*) &socketAddress, sizeof(socketAddress));
+	if CZ_NOEXPECT (ires) { close(listenSocket); return -1; }
+
+	gSocketPath = address;
+	return listenSocket;
+}
+#endif
+
+bool exporter_init(const char* address)
+{
+#if CZ_UNIX
+	// An address of only digits is a port, and anything else is a socket path
+	bool isPort = *address && strspn(address, "0123456789") == strlen(address);
+
+	int listenSocket = isPort ? listen_port(address) : listen_path(address);
+	if CZ_NOEXPECT (listenSocket < 0) { log_error(stderr, "Failed to listen on '%s'", address); return false; }
+
+	int backlog = 4;
+	int ires = listen(listenSocket, backlog);
+	if CZ_NOEXPECT (ires) { log_error(stderr, "Failed to listen on '%s'", address); goto err_close_socket; }
+
+	gListenSocket = listenSocket;
+
+	ires = pthread_create(&gListenThread, NULL, serve_scrapes, NULL);
+	if CZ_NOEXPECT (ires) { PCREATE_FAILURE(ires); goto err_close_socket; }
+
+	gListening = true;
+	return true;
+
+err_close_socket:
+	close(listenSocket);
+	gListenSocket = -1;
+
+	if (gSocketPath) {
+		unlink(gSocketPath);
+		gSocketPath = NULL;
+	}
+
+	return false;
+#else
+	log_error(stderr, "Cannot listen on '%s', as serving metrics is only supported on Unix-like systems", address);
+	return false;
+#endif
+}
+
+void exporter_fini(void)
+{
+	if (!gListening) {
+		return;
+	}
+
+	gListening = false;
+
+#if CZ_UNIX
+	int ires = pthread_cancel(gListenThread);
+	if CZ_NOEXPECT (ires) { PCANCEL_FAILURE(ires); }
+
+	ires = pthread_join(gListenThread, NULL);
+	if CZ_NOEXPECT (ires) { PJOIN_FAILURE(ires); }
+
+	close(gListenSocket);
+	gListenSocket = -1;
+
+	if (gSocketPath) {
+		unlink(gSocketPath);
+		gSocketPath = NULL;
+	}
+#endif
+}
@@ -0,0 +1,36 @@
+/* 
+ * Copyright (C) 2025 Seth McDonald
+ * 
+ * This file is part of Collatz Conjecture Simulator.
+ * 
+ * Collatz Conjecture Simulator is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ * 
+ * Collatz Conjecture Simulator is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE. See the GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License along with Collatz Conjecture
+ * Simulator. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "common.h"
+
+#include "metrics.h"
+
+// Live statistics of the submission loop, served for --prometheus in the Prometheus text exposition format
+
+// Listen for scrapes on the localhost TCP port or Unix domain socket path given by address, on a new thread
+CZ_NONNULL_ARGS() CZ_NULTERM_ARG(1) CZ_RD_ACCESS(1)
+bool exporter_init(const char* address);
+
+// Stop listening, if listening
+void exporter_fini(void);
+
+// Add a main loop iteration to the statistics served, without blocking on any scrape in progress
+// Must be called from the main thread
+CZ_NONNULL_ARGS() CZ_RD_ACCESS(1)
+void exporter_publish(const struct LoopMetrics* metrics);
@@ -17,6 +17,15 @@
 
 #include "gpu.h"
 #include "config.h"
+#include "cpu.h"
+#include "exporter.h"
+#include "jit.h"
+#include "latency.h"
+#include "metrics.h"
+#include "probe.h"
+#include "spirv.h"
+#include "stats.h"
+#include "trace.h"
 
 bool create_instance(struct Gpu* restrict gpu)
 {
@@ -50,7 +59,7 @@ bool create_instance(struct Gpu* restrict gpu)
 		if CZ_NOEXPECT (!allocator) {dyrecord_destroy(localRecord); return false; }
 		gpu->allocator = allocator;
 
-		allocator->pUserData = &czgCallbackData;
+		allocator->pUserData = NULL;
 		allocator->pfnAllocation = allocation_callback;
 		allocator->pfnReallocation = reallocation_callback;
 		allocator->pfnFree = free_callback;
@@ -82,7 +91,7 @@ bool create_instance(struct Gpu* restrict gpu)
 	debugMessengerInfo.messageSeverity = debugMessageSeverity;
 	debugMessengerInfo.messageType = debugMessageType;
 	debugMessengerInfo.pfnUserCallback = debug_callback;
-	debugMessengerInfo.pUserData = &czgCallbackData;
+	debugMessengerInfo.pUserData = NULL;
 
 	// Get instance layers
 	CzU32 layerCount;
@@ -369,6 +378,8 @@ bool select_device(struct Gpu* restrict gpu)
 	CzU32 bestScore = 0;
 
 	bool using16BitStorage = false;
+	bool usingCalibratedTimestamps = false;
+	bool usingExternalMemoryHost = false;
 	bool usingMaintenance4 = false;
 	bool usingMaintenance5 = false;
 	bool usingMaintenance7 = false;
@@ -376,9 +387,12 @@ bool select_device(struct Gpu* restrict gpu)
 	bool usingMaintenance9 = false;
 	bool usingMemoryBudget = false;
 	bool usingMemoryPriority = false;
+	bool usingPipelineBinary = false;
 	bool usingPipelineCreationCacheControl = false;
 	bool usingPipelineExecutableProperties = false;
+	bool usingPipelineStatistics = false;
 	bool usingPortabilitySubset = false;
+	bool usingShaderClock = false;
 	bool usingShaderInt16 = false;
 	bool usingShaderInt64 = false;
 	bool usingSpirv14 = false;
@@ -387,6 +401,8 @@ bool select_device(struct Gpu* restrict gpu)
 	bool usingVulkan13 = false;
 	bool usingVulkan14 = false;
 
+	VkDeviceSize hostImportAlignment = 0;
+
 	/*
 	 * Examine the properties and features of each physical device, and give each a score.
 	 * A greater score means a better physical device (for our purposes).
@@ -406,6 +422,7 @@ bool select_device(struct Gpu* restrict gpu)
 		// Check features
 		bool hasShaderInt16 = devicesFeatures[i].features.shaderInt16;
 		bool hasShaderInt64 = devicesFeatures[i].features.shaderInt64;
+		bool hasPipelineStatisticsQuery = devicesFeatures[i].features.pipelineStatisticsQuery;
 
 		bool hasStorageBuffer16BitAccess = devices16BitStorageFeatures[i].storageBuffer16BitAccess;
 
@@ -466,6 +483,7 @@ bool select_device(struct Gpu* restrict gpu)
 		}
 
 		// Check extensions
+		bool hasCalibratedTimestamps = false;
 		bool hasCopyCommands2 = false;
 		bool hasMaintenance4 = false;
 		bool hasMaintenance5 = false;
@@ -474,11 +492,14 @@ bool select_device(struct Gpu* restrict gpu)
 		bool hasMaintenance8 = false;
 		bool hasMaintenance9 = false;
 		bool hasMapMemory2 = false;
+		bool hasPipelineBinary = false;
 		bool hasPipelineExecutableProperties = false;
 		bool hasPortabilitySubset = false;
+		bool hasShaderClock = false;
 		bool hasSpirv14 = false;
 		bool hasSynchronization2 = false;
 		bool hasTimelineSemaphore = false;
+		bool hasExternalMemoryHost = false;
 		bool hasMemoryBudget = false;
 		bool hasMemoryPriority = false;
 		bool hasPipelineCreationCacheControl = false;
@@ -487,7 +508,8 @@ bool select_device(struct Gpu* restrict gpu)
 		for (CzU32 j = 0; j < extensionCount; j++) {
 			const char* extensionName = devicesExtensionsProperties[i][j].extensionName;
 
-			if (!strcmp(extensionName, VK_KHR_COPY_COMMANDS_2_EXTENSION_NAME))    { hasCopyCommands2 = true; }
+			if (!strcmp(extensionName, VK_KHR_CALIBRATED_TIMESTAMPS_EXTENSION_NAME)) { hasCalibratedTimestamps = true; }
+			else if (!strcmp(extensionName, VK_KHR_COPY_COMMANDS_2_EXTENSION_NAME)) { hasCopyCommands2 = true; }
 			else if (!strcmp(extensionName, VK_KHR_MAINTENANCE_4_EXTENSION_NAME)) { hasMaintenance4 = true; }
 			else if (!strcmp(extensionName, VK_KHR_MAINTENANCE_5_EXTENSION_NAME)) { hasMaintenance5 = true; }
 			else if (!strcmp(extensionName, VK_KHR_MAINTENANCE_6_EXTENSION_NAME)) { hasMaintenance6 = true; }
@@ -495,12 +517,16 @@ bool select_device(struct Gpu* restrict gpu)
 			else if (!strcmp(extensionName, VK_KHR_MAINTENANCE_8_EXTENSION_NAME)) { hasMaintenance8 = true; }
 			else if (!strcmp(extensionName, VK_KHR_MAINTENANCE_9_EXTENSION_NAME)) { hasMaintenance9 = true; }
 			else if (!strcmp(extensionName, VK_KHR_MAP_MEMORY_2_EXTENSION_NAME))  { hasMapMemory2 = true; }
+			else if (!strcmp(extensionName, VK_KHR_PIPELINE_BINARY_EXTENSION_NAME)) { hasPipelineBinary = true; }
 			else if (!strcmp(extensionName, VK_KHR_PIPELINE_EXECUTABLE_PROPERTIES_EXTENSION_NAME)) {
 				hasPipelineExecutableProperties = true; }
 			else if (!strcmp(extensionName, VK_KHR_PORTABILITY_SUBSET_EXTENSION_NAME)) { hasPortabilitySubset = true; }
+			else if (!strcmp(extensionName, VK_KHR_SHADER_CLOCK_EXTENSION_NAME))       { hasShaderClock = true; }
 			else if (!strcmp(extensionName, VK_KHR_SPIRV_1_4_EXTENSION_NAME))          { hasSpirv14 = true; }
 			else if (!strcmp(extensionName, VK_KHR_SYNCHRONIZATION_2_EXTENSION_NAME))  { hasSynchronization2 = true; }
 			else if (!strcmp(extensionName, VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME)) { hasTimelineSemaphore = true; }
+			else if (!strcmp(extensionName, VK_EXT_EXTERNAL_MEMORY_HOST_EXTENSION_NAME)) {
+				hasExternalMemoryHost = true; }
 			else if (!strcmp(extensionName, VK_EXT_MEMORY_BUDGET_EXTENSION_NAME))      { hasMemoryBudget = true; }
 			else if (!strcmp(extensionName, VK_EXT_MEMORY_PRIORITY_EXTENSION_NAME))    { hasMemoryPriority = true; }
 			else if (!strcmp(extensionName, VK_EXT_PIPELINE_CREATION_CACHE_CONTROL_EXTENSION_NAME)) {
@@ -509,6 +535,89 @@ bool select_device(struct Gpu* restrict gpu)
 				hasSubgroupSizeControl = true; }
 		}
 
+		// Pipeline binaries are only worth saving if the driver doesn't prefer its own internal cache
+		bool hasPipelineBinaries = false;
+		if (hasPipelineBinary && hasMaintenance5) {
+			VkPhysicalDevicePipelineBinaryFeaturesKHR pipelineBinaryFeatures = {0};
+			pipelineBinaryFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PIPELINE_BINARY_FEATURES_KHR;
+
+			VkPhysicalDeviceFeatures2 features = {0};
+			features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+			features.pNext = &pipelineBinaryFeatures;
+
+			VK_CALL(vkGetPhysicalDeviceFeatures2, devices[i], &features);
+
+			VkPhysicalDevicePipelineBinaryPropertiesKHR pipelineBinaryProperties = {0};
+			pipelineBinaryProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PIPELINE_BINARY_PROPERTIES_KHR;
+
+			VkPhysicalDeviceProperties2 properties = {0};
+			properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+			properties.pNext = &pipelineBinaryProperties;
+
+			VK_CALL(vkGetPhysicalDeviceProperties2, devices[i], &properties);
+
+			hasPipelineBinaries = pipelineBinaryFeatures.pipelineBinaries &&
+				!pipelineBinaryProperties.pipelineBinaryPrefersInternalCache;
+		}
+
+		// Subgroup clocks are only read by runtime compilations of the instrumented shader
+		bool hasSubgroupClock = false;
+		if (gpu->instrumenting && czgConfig.jit && hasShaderClock) {
+			VkPhysicalDeviceShaderClockFeaturesKHR shaderClockFeatures = {0};
+			shaderClockFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SHADER_CLOCK_FEATURES_KHR;
+
+			VkPhysicalDeviceFeatures2 features = {0};
+			features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+			features.pNext = &shaderClockFeatures;
+
+			VK_CALL(vkGetPhysicalDeviceFeatures2, devices[i], &features);
+
+			hasSubgroupClock = shaderClockFeatures.shaderSubgroupClock;
+		}
+
+		// Imported host memory must be aligned to at most a huge page, which is how it is allocated
+		bool hasHostImport = false;
+		VkDeviceSize minImportedHostPointerAlignment = 0;
+		if (czgConfig.hugePages && hasExternalMemoryHost) {
+			VkPhysicalDeviceExternalMemoryHostPropertiesEXT externalMemoryHostProperties = {0};
+			externalMemoryHostProperties.sType =
+				VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTERNAL_MEMORY_HOST_PROPERTIES_EXT;
+
+			VkPhysicalDeviceProperties2 properties = {0};
+			properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+			properties.pNext = &externalMemoryHostProperties;
+
+			VK_CALL(vkGetPhysicalDeviceProperties2, devices[i], &properties);
+
+			minImportedHostPointerAlignment = externalMemoryHostProperties.minImportedHostPointerAlignment;
+			hasHostImport = minImportedHostPointerAlignment <= CZ_HUGE_PAGE_SIZE;
+		}
+
+		// Device timestamps are only placed on the trace timeline if they can be calibrated against wall_time
+		bool hasTimestampCalibration = false;
+		if (czgConfig.tracePath && czgConfig.queryBenchmarks && hasCalibratedTimestamps) {
+			CzU32 domainCount;
+			VK_CALLR(vkGetPhysicalDeviceCalibrateableTimeDomainsKHR, devices[i], &domainCount, NULL);
+			if CZ_NOEXPECT (vkres) { dyrecord_destroy(localRecord); return false; }
+
+			allocSize = domainCount * sizeof(VkTimeDomainKHR);
+			VkTimeDomainKHR* timeDomains = dyrecord_malloc(localRecord, allocSize);
+			if CZ_NOEXPECT (!timeDomains) { dyrecord_destroy(localRecord); return false; }
+
+			VK_CALLR(vkGetPhysicalDeviceCalibrateableTimeDomainsKHR, devices[i], &domainCount, timeDomains);
+			if CZ_NOEXPECT (vkres) { dyrecord_destroy(localRecord); return false; }
+
+			bool hasDeviceDomain = false;
+			bool hasHostDomain = false;
+
+			for (CzU32 j = 0; j < domainCount; j++) {
+				if (timeDomains[j] == VK_TIME_DOMAIN_DEVICE_KHR) { hasDeviceDomain = true; }
+				if (timeDomains[j] == CZ_WALL_TIME_DOMAIN)       { hasHostDomain = true; }
+			}
+
+			hasTimestampCalibration = hasDeviceDomain && hasHostDomain;
+		}
+
 		// Score device
 		CzU32 currentScore = 1;
 
@@ -541,6 +650,7 @@ bool select_device(struct Gpu* restrict gpu)
 		if (hasDedicatedCompute)  { currentScore += 100; }
 		if (hasDedicatedTransfer) { currentScore += 100; }
 
+		if (hasHostImport)                   { currentScore += 10; }
 		if (hasMaintenance4)                 { currentScore += 10; }
 		if (hasMaintenance5)                 { currentScore += 10; }
 		if (hasMaintenance7)                 { currentScore += 10; }
@@ -548,18 +658,26 @@ bool select_device(struct Gpu* restrict gpu)
 		if (hasMaintenance9)                 { currentScore += 10; }
 		if (hasMemoryBudget)                 { currentScore += 10; }
 		if (hasMemoryPriority)               { currentScore += 10; }
+		if (hasPipelineBinaries)             { currentScore += 10; }
 		if (hasPipelineCreationCacheControl) { currentScore += 10; }
 		if (hasSpirv14)                      { currentScore += 10; }
 		if (hasStorageBuffer16BitAccess)     { currentScore += 100; }
 		if (hasSubgroupSizeControl)          { currentScore += 10; }
 
 		if (czgConfig.capturePath && hasPipelineExecutableProperties) { currentScore += 10; }
+		if (hasTimestampCalibration)                                  { currentScore += 10; }
+		if (hasSubgroupClock)                                         { currentScore += 10; }
+
+		bool wantsPipelineStatistics = czgConfig.pipelineStats && !czgConfig.continuous;
+		if (wantsPipelineStatistics && hasPipelineStatisticsQuery) { currentScore += 10; }
 
 		if (currentScore > bestScore) {
 			bestScore = currentScore;
 			deviceIndex = i;
 
 			using16BitStorage = hasStorageBuffer16BitAccess;
+			usingCalibratedTimestamps = hasTimestampCalibration;
+			usingExternalMemoryHost = hasHostImport;
 			usingMaintenance4 = hasMaintenance4;
 			usingMaintenance5 = hasMaintenance5;
 			usingMaintenance7 = hasMaintenance7;
@@ -567,16 +685,21 @@ bool select_device(struct Gpu* restrict gpu)
 			usingMaintenance9 = hasMaintenance9;
 			usingMemoryBudget = hasMemoryBudget;
 			usingMemoryPriority = hasMemoryPriority;
+			usingPipelineBinary = hasPipelineBinaries;
 			usingPipelineCreationCacheControl = hasPipelineCreationCacheControl;
 			usingPipelineExecutableProperties = czgConfig.capturePath && hasPipelineExecutableProperties;
+			usingPipelineStatistics = wantsPipelineStatistics && hasPipelineStatisticsQuery;
 			usingPortabilitySubset = hasPortabilitySubset;
-			usingShaderInt16 = czgConfig.preferInt16 && hasShaderInt16;
-			usingShaderInt64 = czgConfig.preferInt64 && hasShaderInt64;
+			usingShaderClock = hasSubgroupClock;
+			usingShaderInt16 = (czgConfig.preferInt16 || czgConfig.autoVariant) && hasShaderInt16;
+			usingShaderInt64 = (czgConfig.preferInt64 || czgConfig.autoVariant) && hasShaderInt64;
 			usingSpirv14 = hasSpirv14;
 			usingSubgroupSizeControl = hasSubgroupSizeControl;
 			usingVulkan12 = hasVulkan12;
 			usingVulkan13 = hasVulkan13;
 			usingVulkan14 = hasVulkan14;
+
+			hostImportAlignment = minImportedHostPointerAlignment;
 		}
 	}
 
@@ -689,6 +812,8 @@ bool select_device(struct Gpu* restrict gpu)
 	gpu->spvVerMinor = spvVerMinor;
 
 	gpu->using16BitStorage = using16BitStorage;
+	gpu->usingCalibratedTimestamps = usingCalibratedTimestamps;
+	gpu->usingExternalMemoryHost = usingExternalMemoryHost;
 	gpu->usingMaintenance4 = usingMaintenance4;
 	gpu->usingMaintenance5 = usingMaintenance5;
 	gpu->usingMaintenance7 = usingMaintenance7;
@@ -696,13 +821,18 @@ bool select_device(struct Gpu* restrict gpu)
 	gpu->usingMaintenance9 = usingMaintenance9;
 	gpu->usingMemoryBudget = usingMemoryBudget;
 	gpu->usingMemoryPriority = usingMemoryPriority;
+	gpu->usingPipelineBinary = usingPipelineBinary;
 	gpu->usingPipelineCreationCacheControl = usingPipelineCreationCacheControl;
 	gpu->usingPipelineExecutableProperties = usingPipelineExecutableProperties;
+	gpu->usingPipelineStatistics = usingPipelineStatistics;
 	gpu->usingPortabilitySubset = usingPortabilitySubset;
+	gpu->usingShaderClock = usingShaderClock;
 	gpu->usingShaderInt16 = usingShaderInt16;
 	gpu->usingShaderInt64 = usingShaderInt64;
 	gpu->usingSubgroupSizeControl = usingSubgroupSizeControl;
 
+	gpu->hostImportAlignment = hostImportAlignment;
+
 	if (czgConfig.queryBenchmarks) {
 		gpu->computeFamilyTimestampValidBits =
 			devicesFamiliesProperties[deviceIndex][computeFamilyIndex].queueFamilyProperties.timestampValidBits;
@@ -747,24 +877,31 @@ bool select_device(struct Gpu* restrict gpu)
 			"\tTransfer queue family index:       %" PRIu32 "\n"
 			"\tCompute queue index:               %" PRIu32 "\n"
 			"\tTransfer queue index:              %" PRIu32 "\n"
+			"\tcalibratedTimestamps:              %d\n"
+			"\texternalMemoryHost:                %d\n"
 			"\tmaintenance4                       %d\n"
 			"\tmaintenance5                       %d\n"
 			"\tmaintenance7                       %d\n"
 			"\tmaintenance8                       %d\n"
 			"\tmaintenance9                       %d\n"
 			"\tmemoryPriority:                    %d\n"
+			"\tpipelineBinaries:                  %d\n"
 			"\tpipelineCreationCacheControl:      %d\n"
 			"\tpipelineExecutableProperties:      %d\n"
+			"\tpipelineStatisticsQuery:           %d\n"
+			"\tshaderSubgroupClock:               %d\n"
 			"\tshaderInt16:                       %d\n"
 			"\tshaderInt64:                       %d\n"
 			"\tstorageBuffer16BitAccess:          %d\n"
 			"\tsubgroupSizeControl:               %d\n\n",
 			deviceName, bestScore,
 			vkVerMajor, vkVerMinor, spvVerMajor, spvVerMinor,
-			computeFamilyIndex, transferFamilyIndex, computeQueueIndex, transferQueueIndex,
+			computeFamilyIndex, transferFamilyIndex, computeQueueIndex, transferQueueIndex, usingCalibratedTimestamps,
+			usingExternalMemoryHost,
 			usingMaintenance4, usingMaintenance5, usingMaintenance7, usingMaintenance8, usingMaintenance9,
-			usingMemoryPriority, usingPipelineCreationCacheControl, usingPipelineExecutableProperties,
-			usingShaderInt16, usingShaderInt64, using16BitStorage, usingSubgroupSizeControl);
+			usingMemoryPriority, usingPipelineBinary, usingPipelineCreationCacheControl,
+			usingPipelineExecutableProperties, usingPipelineStatistics, usingShaderClock, usingShaderInt16,
+			usingShaderInt64, using16BitStorage, usingSubgroupSizeControl);
 
 		break;
 
@@ -795,7 +932,7 @@ bool create_device(struct Gpu* restrict gpu)
 	if CZ_NOEXPECT (!localRecord) { return false; }
 
 	size_t elmSize = sizeof(const char*);
-	size_t elmCount = 21;
+	size_t elmCount = 24;
 
 	DyArray enabledExtensions = dyarray_create(elmSize, elmCount);
 	if CZ_NOEXPECT (!enabledExtensions) { dyrecord_destroy(localRecord); return false; }
@@ -820,6 +957,10 @@ bool create_device(struct Gpu* restrict gpu)
 	dyarray_append(enabledExtensions, &extensionName);
 
 	// Optional KHR extensions
+	if (gpu->usingCalibratedTimestamps) {
+		extensionName = VK_KHR_CALIBRATED_TIMESTAMPS_EXTENSION_NAME;
+		dyarray_append(enabledExtensions, &extensionName);
+	}
 	if (gpu->usingMaintenance4) {
 		extensionName = VK_KHR_MAINTENANCE_4_EXTENSION_NAME;
 		dyarray_append(enabledExtensions, &extensionName);
@@ -849,6 +990,10 @@ bool create_device(struct Gpu* restrict gpu)
 		extensionName = VK_KHR_MAINTENANCE_9_EXTENSION_NAME;
 		dyarray_append(enabledExtensions, &extensionName);
 	}
+	if (gpu->usingPipelineBinary) {
+		extensionName = VK_KHR_PIPELINE_BINARY_EXTENSION_NAME;
+		dyarray_append(enabledExtensions, &extensionName);
+	}
 	if (gpu->usingPipelineExecutableProperties) {
 		extensionName = VK_KHR_PIPELINE_EXECUTABLE_PROPERTIES_EXTENSION_NAME;
 		dyarray_append(enabledExtensions, &extensionName);
@@ -857,6 +1002,10 @@ bool create_device(struct Gpu* restrict gpu)
 		extensionName = VK_KHR_PORTABILITY_SUBSET_EXTENSION_NAME;
 		dyarray_append(enabledExtensions, &extensionName);
 	}
+	if (gpu->usingShaderClock) {
+		extensionName = VK_KHR_SHADER_CLOCK_EXTENSION_NAME;
+		dyarray_append(enabledExtensions, &extensionName);
+	}
 	if (spvVerMinor >= 4) {
 		extensionName = VK_KHR_SHADER_FLOAT_CONTROLS_EXTENSION_NAME;
 		dyarray_append(enabledExtensions, &extensionName);
@@ -865,6 +1014,10 @@ bool create_device(struct Gpu* restrict gpu)
 		dyarray_append(enabledExtensions, &extensionName);
 	}
 	// Optional EXT extensions
+	if (gpu->usingExternalMemoryHost) {
+		extensionName = VK_EXT_EXTERNAL_MEMORY_HOST_EXTENSION_NAME;
+		dyarray_append(enabledExtensions, &extensionName);
+	}
 	if (gpu->usingMemoryBudget) {
 		extensionName = VK_EXT_MEMORY_BUDGET_EXTENSION_NAME;
 		dyarray_append(enabledExtensions, &extensionName);
@@ -886,6 +1039,7 @@ bool create_device(struct Gpu* restrict gpu)
 	deviceFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
 	deviceFeatures.features.shaderInt64 = gpu->usingShaderInt64;
 	deviceFeatures.features.shaderInt16 = gpu->usingShaderInt16;
+	deviceFeatures.features.pipelineStatisticsQuery = gpu->usingPipelineStatistics;
 
 	VkPhysicalDevice16BitStorageFeatures device16BitStorageFeatures = {0};
 	device16BitStorageFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_16BIT_STORAGE_FEATURES;
@@ -923,6 +1077,10 @@ bool create_device(struct Gpu* restrict gpu)
 	deviceMemoryPriorityFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PRIORITY_FEATURES_EXT;
 	deviceMemoryPriorityFeatures.memoryPriority = VK_TRUE;
 
+	VkPhysicalDevicePipelineBinaryFeaturesKHR devicePipelineBinaryFeatures = {0};
+	devicePipelineBinaryFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PIPELINE_BINARY_FEATURES_KHR;
+	devicePipelineBinaryFeatures.pipelineBinaries = VK_TRUE;
+
 	VkPhysicalDevicePipelineCreationCacheControlFeatures devicePipelineCreationCacheControlFeatures = {0};
 	devicePipelineCreationCacheControlFeatures.sType =
 		VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PIPELINE_CREATION_CACHE_CONTROL_FEATURES;
@@ -933,6 +1091,10 @@ bool create_device(struct Gpu* restrict gpu)
 		VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PIPELINE_EXECUTABLE_PROPERTIES_FEATURES_KHR;
 	devicePipelineExecutablePropertiesFeatures.pipelineExecutableInfo = VK_TRUE;
 
+	VkPhysicalDeviceShaderClockFeaturesKHR deviceShaderClockFeatures = {0};
+	deviceShaderClockFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SHADER_CLOCK_FEATURES_KHR;
+	deviceShaderClockFeatures.shaderSubgroupClock = VK_TRUE;
+
 	VkPhysicalDeviceSubgroupSizeControlFeatures deviceSubgroupSizeControlFeatures = {0};
 	deviceSubgroupSizeControlFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SUBGROUP_SIZE_CONTROL_FEATURES;
 	deviceSubgroupSizeControlFeatures.subgroupSizeControl = VK_TRUE;
@@ -973,12 +1135,18 @@ bool create_device(struct Gpu* restrict gpu)
 	if (gpu->usingMemoryPriority) {
 		CZ_PNEXT_ADD(next, deviceMemoryPriorityFeatures);
 	}
+	if (gpu->usingPipelineBinary) {
+		CZ_PNEXT_ADD(next, devicePipelineBinaryFeatures);
+	}
 	if (gpu->usingPipelineCreationCacheControl) {
 		CZ_PNEXT_ADD(next, devicePipelineCreationCacheControlFeatures);
 	}
 	if (gpu->usingPipelineExecutableProperties) {
 		CZ_PNEXT_ADD(next, devicePipelineExecutablePropertiesFeatures);
 	}
+	if (gpu->usingShaderClock) {
+		CZ_PNEXT_ADD(next, deviceShaderClockFeatures);
+	}
 	if (gpu->usingSubgroupSizeControl) {
 		CZ_PNEXT_ADD(next, deviceSubgroupSizeControlFeatures);
 	}
@@ -1048,6 +1216,484 @@ bool create_device(struct Gpu* restrict gpu)
 	return true;
 }
 
+// Get the identity of a physical device, which keys the cache files
+static void get_device_id(VkPhysicalDevice physicalDevice, CzU8* restrict deviceUuid, CzU32* restrict driverVersion)
+{
+	VkPhysicalDeviceIDProperties deviceIdProperties = {0};
+	deviceIdProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_ID_PROPERTIES;
+
+	VkPhysicalDeviceProperties2 deviceProperties = {0};
+	deviceProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+	deviceProperties.pNext = &deviceIdProperties;
+
+	VK_CALL(vkGetPhysicalDeviceProperties2, physicalDevice, &deviceProperties);
+
+	memcpy(deviceUuid, deviceIdProperties.deviceUUID, VK_UUID_SIZE);
+	*driverVersion = deviceProperties.properties.driverVersion;
+}
+
+// Entry of the tuning cache file, which holds one entry per device, driver version, iteration size, and mode
+struct TuningCacheEntry
+{
+	CzU8 deviceUuid[VK_UUID_SIZE];
+	CzU32 driverVersion;
+	CzU32 iterSize;
+	CzU32 continuous;
+
+	struct Tuning tuning;
+};
+
+// Find the entry of the tuning cache file with the same key as entry, setting offset to CZ_EOF if there is none
+static bool find_tuning(struct TuningCacheEntry* restrict entry, size_t* restrict offset)
+{
+	size_t cacheSize = 0;
+	struct CzFileFlags cacheFileFlags = {0};
+	cacheFileFlags.relativeToExe = true;
+
+	enum CzResult czres = czFileSize(CZ_TUNING_CACHE_NAME, &cacheSize, cacheFileFlags);
+	if CZ_NOEXPECT (czres && czres != CZ_RESULT_NO_FILE) { return false; }
+
+	size_t entryCount = cacheSize / sizeof(struct TuningCacheEntry);
+	*offset = CZ_EOF;
+
+	for (size_t i = 0; i < entryCount; i++) {
+		struct TuningCacheEntry cacheEntry;
+		size_t cacheOffset = i * sizeof(cacheEntry);
+
+		czres = czReadFile(CZ_TUNING_CACHE_NAME, &cacheEntry, sizeof(cacheEntry), cacheOffset, cacheFileFlags);
+		if CZ_NOEXPECT (czres) { return false; }
+
+		bool sameKey = !memcmp(cacheEntry.deviceUuid, entry->deviceUuid, sizeof(entry->deviceUuid)) &&
+			cacheEntry.driverVersion == entry->driverVersion && cacheEntry.iterSize == entry->iterSize &&
+			cacheEntry.continuous == entry->continuous;
+
+		if (sameKey) {
+			entry->tuning = cacheEntry.tuning;
+			*offset = cacheOffset;
+			break;
+		}
+	}
+
+	return true;
+}
+
+// Use the cached tuning of the device, if there is one and --tune is not in use
+static bool load_tuning(struct Gpu* restrict gpu)
+{
+	if (czgConfig.tune) {
+		return true;
+	}
+
+	struct TuningCacheEntry entry = {0};
+	get_device_id(gpu->physicalDevice, entry.deviceUuid, &entry.driverVersion);
+	entry.iterSize = (CzU32) czgConfig.iterSize;
+	entry.continuous = czgConfig.continuous;
+
+	size_t entryOffset;
+	bool bres = find_tuning(&entry, &entryOffset);
+	if CZ_NOEXPECT (!bres) { return false; }
+
+	if (entryOffset != CZ_EOF) {
+		gpu->tuning = entry.tuning;
+	}
+
+	return true;
+}
+
+bool save_tuning(const struct Gpu* restrict gpu)
+{
+	struct TuningCacheEntry entry = {0};
+	get_device_id(gpu->physicalDevice, entry.deviceUuid, &entry.driverVersion);
+	entry.iterSize = (CzU32) czgConfig.iterSize;
+	entry.continuous = czgConfig.continuous;
+
+	size_t entryOffset;
+	bool bres = find_tuning(&entry, &entryOffset);
+	if CZ_NOEXPECT (!bres) { return false; }
+
+	entry.tuning.workgroupSize = gpu->workgroupSize;
+	entry.tuning.valuesPerDispatch = gpu->valuesPerDispatch;
+	entry.tuning.inoutsPerHeap = gpu->inoutsPerHeap;
+	entry.tuning.subgroupSize = gpu->subgroupSize;
+
+	struct CzFileFlags cacheFileFlags = {0};
+	cacheFileFlags.relativeToExe = true;
+
+	enum CzResult czres = czWriteFile(CZ_TUNING_CACHE_NAME, &entry, sizeof(entry), entryOffset, cacheFileFlags);
+	if CZ_NOEXPECT (czres) { return false; }
+
+	return true;
+}
+
+// Bandwidths of a host visible memory type, as measured by probe_memory_type
+struct MemoryProbe
+{
+	double hostWrite; // GB/s
+	double hostRead; // GB/s
+	double upload; // GB/s
+	double download; // GB/s
+};
+
+// Create a buffer of CZ_MEMORY_PROBE_SIZE bytes, bound to its own device memory of the given memory type
+static bool create_probe_buffer(
+	const struct Gpu* restrict gpu, CzU32 typeIndex, VkBuffer* restrict buffer, VkDeviceMemory* restrict memory)
+{
+	const VkAllocationCallbacks* allocator = gpu->allocator;
+	VkDevice device = gpu->device;
+	VkResult vkres;
+
+	VkBufferCreateInfo bufferInfo = {0};
+	bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+	bufferInfo.size = CZ_MEMORY_PROBE_SIZE;
+	bufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+	bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+	VkBuffer probeBuffer;
+	VK_CALLR(vkCreateBuffer, device, &bufferInfo, allocator, &probeBuffer);
+	if CZ_NOEXPECT (vkres) { return false; }
+
+	VkBufferMemoryRequirementsInfo2 requirementsInfo = {0};
+	requirementsInfo.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_REQUIREMENTS_INFO_2;
+	requirementsInfo.buffer = probeBuffer;
+
+	VkMemoryRequirements2 memoryRequirements = {0};
+	memoryRequirements.sType = VK_STRUCTURE_TYPE_MEMORY_REQUIREMENTS_2;
+
+	VK_CALL(vkGetBufferMemoryRequirements2, device, &requirementsInfo, &memoryRequirements);
+
+	if (!(memoryRequirements.memoryRequirements.memoryTypeBits & (UINT32_C(1) << typeIndex))) {
+		VK_CALL(vkDestroyBuffer, device, probeBuffer, allocator);
+		return false;
+	}
+
+	VkMemoryAllocateInfo allocInfo = {0};
+	allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+	allocInfo.allocationSize = memoryRequirements.memoryRequirements.size;
+	allocInfo.memoryTypeIndex = typeIndex;
+
+	VkDeviceMemory probeMemory;
+	VK_CALLR(vkAllocateMemory, device, &allocInfo, allocator, &probeMemory);
+	if CZ_NOEXPECT (vkres) { VK_CALL(vkDestroyBuffer, device, probeBuffer, allocator); return false; }
+
+	VkBindBufferMemoryInfo bindInfo = {0};
+	bindInfo.sType = VK_STRUCTURE_TYPE_BIND_BUFFER_MEMORY_INFO;
+	bindInfo.buffer = probeBuffer;
+	bindInfo.memory = probeMemory;
+	bindInfo.memoryOffset = 0;
+
+	VK_CALLR(vkBindBufferMemory2, device, 1, &bindInfo);
+	if CZ_NOEXPECT (vkres) {
+		VK_CALL(vkDestroyBuffer, device, probeBuffer, allocator);
+		VK_CALL(vkFreeMemory, device, probeMemory, allocator);
+		return false;
+	}
+
+	*buffer = probeBuffer;
+	*memory = probeMemory;
+	return true;
+}
+
+// Time a buffer copy on the transfer queue, followed by the given dependency if not null
+static bool time_probe_copy(
+	const struct Gpu* restrict gpu,
+	VkCommandPool cmdPool,
+	VkCommandBuffer cmdBuffer,
+	const VkCopyBufferInfo2* restrict copyInfo,
+	const VkDependencyInfo* restrict dependencyInfo,
+	double* restrict time)
+{
+	VkDevice device = gpu->device;
+	VkQueue transferQueue = gpu->transferQueue;
+	VkResult vkres;
+
+	VkCommandPoolResetFlags cmdPoolResetFlags = 0;
+	VK_CALLR(vkResetCommandPool, device, cmdPool, cmdPoolResetFlags);
+	if CZ_NOEXPECT (vkres) { return false; }
+
+	VkCommandBufferBeginInfo beginInfo = {0};
+	beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+
+	VK_CALLR(vkBeginCommandBuffer, cmdBuffer, &beginInfo);
+	if CZ_NOEXPECT (vkres) { return false; }
+
+	VK_CALL(vkCmdCopyBuffer2KHR, cmdBuffer, copyInfo);
+
+	if (dependencyInfo) {
+		VK_CALL(vkCmdPipelineBarrier2KHR, cmdBuffer, dependencyInfo);
+	}
+
+	VK_CALLR(vkEndCommandBuffer, cmdBuffer);
+	if CZ_NOEXPECT (vkres) { return false; }
+
+	VkCommandBufferSubmitInfo cmdBufferSubmitInfo = {0};
+	cmdBufferSubmitInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO;
+	cmdBufferSubmitInfo.commandBuffer = cmdBuffer;
+
+	VkSubmitInfo2 submitInfo = {0};
+	submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO_2;
+	submitInfo.commandBufferInfoCount = 1;
+	submitInfo.pCommandBufferInfos = &cmdBufferSubmitInfo;
+
+	// Submit once to warm up caches and clocks, then again for the timed run
+	double start = 0;
+	for (CzU32 i = 0; i < 2; i++) {
+		start = wall_time();
+
+		VK_CALLR(vkQueueSubmit2KHR, transferQueue, 1, &submitInfo, VK_NULL_HANDLE);
+		if CZ_NOEXPECT (vkres) { return false; }
+
+		VK_CALLR(vkQueueWaitIdle, transferQueue);
+		if CZ_NOEXPECT (vkres) { return false; }
+	}
+
+	*time = wall_time() - start;
+	return true;
+}
+
+// Time host writes, copies to and from device local memory, and host reads of a host visible memory type
+static bool probe_memory_type(
+	const struct Gpu* restrict gpu,
+	VkCommandPool cmdPool,
+	VkCommandBuffer cmdBuffer,
+	VkBuffer deviceLocalBuffer,
+	CzU32 typeIndex,
+	bool nonCoherent,
+	struct MemoryProbe* restrict probe)
+{
+	const VkAllocationCallbacks* allocator = gpu->allocator;
+	VkDevice device = gpu->device;
+	VkResult vkres;
+
+	VkBuffer buffer;
+	VkDeviceMemory memory;
+
+	bool bres = create_probe_buffer(gpu, typeIndex, &buffer, &memory);
+	if (!bres) { return false; }
+
+	VkMemoryMapInfo mapInfo = {0};
+	mapInfo.sType = VK_STRUCTURE_TYPE_MEMORY_MAP_INFO;
+	mapInfo.memory = memory;
+	mapInfo.size = VK_WHOLE_SIZE;
+
+	void* mappedMemory;
+	VK_CALLR(vkMapMemory2KHR, device, &mapInfo, &mappedMemory);
+	if CZ_NOEXPECT (vkres) { goto err_destroy_buffer; }
+
+	VkMappedMemoryRange mappedRange = {0};
+	mappedRange.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
+	mappedRange.memory = memory;
+	mappedRange.offset = 0;
+	mappedRange.size = VK_WHOLE_SIZE;
+
+	CzU64* words = mappedMemory;
+	size_t wordCount = CZ_MEMORY_PROBE_SIZE / sizeof(CzU64);
+
+	// Write once to fault in every page, then again for the timed run
+	double writeStart = 0;
+	for (CzU32 i = 0; i < 2; i++) {
+		writeStart = wall_time();
+
+		for (size_t j = 0; j < wordCount; j++) {
+			words[j] = j + i;
+		}
+
+		if (nonCoherent) {
+			VK_CALLR(vkFlushMappedMemoryRanges, device, 1, &mappedRange);
+			if CZ_NOEXPECT (vkres) { goto err_destroy_buffer; }
+		}
+	}
+	double writeTime = wall_time() - writeStart;
+
+	// Copy the first half to device local memory and back into the second half, as with in- and out-buffers
+	VkBufferCopy2 uploadRegion = {0};
+	uploadRegion.sType = VK_STRUCTURE_TYPE_BUFFER_COPY_2;
+	uploadRegion.srcOffset = 0;
+	uploadRegion.dstOffset = 0;
+	uploadRegion.size = CZ_MEMORY_PROBE_SIZE / 2;
+
+	VkBufferCopy2 downloadRegion = uploadRegion;
+	downloadRegion.dstOffset = CZ_MEMORY_PROBE_SIZE / 2;
+
+	VkCopyBufferInfo2 uploadInfo = {0};
+	uploadInfo.sType = VK_STRUCTURE_TYPE_COPY_BUFFER_INFO_2;
+	uploadInfo.srcBuffer = buffer;
+	uploadInfo.dstBuffer = deviceLocalBuffer;
+	uploadInfo.regionCount = 1;
+	uploadInfo.pRegions = &uploadRegion;
+
+	VkCopyBufferInfo2 downloadInfo = {0};
+	downloadInfo.sType = VK_STRUCTURE_TYPE_COPY_BUFFER_INFO_2;
+	downloadInfo.srcBuffer = deviceLocalBuffer;
+	downloadInfo.dstBuffer = buffer;
+	downloadInfo.regionCount = 1;
+	downloadInfo.pRegions = &downloadRegion;
+
+	// Make the downloaded half available to the host, as is done for out-buffers
+	VkBufferMemoryBarrier2 hostReadBarrier = {0};
+	hostReadBarrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2;
+	hostReadBarrier.srcStageMask = VK_PIPELINE_STAGE_2_COPY_BIT;
+	hostReadBarrier.srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+	hostReadBarrier.dstStageMask = VK_PIPELINE_STAGE_2_HOST_BIT;
+	hostReadBarrier.dstAccessMask = VK_ACCESS_2_HOST_READ_BIT;
+	hostReadBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	hostReadBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	hostReadBarrier.buffer = buffer;
+	hostReadBarrier.offset = CZ_MEMORY_PROBE_SIZE / 2;
+	hostReadBarrier.size = CZ_MEMORY_PROBE_SIZE / 2;
+
+	VkDependencyInfo hostReadDependencyInfo = {0};
+	hostReadDependencyInfo.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+	hostReadDependencyInfo.bufferMemoryBarrierCount = 1;
+	hostReadDependencyInfo.pBufferMemoryBarriers = &hostReadBarrier;
+
+	double uploadTime;
+	bres = time_probe_copy(gpu, cmdPool, cmdBuffer, &uploadInfo, NULL, &uploadTime);
+	if CZ_NOEXPECT (!bres) { goto err_destroy_buffer; }
+
+	double downloadTime;
+	bres = time_probe_copy(gpu, cmdPool, cmdBuffer, &downloadInfo, &hostReadDependencyInfo, &downloadTime);
+	if CZ_NOEXPECT (!bres) { goto err_destroy_buffer; }
+
+	// Read the half written by the device, as the host reads out-buffers
+	double readStart = wall_time();
+
+	if (nonCoherent) {
+		VK_CALLR(vkInvalidateMappedMemoryRanges, device, 1, &mappedRange);
+		if CZ_NOEXPECT (vkres) { goto err_destroy_buffer; }
+	}
+
+	CzU64 sum = 0;
+	for (size_t j = wordCount / 2; j < wordCount; j++) {
+		sum += words[j];
+	}
+
+	volatile CzU64 sink = sum; // Keep the reads from being optimised away
+	(void) sink;
+
+	double readTime = wall_time() - readStart;
+
+	VK_CALL(vkDestroyBuffer, device, buffer, allocator);
+	VK_CALL(vkFreeMemory, device, memory, allocator);
+
+	// Bytes per millisecond => GB/s
+	probe->hostWrite = (double) CZ_MEMORY_PROBE_SIZE / writeTime / 1000000;
+	probe->hostRead = (double) (CZ_MEMORY_PROBE_SIZE / 2) / readTime / 1000000;
+	probe->upload = (double) (CZ_MEMORY_PROBE_SIZE / 2) / uploadTime / 1000000;
+	probe->download = (double) (CZ_MEMORY_PROBE_SIZE / 2) / downloadTime / 1000000;
+	return true;
+
+err_destroy_buffer:
+	VK_CALL(vkDestroyBuffer, device, buffer, allocator);
+	VK_CALL(vkFreeMemory, device, memory, allocator);
+	return false;
+}
+
+// Benchmark each candidate host visible memory type, and select the ones least costly for the in- and out-buffers
+static bool probe_memory(
+	struct Gpu* restrict gpu,
+	const VkPhysicalDeviceMemoryProperties* restrict memoryProperties,
+	CzU32 candidateTypeBits,
+	CzU32 deviceLocalTypeIndex,
+	CzU32 fallbackTypeIndex)
+{
+	const VkAllocationCallbacks* allocator = gpu->allocator;
+	VkDevice device = gpu->device;
+	VkResult vkres;
+
+	gpu->memoryProbed = true;
+	gpu->probedInTypeIndex = fallbackTypeIndex;
+	gpu->probedOutTypeIndex = fallbackTypeIndex;
+
+	VkCommandPoolCreateInfo cmdPoolInfo = {0};
+	cmdPoolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+	cmdPoolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+	cmdPoolInfo.queueFamilyIndex = gpu->transferFamilyIndex;
+
+	VkCommandPool cmdPool;
+	VK_CALLR(vkCreateCommandPool, device, &cmdPoolInfo, allocator, &cmdPool);
+	if CZ_NOEXPECT (vkres) { return false; }
+
+	VkCommandBufferAllocateInfo cmdBufferAllocInfo = {0};
+	cmdBufferAllocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+	cmdBufferAllocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+	cmdBufferAllocInfo.commandPool = cmdPool;
+	cmdBufferAllocInfo.commandBufferCount = 1;
+
+	VkCommandBuffer cmdBuffer;
+	VK_CALLR(vkAllocateCommandBuffers, device, &cmdBufferAllocInfo, &cmdBuffer);
+	if CZ_NOEXPECT (vkres) { goto err_destroy_cmdpool; }
+
+	// Without device local memory to copy to, keep the heuristic selection
+	VkBuffer deviceLocalBuffer;
+	VkDeviceMemory deviceLocalMemory;
+
+	bool bres = create_probe_buffer(gpu, deviceLocalTypeIndex, &deviceLocalBuffer, &deviceLocalMemory);
+	if (!bres) {
+		VK_CALL(vkDestroyCommandPool, device, cmdPool, allocator);
+		return true;
+	}
+
+	if (czgConfig.outputLevel > CZ_OUTPUT_LEVEL_DEFAULT) {
+		printf("HV memory type bandwidths:\n");
+	}
+
+	double bestInCost = DBL_MAX;
+	double bestOutCost = DBL_MAX;
+
+	for (CzU32 i = 0; i < memoryProperties->memoryTypeCount; i++) {
+		if (!(candidateTypeBits & (UINT32_C(1) << i))) {
+			continue;
+		}
+
+		VkMemoryPropertyFlags propFlags = memoryProperties->memoryTypes[i].propertyFlags;
+		bool nonCoherent = !(propFlags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+
+		// Types that fail to be probed are skipped, as they may still be selected by the heuristic
+		struct MemoryProbe probe;
+		bres = probe_memory_type(gpu, cmdPool, cmdBuffer, deviceLocalBuffer, i, nonCoherent, &probe);
+		if (!bres) { continue; }
+
+		if (czgConfig.outputLevel > CZ_OUTPUT_LEVEL_DEFAULT) {
+			printf(
+				"\tType %" PRIu32 ": write %.2f GB/s, read %.2f GB/s, upload %.2f GB/s, download %.2f GB/s\n",
+				i, probe.hostWrite, probe.hostRead, probe.upload, probe.download);
+		}
+
+		// Per value, the host writes an in-value which is uploaded, and an out-value is downloaded which it reads
+		double inCost = (double) sizeof(CzU128) / probe.hostWrite + (double) sizeof(CzU128) / probe.upload;
+		double outCost = (double) sizeof(CzU16) / probe.hostRead + (double) sizeof(CzU16) / probe.download;
+
+		if (inCost < bestInCost) {
+			bestInCost = inCost;
+
+			gpu->probedInTypeIndex = i;
+			gpu->hostWriteBandwidth = probe.hostWrite;
+			gpu->uploadBandwidth = probe.upload;
+		}
+
+		if (outCost < bestOutCost) {
+			bestOutCost = outCost;
+
+			gpu->probedOutTypeIndex = i;
+			gpu->hostReadBandwidth = probe.hostRead;
+			gpu->downloadBandwidth = probe.download;
+		}
+	}
+
+	if (czgConfig.outputLevel > CZ_OUTPUT_LEVEL_DEFAULT) {
+		CZ_NEWLINE();
+	}
+
+	VK_CALL(vkDestroyBuffer, device, deviceLocalBuffer, allocator);
+	VK_CALL(vkFreeMemory, device, deviceLocalMemory, allocator);
+	VK_CALL(vkDestroyCommandPool, device, cmdPool, allocator);
+	return true;
+
+err_destroy_cmdpool:
+	VK_CALL(vkDestroyCommandPool, device, cmdPool, allocator);
+	return false;
+}
+
 bool manage_memory(struct Gpu* restrict gpu)
 {
 	VkPhysicalDevice physicalDevice = gpu->physicalDevice;
@@ -1057,16 +1703,28 @@ bool manage_memory(struct Gpu* restrict gpu)
 		gpu->usingMaintenance4 ? get_buffer_requirements_main4 : get_buffer_requirements_noext;
 
 	// Get device properties
+	VkPhysicalDeviceSubgroupSizeControlProperties deviceSubgroupSizeControlProperties = {0};
+	deviceSubgroupSizeControlProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SUBGROUP_SIZE_CONTROL_PROPERTIES;
+
 	VkPhysicalDeviceMaintenance4Properties deviceMaintenance4Properties = {0};
 	deviceMaintenance4Properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MAINTENANCE_4_PROPERTIES;
 
 	VkPhysicalDeviceMaintenance3Properties deviceMaintenance3Properties = {0};
 	deviceMaintenance3Properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MAINTENANCE_3_PROPERTIES;
-	deviceMaintenance3Properties.pNext = gpu->usingMaintenance4 ? &deviceMaintenance4Properties : NULL;
 
 	VkPhysicalDeviceProperties2 deviceProperties = {0};
 	deviceProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
-	deviceProperties.pNext = &deviceMaintenance3Properties;
+
+	void** next = &deviceProperties.pNext;
+
+	CZ_PNEXT_ADD(next, deviceMaintenance3Properties);
+
+	if (gpu->usingMaintenance4) {
+		CZ_PNEXT_ADD(next, deviceMaintenance4Properties);
+	}
+	if (gpu->usingSubgroupSizeControl) {
+		CZ_PNEXT_ADD(next, deviceSubgroupSizeControlProperties);
+	}
 
 	VK_CALL(vkGetPhysicalDeviceProperties2, physicalDevice, &deviceProperties);
 
@@ -1094,6 +1752,10 @@ bool manage_memory(struct Gpu* restrict gpu)
 	hostVisibleBufferUsage |= VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
 	hostVisibleBufferUsage |= VK_BUFFER_USAGE_TRANSFER_DST_BIT;
 
+	if (czgConfig.continuous) {
+		hostVisibleBufferUsage |= VK_BUFFER_USAGE_STORAGE_BUFFER_BIT; // Record ring buffers are written by shaders
+	}
+
 	VkMemoryRequirements hostVisibleMemoryRequirements;
 	bool bres = get_buffer_requirements(device, sizeof(char), hostVisibleBufferUsage, &hostVisibleMemoryRequirements);
 	if CZ_NOEXPECT (!bres) { return false; }
@@ -1124,6 +1786,8 @@ bool manage_memory(struct Gpu* restrict gpu)
 	bool hasHostNonCoherent = false;
 	bool hasHostVisible = false;
 
+	CzU32 hostVisibleCandidateTypeBits = 0;
+
 	for (CzU32 i = 0; i < memoryTypeCount; i++) {
 		CzU32 memoryTypeBit = UINT32_C(1) << i;
 		CzU32 heapIndex = deviceMemoryProperties.memoryProperties.memoryTypes[i].heapIndex;
@@ -1156,6 +1820,8 @@ bool manage_memory(struct Gpu* restrict gpu)
 		}
 
 		if (isHostVisible && (hostVisibleMemoryTypeBits & memoryTypeBit)) {
+			hostVisibleCandidateTypeBits |= memoryTypeBit;
+
 			if (!hasHostCachedNonCoherent && isHostCached && !isHostCoherent) {
 				hostVisibleHeapIndex = heapIndex;
 				hostVisibleTypeIndex = i;
@@ -1185,27 +1851,105 @@ bool manage_memory(struct Gpu* restrict gpu)
 		}
 	}
 
+	// The heuristic cannot tell apart types with the same properties, so measure each candidate once per device
+	if (!gpu->memoryProbed) {
+		bres = probe_memory(
+			gpu, &deviceMemoryProperties.memoryProperties, hostVisibleCandidateTypeBits, deviceLocalTypeIndex,
+			hostVisibleTypeIndex);
+
+		if CZ_NOEXPECT (!bres) { return false; }
+	}
+
+	// In continuous mode the host mostly reads the record ring buffers the device writes, as with out-buffers
+	CzU32 probedInTypeIndex = czgConfig.continuous ? gpu->probedOutTypeIndex : gpu->probedInTypeIndex;
+	CzU32 probedOutTypeIndex = gpu->probedOutTypeIndex;
+
+	CzU32 hostVisibleOutHeapIndex = hostVisibleHeapIndex;
+	CzU32 hostVisibleOutTypeIndex = hostVisibleTypeIndex;
+	bool hasHostOutNonCoherent = hasHostNonCoherent;
+
+	if (hostVisibleCandidateTypeBits & (UINT32_C(1) << probedInTypeIndex)) {
+		VkMemoryType probedType = deviceMemoryProperties.memoryProperties.memoryTypes[probedInTypeIndex];
+
+		hostVisibleHeapIndex = probedType.heapIndex;
+		hostVisibleTypeIndex = probedInTypeIndex;
+		hasHostNonCoherent = !(probedType.propertyFlags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+	}
+
+	if (hostVisibleCandidateTypeBits & (UINT32_C(1) << probedOutTypeIndex)) {
+		VkMemoryType probedType = deviceMemoryProperties.memoryProperties.memoryTypes[probedOutTypeIndex];
+
+		hostVisibleOutHeapIndex = probedType.heapIndex;
+		hostVisibleOutTypeIndex = probedOutTypeIndex;
+		hasHostOutNonCoherent = !(probedType.propertyFlags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+	}
+
 	VkDeviceSize hostVisibleHeapBudget = deviceBudgetProperties.heapBudget[hostVisibleHeapIndex];
+	VkDeviceSize hostVisibleOutHeapBudget = deviceBudgetProperties.heapBudget[hostVisibleOutHeapIndex];
 	VkDeviceSize deviceLocalHeapBudget = deviceBudgetProperties.heapBudget[deviceLocalHeapIndex];
 
-	VkDeviceSize hostVisibleHeapSize = deviceMemoryProperties.memoryProperties.memoryHeaps[hostVisibleHeapIndex].size;
-	VkDeviceSize deviceLocalHeapSize = deviceMemoryProperties.memoryProperties.memoryHeaps[deviceLocalHeapIndex].size;
+	// Each HV buffer holds one staging region per pipelined generation (continuous mode stages nothing)
+	// Instrumented dispatches of an inout-buffer share its stats, so only one generation of it is queued at a time
+	CzU32 stagesPerInout = czgConfig.continuous || gpu->instrumenting ? 1 : (CzU32) czgConfig.pipelineDepth;
+
+	/*
+	 * Per 18 bytes of DL memory, each generation stages 16 bytes of in-buffers and 2 bytes of out-buffers. In
+	 * continuous mode, the HV buffers are instead as large as the DL buffers. Each heap is then shared between the
+	 * memories placed in it, and between the memory still held by another memory layout, which counts against the same
+	 * user-given limit.
+	 */
+	CzU32 heapIndices[3] = {deviceLocalHeapIndex, hostVisibleHeapIndex, hostVisibleOutHeapIndex};
+
+	VkDeviceSize heapWeights[3] = {
+		sizeof(CzU128) + sizeof(CzU16),
+		czgConfig.continuous ? sizeof(CzU128) + sizeof(CzU16) : sizeof(CzU128) * stagesPerInout,
+		czgConfig.continuous ? 0 : sizeof(CzU16) * stagesPerInout};
 
-	VkDeviceSize bytesPerHostVisibleHeap = gpu->usingMemoryBudget ? hostVisibleHeapBudget : hostVisibleHeapSize;
-	VkDeviceSize bytesPerDeviceLocalHeap = gpu->usingMemoryBudget ? deviceLocalHeapBudget : deviceLocalHeapSize;
+	VkDeviceSize heapReserves[3] = {
+		gpu->deviceLocalBytesReserved, gpu->hostVisibleBytesReserved, gpu->hostVisibleOutBytesReserved};
 
-	VkDeviceSize bytesPerHeap = minu64(bytesPerHostVisibleHeap, bytesPerDeviceLocalHeap);
-	bytesPerHeap = (VkDeviceSize) ((float) bytesPerHeap * czgConfig.maxMemory); // User-given limit on heap memory
+	VkDeviceSize bytesPerHeap = UINT64_MAX;
 
-	if (deviceLocalHeapIndex == hostVisibleHeapIndex) {
-		bytesPerHeap /= 2; // Evenly partition heap into HV memory and DL memory
+	for (CzU32 i = 0; i < CZ_COUNTOF(heapIndices); i++) {
+		if (!heapWeights[i]) {
+			continue;
+		}
+
+		CzU32 heapIndex = heapIndices[i];
+		VkDeviceSize heapBudget = deviceBudgetProperties.heapBudget[heapIndex];
+		VkDeviceSize heapSize = deviceMemoryProperties.memoryProperties.memoryHeaps[heapIndex].size;
+
+		VkDeviceSize bytesPerMemoryHeap = gpu->usingMemoryBudget ? heapBudget : heapSize;
+		bytesPerMemoryHeap = (VkDeviceSize) ((float) bytesPerMemoryHeap * czgConfig.maxMemory);
+
+		VkDeviceSize heapWeight = 0;
+		VkDeviceSize heapReserve = 0;
+
+		for (CzU32 j = 0; j < CZ_COUNTOF(heapIndices); j++) {
+			if (heapIndices[j] == heapIndex) {
+				heapWeight += heapWeights[j];
+				heapReserve += heapReserves[j];
+			}
+		}
+
+		bytesPerMemoryHeap -= minu64(bytesPerMemoryHeap, heapReserve);
+		bytesPerHeap = minu64(bytesPerHeap, bytesPerMemoryHeap / heapWeight * heapWeights[0]);
 	}
 
-	VkDeviceSize bytesPerBuffer = minu64v(3, maxMemorySize, maxBufferSize, bytesPerHeap);
+	if CZ_NOEXPECT (!bytesPerHeap) {
+		log_error(stderr, "No heap memory is left for the memory layout");
+		return false;
+	}
+
+	VkDeviceSize bytesPerBuffer = minu64v(
+		3, maxMemorySize / stagesPerInout, maxBufferSize / stagesPerInout, bytesPerHeap);
 	CzU32 buffersPerHeap = (CzU32) (bytesPerHeap / bytesPerBuffer);
 
+	// Each buffer of DL memory has an HV in-buffer memory, and an HV out-buffer memory if not continuous
+	CzU32 maxBufferCount = maxMemoryCount / (czgConfig.continuous ? 2 : 3);
+
 	// Can we squeeze in another buffer?
-	if (buffersPerHeap < maxMemoryCount && bytesPerHeap % bytesPerBuffer) {
+	if (buffersPerHeap < maxBufferCount && bytesPerHeap % bytesPerBuffer) {
 		VkDeviceSize excessBytes = bytesPerBuffer - bytesPerHeap % bytesPerBuffer;
 
 		buffersPerHeap++;
@@ -1215,41 +1959,96 @@ bool manage_memory(struct Gpu* restrict gpu)
 			bytesPerBuffer--;
 		}
 	}
-	else if (buffersPerHeap > maxMemoryCount) {
-		buffersPerHeap = maxMemoryCount; // Don't use too many allocations
+	else if (buffersPerHeap > maxBufferCount) {
+		buffersPerHeap = maxBufferCount; // Don't use too many allocations
 	}
 
-	CzU32 workgroupSize = floor_pow2(maxWorkgroupSize);
-	CzU32 workgroupCount = minu32(
-		maxWorkgroupCount, (CzU32) (maxStorageBufferRange / (workgroupSize * sizeof(CzU128))));
+	// Subgroup sizes can only be required if supported for compute shaders
+	CzU32 minSubgroupSize = 0;
+	CzU32 maxSubgroupSize = 0;
+	CzU32 maxWorkgroupSubgroups = 0;
 
-	CzU32 valuesPerInout = workgroupSize * workgroupCount;
-	VkDeviceSize bytesPerInout = valuesPerInout * (sizeof(CzU128) + sizeof(CzU16));
+	if (deviceSubgroupSizeControlProperties.requiredSubgroupSizeStages & VK_SHADER_STAGE_COMPUTE_BIT) {
+		minSubgroupSize = deviceSubgroupSizeControlProperties.minSubgroupSize;
+		maxSubgroupSize = deviceSubgroupSizeControlProperties.maxSubgroupSize;
+		maxWorkgroupSubgroups = deviceSubgroupSizeControlProperties.maxComputeWorkgroupSubgroups;
+	}
+
+	bres = load_tuning(gpu);
+	if CZ_NOEXPECT (!bres) { return false; }
+
+	struct Tuning tuning = gpu->tuning;
+
+	// Tuned limits only ever shrink the memory layout, and keep workgroupSize a power of 2 no less than 128
+	CzU32 workgroupSize = floor_pow2(maxWorkgroupSize);
+	CzU32 subgroupSize = 0;
+
+	if (tuning.workgroupSize >= 128) {
+		workgroupSize = minu32(workgroupSize, floor_pow2(tuning.workgroupSize));
+	}
+
+	if (tuning.subgroupSize >= minSubgroupSize && tuning.subgroupSize <= maxSubgroupSize && tuning.subgroupSize) {
+		CzU32 maxSubgroupWorkgroupSize = floor_pow2(maxWorkgroupSubgroups * tuning.subgroupSize);
+
+		if (maxSubgroupWorkgroupSize >= 128) {
+			workgroupSize = minu32(workgroupSize, maxSubgroupWorkgroupSize);
+			subgroupSize = tuning.subgroupSize;
+		}
+	}
+
+	CzU32 workgroupCount = minu32(
+		maxWorkgroupCount, (CzU32) (maxStorageBufferRange / (workgroupSize * sizeof(CzU128))));
+
+	if (tuning.valuesPerDispatch) {
+		workgroupCount = minu32(workgroupCount, maxu32(tuning.valuesPerDispatch / workgroupSize, 1));
+	}
+
+	CzU32 valuesPerDispatch = workgroupSize * workgroupCount;
+
+	// Each inout-buffer spans several dispatches, but must still fit in a buffer
+	CzU32 dispatchesPerInout = czgConfig.continuous || gpu->rampingUp ? 1 : (CzU32) czgConfig.inoutDispatches;
+	dispatchesPerInout = (CzU32) minu64(
+		dispatchesPerInout, maxu64(bytesPerBuffer / (valuesPerDispatch * (sizeof(CzU128) + sizeof(CzU16))), 1));
+
+	CzU64 valuesPerInout = (CzU64) valuesPerDispatch * dispatchesPerInout;
+	VkDeviceSize bytesPerInout = valuesPerInout * (sizeof(CzU128) + sizeof(CzU16));
 	CzU32 inoutsPerBuffer = (CzU32) (bytesPerBuffer / bytesPerInout);
 
+	// Begin on only a few inout-buffers while the full memory layout is created in the background
+	if (gpu->rampingUp) {
+		buffersPerHeap = 1;
+		inoutsPerBuffer = minu32(inoutsPerBuffer, CZ_RAMP_UP_INOUT_COUNT);
+	}
+	// Don't use more inout-buffers than tuned
+	else if (tuning.inoutsPerHeap && inoutsPerBuffer * buffersPerHeap >= tuning.inoutsPerHeap) {
+		buffersPerHeap = minu32(buffersPerHeap, tuning.inoutsPerHeap);
+		inoutsPerBuffer = minu32(inoutsPerBuffer, tuning.inoutsPerHeap / buffersPerHeap);
+	}
 	// Can we squeeze in another inout-buffer?
-	if (bytesPerBuffer % bytesPerInout > inoutsPerBuffer * workgroupSize * (sizeof(CzU128) + sizeof(CzU16))) {
-		CzU32 excessValues =
-			valuesPerInout - (CzU32) (bytesPerBuffer % bytesPerInout / (sizeof(CzU128) + sizeof(CzU16)));
+	else if (
+		bytesPerBuffer % bytesPerInout >
+		(CzU64) inoutsPerBuffer * dispatchesPerInout * workgroupSize * (sizeof(CzU128) + sizeof(CzU16)))
+	{
+		CzU64 excessValues = valuesPerInout - bytesPerBuffer % bytesPerInout / (sizeof(CzU128) + sizeof(CzU16));
 
 		inoutsPerBuffer++;
-		valuesPerInout -= excessValues / inoutsPerBuffer;
-
-		if (excessValues % inoutsPerBuffer) {
-			valuesPerInout--;
-		}
 
-		valuesPerInout &= ~(workgroupSize - 1); // Round down to multiple of workgroupSize
+		// Spread the excess evenly over every dispatch of every inout-buffer
+		CzU64 dispatchesPerBuffer = (CzU64) inoutsPerBuffer * dispatchesPerInout;
+		valuesPerDispatch -= (CzU32) ((excessValues + dispatchesPerBuffer - 1) / dispatchesPerBuffer);
+		valuesPerDispatch &= ~(workgroupSize - 1); // Round down to multiple of workgroupSize
 
 		// Squeeze worked
-		if (valuesPerInout) {
-			workgroupCount = valuesPerInout / workgroupSize;
+		if (valuesPerDispatch) {
+			workgroupCount = valuesPerDispatch / workgroupSize;
 		}
 		// Squeeze failed
 		else {
 			inoutsPerBuffer--;
-			valuesPerInout = workgroupSize * workgroupCount;
+			valuesPerDispatch = workgroupSize * workgroupCount;
 		}
+
+		valuesPerInout = (CzU64) valuesPerDispatch * dispatchesPerInout;
 	}
 
 	VkDeviceSize bytesPerIn = valuesPerInout * sizeof(CzU128);
@@ -1258,17 +2057,46 @@ bool manage_memory(struct Gpu* restrict gpu)
 	bytesPerInout = bytesPerIn + bytesPerOut;
 	bytesPerBuffer = bytesPerInout * inoutsPerBuffer;
 
-	CzU32 valuesPerBuffer = valuesPerInout * inoutsPerBuffer;
-	CzU32 valuesPerHeap = valuesPerBuffer * buffersPerHeap;
+	// In continuous mode, each inout-buffer instead holds a claim counter (DL) and a record ring buffer (HV)
+	VkDeviceSize bytesPerRing = sizeof(struct RingHeader) + valuesPerInout * sizeof(struct RingCandidate);
+	VkDeviceSize bytesPerClaim = sizeof(CzU32);
+
+	// If not continuous, each dispatch has a step counter region, with one counter per staging region
+	VkDeviceSize bytesPerSteps = (sizeof(struct StepCounters) + 255) & ~(VkDeviceSize) 255;
+
+	// If instrumenting, each dispatch also has a stats region, with one record per workgroup
+	VkDeviceSize bytesPerStats = sizeof(struct StatsHeader) + workgroupCount * sizeof(struct StatsRecord);
+	bytesPerStats = (bytesPerStats + 255) & ~(VkDeviceSize) 255;
+
+	CzU64 valuesPerBuffer = valuesPerInout * inoutsPerBuffer;
+	CzU64 valuesPerHeap = valuesPerBuffer * buffersPerHeap;
 	CzU32 inoutsPerHeap = inoutsPerBuffer * buffersPerHeap;
 
-	bres = get_buffer_requirements(device, bytesPerBuffer, hostVisibleBufferUsage, &hostVisibleMemoryRequirements);
+	// The staging regions of the in- and out-buffers are in separate HV buffers, each grouped by generation
+	VkDeviceSize bytesPerInStaging = bytesPerIn * inoutsPerBuffer * stagesPerInout;
+	VkDeviceSize bytesPerOutStaging = bytesPerOut * inoutsPerBuffer * stagesPerInout;
+
+	if (czgConfig.continuous) {
+		bytesPerInStaging = bytesPerBuffer;
+	}
+
+	bres = get_buffer_requirements(device, bytesPerInStaging, hostVisibleBufferUsage, &hostVisibleMemoryRequirements);
 	if CZ_NOEXPECT (!bres) { return false; }
 
+	VkMemoryRequirements hostVisibleOutMemoryRequirements = {0};
+
+	if (!czgConfig.continuous) {
+		bres = get_buffer_requirements(
+			device, bytesPerOutStaging, hostVisibleBufferUsage, &hostVisibleOutMemoryRequirements);
+
+		if CZ_NOEXPECT (!bres) { return false; }
+	}
+
 	bres = get_buffer_requirements(device, bytesPerBuffer, deviceLocalBufferUsage, &deviceLocalMemoryRequirements);
 	if CZ_NOEXPECT (!bres) { return false; }
 
 	VkDeviceSize bytesPerHostVisibleMemory = hostVisibleMemoryRequirements.size;
+	VkDeviceSize bytesPerHostVisibleOutMemory = hostVisibleOutMemoryRequirements.size;
 	VkDeviceSize bytesPerDeviceLocalMemory = deviceLocalMemoryRequirements.size;
 
 	/*
@@ -1276,76 +2104,127 @@ bool manage_memory(struct Gpu* restrict gpu)
 	 * workgroupSize is maxComputeWorkGroupSize rounded down to a power of 2
 	 * => workgroupSize is a multiple of 128
 	 *
-	 * valuesPerInout is a multiple of workgroupSize
-	 * => valuesPerInout is a multiple of 128
+	 * valuesPerDispatch and valuesPerInout are multiples of workgroupSize
+	 * => valuesPerDispatch and valuesPerInout are multiples of 128
 	 *
-	 * bytesPerIn and bytesPerOut are multiples of valuesPerInout * 2
-	 * => bytesPerIn and bytesPerOut are multiples of 256
+	 * bytesPerIn, bytesPerOut, and the offsets of each dispatch within them are multiples of valuesPerDispatch * 2
+	 * => bytesPerIn, bytesPerOut, and dispatch offsets are multiples of 256
 	 *
 	 * nonCoherentAtomSize and minStorageBufferOffsetAlignment are guaranteed to be at most 256
-	 * => bytesPerIn and bytesPerOut are multiples of nonCoherentAtomSize and minStorageBufferOffsetAlignment
+	 * => bytesPerIn, bytesPerOut, and dispatch offsets are multiples of nonCoherentAtomSize and
+	 *    minStorageBufferOffsetAlignment
+	 *
+	 * sizeof(struct RingHeader) is 256 and sizeof(struct RingCandidate) is 8
+	 * => bytesPerRing is a multiple of 256 and is less than bytesPerInout
+	 *
+	 * bytesPerSteps and bytesPerStats are rounded up to multiples of 256
+	 * => step counter and stats offsets are multiples of nonCoherentAtomSize and minStorageBufferOffsetAlignment
 	 */
 
 	gpu->bytesPerIn = bytesPerIn;
 	gpu->bytesPerOut = bytesPerOut;
 	gpu->bytesPerInout = bytesPerInout;
+	gpu->bytesPerRing = bytesPerRing;
+	gpu->bytesPerClaim = bytesPerClaim;
+	gpu->bytesPerSteps = czgConfig.continuous ? 0 : bytesPerSteps;
+	gpu->bytesPerStats = gpu->instrumenting ? bytesPerStats : 0;
 	gpu->bytesPerBuffer = bytesPerBuffer;
 	gpu->bytesPerHostVisibleMemory = bytesPerHostVisibleMemory;
+	gpu->bytesPerHostVisibleOutMemory = bytesPerHostVisibleOutMemory;
 	gpu->bytesPerDeviceLocalMemory = bytesPerDeviceLocalMemory;
+	gpu->hostVisibleHeapBudget = hostVisibleHeapBudget;
+	gpu->hostVisibleOutHeapBudget = hostVisibleOutHeapBudget;
+	gpu->deviceLocalHeapBudget = deviceLocalHeapBudget;
 
 	gpu->valuesPerInout = valuesPerInout;
 	gpu->valuesPerBuffer = valuesPerBuffer;
 	gpu->valuesPerHeap = valuesPerHeap;
+	gpu->valuesPerDispatch = valuesPerDispatch;
+	gpu->dispatchesPerInout = dispatchesPerInout;
 	gpu->inoutsPerBuffer = inoutsPerBuffer;
 	gpu->inoutsPerHeap = inoutsPerHeap;
 	gpu->buffersPerHeap = buffersPerHeap;
+	gpu->stagesPerInout = stagesPerInout;
 
 	gpu->workgroupSize = workgroupSize;
 	gpu->workgroupCount = workgroupCount;
+	gpu->subgroupSize = subgroupSize;
+	gpu->minSubgroupSize = minSubgroupSize;
+	gpu->maxSubgroupSize = maxSubgroupSize;
 
 	gpu->hostVisibleHeapIndex = hostVisibleHeapIndex;
+	gpu->hostVisibleOutHeapIndex = hostVisibleOutHeapIndex;
 	gpu->deviceLocalHeapIndex = deviceLocalHeapIndex;
 	gpu->hostVisibleTypeIndex = hostVisibleTypeIndex;
+	gpu->hostVisibleOutTypeIndex = hostVisibleOutTypeIndex;
 	gpu->deviceLocalTypeIndex = deviceLocalTypeIndex;
 
 	gpu->hostNonCoherent = hasHostNonCoherent;
+	gpu->hostOutNonCoherent = hasHostOutNonCoherent;
+
+	// The ramp-up memory layout is short-lived, so only the full memory layout is displayed in detail
+	if (gpu->rampingUp) {
+		if (czgConfig.outputLevel > CZ_OUTPUT_LEVEL_QUIET) {
+			printf("Ramping up on %" PRIu32 " inout-buffers\n\n", inoutsPerHeap);
+		}
+
+		return true;
+	}
 
 	// Display info on planned memory usage
 	switch (czgConfig.outputLevel) {
 	case CZ_OUTPUT_LEVEL_DEFAULT:
 		printf(
 			"Memory information:\n"
-			"\tHV memory type index:    %" PRIu32 "\n"
-			"\tDL memory type index:    %" PRIu32 "\n"
-			"\tWorkgroup size:          %" PRIu32 "\n"
-			"\tWorkgroup count:         %" PRIu32 "\n"
-			"\tValues per inout-buffer: %" PRIu32 "\n"
-			"\tInout-buffers per heap:  %" PRIu32 "\n\n",
-			hostVisibleTypeIndex, deviceLocalTypeIndex,
+			"\tHV in memory type index:  %" PRIu32 "\n"
+			"\tHV out memory type index: %" PRIu32 "\n"
+			"\tDL memory type index:     %" PRIu32 "\n"
+			"\tWorkgroup size:           %" PRIu32 "\n"
+			"\tWorkgroup count:          %" PRIu32 "\n"
+			"\tValues per inout-buffer:  %" PRIu64 "\n"
+			"\tInout-buffers per heap:   %" PRIu32 "\n"
+			"\tHV write bandwidth:       %.2f GB/s\n"
+			"\tHV read bandwidth:        %.2f GB/s\n"
+			"\tHV-DL upload bandwidth:   %.2f GB/s\n"
+			"\tDL-HV download bandwidth: %.2f GB/s\n\n",
+			hostVisibleTypeIndex, hostVisibleOutTypeIndex, deviceLocalTypeIndex,
 			workgroupSize, workgroupCount,
-			valuesPerInout, inoutsPerHeap);
+			valuesPerInout, inoutsPerHeap,
+			gpu->hostWriteBandwidth, gpu->hostReadBandwidth, gpu->uploadBandwidth, gpu->downloadBandwidth);
 
 		break;
 
 	case CZ_OUTPUT_LEVEL_VERBOSE:
 		printf(
 			"Memory information:\n"
-			"\tHV non-coherent memory:   %d\n"
-			"\tHV memory heap index:     %" PRIu32 "\n"
+			"\tHV in non-coherent:       %d\n"
+			"\tHV out non-coherent:      %d\n"
+			"\tHV in memory heap index:  %" PRIu32 "\n"
+			"\tHV out memory heap index: %" PRIu32 "\n"
 			"\tDL memory heap index:     %" PRIu32 "\n"
-			"\tHV memory type index:     %" PRIu32 "\n"
+			"\tHV in memory type index:  %" PRIu32 "\n"
+			"\tHV out memory type index: %" PRIu32 "\n"
 			"\tDL memory type index:     %" PRIu32 "\n"
 			"\tWorkgroup size:           %" PRIu32 "\n"
 			"\tWorkgroup count:          %" PRIu32 "\n"
-			"\tValues per inout-buffer:  %" PRIu32 "\n"
+			"\tSubgroup size:            %" PRIu32 "\n"
+			"\tDispatches per inout:     %" PRIu32 "\n"
+			"\tValues per inout-buffer:  %" PRIu64 "\n"
 			"\tInout-buffers per buffer: %" PRIu32 "\n"
 			"\tBuffers per heap:         %" PRIu32 "\n"
-			"\tValues per heap:          %" PRIu32 "\n\n",
-			hasHostNonCoherent,
-			hostVisibleHeapIndex, deviceLocalHeapIndex,
-			hostVisibleTypeIndex, deviceLocalTypeIndex,
-			workgroupSize, workgroupCount,
-			valuesPerInout, inoutsPerBuffer, buffersPerHeap, valuesPerHeap);
+			"\tValues per heap:          %" PRIu64 "\n"
+			"\tPipeline depth:           %" PRIu32 "\n"
+			"\tHV write bandwidth:       %.2f GB/s\n"
+			"\tHV read bandwidth:        %.2f GB/s\n"
+			"\tHV-DL upload bandwidth:   %.2f GB/s\n"
+			"\tDL-HV download bandwidth: %.2f GB/s\n\n",
+			hasHostNonCoherent, hasHostOutNonCoherent,
+			hostVisibleHeapIndex, hostVisibleOutHeapIndex, deviceLocalHeapIndex,
+			hostVisibleTypeIndex, hostVisibleOutTypeIndex, deviceLocalTypeIndex,
+			workgroupSize, workgroupCount, subgroupSize, dispatchesPerInout,
+			valuesPerInout, inoutsPerBuffer, buffersPerHeap, valuesPerHeap,
+			stagesPerInout,
+			gpu->hostWriteBandwidth, gpu->hostReadBandwidth, gpu->uploadBandwidth, gpu->downloadBandwidth);
 
 		break;
 
@@ -1356,7 +2235,47 @@ bool manage_memory(struct Gpu* restrict gpu)
 	return true;
 }
 
-bool create_buffers(struct Gpu* restrict gpu)
+// Allocate huge pages to import as a host visible device memory, or return null if they can't be of the memory type
+static void* alloc_host_import(VkDevice device, VkDeviceSize size, CzU32 typeIndex)
+{
+	VkResult vkres;
+
+	void* hostPointer;
+	struct CzAllocFlags flags = {0};
+
+	enum CzResult czres = czAllocHuge(&hostPointer, (size_t) size, flags);
+	if CZ_NOEXPECT (czres) { return NULL; }
+
+	VkMemoryHostPointerPropertiesEXT hostPointerProperties = {0};
+	hostPointerProperties.sType = VK_STRUCTURE_TYPE_MEMORY_HOST_POINTER_PROPERTIES_EXT;
+
+	VkExternalMemoryHandleTypeFlagBits handleType = VK_EXTERNAL_MEMORY_HANDLE_TYPE_HOST_ALLOCATION_BIT_EXT;
+	VK_CALLR(vkGetMemoryHostPointerPropertiesEXT, device, handleType, hostPointer, &hostPointerProperties);
+
+	if CZ_NOEXPECT (vkres || !(hostPointerProperties.memoryTypeBits & (UINT32_C(1) << typeIndex))) {
+		czFreeHuge(hostPointer, (size_t) size);
+		return NULL;
+	}
+
+	return hostPointer;
+}
+
+/*
+ * Create a host visible buffer per buffer of the heap, each bound to its own device memory of the given memory type,
+ * and map them. The arrays are stored through the given pointers as soon as they are allocated, so the objects are
+ * released with the rest of the memory layout even if creation fails part way.
+ */
+static bool create_host_visible_buffers(
+	struct Gpu* restrict gpu,
+	VkDeviceSize bufferSize,
+	VkDeviceSize memorySize,
+	CzU32 typeIndex,
+	bool nonCoherent,
+	VkBuffer** restrict buffers,
+	VkDeviceMemory** restrict memories,
+	void*** restrict imports,
+	VkDeviceSize* restrict bytesPerImport,
+	void** restrict mappedMemories)
 {
 	DyRecord gpuRecord = gpu->allocRecord;
 
@@ -1364,48 +2283,213 @@ bool create_buffers(struct Gpu* restrict gpu)
 
 	VkDevice device = gpu->device;
 
-	VkDeviceSize bytesPerInout = gpu->bytesPerInout;
-	VkDeviceSize bytesPerBuffer = gpu->bytesPerBuffer;
-	VkDeviceSize bytesPerHostVisibleMemory = gpu->bytesPerHostVisibleMemory;
-	VkDeviceSize bytesPerDeviceLocalMemory = gpu->bytesPerDeviceLocalMemory;
-
-	CzU32 valuesPerInout = gpu->valuesPerInout;
-	CzU32 inoutsPerBuffer = gpu->inoutsPerBuffer;
-	CzU32 inoutsPerHeap = gpu->inoutsPerHeap;
 	CzU32 buffersPerHeap = gpu->buffersPerHeap;
-	CzU32 hostVisibleTypeIndex = gpu->hostVisibleTypeIndex;
-	CzU32 deviceLocalTypeIndex = gpu->deviceLocalTypeIndex;
 
 	VkResult vkres;
 
-	DyRecord localRecord = dyrecord_create();
-	if CZ_NOEXPECT (!localRecord) { return false; }
-
 	// Create host visible buffers
 	size_t allocCount = buffersPerHeap;
 	size_t allocSize = sizeof(VkBuffer);
 
 	VkBuffer* hostVisibleBuffers = dyrecord_calloc(gpuRecord, allocCount, allocSize);
-	if CZ_NOEXPECT (!hostVisibleBuffers) { dyrecord_destroy(localRecord); return false; }
-	gpu->hostVisibleBuffers = hostVisibleBuffers;
+	if CZ_NOEXPECT (!hostVisibleBuffers) { return false; }
+	*buffers = hostVisibleBuffers;
 
 	VkBufferUsageFlags hostVisibleBufferUsage = 0;
 	hostVisibleBufferUsage |= VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
 	hostVisibleBufferUsage |= VK_BUFFER_USAGE_TRANSFER_DST_BIT;
 
+	if (czgConfig.continuous) {
+		hostVisibleBufferUsage |= VK_BUFFER_USAGE_STORAGE_BUFFER_BIT; // Record ring buffers are written by shaders
+	}
+
+	/*
+	 * Imported host allocations are accessed directly rather than mapped, so their ranges cannot be flushed or
+	 * invalidated. They are therefore only imported into host coherent memory, which needs neither.
+	 */
+	bool importingHostMemory = gpu->usingExternalMemoryHost && !nonCoherent;
+
+	VkExternalMemoryBufferCreateInfo hostVisibleExternalInfo = {0};
+	hostVisibleExternalInfo.sType = VK_STRUCTURE_TYPE_EXTERNAL_MEMORY_BUFFER_CREATE_INFO;
+	hostVisibleExternalInfo.handleTypes = VK_EXTERNAL_MEMORY_HANDLE_TYPE_HOST_ALLOCATION_BIT_EXT;
+
 	VkBufferCreateInfo hostVisibleBufferInfo = {0};
 	hostVisibleBufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
-	hostVisibleBufferInfo.size = bytesPerBuffer;
+	hostVisibleBufferInfo.pNext = importingHostMemory ? &hostVisibleExternalInfo : NULL;
+	hostVisibleBufferInfo.size = bufferSize;
 	hostVisibleBufferInfo.usage = hostVisibleBufferUsage;
 	hostVisibleBufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 
 	for (CzU32 i = 0; i < buffersPerHeap; i++) {
 		VkBuffer hostVisibleBuffer;
 		VK_CALLR(vkCreateBuffer, device, &hostVisibleBufferInfo, allocator, &hostVisibleBuffer);
-		if CZ_NOEXPECT (vkres) { dyrecord_destroy(localRecord); return false; }
+		if CZ_NOEXPECT (vkres) { return false; }
 		hostVisibleBuffers[i] = hostVisibleBuffer;
 	}
 
+	// Create host visible device memories
+	allocCount = buffersPerHeap;
+	allocSize = sizeof(VkDeviceMemory);
+
+	VkDeviceMemory* hostVisibleMemories = dyrecord_calloc(gpuRecord, allocCount, allocSize);
+	if CZ_NOEXPECT (!hostVisibleMemories) { return false; }
+	*memories = hostVisibleMemories;
+
+	VkMemoryPriorityAllocateInfoEXT hostVisiblePriorityInfo = {0};
+	hostVisiblePriorityInfo.sType = VK_STRUCTURE_TYPE_MEMORY_PRIORITY_ALLOCATE_INFO_EXT;
+	hostVisiblePriorityInfo.priority = 0;
+
+	// Host allocations to import as host visible device memories, backed by huge pages
+	void** hostImports = NULL;
+	VkDeviceSize hostImportAlignment = gpu->hostImportAlignment;
+	VkDeviceSize bytesPerHostImport = 0;
+
+	*imports = NULL;
+	*bytesPerImport = 0;
+
+	if (importingHostMemory) {
+		allocCount = buffersPerHeap;
+		allocSize = sizeof(void*);
+
+		hostImports = dyrecord_calloc(gpuRecord, allocCount, allocSize);
+		if CZ_NOEXPECT (!hostImports) { return false; }
+		*imports = hostImports;
+
+		// Imported host allocations must span a multiple of the minimum host pointer alignment
+		bytesPerHostImport = (memorySize + hostImportAlignment - 1) & ~(hostImportAlignment - 1);
+		*bytesPerImport = bytesPerHostImport;
+	}
+
+	for (CzU32 i = 0; i < buffersPerHeap; i++) {
+		VkMemoryDedicatedAllocateInfo hostVisibleDedicatedInfo = {0};
+		hostVisibleDedicatedInfo.sType = VK_STRUCTURE_TYPE_MEMORY_DEDICATED_ALLOCATE_INFO;
+		hostVisibleDedicatedInfo.pNext = gpu->usingMemoryPriority ? &hostVisiblePriorityInfo : NULL;
+		hostVisibleDedicatedInfo.buffer = hostVisibleBuffers[i];
+
+		VkMemoryAllocateInfo hostVisibleAllocInfo = {0};
+		hostVisibleAllocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+		hostVisibleAllocInfo.pNext = &hostVisibleDedicatedInfo;
+		hostVisibleAllocInfo.allocationSize = memorySize;
+		hostVisibleAllocInfo.memoryTypeIndex = typeIndex;
+
+		VkImportMemoryHostPointerInfoEXT hostVisibleImportInfo = {0};
+		hostVisibleImportInfo.sType = VK_STRUCTURE_TYPE_IMPORT_MEMORY_HOST_POINTER_INFO_EXT;
+		hostVisibleImportInfo.pNext = gpu->usingMemoryPriority ? &hostVisiblePriorityInfo : NULL;
+		hostVisibleImportInfo.handleType = VK_EXTERNAL_MEMORY_HANDLE_TYPE_HOST_ALLOCATION_BIT_EXT;
+
+		if (hostImports) {
+			hostImports[i] = alloc_host_import(device, bytesPerHostImport, typeIndex);
+		}
+
+		// Host pointers cannot be imported as dedicated allocations
+		if (hostImports && hostImports[i]) {
+			hostVisibleImportInfo.pHostPointer = hostImports[i];
+
+			hostVisibleAllocInfo.pNext = &hostVisibleImportInfo;
+			hostVisibleAllocInfo.allocationSize = bytesPerHostImport;
+		}
+
+		VkDeviceMemory hostVisibleMemory;
+		VK_CALLR(vkAllocateMemory, device, &hostVisibleAllocInfo, allocator, &hostVisibleMemory);
+		if CZ_NOEXPECT (vkres) { return false; }
+		hostVisibleMemories[i] = hostVisibleMemory;
+	}
+
+	// Bind buffers and device memories
+	for (CzU32 i = 0; i < buffersPerHeap; i++) {
+		VkBindBufferMemoryInfo bindInfo = {0};
+		bindInfo.sType = VK_STRUCTURE_TYPE_BIND_BUFFER_MEMORY_INFO;
+		bindInfo.buffer = hostVisibleBuffers[i];
+		bindInfo.memory = hostVisibleMemories[i];
+		bindInfo.memoryOffset = 0;
+
+		VK_CALLR(vkBindBufferMemory2, device, 1, &bindInfo);
+		if CZ_NOEXPECT (vkres) { return false; }
+	}
+
+	// Map device memories
+	for (CzU32 i = 0; i < buffersPerHeap; i++) {
+		VkMemoryMapInfo mapInfo = {0};
+		mapInfo.sType = VK_STRUCTURE_TYPE_MEMORY_MAP_INFO;
+		mapInfo.memory = hostVisibleMemories[i];
+		mapInfo.size = memorySize;
+
+		// Imported host allocations are accessed directly, so through their huge pages
+		if (hostImports && hostImports[i]) {
+			mappedMemories[i] = hostImports[i];
+		}
+		else {
+			VK_CALLR(vkMapMemory2KHR, device, &mapInfo, &mappedMemories[i]);
+			if CZ_NOEXPECT (vkres) { return false; }
+		}
+	}
+
+	return true;
+}
+
+bool create_buffers(struct Gpu* restrict gpu)
+{
+	DyRecord gpuRecord = gpu->allocRecord;
+
+	const VkAllocationCallbacks* allocator = gpu->allocator;
+
+	VkDevice device = gpu->device;
+
+	VkDeviceSize bytesPerIn = gpu->bytesPerIn;
+	VkDeviceSize bytesPerOut = gpu->bytesPerOut;
+	VkDeviceSize bytesPerInout = gpu->bytesPerInout;
+	VkDeviceSize bytesPerBuffer = gpu->bytesPerBuffer;
+	VkDeviceSize bytesPerDeviceLocalMemory = gpu->bytesPerDeviceLocalMemory;
+
+	CzU32 inoutsPerBuffer = gpu->inoutsPerBuffer;
+	CzU32 inoutsPerHeap = gpu->inoutsPerHeap;
+	CzU32 buffersPerHeap = gpu->buffersPerHeap;
+	CzU32 stagesPerInout = gpu->stagesPerInout;
+	CzU32 hostVisibleTypeIndex = gpu->hostVisibleTypeIndex;
+	CzU32 hostVisibleOutTypeIndex = gpu->hostVisibleOutTypeIndex;
+	CzU32 deviceLocalTypeIndex = gpu->deviceLocalTypeIndex;
+
+	VkResult vkres;
+
+	DyRecord localRecord = dyrecord_create();
+	if CZ_NOEXPECT (!localRecord) { return false; }
+
+	// Create host visible in-buffers (record ring buffers in continuous mode)
+	size_t allocCount = buffersPerHeap;
+	size_t allocSize = sizeof(void*);
+
+	void** mappedInMemories = dyrecord_calloc(localRecord, allocCount, allocSize);
+	if CZ_NOEXPECT (!mappedInMemories) { dyrecord_destroy(localRecord); return false; }
+
+	VkDeviceSize bytesPerInStaging = bytesPerIn * inoutsPerBuffer * stagesPerInout;
+	if (czgConfig.continuous) {
+		bytesPerInStaging = bytesPerBuffer;
+	}
+
+	bool bres = create_host_visible_buffers(
+		gpu, bytesPerInStaging, gpu->bytesPerHostVisibleMemory, hostVisibleTypeIndex, gpu->hostNonCoherent,
+		&gpu->hostVisibleBuffers, &gpu->hostVisibleDeviceMemories, &gpu->hostImports, &gpu->bytesPerHostImport,
+		mappedInMemories);
+
+	if CZ_NOEXPECT (!bres) { dyrecord_destroy(localRecord); return false; }
+
+	// Create host visible out-buffers, so they can be of a memory type suited to being read rather than written
+	void** mappedOutMemories = NULL;
+
+	if (!czgConfig.continuous) {
+		mappedOutMemories = dyrecord_calloc(localRecord, allocCount, allocSize);
+		if CZ_NOEXPECT (!mappedOutMemories) { dyrecord_destroy(localRecord); return false; }
+
+		VkDeviceSize bytesPerOutStaging = bytesPerOut * inoutsPerBuffer * stagesPerInout;
+
+		bres = create_host_visible_buffers(
+			gpu, bytesPerOutStaging, gpu->bytesPerHostVisibleOutMemory, hostVisibleOutTypeIndex,
+			gpu->hostOutNonCoherent, &gpu->hostVisibleOutBuffers, &gpu->hostVisibleOutDeviceMemories,
+			&gpu->hostOutImports, &gpu->bytesPerHostOutImport, mappedOutMemories);
+
+		if CZ_NOEXPECT (!bres) { dyrecord_destroy(localRecord); return false; }
+	}
+
 	// Create device local buffers
 	allocCount = buffersPerHeap;
 	allocSize = sizeof(VkBuffer);
@@ -1432,36 +2516,6 @@ bool create_buffers(struct Gpu* restrict gpu)
 		deviceLocalBuffers[i] = deviceLocalBuffer;
 	}
 
-	// Create host visible device memories
-	allocCount = buffersPerHeap;
-	allocSize = sizeof(VkDeviceMemory);
-
-	VkDeviceMemory* hostVisibleMemories = dyrecord_calloc(gpuRecord, allocCount, allocSize);
-	if CZ_NOEXPECT (!hostVisibleMemories) { dyrecord_destroy(localRecord); return false; }
-	gpu->hostVisibleDeviceMemories = hostVisibleMemories;
-
-	VkMemoryPriorityAllocateInfoEXT hostVisiblePriorityInfo = {0};
-	hostVisiblePriorityInfo.sType = VK_STRUCTURE_TYPE_MEMORY_PRIORITY_ALLOCATE_INFO_EXT;
-	hostVisiblePriorityInfo.priority = 0;
-
-	for (CzU32 i = 0; i < buffersPerHeap; i++) {
-		VkMemoryDedicatedAllocateInfo hostVisibleDedicatedInfo = {0};
-		hostVisibleDedicatedInfo.sType = VK_STRUCTURE_TYPE_MEMORY_DEDICATED_ALLOCATE_INFO;
-		hostVisibleDedicatedInfo.pNext = gpu->usingMemoryPriority ? &hostVisiblePriorityInfo : NULL;
-		hostVisibleDedicatedInfo.buffer = hostVisibleBuffers[i];
-
-		VkMemoryAllocateInfo hostVisibleAllocInfo = {0};
-		hostVisibleAllocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-		hostVisibleAllocInfo.pNext = &hostVisibleDedicatedInfo;
-		hostVisibleAllocInfo.allocationSize = bytesPerHostVisibleMemory;
-		hostVisibleAllocInfo.memoryTypeIndex = hostVisibleTypeIndex;
-
-		VkDeviceMemory hostVisibleMemory;
-		VK_CALLR(vkAllocateMemory, device, &hostVisibleAllocInfo, allocator, &hostVisibleMemory);
-		if CZ_NOEXPECT (vkres) { dyrecord_destroy(localRecord); return false; }
-		hostVisibleMemories[i] = hostVisibleMemory;
-	}
-
 	// Create device local device memories
 	allocCount = buffersPerHeap;
 	allocSize = sizeof(VkDeviceMemory);
@@ -1494,106 +2548,156 @@ bool create_buffers(struct Gpu* restrict gpu)
 
 	// Bind buffers and device memories
 	allocCount = buffersPerHeap;
-	allocSize = sizeof(VkBindBufferMemoryInfo[2]);
+	allocSize = sizeof(VkBindBufferMemoryInfo);
 
-	VkBindBufferMemoryInfo (*bindBufferMemoryInfos)[2] = dyrecord_calloc(localRecord, allocCount, allocSize);
-	if CZ_NOEXPECT (!bindBufferMemoryInfos) { dyrecord_destroy(localRecord); return false; }
+	VkBindBufferMemoryInfo* bindInfos = dyrecord_calloc(localRecord, allocCount, allocSize);
+	if CZ_NOEXPECT (!bindInfos) { dyrecord_destroy(localRecord); return false; }
 
 	for (CzU32 i = 0; i < buffersPerHeap; i++) {
-		bindBufferMemoryInfos[i][0].sType = VK_STRUCTURE_TYPE_BIND_BUFFER_MEMORY_INFO;
-		bindBufferMemoryInfos[i][0].buffer = hostVisibleBuffers[i];
-		bindBufferMemoryInfos[i][0].memory = hostVisibleMemories[i];
-		bindBufferMemoryInfos[i][0].memoryOffset = 0;
-
-		bindBufferMemoryInfos[i][1].sType = VK_STRUCTURE_TYPE_BIND_BUFFER_MEMORY_INFO;
-		bindBufferMemoryInfos[i][1].buffer = deviceLocalBuffers[i];
-		bindBufferMemoryInfos[i][1].memory = deviceLocalMemories[i];
-		bindBufferMemoryInfos[i][1].memoryOffset = 0;
+		bindInfos[i].sType = VK_STRUCTURE_TYPE_BIND_BUFFER_MEMORY_INFO;
+		bindInfos[i].buffer = deviceLocalBuffers[i];
+		bindInfos[i].memory = deviceLocalMemories[i];
+		bindInfos[i].memoryOffset = 0;
 	}
 
-	CzU32 bindInfoCount = buffersPerHeap * CZ_COUNTOF(bindBufferMemoryInfos[0]);
-	VkBindBufferMemoryInfo* bindInfos = (VkBindBufferMemoryInfo*) bindBufferMemoryInfos;
-
-	VK_CALLR(vkBindBufferMemory2, device, bindInfoCount, bindInfos);
+	VK_CALLR(vkBindBufferMemory2, device, buffersPerHeap, bindInfos);
 	if CZ_NOEXPECT (vkres) { dyrecord_destroy(localRecord); return false; }
 
-	// Map host visible device memories
-	allocSize = inoutsPerHeap * sizeof(CzU128*);
+	// Find mapped in- and out-buffers (staging regions of an inout-buffer are consecutive in the mapped arrays)
+	allocSize = inoutsPerHeap * stagesPerInout * sizeof(CzU128*);
 	CzU128** mappedInBuffers = dyrecord_malloc(gpuRecord, allocSize);
 	if CZ_NOEXPECT (!mappedInBuffers) { dyrecord_destroy(localRecord); return false; }
 	gpu->mappedInBuffers = mappedInBuffers;
 
-	allocSize = inoutsPerHeap * sizeof(CzU16*);
+	allocSize = inoutsPerHeap * stagesPerInout * sizeof(CzU16*);
 	CzU16** mappedOutBuffers = dyrecord_malloc(gpuRecord, allocSize);
 	if CZ_NOEXPECT (!mappedOutBuffers) { dyrecord_destroy(localRecord); return false; }
 	gpu->mappedOutBuffers = mappedOutBuffers;
 
 	for (CzU32 i = 0, j = 0; i < buffersPerHeap; i++) {
-		VkMemoryMapInfo mapInfo = {0};
-		mapInfo.sType = VK_STRUCTURE_TYPE_MEMORY_MAP_INFO;
-		mapInfo.memory = hostVisibleMemories[i];
-		mapInfo.size = bytesPerHostVisibleMemory;
+		for (CzU32 k = 0; k < inoutsPerBuffer; k++) {
+			for (CzU32 l = 0; l < stagesPerInout; j++, l++) {
+				// Record ring buffers take the place of the inout-buffers in continuous mode
+				if (czgConfig.continuous) {
+					mappedInBuffers[j] = (CzU128*) ((char*) mappedInMemories[i] + bytesPerInout * k);
+					mappedOutBuffers[j] = NULL;
+					continue;
+				}
+
+				// Staging regions are grouped by generation within each HV buffer
+				CzU64 region = (CzU64) inoutsPerBuffer * l + k;
+
+				mappedInBuffers[j] = (CzU128*) ((char*) mappedInMemories[i] + bytesPerIn * region);
+				mappedOutBuffers[j] = (CzU16*) ((char*) mappedOutMemories[i] + bytesPerOut * region);
+			}
+		}
+	}
+
+	// Create stats buffer in host visible out-buffer memory, so the host reads the counters and records in place
+	if (!czgConfig.continuous) {
+		VkDeviceSize bytesPerStatsBuffer =
+			(gpu->bytesPerSteps + gpu->bytesPerStats) * inoutsPerHeap * gpu->dispatchesPerInout;
 
-		void* mappedMemory;
-		VK_CALLR(vkMapMemory2KHR, device, &mapInfo, &mappedMemory);
+		VkBufferCreateInfo statsBufferInfo = {0};
+		statsBufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+		statsBufferInfo.size = bytesPerStatsBuffer;
+		statsBufferInfo.usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+		statsBufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+		VkBuffer statsBuffer;
+		VK_CALLR(vkCreateBuffer, device, &statsBufferInfo, allocator, &statsBuffer);
 		if CZ_NOEXPECT (vkres) { dyrecord_destroy(localRecord); return false; }
+		gpu->statsBuffer = statsBuffer;
+
+		VkBufferMemoryRequirementsInfo2 statsRequirementsInfo = {0};
+		statsRequirementsInfo.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_REQUIREMENTS_INFO_2;
+		statsRequirementsInfo.buffer = statsBuffer;
+
+		VkMemoryRequirements2 statsMemoryRequirements = {0};
+		statsMemoryRequirements.sType = VK_STRUCTURE_TYPE_MEMORY_REQUIREMENTS_2;
+
+		VK_CALL(vkGetBufferMemoryRequirements2, device, &statsRequirementsInfo, &statsMemoryRequirements);
 
-		mappedInBuffers[j] = mappedMemory;
-		mappedOutBuffers[j] = (CzU16*) (mappedInBuffers[j] + valuesPerInout);
-		j++;
+		CzU32 statsMemoryTypeBits = statsMemoryRequirements.memoryRequirements.memoryTypeBits;
 
-		for (CzU32 k = 1; k < inoutsPerBuffer; j++, k++) {
-			mappedInBuffers[j] = mappedInBuffers[j - 1] + bytesPerInout / sizeof(CzU128);
-			mappedOutBuffers[j] = mappedOutBuffers[j - 1] + bytesPerInout / sizeof(CzU16);
+		if CZ_NOEXPECT (!(statsMemoryTypeBits & (UINT32_C(1) << hostVisibleOutTypeIndex))) {
+			log_error(stderr, "Stats buffer cannot be bound to memory type %" PRIu32, hostVisibleOutTypeIndex);
+			dyrecord_destroy(localRecord);
+			return false;
 		}
+
+		VkMemoryAllocateInfo statsAllocInfo = {0};
+		statsAllocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+		statsAllocInfo.allocationSize = statsMemoryRequirements.memoryRequirements.size;
+		statsAllocInfo.memoryTypeIndex = hostVisibleOutTypeIndex;
+
+		VkDeviceMemory statsMemory;
+		VK_CALLR(vkAllocateMemory, device, &statsAllocInfo, allocator, &statsMemory);
+		if CZ_NOEXPECT (vkres) { dyrecord_destroy(localRecord); return false; }
+		gpu->statsDeviceMemory = statsMemory;
+
+		VkBindBufferMemoryInfo statsBindInfo = {0};
+		statsBindInfo.sType = VK_STRUCTURE_TYPE_BIND_BUFFER_MEMORY_INFO;
+		statsBindInfo.buffer = statsBuffer;
+		statsBindInfo.memory = statsMemory;
+		statsBindInfo.memoryOffset = 0;
+
+		VK_CALLR(vkBindBufferMemory2, device, 1, &statsBindInfo);
+		if CZ_NOEXPECT (vkres) { dyrecord_destroy(localRecord); return false; }
+
+		VkMemoryMapInfo statsMapInfo = {0};
+		statsMapInfo.sType = VK_STRUCTURE_TYPE_MEMORY_MAP_INFO;
+		statsMapInfo.memory = statsMemory;
+		statsMapInfo.size = VK_WHOLE_SIZE;
+
+		void* mappedStats;
+		VK_CALLR(vkMapMemory2KHR, device, &statsMapInfo, &mappedStats);
+		if CZ_NOEXPECT (vkres) { dyrecord_destroy(localRecord); return false; }
+		gpu->mappedStats = mappedStats;
 	}
 
 #if !defined(NDEBUG)
 	for (CzU32 i = 0; i < buffersPerHeap; i++) {
-		char objectName[37];
+		char objectName[41];
 		sprintf(objectName, "Host visible (%" PRIu32 "/%" PRIu32 ")", i + 1, buffersPerHeap);
 
-		set_debug_name(device, VK_OBJECT_TYPE_BUFFER, (CzU64) hostVisibleBuffers[i], objectName);
-		set_debug_name(device, VK_OBJECT_TYPE_DEVICE_MEMORY, (CzU64) hostVisibleMemories[i], objectName);
+		set_debug_name(device, VK_OBJECT_TYPE_BUFFER, (CzU64) gpu->hostVisibleBuffers[i], objectName);
+		set_debug_name(device, VK_OBJECT_TYPE_DEVICE_MEMORY, (CzU64) gpu->hostVisibleDeviceMemories[i], objectName);
+
+		if (!czgConfig.continuous) {
+			sprintf(objectName, "Host visible out (%" PRIu32 "/%" PRIu32 ")", i + 1, buffersPerHeap);
+
+			set_debug_name(device, VK_OBJECT_TYPE_BUFFER, (CzU64) gpu->hostVisibleOutBuffers[i], objectName);
+			set_debug_name(
+				device, VK_OBJECT_TYPE_DEVICE_MEMORY, (CzU64) gpu->hostVisibleOutDeviceMemories[i], objectName);
+		}
 
-		strcpy(objectName, "Device local");
-		objectName[12] = ' '; // Remove '\0' from strcpy
+		sprintf(objectName, "Device local (%" PRIu32 "/%" PRIu32 ")", i + 1, buffersPerHeap);
 
 		set_debug_name(device, VK_OBJECT_TYPE_BUFFER, (CzU64) deviceLocalBuffers[i], objectName);
 		set_debug_name(device, VK_OBJECT_TYPE_DEVICE_MEMORY, (CzU64) deviceLocalMemories[i], objectName);
 	}
+
+	if (!czgConfig.continuous) {
+		set_debug_name(device, VK_OBJECT_TYPE_BUFFER, (CzU64) gpu->statsBuffer, "Stats");
+		set_debug_name(device, VK_OBJECT_TYPE_DEVICE_MEMORY, (CzU64) gpu->statsDeviceMemory, "Stats");
+	}
 #endif
 
 	dyrecord_destroy(localRecord);
 	return true;
 }
 
-bool create_descriptors(struct Gpu* restrict gpu)
+bool create_descriptor_layout(struct Gpu* restrict gpu)
 {
-	DyRecord gpuRecord = gpu->allocRecord;
-
 	const VkAllocationCallbacks* allocator = gpu->allocator;
-	const VkBuffer* deviceLocalBuffers = gpu->deviceLocalBuffers;
 
 	VkDevice device = gpu->device;
 
-	VkDeviceSize bytesPerIn = gpu->bytesPerIn;
-	VkDeviceSize bytesPerOut = gpu->bytesPerOut;
-	VkDeviceSize bytesPerInout = gpu->bytesPerInout;
-
-	CzU32 inoutsPerBuffer = gpu->inoutsPerBuffer;
-	CzU32 inoutsPerHeap = gpu->inoutsPerHeap;
-	CzU32 buffersPerHeap = gpu->buffersPerHeap;
-
 	VkResult vkres;
-	size_t allocCount;
-	size_t allocSize;
 
-	DyRecord localRecord = dyrecord_create();
-	if CZ_NOEXPECT (!localRecord) { return false; }
-
-	// Create descriptor set layout (same layout for each set)
-	VkDescriptorSetLayoutBinding descriptorSetLayoutBindings[2] = {0};
+	// Same layout for each set, and needed by both the descriptor sets and the pipeline
+	VkDescriptorSetLayoutBinding descriptorSetLayoutBindings[4] = {0};
 	descriptorSetLayoutBindings[0].binding = 0;
 	descriptorSetLayoutBindings[0].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
 	descriptorSetLayoutBindings[0].descriptorCount = 1;
@@ -1604,91 +2708,170 @@ bool create_descriptors(struct Gpu* restrict gpu)
 	descriptorSetLayoutBindings[1].descriptorCount = 1;
 	descriptorSetLayoutBindings[1].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
 
+	// Step counters, only if not continuous
+	descriptorSetLayoutBindings[2].binding = 2;
+	descriptorSetLayoutBindings[2].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+	descriptorSetLayoutBindings[2].descriptorCount = 1;
+	descriptorSetLayoutBindings[2].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+
+	// Stats buffer, only if instrumenting
+	descriptorSetLayoutBindings[3].binding = 3;
+	descriptorSetLayoutBindings[3].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+	descriptorSetLayoutBindings[3].descriptorCount = 1;
+	descriptorSetLayoutBindings[3].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+
 	VkDescriptorSetLayoutCreateInfo descriptorSetLayoutInfo = {0};
 	descriptorSetLayoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
-	descriptorSetLayoutInfo.bindingCount = CZ_COUNTOF(descriptorSetLayoutBindings);
+	descriptorSetLayoutInfo.bindingCount = czgConfig.continuous ? 2 : gpu->instrumenting ? 4 : 3;
 	descriptorSetLayoutInfo.pBindings = descriptorSetLayoutBindings;
 
 	VkDescriptorSetLayout descriptorSetLayout;
 	VK_CALLR(vkCreateDescriptorSetLayout, device, &descriptorSetLayoutInfo, allocator, &descriptorSetLayout);
-	if CZ_NOEXPECT (vkres) { dyrecord_destroy(localRecord); return false; }
+	if CZ_NOEXPECT (vkres) { return false; }
 	gpu->descriptorSetLayout = descriptorSetLayout;
 
-	// Create descriptor pool (all sets allocated from same pool)
-	VkDescriptorPoolSize descriptorPoolSizes[1];
-	descriptorPoolSizes[0].type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
-	descriptorPoolSizes[0].descriptorCount = inoutsPerHeap * 2;
+	return true;
+}
 
-	VkDescriptorPoolCreateInfo descriptorPoolInfo = {0};
-	descriptorPoolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
-	descriptorPoolInfo.maxSets = inoutsPerHeap;
-	descriptorPoolInfo.poolSizeCount = CZ_COUNTOF(descriptorPoolSizes);
-	descriptorPoolInfo.pPoolSizes = descriptorPoolSizes;
+bool create_descriptors(struct Gpu* restrict gpu)
+{
+	DyRecord gpuRecord = gpu->allocRecord;
+
+	const VkAllocationCallbacks* allocator = gpu->allocator;
+	const VkBuffer* hostVisibleBuffers = gpu->hostVisibleBuffers;
+	const VkBuffer* deviceLocalBuffers = gpu->deviceLocalBuffers;
+
+	VkDevice device = gpu->device;
+	VkDescriptorSetLayout descriptorSetLayout = gpu->descriptorSetLayout;
+
+	VkDeviceSize bytesPerIn = gpu->bytesPerIn;
+	VkDeviceSize bytesPerInout = gpu->bytesPerInout;
+	VkDeviceSize bytesPerRing = gpu->bytesPerRing;
+	VkDeviceSize bytesPerClaim = gpu->bytesPerClaim;
+	VkDeviceSize bytesPerSteps = gpu->bytesPerSteps;
+	VkDeviceSize bytesPerStats = gpu->bytesPerStats;
+
+	CzU32 valuesPerDispatch = gpu->valuesPerDispatch;
+	CzU32 dispatchesPerInout = gpu->dispatchesPerInout;
+	CzU32 inoutsPerBuffer = gpu->inoutsPerBuffer;
+	CzU32 inoutsPerHeap = gpu->inoutsPerHeap;
+	CzU32 buffersPerHeap = gpu->buffersPerHeap;
+
+	CzU32 setCount = inoutsPerHeap * dispatchesPerInout;
+	CzU32 bindingCount = czgConfig.continuous ? 2 : gpu->instrumenting ? 4 : 3;
+
+	VkDeviceSize bytesPerDispatchIn = valuesPerDispatch * sizeof(CzU128);
+	VkDeviceSize bytesPerDispatchOut = valuesPerDispatch * sizeof(CzU16);
+
+	VkResult vkres;
+	size_t allocCount;
+	size_t allocSize;
+
+	DyRecord localRecord = dyrecord_create();
+	if CZ_NOEXPECT (!localRecord) { return false; }
+
+	// Create descriptor pool (all sets allocated from same pool)
+	VkDescriptorPoolSize descriptorPoolSizes[1];
+	descriptorPoolSizes[0].type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+	descriptorPoolSizes[0].descriptorCount = setCount * bindingCount;
+
+	VkDescriptorPoolCreateInfo descriptorPoolInfo = {0};
+	descriptorPoolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+	descriptorPoolInfo.maxSets = setCount;
+	descriptorPoolInfo.poolSizeCount = CZ_COUNTOF(descriptorPoolSizes);
+	descriptorPoolInfo.pPoolSizes = descriptorPoolSizes;
 
 	VkDescriptorPool descriptorPool;
 	VK_CALLR(vkCreateDescriptorPool, device, &descriptorPoolInfo, allocator, &descriptorPool);
 	if CZ_NOEXPECT (vkres) { dyrecord_destroy(localRecord); return false; }
 	gpu->descriptorPool = descriptorPool;
 
-	// Allocate descriptor sets (one per inout-buffer)
-	allocSize = inoutsPerHeap * sizeof(VkDescriptorSet);
+	// Allocate descriptor sets (one per dispatch of each inout-buffer)
+	allocSize = setCount * sizeof(VkDescriptorSet);
 	VkDescriptorSet* descriptorSets = dyrecord_malloc(gpuRecord, allocSize);
 	if CZ_NOEXPECT (!descriptorSets) { dyrecord_destroy(localRecord); return false; }
 	gpu->descriptorSets = descriptorSets;
 
-	allocSize = inoutsPerHeap * sizeof(VkDescriptorSetLayout);
+	allocSize = setCount * sizeof(VkDescriptorSetLayout);
 	VkDescriptorSetLayout* descriptorSetLayouts = dyrecord_malloc(localRecord, allocSize);
 	if CZ_NOEXPECT (!descriptorSetLayouts) { dyrecord_destroy(localRecord); return false; }
 
-	for (CzU32 i = 0; i < inoutsPerHeap; i++) {
+	for (CzU32 i = 0; i < setCount; i++) {
 		descriptorSetLayouts[i] = descriptorSetLayout;
 	}
 
 	VkDescriptorSetAllocateInfo descriptorSetAllocInfo = {0};
 	descriptorSetAllocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
 	descriptorSetAllocInfo.descriptorPool = descriptorPool;
-	descriptorSetAllocInfo.descriptorSetCount = inoutsPerHeap;
+	descriptorSetAllocInfo.descriptorSetCount = setCount;
 	descriptorSetAllocInfo.pSetLayouts = descriptorSetLayouts;
 
 	VK_CALLR(vkAllocateDescriptorSets, device, &descriptorSetAllocInfo, descriptorSets);
 	if CZ_NOEXPECT (vkres) { dyrecord_destroy(localRecord); return false; }
 
 	// Write to each descriptor set
-	allocCount = inoutsPerHeap;
+	allocCount = setCount;
 	allocSize = sizeof(VkWriteDescriptorSet);
 
 	VkWriteDescriptorSet* writeDescriptorSets = dyrecord_calloc(localRecord, allocCount, allocSize);
 	if CZ_NOEXPECT (!writeDescriptorSets) { dyrecord_destroy(localRecord); return false; }
 
-	allocCount = inoutsPerHeap;
-	allocSize = sizeof(VkDescriptorBufferInfo[2]);
+	allocCount = setCount;
+	allocSize = sizeof(VkDescriptorBufferInfo[4]);
 
-	VkDescriptorBufferInfo (*descriptorBufferInfos)[2] = dyrecord_calloc(localRecord, allocCount, allocSize);
+	VkDescriptorBufferInfo (*descriptorBufferInfos)[4] = dyrecord_calloc(localRecord, allocCount, allocSize);
 	if CZ_NOEXPECT (!descriptorBufferInfos) { dyrecord_destroy(localRecord); return false; }
 
+	// Each dispatch of an inout-buffer sees only its own slice of the in-buffer and out-buffer
 	for (CzU32 i = 0, j = 0; i < buffersPerHeap; i++) {
-		for (CzU32 k = 0; k < inoutsPerBuffer; j++, k++) {
-			// Binding 0
-			descriptorBufferInfos[j][0].buffer = deviceLocalBuffers[i];
-			descriptorBufferInfos[j][0].offset = bytesPerInout * k;
-			descriptorBufferInfos[j][0].range = bytesPerIn;
-
-			// Binding 1
-			descriptorBufferInfos[j][1].buffer = deviceLocalBuffers[i];
-			descriptorBufferInfos[j][1].offset = bytesPerInout * k + bytesPerIn;
-			descriptorBufferInfos[j][1].range = bytesPerOut;
-
-			writeDescriptorSets[j].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-			writeDescriptorSets[j].dstSet = descriptorSets[j];
-			writeDescriptorSets[j].dstBinding = 0; // Start from this binding in the descriptor set
-			writeDescriptorSets[j].dstArrayElement = 0; // Start from this descriptor in the binding
-			writeDescriptorSets[j].descriptorCount = CZ_COUNTOF(descriptorBufferInfos[j]);
-			writeDescriptorSets[j].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
-			writeDescriptorSets[j].pBufferInfo = descriptorBufferInfos[j];
+		for (CzU32 k = 0; k < inoutsPerBuffer; k++) {
+			for (CzU32 d = 0; d < dispatchesPerInout; j++, d++) {
+				// Binding 0 (claim counter in continuous mode)
+				descriptorBufferInfos[j][0].buffer = deviceLocalBuffers[i];
+
+				if (czgConfig.continuous) {
+					descriptorBufferInfos[j][0].offset = bytesPerInout * k;
+					descriptorBufferInfos[j][0].range = bytesPerClaim;
+				}
+				else {
+					descriptorBufferInfos[j][0].offset = bytesPerInout * k + bytesPerDispatchIn * d;
+					descriptorBufferInfos[j][0].range = bytesPerDispatchIn;
+				}
+
+				// Binding 1 (record ring buffer in continuous mode)
+				if (czgConfig.continuous) {
+					descriptorBufferInfos[j][1].buffer = hostVisibleBuffers[i];
+					descriptorBufferInfos[j][1].offset = bytesPerInout * k;
+					descriptorBufferInfos[j][1].range = bytesPerRing;
+				}
+				else {
+					descriptorBufferInfos[j][1].buffer = deviceLocalBuffers[i];
+					descriptorBufferInfos[j][1].offset = bytesPerInout * k + bytesPerIn + bytesPerDispatchOut * d;
+					descriptorBufferInfos[j][1].range = bytesPerDispatchOut;
+				}
+
+				// Binding 2 (if not continuous)
+				descriptorBufferInfos[j][2].buffer = gpu->statsBuffer;
+				descriptorBufferInfos[j][2].offset = bytesPerSteps * j;
+				descriptorBufferInfos[j][2].range = bytesPerSteps;
+
+				// Binding 3 (if instrumenting), after the step counters of every dispatch
+				descriptorBufferInfos[j][3].buffer = gpu->statsBuffer;
+				descriptorBufferInfos[j][3].offset = bytesPerSteps * setCount + bytesPerStats * j;
+				descriptorBufferInfos[j][3].range = bytesPerStats;
+
+				writeDescriptorSets[j].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+				writeDescriptorSets[j].dstSet = descriptorSets[j];
+				writeDescriptorSets[j].dstBinding = 0; // Start from this binding in the descriptor set
+				writeDescriptorSets[j].dstArrayElement = 0; // Start from this descriptor in the binding
+				writeDescriptorSets[j].descriptorCount = bindingCount;
+				writeDescriptorSets[j].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+				writeDescriptorSets[j].pBufferInfo = descriptorBufferInfos[j];
+			}
 		}
 	}
 
-	CzU32 writeCount = inoutsPerHeap;
+	CzU32 writeCount = setCount;
 	CzU32 copyCount = 0;
 	VkCopyDescriptorSet* copyDescriptorSets = NULL;
 
@@ -1696,14 +2879,16 @@ bool create_descriptors(struct Gpu* restrict gpu)
 
 #if !defined(NDEBUG)
 	for (CzU32 i = 0, j = 0; i < buffersPerHeap; i++) {
-		for (CzU32 k = 0; k < inoutsPerBuffer; j++, k++) {
-			char objectName[58];
-			sprintf(
-				objectName,
-				"Inout %" PRIu32 "/%" PRIu32 ", Buffer %" PRIu32 "/%" PRIu32,
-				k + 1, inoutsPerBuffer, i + 1, buffersPerHeap);
-
-			set_debug_name(device, VK_OBJECT_TYPE_DESCRIPTOR_SET, (CzU64) descriptorSets[j], objectName);
+		for (CzU32 k = 0; k < inoutsPerBuffer; k++) {
+			for (CzU32 d = 0; d < dispatchesPerInout; j++, d++) {
+				char objectName[84];
+				sprintf(
+					objectName,
+					"Dispatch %" PRIu32 "/%" PRIu32 ", Inout %" PRIu32 "/%" PRIu32 ", Buffer %" PRIu32 "/%" PRIu32,
+					d + 1, dispatchesPerInout, k + 1, inoutsPerBuffer, i + 1, buffersPerHeap);
+
+				set_debug_name(device, VK_OBJECT_TYPE_DESCRIPTOR_SET, (CzU64) descriptorSets[j], objectName);
+			}
 		}
 	}
 #endif
@@ -1712,28 +2897,31 @@ bool create_descriptors(struct Gpu* restrict gpu)
 	return true;
 }
 
-bool create_pipeline(struct Gpu* restrict gpu)
+// Load the SPIR-V of the shader variant given by the shader features in use
+static bool load_shader(
+	const struct Gpu* restrict gpu,
+	DyRecord record,
+	char* restrict shaderName,
+	char* restrict entryPointName,
+	const CzU32** restrict code,
+	size_t* restrict size)
 {
-	const VkAllocationCallbacks* allocator = gpu->allocator;
-
-	VkDevice device = gpu->device;
-	VkDescriptorSetLayout descriptorSetLayout = gpu->descriptorSetLayout;
-
-	CzU32 inoutsPerHeap = gpu->inoutsPerHeap;
-	CzU32 workgroupSize = gpu->workgroupSize;
-
-	CzU32 computeFamilyTimestampValidBits = gpu->computeFamilyTimestampValidBits;
-	CzU32 transferFamilyTimestampValidBits = gpu->transferFamilyTimestampValidBits;
-
 	CzU32 spvVerMajor = gpu->spvVerMajor;
 	CzU32 spvVerMinor = gpu->spvVerMinor;
 
-	VkResult vkres;
+	if (czgConfig.jit) {
+		// Runtime compilations contain only the selected variant, under the source entry point
+		strcpy(shaderName, "(runtime compilation)");
+		strcpy(entryPointName, "main");
 
-	DyRecord localRecord = dyrecord_create();
-	if CZ_NOEXPECT (!localRecord) { return false; }
+		CzU32* jitCode;
+		bool bres = jit_shader(gpu, record, &jitCode, size);
+		if CZ_NOEXPECT (!bres) { return false; }
+
+		*code = jitCode;
+		return true;
+	}
 
-	char shaderName[52];
 	sprintf(
 		shaderName,
 		"./v%" PRIu32 "%" PRIu32 "/spirv%s%s%s.spv",
@@ -1748,15 +2936,23 @@ bool create_pipeline(struct Gpu* restrict gpu)
 	 * "The representation and endianness of [integers] on the host must match the representation and endianness of
 	 * [integers] on every physical device supported."
 	 */
-	char entryPointName[37];
 	enum CzEndianness endianness = get_endianness();
-
-	sprintf(entryPointName, "main-%u-%lu", endianness, czgConfig.iterSize);
-
-	if (czgConfig.outputLevel > CZ_OUTPUT_LEVEL_QUIET) {
-		printf("Selected shader: %s\nSelected entry point: %s\n\n", shaderName, entryPointName);
+	const char* variant = czgConfig.continuous ? "cont" : gpu->instrumenting ? "inst" : "main";
+	sprintf(entryPointName, "%s-%u-%lu", variant, endianness, czgConfig.iterSize);
+
+#if CZ_EMBED_SHADERS
+	// Embedded shaders are used in place, so selecting one does no file IO
+	for (size_t i = 0; i < czgEmbeddedShaderCount; i++) {
+		if (!strcmp(czgEmbeddedShaders[i].name, shaderName)) {
+			*code = czgEmbeddedShaders[i].code;
+			*size = czgEmbeddedShaders[i].size;
+			return true;
+		}
 	}
 
+	log_error(stderr, "Selected shader '%s' not embedded", shaderName);
+	return false;
+#else
 	size_t shaderSize;
 	struct CzFileFlags shaderFileFlags = {0};
 	shaderFileFlags.relativeToExe = true;
@@ -1766,75 +2962,367 @@ bool create_pipeline(struct Gpu* restrict gpu)
 		if (czres == CZ_RESULT_NO_FILE) {
 			log_error(stderr, "Selected shader '%s' not found", shaderName);
 		}
-		dyrecord_destroy(localRecord);
 		return false;
 	}
 
-	CzU32* shaderCode = dyrecord_malloc(localRecord, shaderSize);
-	if CZ_NOEXPECT (!shaderCode) { dyrecord_destroy(localRecord); return false; }
+	CzU32* shaderCode = dyrecord_malloc(record, shaderSize);
+	if CZ_NOEXPECT (!shaderCode) { return false; }
 
 	size_t shaderOffset = 0;
 	czres = czReadFile(shaderName, shaderCode, shaderSize, shaderOffset, shaderFileFlags);
-	if CZ_NOEXPECT (czres) { dyrecord_destroy(localRecord); return false; }
+	if CZ_NOEXPECT (czres) { return false; }
+
+	*code = shaderCode;
+	*size = shaderSize;
+	return true;
+#endif
+}
+
+static bool record_benchmark_cmdbuffer(
+	VkCommandBuffer cmdBuffer,
+	VkPipeline pipeline,
+	const VkBindDescriptorSetsInfo* bindDescriptorSetsInfo,
+	const VkPushConstantsInfo* pushConstantsInfo,
+	const VkCopyBufferInfo2* inBufferCopyInfo,
+	const VkDependencyInfo* dependencyInfo,
+	VkQueryPool queryPool,
+	CzU32 workgroupCount)
+{
+	VkResult vkres;
+
+	VkCommandBufferBeginInfo beginInfo = {0};
+	beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+
+	VK_CALLR(vkBeginCommandBuffer, cmdBuffer, &beginInfo);
+	if CZ_NOEXPECT (vkres) { return false; }
+
+	CzU32 firstQuery = 0;
+	CzU32 queryCount = 2;
+	VK_CALL(vkCmdResetQueryPool, cmdBuffer, queryPool, firstQuery, queryCount);
+
+	// Reset claim counter in continuous mode, else copy starting values to device local memory
+	if (czgConfig.continuous) {
+		VkBuffer claimBuffer = dependencyInfo->pBufferMemoryBarriers[0].buffer;
+		VkDeviceSize claimOffset = dependencyInfo->pBufferMemoryBarriers[0].offset;
+		VkDeviceSize claimSize = dependencyInfo->pBufferMemoryBarriers[0].size;
+
+		VK_CALL(vkCmdFillBuffer, cmdBuffer, claimBuffer, claimOffset, claimSize, 0);
+	}
+	else {
+		VK_CALL(vkCmdCopyBuffer2KHR, cmdBuffer, inBufferCopyInfo);
+	}
+
+	VK_CALL(vkCmdPipelineBarrier2KHR, cmdBuffer, dependencyInfo);
+	VK_CALL(vkCmdBindDescriptorSets2KHR, cmdBuffer, bindDescriptorSetsInfo);
+
+	VK_CALL(vkCmdPushConstants2KHR, cmdBuffer, pushConstantsInfo);
+
+	VkPipelineBindPoint bindPoint = VK_PIPELINE_BIND_POINT_COMPUTE;
+	VK_CALL(vkCmdBindPipeline, cmdBuffer, bindPoint, pipeline);
+
+	VkPipelineStageFlags2 stage = VK_PIPELINE_STAGE_2_NONE;
+	CzU32 query = firstQuery;
+
+	VK_CALL(vkCmdWriteTimestamp2KHR, cmdBuffer, stage, queryPool, query);
+
+	CzU32 workgroupCountX = workgroupCount;
+	CzU32 workgroupCountY = 1;
+	CzU32 workgroupCountZ = 1;
+
+	VK_CALL(vkCmdDispatch, cmdBuffer, workgroupCountX, workgroupCountY, workgroupCountZ);
+
+	stage = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+	query = firstQuery + 1;
+
+	VK_CALL(vkCmdWriteTimestamp2KHR, cmdBuffer, stage, queryPool, query);
+
+	VK_CALLR(vkEndCommandBuffer, cmdBuffer);
+	if CZ_NOEXPECT (vkres) { return false; }
+
+	return true;
+}
+
+// Get the number of ticks between a pair of timestamps, which wrap after validBits bits
+static CzU64 get_timestamp_ticks(const CzU64* timestamps, CzU32 validBits)
+{
+	CzU64 mask = validBits < 64 ? (UINT64_C(1) << validBits) - 1 : UINT64_MAX;
+	return (timestamps[1] - timestamps[0]) & mask;
+}
+
+// Entry of the variant cache file, which holds one entry per device, iteration size, and mode
+struct VariantCacheEntry
+{
+	CzU8 deviceUuid[VK_UUID_SIZE];
+	CzU32 driverVersion;
+	CzU32 iterSize;
+
+	CzU8 mode; // 0 for the main shader, 1 for the continuous shader, or 2 for the instrumented shader.
+	CzU8 using16BitStorage;
+	CzU8 usingShaderInt16;
+	CzU8 usingShaderInt64;
+};
+
+bool select_variant(struct Gpu* restrict gpu)
+{
+	const VkAllocationCallbacks* allocator = gpu->allocator;
+	const VkBuffer* hostVisibleBuffers = gpu->hostVisibleBuffers;
+	const VkBuffer* deviceLocalBuffers = gpu->deviceLocalBuffers;
+	const VkDeviceMemory* hostVisibleMemories = gpu->hostVisibleDeviceMemories;
+	const VkDescriptorSet* descriptorSets = gpu->descriptorSets;
+
+	CzU128* const* mappedInBuffers = gpu->mappedInBuffers;
+
+	VkPhysicalDevice physicalDevice = gpu->physicalDevice;
+	VkDevice device = gpu->device;
+	VkQueue computeQueue = gpu->computeQueue;
+	VkDescriptorSetLayout descriptorSetLayout = gpu->descriptorSetLayout;
+
+	VkDeviceSize bytesPerIn = gpu->bytesPerIn;
+	VkDeviceSize bytesPerClaim = gpu->bytesPerClaim;
+
+	CzU64 valuesPerInout = gpu->valuesPerInout;
+	CzU64 valuesPerHeap = gpu->valuesPerHeap;
+	CzU32 workgroupSize = gpu->workgroupSize;
+	CzU32 workgroupCount = gpu->workgroupCount;
+	CzU32 subgroupSize = gpu->subgroupSize;
+	CzU32 computeFamilyIndex = gpu->computeFamilyIndex;
+
+	bool hostNonCoherent = gpu->hostNonCoherent;
+	bool has16BitStorage = gpu->using16BitStorage;
+	bool hasShaderInt16 = gpu->usingShaderInt16;
+	bool hasShaderInt64 = gpu->usingShaderInt64;
+
+	VkResult vkres;
+
+	DyRecord localRecord = dyrecord_create();
+	if CZ_NOEXPECT (!localRecord) { return false; }
+
+	// Cached selections are keyed by device and driver version, and the instrumented shader is selected separately
+	struct VariantCacheEntry entry = {0};
+	get_device_id(physicalDevice, entry.deviceUuid, &entry.driverVersion);
+	entry.iterSize = (CzU32) czgConfig.iterSize;
+	entry.mode = czgConfig.continuous ? 1 : gpu->instrumenting ? 2 : 0;
 
 	size_t cacheSize = 0;
 	struct CzFileFlags cacheFileFlags = {0};
 	cacheFileFlags.relativeToExe = true;
 
-	czres = czFileSize(CZ_PIPELINE_CACHE_NAME, &cacheSize, cacheFileFlags);
+	enum CzResult czres = czFileSize(CZ_VARIANT_CACHE_NAME, &cacheSize, cacheFileFlags);
 	if CZ_NOEXPECT (czres && czres != CZ_RESULT_NO_FILE) { dyrecord_destroy(localRecord); return false; }
 
-	void* cacheData = NULL;
-	if (cacheSize) {
-		cacheData = dyrecord_malloc(localRecord, cacheSize);
-		if CZ_NOEXPECT (!cacheData) { dyrecord_destroy(localRecord); return false; }
+	size_t entryCount = cacheSize / sizeof(struct VariantCacheEntry);
+	size_t entryOffset = CZ_EOF;
+
+	if (entryCount) {
+		struct VariantCacheEntry* cacheEntries = dyrecord_calloc(localRecord, entryCount, sizeof(*cacheEntries));
+		if CZ_NOEXPECT (!cacheEntries) { dyrecord_destroy(localRecord); return false; }
 
 		size_t cacheOffset = 0;
-		czres = czReadFile(CZ_PIPELINE_CACHE_NAME, cacheData, cacheSize, cacheOffset, cacheFileFlags);
+		czres = czReadFile(
+			CZ_VARIANT_CACHE_NAME, cacheEntries, entryCount * sizeof(*cacheEntries), cacheOffset, cacheFileFlags);
+
 		if CZ_NOEXPECT (czres) { dyrecord_destroy(localRecord); return false; }
-	}
 
-	VkShaderModuleCreateInfo shaderInfo = {0};
-	shaderInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
-	shaderInfo.codeSize = shaderSize;
-	shaderInfo.pCode = shaderCode;
+		for (size_t i = 0; i < entryCount; i++) {
+			const struct VariantCacheEntry* cacheEntry = &cacheEntries[i];
 
-	VkShaderModule shader = VK_NULL_HANDLE;
-	if (!gpu->usingMaintenance5) {
-		VK_CALLR(vkCreateShaderModule, device, &shaderInfo, allocator, &shader);
-		if CZ_NOEXPECT (vkres) { dyrecord_destroy(localRecord); return false; }
-		gpu->shaderModule = shader;
+			bool sameKey = !memcmp(cacheEntry->deviceUuid, entry.deviceUuid, sizeof(entry.deviceUuid)) &&
+				cacheEntry->iterSize == entry.iterSize && cacheEntry->mode == entry.mode;
+
+			if (!sameKey) {
+				continue;
+			}
+
+			// Selections made on an older driver may no longer be the fastest, so benchmark again
+			bool sameDriver = cacheEntry->driverVersion == entry.driverVersion;
+			bool compatible = (has16BitStorage || !cacheEntry->using16BitStorage) &&
+				(hasShaderInt16 || !cacheEntry->usingShaderInt16) && (hasShaderInt64 || !cacheEntry->usingShaderInt64);
+
+			if (sameDriver && compatible) {
+				gpu->using16BitStorage = cacheEntry->using16BitStorage;
+				gpu->usingShaderInt16 = cacheEntry->usingShaderInt16;
+				gpu->usingShaderInt64 = cacheEntry->usingShaderInt64;
+
+				if (czgConfig.outputLevel > CZ_OUTPUT_LEVEL_QUIET) {
+					printf(
+						"Cached shader variant: sto16 %d, int16 %d, int64 %d\n\n",
+						gpu->using16BitStorage, gpu->usingShaderInt16, gpu->usingShaderInt64);
+				}
+
+				dyrecord_destroy(localRecord);
+				return true;
+			}
+
+			entryOffset = i * sizeof(struct VariantCacheEntry);
+			break;
+		}
 	}
 
-	VkPipelineCacheCreateFlags cacheFlags = 0;
-	if (gpu->usingPipelineCreationCacheControl) {
-		cacheFlags |= VK_PIPELINE_CACHE_CREATE_EXTERNALLY_SYNCHRONIZED_BIT;
+	// Benchmarks require timestamps on the compute queue family
+	CzU32 familyCount;
+	VK_CALL(vkGetPhysicalDeviceQueueFamilyProperties, physicalDevice, &familyCount, NULL);
+
+	size_t allocSize = familyCount * sizeof(VkQueueFamilyProperties);
+	VkQueueFamilyProperties* familiesProperties = dyrecord_malloc(localRecord, allocSize);
+	if CZ_NOEXPECT (!familiesProperties) { dyrecord_destroy(localRecord); return false; }
+
+	VK_CALL(vkGetPhysicalDeviceQueueFamilyProperties, physicalDevice, &familyCount, familiesProperties);
+
+	VkPhysicalDeviceProperties deviceProperties;
+	VK_CALL(vkGetPhysicalDeviceProperties, physicalDevice, &deviceProperties);
+
+	CzU32 timestampValidBits = familiesProperties[computeFamilyIndex].timestampValidBits;
+	double timestampPeriod = (double) deviceProperties.limits.timestampPeriod;
+
+	if (!timestampValidBits) {
+		log_warning(stdout, "Compute queue family does not support timestamps; using default shader variant");
+		dyrecord_destroy(localRecord);
+		return true;
 	}
 
-	VkPipelineCacheCreateInfo cacheInfo = {0};
-	cacheInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
-	cacheInfo.flags = cacheFlags;
-	cacheInfo.initialDataSize = cacheSize;
-	cacheInfo.pInitialData = cacheData;
+	// Create temporary objects for benchmarking
+	VkCommandPoolCreateInfo cmdPoolInfo = {0};
+	cmdPoolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+	cmdPoolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+	cmdPoolInfo.queueFamilyIndex = computeFamilyIndex;
+
+	VkCommandPool cmdPool;
+	VK_CALLR(vkCreateCommandPool, device, &cmdPoolInfo, allocator, &cmdPool);
+	if CZ_NOEXPECT (vkres) { dyrecord_destroy(localRecord); return false; }
+	gpu->computeCmdPool = cmdPool;
+
+	VkCommandBufferAllocateInfo cmdBufferAllocInfo = {0};
+	cmdBufferAllocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+	cmdBufferAllocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+	cmdBufferAllocInfo.commandPool = cmdPool;
+	cmdBufferAllocInfo.commandBufferCount = 1;
 
-	VkPipelineCache cache;
-	VK_CALLR(vkCreatePipelineCache, device, &cacheInfo, allocator, &cache);
+	VkCommandBuffer cmdBuffer;
+	VK_CALLR(vkAllocateCommandBuffers, device, &cmdBufferAllocInfo, &cmdBuffer);
 	if CZ_NOEXPECT (vkres) { dyrecord_destroy(localRecord); return false; }
-	gpu->pipelineCache = cache;
+
+	VkQueryPoolCreateInfo queryPoolInfo = {0};
+	queryPoolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+	queryPoolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+	queryPoolInfo.queryCount = 2;
+
+	VkQueryPool queryPool;
+	VK_CALLR(vkCreateQueryPool, device, &queryPoolInfo, allocator, &queryPool);
+	if CZ_NOEXPECT (vkres) { dyrecord_destroy(localRecord); return false; }
+	gpu->queryPool = queryPool;
 
 	VkDescriptorSetLayout descriptorSetLayouts[1];
 	descriptorSetLayouts[0] = descriptorSetLayout;
 
+	// Staging region of each dispatch, so the step counters of in-flight generations are kept apart
+	VkPushConstantRange pushConstantRanges[1];
+	pushConstantRanges[0].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+	pushConstantRanges[0].offset = 0;
+	pushConstantRanges[0].size = sizeof(CzU32);
+
 	VkPipelineLayoutCreateInfo pipelineLayoutInfo = {0};
 	pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
 	pipelineLayoutInfo.setLayoutCount = CZ_COUNTOF(descriptorSetLayouts);
 	pipelineLayoutInfo.pSetLayouts = descriptorSetLayouts;
+	pipelineLayoutInfo.pushConstantRangeCount = CZ_COUNTOF(pushConstantRanges);
+	pipelineLayoutInfo.pPushConstantRanges = pushConstantRanges;
 
 	VkPipelineLayout pipelineLayout;
 	VK_CALLR(vkCreatePipelineLayout, device, &pipelineLayoutInfo, allocator, &pipelineLayout);
 	if CZ_NOEXPECT (vkres) { dyrecord_destroy(localRecord); return false; }
 	gpu->pipelineLayout = pipelineLayout;
 
+	// Write the same starting values for each variant, so each benchmark performs identical work
+	CzU128 startValue = CZ_U128(1, 3);
+	CzU32 dispatchCount = workgroupCount;
+
+	VkBufferMemoryBarrier2 bufferMemoryBarrier = {0};
+	bufferMemoryBarrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2;
+	bufferMemoryBarrier.dstStageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+	bufferMemoryBarrier.buffer = deviceLocalBuffers[0];
+	bufferMemoryBarrier.offset = 0;
+
+	VkMappedMemoryRange inBufferMappedRange = {0};
+	inBufferMappedRange.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
+	inBufferMappedRange.memory = hostVisibleMemories[0];
+	inBufferMappedRange.offset = 0;
+
+	if (czgConfig.continuous) {
+		struct RingHeader* ringHeader = (struct RingHeader*) mappedInBuffers[0];
+		CzU16 bestStopTime = UINT16_MAX; // No candidates are appended
+		write_ringheader(ringHeader, &startValue, bestStopTime, workgroupCount, valuesPerHeap);
+
+		dispatchCount = (workgroupCount + CZ_CHUNKS_PER_WORKGROUP - 1) / CZ_CHUNKS_PER_WORKGROUP;
+
+		bufferMemoryBarrier.srcStageMask = VK_PIPELINE_STAGE_2_CLEAR_BIT;
+		bufferMemoryBarrier.srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+		bufferMemoryBarrier.dstAccessMask = VK_ACCESS_2_SHADER_STORAGE_READ_BIT | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT;
+		bufferMemoryBarrier.size = bytesPerClaim;
+
+		inBufferMappedRange.size = sizeof(struct RingHeader);
+	}
+	else {
+		write_inbuffer(mappedInBuffers[0], &startValue, valuesPerInout, valuesPerHeap);
+
+		bufferMemoryBarrier.srcStageMask = VK_PIPELINE_STAGE_2_COPY_BIT;
+		bufferMemoryBarrier.srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+		bufferMemoryBarrier.dstAccessMask = VK_ACCESS_2_SHADER_STORAGE_READ_BIT;
+		bufferMemoryBarrier.size = bytesPerIn;
+
+		inBufferMappedRange.size = bytesPerIn;
+	}
+
+	if (hostNonCoherent) {
+		CzU32 rangeCount = 1;
+		VK_CALLR(vkFlushMappedMemoryRanges, device, rangeCount, &inBufferMappedRange);
+		if CZ_NOEXPECT (vkres) { dyrecord_destroy(localRecord); return false; }
+	}
+
+	VkBufferCopy2 inBufferRegion = {0};
+	inBufferRegion.sType = VK_STRUCTURE_TYPE_BUFFER_COPY_2;
+	inBufferRegion.srcOffset = 0;
+	inBufferRegion.dstOffset = 0;
+	inBufferRegion.size = bytesPerIn;
+
+	VkCopyBufferInfo2 inBufferCopyInfo = {0};
+	inBufferCopyInfo.sType = VK_STRUCTURE_TYPE_COPY_BUFFER_INFO_2;
+	inBufferCopyInfo.srcBuffer = hostVisibleBuffers[0];
+	inBufferCopyInfo.dstBuffer = deviceLocalBuffers[0];
+	inBufferCopyInfo.regionCount = 1;
+	inBufferCopyInfo.pRegions = &inBufferRegion;
+
+	VkDependencyInfo dependencyInfo = {0};
+	dependencyInfo.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+	dependencyInfo.bufferMemoryBarrierCount = 1;
+	dependencyInfo.pBufferMemoryBarriers = &bufferMemoryBarrier;
+
+	VkBindDescriptorSetsInfo bindDescriptorSetsInfo = {0};
+	bindDescriptorSetsInfo.sType = VK_STRUCTURE_TYPE_BIND_DESCRIPTOR_SETS_INFO;
+	bindDescriptorSetsInfo.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+	bindDescriptorSetsInfo.layout = pipelineLayout;
+	bindDescriptorSetsInfo.firstSet = 0;
+	bindDescriptorSetsInfo.descriptorSetCount = 1;
+	bindDescriptorSetsInfo.pDescriptorSets = &descriptorSets[0];
+
+	CzU32 pushConstants[1] = {0}; // Staging region
+
+	VkPushConstantsInfo pushConstantsInfo = {0};
+	pushConstantsInfo.sType = VK_STRUCTURE_TYPE_PUSH_CONSTANTS_INFO;
+	pushConstantsInfo.layout = pipelineLayout;
+	pushConstantsInfo.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+	pushConstantsInfo.offset = 0;
+	pushConstantsInfo.size = sizeof(pushConstants);
+	pushConstantsInfo.pValues = pushConstants;
+
+	VkCommandBufferSubmitInfo cmdBufferSubmitInfo = {0};
+	cmdBufferSubmitInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO;
+	cmdBufferSubmitInfo.commandBuffer = cmdBuffer;
+
+	VkSubmitInfo2 submitInfo = {0};
+	submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO_2;
+	submitInfo.commandBufferInfoCount = 1;
+	submitInfo.pCommandBufferInfos = &cmdBufferSubmitInfo;
+
 	CzU32 specialisationData[1];
 	specialisationData[0] = workgroupSize;
 
@@ -1849,663 +3337,3144 @@ bool create_pipeline(struct Gpu* restrict gpu)
 	specialisationInfo.dataSize = sizeof(specialisationData);
 	specialisationInfo.pData = specialisationData;
 
+	VkPipelineShaderStageRequiredSubgroupSizeCreateInfo requiredSubgroupSizeInfo = {0};
+	requiredSubgroupSizeInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_REQUIRED_SUBGROUP_SIZE_CREATE_INFO;
+	requiredSubgroupSizeInfo.requiredSubgroupSize = subgroupSize;
+
 	VkPipelineShaderStageCreateFlags shaderStageFlags = 0;
-	if (gpu->usingSubgroupSizeControl) {
+	if (gpu->usingSubgroupSizeControl && !subgroupSize) {
 		shaderStageFlags |= VK_PIPELINE_SHADER_STAGE_CREATE_ALLOW_VARYING_SUBGROUP_SIZE_BIT_EXT;
 	}
 
-	VkPipelineShaderStageCreateInfo shaderStageInfo = {0};
-	shaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
-	shaderStageInfo.pNext = gpu->usingMaintenance5 ? &shaderInfo : NULL;
-	shaderStageInfo.flags = shaderStageFlags;
-	shaderStageInfo.stage = VK_SHADER_STAGE_COMPUTE_BIT;
-	shaderStageInfo.module = shader;
-	shaderStageInfo.pName = entryPointName;
-	shaderStageInfo.pSpecializationInfo = &specialisationInfo;
+	double bestTime = DBL_MAX;
+	CzU32 bestVariant = 0;
 
-	VkPipelineCreateFlags pipelineFlags = 0;
-	if (gpu->usingPipelineExecutableProperties) {
-		pipelineFlags |= VK_PIPELINE_CREATE_CAPTURE_STATISTICS_BIT_KHR;
-		pipelineFlags |= VK_PIPELINE_CREATE_CAPTURE_INTERNAL_REPRESENTATIONS_BIT_KHR;
-	}
+	// Bits 0, 1, and 2 of each variant select 16-bit storage, 16-bit integers, and 64-bit integers respectively
+	for (CzU32 variant = 0; variant < 8; variant++) {
+		bool variant16BitStorage = variant & 1;
+		bool variantShaderInt16 = variant & 2;
+		bool variantShaderInt64 = variant & 4;
 
-	VkComputePipelineCreateInfo pipelineInfos[1] = {0};
-	pipelineInfos[0].sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
-	pipelineInfos[0].flags = pipelineFlags;
-	pipelineInfos[0].stage = shaderStageInfo;
-	pipelineInfos[0].layout = pipelineLayout;
+		if (variant16BitStorage && !has16BitStorage) { continue; }
+		if (variantShaderInt16 && !hasShaderInt16) { continue; }
+		if (variantShaderInt64 && !hasShaderInt64) { continue; }
 
-	VkPipeline pipeline;
-	VK_CALLR(vkCreateComputePipelines, device, cache, CZ_COUNTOF(pipelineInfos), pipelineInfos, allocator, &pipeline);
-	if CZ_NOEXPECT (vkres) { dyrecord_destroy(localRecord); return false; }
-	gpu->pipeline = pipeline;
+		gpu->using16BitStorage = variant16BitStorage;
+		gpu->usingShaderInt16 = variantShaderInt16;
+		gpu->usingShaderInt64 = variantShaderInt64;
 
-	bool bres = save_pipeline_cache(device, cache, CZ_PIPELINE_CACHE_NAME);
-	if CZ_NOEXPECT (!bres) { dyrecord_destroy(localRecord); return false; }
+		DyRecord variantRecord = dyrecord_create();
+		if CZ_NOEXPECT (!variantRecord) { dyrecord_destroy(localRecord); return false; }
 
-	if (computeFamilyTimestampValidBits || transferFamilyTimestampValidBits) {
-		VkQueryPoolCreateInfo queryPoolInfo = {0};
-		queryPoolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
-		queryPoolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
-		queryPoolInfo.queryCount = inoutsPerHeap * 4; // Two per copy, two per dispatch
+		char shaderName[52];
+		char entryPointName[37];
+		size_t shaderSize;
+		const CzU32* shaderCode;
 
-		VkQueryPool queryPool;
-		VK_CALLR(vkCreateQueryPool, device, &queryPoolInfo, allocator, &queryPool);
-		if CZ_NOEXPECT (vkres) { dyrecord_destroy(localRecord); return false; }
-		gpu->queryPool = queryPool;
-	}
+		bool bres = load_shader(gpu, variantRecord, shaderName, entryPointName, &shaderCode, &shaderSize);
+		if CZ_NOEXPECT (!bres) { dyrecord_destroy(variantRecord); dyrecord_destroy(localRecord); return false; }
 
-	if (gpu->usingPipelineExecutableProperties) {
-		bres = capture_pipeline(device, pipeline);
-		if CZ_NOEXPECT (!bres) { dyrecord_destroy(localRecord); return false; }
+		VkShaderModuleCreateInfo shaderInfo = {0};
+		shaderInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+		shaderInfo.codeSize = shaderSize;
+		shaderInfo.pCode = shaderCode;
+
+		VkShaderModule shader = VK_NULL_HANDLE;
+		if (!gpu->usingMaintenance5) {
+			VK_CALLR(vkCreateShaderModule, device, &shaderInfo, allocator, &shader);
+			if CZ_NOEXPECT (vkres) { dyrecord_destroy(variantRecord); dyrecord_destroy(localRecord); return false; }
+			gpu->shaderModule = shader;
+		}
+
+		requiredSubgroupSizeInfo.pNext = gpu->usingMaintenance5 ? &shaderInfo : NULL;
+
+		VkPipelineShaderStageCreateInfo shaderStageInfo = {0};
+		shaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+		shaderStageInfo.pNext = subgroupSize ? &requiredSubgroupSizeInfo : requiredSubgroupSizeInfo.pNext;
+		shaderStageInfo.flags = shaderStageFlags;
+		shaderStageInfo.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+		shaderStageInfo.module = shader;
+		shaderStageInfo.pName = entryPointName;
+		shaderStageInfo.pSpecializationInfo = &specialisationInfo;
+
+		VkComputePipelineCreateInfo pipelineInfos[1] = {0};
+		pipelineInfos[0].sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+		pipelineInfos[0].stage = shaderStageInfo;
+		pipelineInfos[0].layout = pipelineLayout;
+
+		VkPipeline pipeline;
+		VK_CALLR(vkCreateComputePipelines,
+			device, VK_NULL_HANDLE, CZ_COUNTOF(pipelineInfos), pipelineInfos, allocator, &pipeline);
+
+		if CZ_NOEXPECT (vkres) { dyrecord_destroy(variantRecord); dyrecord_destroy(localRecord); return false; }
+		gpu->pipeline = pipeline;
+
+		dyrecord_destroy(variantRecord);
+
+		VkCommandPoolResetFlags cmdPoolResetFlags = 0;
+		VK_CALLR(vkResetCommandPool, device, cmdPool, cmdPoolResetFlags);
+		if CZ_NOEXPECT (vkres) { dyrecord_destroy(localRecord); return false; }
+
+		bres = record_benchmark_cmdbuffer(
+			cmdBuffer, pipeline, &bindDescriptorSetsInfo, &pushConstantsInfo, &inBufferCopyInfo, &dependencyInfo,
+			queryPool, dispatchCount);
+
+		if CZ_NOEXPECT (!bres) { dyrecord_destroy(localRecord); return false; }
+
+		// Submit once to warm up caches and clocks, then again for the timed run
+		for (CzU32 i = 0; i < 2; i++) {
+			CzU32 submitInfoCount = 1;
+			VK_CALLR(vkQueueSubmit2KHR, computeQueue, submitInfoCount, &submitInfo, VK_NULL_HANDLE);
+			if CZ_NOEXPECT (vkres) { dyrecord_destroy(localRecord); return false; }
+
+			VK_CALLR(vkQueueWaitIdle, computeQueue);
+			if CZ_NOEXPECT (vkres) { dyrecord_destroy(localRecord); return false; }
+		}
+
+		CzU32 firstQuery = 0;
+		CzU32 queryCount = 2;
+		VkQueryResultFlags queryFlags = VK_QUERY_RESULT_64_BIT;
+
+		CzU64 timestamps[2];
+		VK_CALLR(vkGetQueryPoolResults,
+			device, queryPool, firstQuery, queryCount, sizeof(timestamps), timestamps, sizeof(timestamps[0]),
+			queryFlags);
+
+		if CZ_NOEXPECT (vkres) { dyrecord_destroy(localRecord); return false; }
+		CzU64 ticks = get_timestamp_ticks(timestamps, timestampValidBits);
+		double variantTime = (double) ticks * timestampPeriod / 1000000;
+
+		if (czgConfig.outputLevel > CZ_OUTPUT_LEVEL_DEFAULT) {
+			printf(
+				"Shader variant (sto16 %d, int16 %d, int64 %d): %.3fms\n",
+				variant16BitStorage, variantShaderInt16, variantShaderInt64, variantTime);
+		}
+
+		if (variantTime < bestTime) {
+			bestTime = variantTime;
+			bestVariant = variant;
+		}
+
+		VK_CALL(vkDestroyPipeline, device, pipeline, allocator);
+		gpu->pipeline = VK_NULL_HANDLE;
+
+		if (!gpu->usingMaintenance5) {
+			VK_CALL(vkDestroyShaderModule, device, shader, allocator);
+			gpu->shaderModule = VK_NULL_HANDLE;
+		}
 	}
 
-	VK_CALL(vkDestroyDescriptorSetLayout, device, descriptorSetLayout, allocator);
-	gpu->descriptorSetLayout = VK_NULL_HANDLE;
+	VK_CALL(vkDestroyPipelineLayout, device, pipelineLayout, allocator);
+	gpu->pipelineLayout = VK_NULL_HANDLE;
+
+	VK_CALL(vkDestroyQueryPool, device, queryPool, allocator);
+	gpu->queryPool = VK_NULL_HANDLE;
 
-	VK_CALL(vkDestroyPipelineCache, device, cache, allocator);
-	gpu->pipelineCache = VK_NULL_HANDLE;
+	VK_CALL(vkDestroyCommandPool, device, cmdPool, allocator);
+	gpu->computeCmdPool = VK_NULL_HANDLE;
 
-	if (!gpu->usingMaintenance5) {
-		VK_CALL(vkDestroyShaderModule, device, shader, allocator);
-		gpu->shaderModule = VK_NULL_HANDLE;
+	gpu->using16BitStorage = bestVariant & 1;
+	gpu->usingShaderInt16 = bestVariant & 2;
+	gpu->usingShaderInt64 = bestVariant & 4;
+
+	entry.using16BitStorage = gpu->using16BitStorage;
+	entry.usingShaderInt16 = gpu->usingShaderInt16;
+	entry.usingShaderInt64 = gpu->usingShaderInt64;
+
+	czres = czWriteFile(CZ_VARIANT_CACHE_NAME, &entry, sizeof(entry), entryOffset, cacheFileFlags);
+	if CZ_NOEXPECT (czres) { dyrecord_destroy(localRecord); return false; }
+
+	if (czgConfig.outputLevel > CZ_OUTPUT_LEVEL_QUIET) {
+		printf(
+			"Selected shader variant: sto16 %d, int16 %d, int64 %d (%.3fms)\n\n",
+			gpu->using16BitStorage, gpu->usingShaderInt16, gpu->usingShaderInt64, bestTime);
 	}
 
 	dyrecord_destroy(localRecord);
 	return true;
 }
 
-static bool record_initial_cmdbuffer(
-	VkCommandBuffer cmdBuffer,
-	const VkCopyBufferInfo2* inBufferCopyInfos,
-	const VkDependencyInfo* dependencyInfo,
-	CzU32 buffersPerHeap)
+// Get the name of the file holding the pipeline cache or binaries for the device, driver, and shader variant in use
+static void get_pipeline_cache_name(
+	const struct Gpu* restrict gpu,
+	const VkPhysicalDeviceProperties* restrict properties,
+	const char* restrict prefix,
+	char* restrict name)
 {
-	VkResult vkres;
+	char cacheUuid[VK_UUID_SIZE * 2 + 1];
+	for (CzU32 i = 0; i < VK_UUID_SIZE; i++) {
+		sprintf(cacheUuid + i * 2, "%02" PRIx8, properties->pipelineCacheUUID[i]);
+	}
 
-	VkCommandBufferBeginInfo beginInfo = {0};
-	beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-	beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+	sprintf(
+		name,
+		"%s-%04" PRIx32 "-%04" PRIx32 "-%s-v%" PRIu32 "%" PRIu32 "%s%s%s%s-%s-%lu.bin",
+		prefix, properties->vendorID, properties->deviceID, cacheUuid,
+		gpu->spvVerMajor, gpu->spvVerMinor,
+		gpu->using16BitStorage ? "-sto16" : "",
+		gpu->usingShaderInt16  ? "-int16" : "",
+		gpu->usingShaderInt64  ? "-int64" : "",
+		czgConfig.jit          ? "-jit"   : "",
+		czgConfig.continuous ? "cont" : gpu->instrumenting ? "inst" : "main", czgConfig.iterSize);
+}
 
-	VK_CALLR(vkBeginCommandBuffer, cmdBuffer, &beginInfo);
-	if CZ_NOEXPECT (vkres) { return false; }
+// Check the header of pipeline cache data matches the device and driver, so a foreign or stale cache can be discarded
+static bool check_pipeline_cache(
+	const VkPhysicalDeviceProperties* restrict properties, const CzU8* restrict data, size_t size)
+{
+	if (size < sizeof(VkPipelineCacheHeaderVersionOne)) { return false; }
 
-	for (CzU32 i = 0; i < buffersPerHeap; i++) {
-		VK_CALL(vkCmdCopyBuffer2KHR, cmdBuffer, &inBufferCopyInfos[i]);
+	// The header fields are always little-endian, regardless of the endianness of the host
+	CzU32 fields[4];
+	for (CzU32 i = 0; i < CZ_COUNTOF(fields); i++) {
+		const CzU8* bytes = data + i * sizeof(CzU32);
+		fields[i] = (CzU32) bytes[0] | (CzU32) bytes[1] << 8 | (CzU32) bytes[2] << 16 | (CzU32) bytes[3] << 24;
 	}
 
-	VK_CALL(vkCmdPipelineBarrier2KHR, cmdBuffer, dependencyInfo);
+	CzU32 headerSize = fields[0];
+	CzU32 headerVersion = fields[1];
+	CzU32 vendorId = fields[2];
+	CzU32 deviceId = fields[3];
+	const CzU8* cacheUuid = data + sizeof(fields);
 
-	VK_CALLR(vkEndCommandBuffer, cmdBuffer);
-	if CZ_NOEXPECT (vkres) { return false; }
+	if (headerSize < sizeof(VkPipelineCacheHeaderVersionOne))  { return false; }
+	if (headerSize > size)                                     { return false; }
+	if (headerVersion != VK_PIPELINE_CACHE_HEADER_VERSION_ONE) { return false; }
+	if (vendorId != properties->vendorID)                      { return false; }
+	if (deviceId != properties->deviceID)                      { return false; }
 
-	return true;
+	return !memcmp(cacheUuid, properties->pipelineCacheUUID, VK_UUID_SIZE);
 }
 
-static bool record_transfer_cmdbuffer(
-	VkCommandBuffer cmdBuffer,
-	const VkCopyBufferInfo2* inBufferCopyInfo,
-	const VkCopyBufferInfo2* outBufferCopyInfo,
-	const VkDependencyInfo* dependencyInfos,
-	VkQueryPool queryPool,
-	CzU32 firstQuery,
-	CzU32 timestampValidBits)
+// Header of a pipeline binary file, followed by binaryCount pairs of PipelineBinaryEntry and binary data
+struct PipelineBinaryHeader
 {
-	VkResult vkres;
+	CzU8 globalKey[VK_MAX_PIPELINE_BINARY_KEY_SIZE_KHR];
+	CzU8 pipelineKey[VK_MAX_PIPELINE_BINARY_KEY_SIZE_KHR];
+	CzU32 globalKeySize;
+	CzU32 pipelineKeySize;
+	CzU32 binaryCount;
+	CzU32 reserved;
+};
+
+struct PipelineBinaryEntry
+{
+	CzU8 key[VK_MAX_PIPELINE_BINARY_KEY_SIZE_KHR];
+	CzU32 keySize;
+	CzU32 reserved;
+	CzU64 dataSize;
+};
+
+// Parse the pipeline binaries of a pipeline binary file, returning zero binaries if the file is stale or truncated
+static bool parse_pipeline_binaries(
+	DyRecord record,
+	const VkPipelineBinaryKeyKHR* restrict globalKey,
+	const VkPipelineBinaryKeyKHR* restrict pipelineKey,
+	CzU8* restrict data,
+	size_t size,
+	VkPipelineBinaryKeysAndDataKHR* restrict keysAndData)
+{
+	keysAndData->binaryCount = 0;
 
-	VkCommandBufferBeginInfo beginInfo = {0};
-	beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+	struct PipelineBinaryHeader header;
+	if (size < sizeof(header)) { return true; }
 
-	VK_CALLR(vkBeginCommandBuffer, cmdBuffer, &beginInfo);
-	if CZ_NOEXPECT (vkres) { return false; }
+	memcpy(&header, data, sizeof(header));
 
-	if (timestampValidBits) {
-		// TODO Remove (vkCmdResetQueryPool not guaranteed to work on dedicated transfer queue families)
-		CzU32 queryCount = 2;
-		VK_CALL(vkCmdResetQueryPool, cmdBuffer, queryPool, firstQuery, queryCount);
+	if (header.globalKeySize != globalKey->keySize)     { return true; }
+	if (header.pipelineKeySize != pipelineKey->keySize) { return true; }
 
-		VkPipelineStageFlags2 stage = VK_PIPELINE_STAGE_2_NONE;
-		CzU32 query = firstQuery;
+	if (memcmp(header.globalKey, globalKey->key, globalKey->keySize))       { return true; }
+	if (memcmp(header.pipelineKey, pipelineKey->key, pipelineKey->keySize)) { return true; }
 
-		VK_CALL(vkCmdWriteTimestamp2KHR, cmdBuffer, stage, queryPool, query);
-	}
+	CzU32 binaryCount = header.binaryCount;
+	size_t offset = sizeof(header);
 
-	VK_CALL(vkCmdCopyBuffer2KHR, cmdBuffer, inBufferCopyInfo);
-	VK_CALL(vkCmdPipelineBarrier2KHR, cmdBuffer, &dependencyInfos[0]);
+	if (!binaryCount)                                                       { return true; }
+	if (binaryCount > (size - offset) / sizeof(struct PipelineBinaryEntry)) { return true; }
 
-	VK_CALL(vkCmdCopyBuffer2KHR, cmdBuffer, outBufferCopyInfo);
-	VK_CALL(vkCmdPipelineBarrier2KHR, cmdBuffer, &dependencyInfos[1]);
+	VkPipelineBinaryKeyKHR* binaryKeys = dyrecord_calloc(record, binaryCount, sizeof(VkPipelineBinaryKeyKHR));
+	if CZ_NOEXPECT (!binaryKeys) { return false; }
 
-	if (timestampValidBits) {
-		VkPipelineStageFlags2 stage = VK_PIPELINE_STAGE_2_COPY_BIT;
-		CzU32 query = firstQuery + 1;
+	VkPipelineBinaryDataKHR* binaryData = dyrecord_calloc(record, binaryCount, sizeof(VkPipelineBinaryDataKHR));
+	if CZ_NOEXPECT (!binaryData) { return false; }
 
-		VK_CALL(vkCmdWriteTimestamp2KHR, cmdBuffer, stage, queryPool, query);
-	}
+	for (CzU32 i = 0; i < binaryCount; i++) {
+		struct PipelineBinaryEntry entry;
+		if (size - offset < sizeof(entry)) { return true; }
 
-	VK_CALLR(vkEndCommandBuffer, cmdBuffer);
-	if CZ_NOEXPECT (vkres) { return false; }
+		memcpy(&entry, data + offset, sizeof(entry));
+		offset += sizeof(entry);
+
+		if (entry.keySize > VK_MAX_PIPELINE_BINARY_KEY_SIZE_KHR) { return true; }
+		if (entry.dataSize > size - offset)                      { return true; }
+
+		binaryKeys[i].sType = VK_STRUCTURE_TYPE_PIPELINE_BINARY_KEY_KHR;
+		binaryKeys[i].keySize = entry.keySize;
+		memcpy(binaryKeys[i].key, entry.key, entry.keySize);
 
+		binaryData[i].dataSize = (size_t) entry.dataSize;
+		binaryData[i].pData = data + offset;
+		offset += (size_t) entry.dataSize;
+	}
+
+	keysAndData->binaryCount = binaryCount;
+	keysAndData->pPipelineBinaryKeys = binaryKeys;
+	keysAndData->pPipelineBinaryData = binaryData;
 	return true;
 }
 
-static bool record_compute_cmdbuffer(
-	VkCommandBuffer cmdBuffer,
-	VkPipeline pipeline,
-	const VkBindDescriptorSetsInfo* bindDescriptorSetsInfo,
-	const VkDependencyInfo* dependencyInfos,
-	VkQueryPool queryPool,
-	CzU32 firstQuery,
-	CzU32 timestampValidBits,
-	CzU32 workgroupCount)
+// Save the pipeline binaries captured by a pipeline to a pipeline binary file
+static bool save_pipeline_binaries(
+	VkDevice device,
+	DyRecord record,
+	const VkPipelineBinaryKeyKHR* restrict globalKey,
+	const VkPipelineBinaryKeyKHR* restrict pipelineKey,
+	const VkPipelineBinaryKHR* restrict binaries,
+	CzU32 binaryCount,
+	const char* restrict filename)
 {
 	VkResult vkres;
 
-	VkCommandBufferBeginInfo beginInfo = {0};
-	beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+	size_t fileSize = sizeof(struct PipelineBinaryHeader);
 
-	VK_CALLR(vkBeginCommandBuffer, cmdBuffer, &beginInfo);
-	if CZ_NOEXPECT (vkres) { return false; }
+	for (CzU32 i = 0; i < binaryCount; i++) {
+		VkPipelineBinaryDataInfoKHR dataInfo = {0};
+		dataInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_BINARY_DATA_INFO_KHR;
+		dataInfo.pipelineBinary = binaries[i];
 
-	if (timestampValidBits) {
-		CzU32 queryCount = 2;
-		VK_CALL(vkCmdResetQueryPool, cmdBuffer, queryPool, firstQuery, queryCount);
+		VkPipelineBinaryKeyKHR binaryKey = {0};
+		binaryKey.sType = VK_STRUCTURE_TYPE_PIPELINE_BINARY_KEY_KHR;
 
-		VkPipelineStageFlags2 stage = VK_PIPELINE_STAGE_2_NONE;
-		CzU32 query = firstQuery;
+		size_t dataSize;
+		VK_CALLR(vkGetPipelineBinaryDataKHR, device, &dataInfo, &binaryKey, &dataSize, NULL);
+		if CZ_NOEXPECT (vkres) { return false; }
 
-		VK_CALL(vkCmdWriteTimestamp2KHR, cmdBuffer, stage, queryPool, query);
+		fileSize += sizeof(struct PipelineBinaryEntry) + dataSize;
 	}
 
-	VK_CALL(vkCmdPipelineBarrier2KHR, cmdBuffer, &dependencyInfos[0]);
-	VK_CALL(vkCmdBindDescriptorSets2KHR, cmdBuffer, bindDescriptorSetsInfo);
+	CzU8* fileData = dyrecord_malloc(record, fileSize);
+	if CZ_NOEXPECT (!fileData) { return false; }
 
-	VkPipelineBindPoint bindPoint = VK_PIPELINE_BIND_POINT_COMPUTE;
-	VK_CALL(vkCmdBindPipeline, cmdBuffer, bindPoint, pipeline);
+	struct PipelineBinaryHeader header = {0};
+	header.globalKeySize = globalKey->keySize;
+	header.pipelineKeySize = pipelineKey->keySize;
+	header.binaryCount = binaryCount;
 
-	CzU32 workgroupCountX = workgroupCount;
-	CzU32 workgroupCountY = 1;
-	CzU32 workgroupCountZ = 1;
+	memcpy(header.globalKey, globalKey->key, globalKey->keySize);
+	memcpy(header.pipelineKey, pipelineKey->key, pipelineKey->keySize);
+	memcpy(fileData, &header, sizeof(header));
 
-	// Use vkCmdDispatchBase if want to alter base value of workgroup index (first value of WorkgroupId)
-	VK_CALL(vkCmdDispatch, cmdBuffer, workgroupCountX, workgroupCountY, workgroupCountZ);
-	VK_CALL(vkCmdPipelineBarrier2KHR, cmdBuffer, &dependencyInfos[1]);
+	size_t offset = sizeof(header);
 
-	if (timestampValidBits) {
-		VkPipelineStageFlags2 stage = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
-		CzU32 query = firstQuery + 1;
+	for (CzU32 i = 0; i < binaryCount; i++) {
+		VkPipelineBinaryDataInfoKHR dataInfo = {0};
+		dataInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_BINARY_DATA_INFO_KHR;
+		dataInfo.pipelineBinary = binaries[i];
 
-		VK_CALL(vkCmdWriteTimestamp2KHR, cmdBuffer, stage, queryPool, query);
+		VkPipelineBinaryKeyKHR binaryKey = {0};
+		binaryKey.sType = VK_STRUCTURE_TYPE_PIPELINE_BINARY_KEY_KHR;
+
+		struct PipelineBinaryEntry entry = {0};
+		size_t dataSize = fileSize - offset - sizeof(entry);
+
+		void* binaryData = fileData + offset + sizeof(entry);
+
+		VK_CALLR(vkGetPipelineBinaryDataKHR, device, &dataInfo, &binaryKey, &dataSize, binaryData);
+		if CZ_NOEXPECT (vkres) { return false; }
+
+		entry.keySize = binaryKey.keySize;
+		entry.dataSize = dataSize;
+		memcpy(entry.key, binaryKey.key, binaryKey.keySize);
+		memcpy(fileData + offset, &entry, sizeof(entry));
+
+		offset += sizeof(entry) + dataSize;
 	}
 
-	VK_CALLR(vkEndCommandBuffer, cmdBuffer);
-	if CZ_NOEXPECT (vkres) { return false; }
+	bool bres = replace_file(filename, fileData, offset);
+	if CZ_NOEXPECT (!bres) { return false; }
 
 	return true;
 }
 
-bool create_commands(struct Gpu* restrict gpu)
+/*
+ * Create the compute pipeline from the pipeline binaries of a pipeline binary file. If the file has no usable binaries,
+ * compile the pipeline instead, and replace the file with the binaries captured from it.
+ */
+static bool create_binary_pipeline(
+	struct Gpu* restrict gpu,
+	DyRecord record,
+	const VkComputePipelineCreateInfo* restrict pipelineInfo,
+	const char* restrict filename,
+	CzU8* restrict data,
+	size_t size)
 {
-	DyRecord gpuRecord = gpu->allocRecord;
-
 	const VkAllocationCallbacks* allocator = gpu->allocator;
-	const VkBuffer* hostVisibleBuffers = gpu->hostVisibleBuffers;
-	const VkBuffer* deviceLocalBuffers = gpu->deviceLocalBuffers;
-	const VkDescriptorSet* descriptorSets  = gpu->descriptorSets;
 
 	VkDevice device = gpu->device;
-	VkPipelineLayout pipelineLayout = gpu->pipelineLayout;
-	VkPipeline pipeline = gpu->pipeline;
-	VkQueryPool queryPool = gpu->queryPool;
 
-	VkDeviceSize bytesPerIn = gpu->bytesPerIn;
-	VkDeviceSize bytesPerOut = gpu->bytesPerOut;
-	VkDeviceSize bytesPerInout = gpu->bytesPerInout;
+	VkResult vkres;
 
-	CzU32 inoutsPerBuffer = gpu->inoutsPerBuffer;
-	CzU32 inoutsPerHeap = gpu->inoutsPerHeap;
-	CzU32 buffersPerHeap = gpu->buffersPerHeap;
-	CzU32 workgroupCount = gpu->workgroupCount;
+	// The pNext member of VkPipelineCreateInfoKHR is non-const, so chain a copy of the create-info
+	VkComputePipelineCreateInfo keyPipelineInfo = *pipelineInfo;
 
-	CzU32 computeFamilyIndex = gpu->computeFamilyIndex;
-	CzU32 transferFamilyIndex = gpu->transferFamilyIndex;
-	CzU32 computeFamilyTimestampValidBits = gpu->computeFamilyTimestampValidBits;
-	CzU32 transferFamilyTimestampValidBits = gpu->transferFamilyTimestampValidBits;
+	VkPipelineCreateInfoKHR keyInfo = {0};
+	keyInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CREATE_INFO_KHR;
+	keyInfo.pNext = &keyPipelineInfo;
 
-	VkResult vkres;
-	size_t allocCount;
-	size_t allocSize;
+	VkPipelineBinaryKeyKHR globalKey = {0};
+	globalKey.sType = VK_STRUCTURE_TYPE_PIPELINE_BINARY_KEY_KHR;
 
-	DyRecord localRecord = dyrecord_create();
-	if CZ_NOEXPECT (!localRecord) { return false; }
+	VK_CALLR(vkGetPipelineKeyKHR, device, NULL, &globalKey);
+	if CZ_NOEXPECT (vkres) { return false; }
 
-	// Create initial command pool
-	VkCommandPoolCreateInfo initialCmdPoolInfo = {0};
-	initialCmdPoolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
-	initialCmdPoolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
-	initialCmdPoolInfo.queueFamilyIndex = transferFamilyIndex;
+	VkPipelineBinaryKeyKHR pipelineKey = {0};
+	pipelineKey.sType = VK_STRUCTURE_TYPE_PIPELINE_BINARY_KEY_KHR;
 
-	VkCommandPool initialCmdPool;
-	VK_CALLR(vkCreateCommandPool, device, &initialCmdPoolInfo, allocator, &initialCmdPool);
-	if CZ_NOEXPECT (vkres) { dyrecord_destroy(localRecord); return false; }
-	gpu->initialCmdPool = initialCmdPool;
+	VK_CALLR(vkGetPipelineKeyKHR, device, &keyInfo, &pipelineKey);
+	if CZ_NOEXPECT (vkres) { return false; }
 
-	// Create compute command pool (all compute command buffers allocated from this pool)
-	VkCommandPoolCreateInfo computeCmdPoolInfo = {0};
-	computeCmdPoolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
-	computeCmdPoolInfo.queueFamilyIndex = computeFamilyIndex;
+	VkPipelineBinaryKeysAndDataKHR keysAndData = {0};
+	bool bres = parse_pipeline_binaries(record, &globalKey, &pipelineKey, data, size, &keysAndData);
+	if CZ_NOEXPECT (!bres) { return false; }
 
-	VkCommandPool computeCmdPool;
-	VK_CALLR(vkCreateCommandPool, device, &computeCmdPoolInfo, allocator, &computeCmdPool);
-	if CZ_NOEXPECT (vkres) { dyrecord_destroy(localRecord); return false; }
-	gpu->computeCmdPool = computeCmdPool;
+	CzU32 binaryCount = keysAndData.binaryCount;
+	VkPipelineBinaryKHR* binaries = NULL;
 
-	// Create transfer command pool (all transfer command buffers allocated from this pool)
-	VkCommandPoolCreateInfo transferCmdPoolInfo = {0};
-	transferCmdPoolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
-	transferCmdPoolInfo.queueFamilyIndex = transferFamilyIndex;
+	if (binaryCount) {
+		binaries = dyrecord_calloc(record, binaryCount, sizeof(VkPipelineBinaryKHR));
+		if CZ_NOEXPECT (!binaries) { return false; }
 
-	VkCommandPool transferCmdPool;
-	VK_CALLR(vkCreateCommandPool, device, &transferCmdPoolInfo, allocator, &transferCmdPool);
-	if CZ_NOEXPECT (vkres) { dyrecord_destroy(localRecord); return false; }
-	gpu->transferCmdPool = transferCmdPool;
+		VkPipelineBinaryCreateInfoKHR binaryInfo = {0};
+		binaryInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_BINARY_CREATE_INFO_KHR;
+		binaryInfo.pKeysAndDataInfo = &keysAndData;
 
-	// Allocate initial command buffer
-	VkCommandBufferAllocateInfo initialCmdBufferAllocInfo = {0};
-	initialCmdBufferAllocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-	initialCmdBufferAllocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-	initialCmdBufferAllocInfo.commandPool = initialCmdPool;
-	initialCmdBufferAllocInfo.commandBufferCount = 1;
+		VkPipelineBinaryHandlesInfoKHR handlesInfo = {0};
+		handlesInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_BINARY_HANDLES_INFO_KHR;
+		handlesInfo.pipelineBinaryCount = binaryCount;
+		handlesInfo.pPipelineBinaries = binaries;
 
-	VkCommandBuffer initialCmdBuffer;
-	VK_CALLR(vkAllocateCommandBuffers, device, &initialCmdBufferAllocInfo, &initialCmdBuffer);
-	if CZ_NOEXPECT (vkres) { dyrecord_destroy(localRecord); return false; }
-	gpu->initialCmdBuffer = initialCmdBuffer;
+		// If the driver rejects the saved binaries, fall back to compiling the pipeline
+		VK_CALLR(vkCreatePipelineBinariesKHR, device, &binaryInfo, allocator, &handlesInfo);
+		if (vkres) {
+			for (CzU32 i = 0; i < binaryCount; i++) {
+				VK_CALL(vkDestroyPipelineBinaryKHR, device, binaries[i], allocator);
+			}
+			binaryCount = 0;
+		}
+	}
 
-	// Allocate compute command buffers (one per inout-buffer)
-	allocCount = inoutsPerHeap;
-	allocSize = sizeof(VkCommandBuffer);
+	if (binaryCount) {
+		VkPipelineBinaryInfoKHR pipelineBinaryInfo = {0};
+		pipelineBinaryInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_BINARY_INFO_KHR;
+		pipelineBinaryInfo.pNext = pipelineInfo->pNext;
+		pipelineBinaryInfo.binaryCount = binaryCount;
+		pipelineBinaryInfo.pPipelineBinaries = binaries;
 
-	VkCommandBuffer* computeCmdBuffers = dyrecord_calloc(gpuRecord, allocCount, allocSize);
-	if CZ_NOEXPECT (!computeCmdBuffers) { dyrecord_destroy(localRecord); return false; }
-	gpu->computeCmdBuffers = computeCmdBuffers;
+		VkComputePipelineCreateInfo binaryPipelineInfos[1];
+		binaryPipelineInfos[0] = *pipelineInfo;
+		binaryPipelineInfos[0].pNext = &pipelineBinaryInfo;
 
-	VkCommandBufferAllocateInfo computeCmdBufferAllocInfo = {0};
-	computeCmdBufferAllocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-	computeCmdBufferAllocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-	computeCmdBufferAllocInfo.commandPool = computeCmdPool;
-	computeCmdBufferAllocInfo.commandBufferCount = inoutsPerHeap;
+		VkPipeline pipeline;
+		VK_CALLR(
+			vkCreateComputePipelines,
+			device, VK_NULL_HANDLE, CZ_COUNTOF(binaryPipelineInfos), binaryPipelineInfos, allocator, &pipeline);
 
-	VK_CALLR(vkAllocateCommandBuffers, device, &computeCmdBufferAllocInfo, computeCmdBuffers);
-	if CZ_NOEXPECT (vkres) { dyrecord_destroy(localRecord); return false; }
+		for (CzU32 i = 0; i < binaryCount; i++) {
+			VK_CALL(vkDestroyPipelineBinaryKHR, device, binaries[i], allocator);
+		}
 
-	// Allocate transfer command buffers (one per inout-buffer)
-	allocCount = inoutsPerHeap;
-	allocSize = sizeof(VkCommandBuffer);
+		if CZ_NOEXPECT (vkres) { return false; }
+		gpu->pipeline = pipeline;
 
-	VkCommandBuffer* transferCmdBuffers = dyrecord_calloc(gpuRecord, allocCount, allocSize);
-	if CZ_NOEXPECT (!transferCmdBuffers) { dyrecord_destroy(localRecord); return false; }
-	gpu->transferCmdBuffers = transferCmdBuffers;
+		return true;
+	}
 
-	VkCommandBufferAllocateInfo transferCmdBufferAllocInfo = {0};
-	transferCmdBufferAllocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-	transferCmdBufferAllocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-	transferCmdBufferAllocInfo.commandPool = transferCmdPool;
-	transferCmdBufferAllocInfo.commandBufferCount = inoutsPerHeap;
+	VkPipelineCreateFlags2CreateInfoKHR pipelineFlagsInfo = {0};
+	pipelineFlagsInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CREATE_FLAGS_2_CREATE_INFO_KHR;
+	pipelineFlagsInfo.pNext = pipelineInfo->pNext;
+	pipelineFlagsInfo.flags = pipelineInfo->flags | VK_PIPELINE_CREATE_2_CAPTURE_DATA_BIT_KHR;
 
-	VK_CALLR(vkAllocateCommandBuffers, device, &transferCmdBufferAllocInfo, transferCmdBuffers);
-	if CZ_NOEXPECT (vkres) { dyrecord_destroy(localRecord); return false; }
+	VkComputePipelineCreateInfo capturePipelineInfos[1];
+	capturePipelineInfos[0] = *pipelineInfo;
+	capturePipelineInfos[0].pNext = &pipelineFlagsInfo;
 
-	// Specify in-buffer copy regions (same region layout per buffer)
-	allocCount = inoutsPerBuffer;
-	allocSize = sizeof(VkBufferCopy2);
+	VkPipeline pipeline;
+	VK_CALLR(
+		vkCreateComputePipelines,
+		device, VK_NULL_HANDLE, CZ_COUNTOF(capturePipelineInfos), capturePipelineInfos, allocator, &pipeline);
 
-	VkBufferCopy2* inBufferRegions = dyrecord_calloc(localRecord, allocCount, allocSize);
-	if CZ_NOEXPECT (!inBufferRegions) { dyrecord_destroy(localRecord); return false; }
+	if CZ_NOEXPECT (vkres) { return false; }
+	gpu->pipeline = pipeline;
 
-	for (CzU32 i = 0; i < inoutsPerBuffer; i++) {
-		inBufferRegions[i].sType = VK_STRUCTURE_TYPE_BUFFER_COPY_2;
-		inBufferRegions[i].srcOffset = bytesPerInout * i;
-		inBufferRegions[i].dstOffset = bytesPerInout * i;
-		inBufferRegions[i].size = bytesPerIn;
-	}
+	VkPipelineBinaryCreateInfoKHR binaryInfo = {0};
+	binaryInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_BINARY_CREATE_INFO_KHR;
+	binaryInfo.pipeline = pipeline;
 
-	// Specify out-buffer copy regions (same region layout per buffer)
-	allocCount = inoutsPerBuffer;
-	allocSize = sizeof(VkBufferCopy2);
+	VkPipelineBinaryHandlesInfoKHR handlesInfo = {0};
+	handlesInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_BINARY_HANDLES_INFO_KHR;
 
-	VkBufferCopy2* outBufferRegions = dyrecord_calloc(localRecord, allocCount, allocSize);
-	if CZ_NOEXPECT (!outBufferRegions) { dyrecord_destroy(localRecord); return false; }
+	VK_CALLR(vkCreatePipelineBinariesKHR, device, &binaryInfo, allocator, &handlesInfo);
+	if CZ_NOEXPECT (vkres) { return false; }
 
-	for (CzU32 i = 0; i < inoutsPerBuffer; i++) {
-		outBufferRegions[i].sType = VK_STRUCTURE_TYPE_BUFFER_COPY_2;
-		outBufferRegions[i].srcOffset = bytesPerInout * i + bytesPerIn;
-		outBufferRegions[i].dstOffset = bytesPerInout * i + bytesPerIn;
-		outBufferRegions[i].size = bytesPerOut;
-	}
+	binaryCount = handlesInfo.pipelineBinaryCount;
 
-	// Specify initial buffer copies
-	allocCount = buffersPerHeap;
-	allocSize = sizeof(VkCopyBufferInfo2);
+	binaries = dyrecord_calloc(record, binaryCount, sizeof(VkPipelineBinaryKHR));
+	if CZ_NOEXPECT (!binaries) { return false; }
 
-	VkCopyBufferInfo2* initialBufferCopyInfos = dyrecord_calloc(localRecord, allocCount, allocSize);
-	if CZ_NOEXPECT (!initialBufferCopyInfos) { dyrecord_destroy(localRecord); return false; }
+	handlesInfo.pPipelineBinaries = binaries;
+
+	VK_CALLR(vkCreatePipelineBinariesKHR, device, &binaryInfo, allocator, &handlesInfo);
+	if CZ_NOEXPECT (vkres) { goto err_destroy_binaries; }
+
+	VkReleaseCapturedPipelineDataInfoKHR releaseInfo = {0};
+	releaseInfo.sType = VK_STRUCTURE_TYPE_RELEASE_CAPTURED_PIPELINE_DATA_INFO_KHR;
+	releaseInfo.pipeline = pipeline;
+
+	VK_CALLR(vkReleaseCapturedPipelineDataKHR, device, &releaseInfo, allocator);
+	if CZ_NOEXPECT (vkres) { goto err_destroy_binaries; }
+
+	bres = save_pipeline_binaries(device, record, &globalKey, &pipelineKey, binaries, binaryCount, filename);
+	if CZ_NOEXPECT (!bres) { goto err_destroy_binaries; }
+
+	for (CzU32 i = 0; i < binaryCount; i++) {
+		VK_CALL(vkDestroyPipelineBinaryKHR, device, binaries[i], allocator);
+	}
+
+	return true;
+
+err_destroy_binaries:
+	for (CzU32 i = 0; i < binaryCount; i++) {
+		VK_CALL(vkDestroyPipelineBinaryKHR, device, binaries[i], allocator);
+	}
+
+	return false;
+}
+
+bool create_pipeline(struct Gpu* restrict gpu)
+{
+	const VkAllocationCallbacks* allocator = gpu->allocator;
+
+	VkDevice device = gpu->device;
+	VkDescriptorSetLayout descriptorSetLayout = gpu->descriptorSetLayout;
+
+	CzU32 workgroupSize = gpu->workgroupSize;
+	CzU32 subgroupSize = gpu->subgroupSize;
+
+	bool usingPipelineBinary = gpu->usingPipelineBinary;
+
+	VkResult vkres;
+
+	DyRecord localRecord = dyrecord_create();
+	if CZ_NOEXPECT (!localRecord) { return false; }
+
+	char shaderName[52];
+	char entryPointName[37];
+	size_t shaderSize;
+	const CzU32* shaderCode;
+
+	bool bres = load_shader(gpu, localRecord, shaderName, entryPointName, &shaderCode, &shaderSize);
+	if CZ_NOEXPECT (!bres) { dyrecord_destroy(localRecord); return false; }
+
+	if (czgConfig.outputLevel > CZ_OUTPUT_LEVEL_QUIET && !gpu->background) {
+		printf("Selected shader: %s\nSelected entry point: %s\n\n", shaderName, entryPointName);
+	}
+
+	VkPhysicalDeviceProperties2 deviceProperties = {0};
+	deviceProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+
+	VK_CALL(vkGetPhysicalDeviceProperties2, gpu->physicalDevice, &deviceProperties);
+
+	// Each device, driver, and shader variant has its own file, so none of them evict the others
+	char cacheName[160];
+	const char* cachePrefix = usingPipelineBinary ? CZ_PIPELINE_BINARY_PREFIX : CZ_PIPELINE_CACHE_PREFIX;
+	get_pipeline_cache_name(gpu, &deviceProperties.properties, cachePrefix, cacheName);
+
+	size_t cacheSize = 0;
+	struct CzFileFlags cacheFileFlags = {0};
+	cacheFileFlags.relativeToExe = true;
+
+	enum CzResult czres = czFileSize(cacheName, &cacheSize, cacheFileFlags);
+	if CZ_NOEXPECT (czres && czres != CZ_RESULT_NO_FILE) { dyrecord_destroy(localRecord); return false; }
+
+	CzU8* cacheData = NULL;
+	if (cacheSize) {
+		cacheData = dyrecord_malloc(localRecord, cacheSize);
+		if CZ_NOEXPECT (!cacheData) { dyrecord_destroy(localRecord); return false; }
+
+		size_t cacheOffset = 0;
+		czres = czReadFile(cacheName, cacheData, cacheSize, cacheOffset, cacheFileFlags);
+		if CZ_NOEXPECT (czres) { dyrecord_destroy(localRecord); return false; }
+	}
+
+	bool staleCache = !usingPipelineBinary && cacheSize &&
+		!check_pipeline_cache(&deviceProperties.properties, cacheData, cacheSize);
+
+	if (staleCache) {
+		if (czgConfig.outputLevel > CZ_OUTPUT_LEVEL_DEFAULT && !gpu->background) {
+			printf("Discarding pipeline cache '%s' from a different device or driver\n\n", cacheName);
+		}
+
+		cacheSize = 0;
+		cacheData = NULL;
+	}
+
+	VkShaderModuleCreateInfo shaderInfo = {0};
+	shaderInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+	shaderInfo.codeSize = shaderSize;
+	shaderInfo.pCode = shaderCode;
+
+	VkShaderModule shader = VK_NULL_HANDLE;
+	if (!gpu->usingMaintenance5) {
+		VK_CALLR(vkCreateShaderModule, device, &shaderInfo, allocator, &shader);
+		if CZ_NOEXPECT (vkres) { dyrecord_destroy(localRecord); return false; }
+		gpu->shaderModule = shader;
+	}
+
+	VkPipelineCacheCreateFlags cacheFlags = 0;
+	if (gpu->usingPipelineCreationCacheControl) {
+		cacheFlags |= VK_PIPELINE_CACHE_CREATE_EXTERNALLY_SYNCHRONIZED_BIT;
+	}
+
+	VkPipelineCacheCreateInfo cacheInfo = {0};
+	cacheInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+	cacheInfo.flags = cacheFlags;
+	cacheInfo.initialDataSize = cacheSize;
+	cacheInfo.pInitialData = cacheData;
+
+	// Pipeline binaries replace the pipeline cache, and cannot be used alongside it
+	VkPipelineCache cache = VK_NULL_HANDLE;
+	if (!usingPipelineBinary) {
+		VK_CALLR(vkCreatePipelineCache, device, &cacheInfo, allocator, &cache);
+		if CZ_NOEXPECT (vkres) { dyrecord_destroy(localRecord); return false; }
+		gpu->pipelineCache = cache;
+	}
+
+	VkDescriptorSetLayout descriptorSetLayouts[1];
+	descriptorSetLayouts[0] = descriptorSetLayout;
+
+	// Staging region of each dispatch, so the step counters of in-flight generations are kept apart
+	VkPushConstantRange pushConstantRanges[1];
+	pushConstantRanges[0].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+	pushConstantRanges[0].offset = 0;
+	pushConstantRanges[0].size = sizeof(CzU32);
+
+	VkPipelineLayoutCreateInfo pipelineLayoutInfo = {0};
+	pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+	pipelineLayoutInfo.setLayoutCount = CZ_COUNTOF(descriptorSetLayouts);
+	pipelineLayoutInfo.pSetLayouts = descriptorSetLayouts;
+	pipelineLayoutInfo.pushConstantRangeCount = CZ_COUNTOF(pushConstantRanges);
+	pipelineLayoutInfo.pPushConstantRanges = pushConstantRanges;
+
+	VkPipelineLayout pipelineLayout;
+	VK_CALLR(vkCreatePipelineLayout, device, &pipelineLayoutInfo, allocator, &pipelineLayout);
+	if CZ_NOEXPECT (vkres) { dyrecord_destroy(localRecord); return false; }
+	gpu->pipelineLayout = pipelineLayout;
+
+	CzU32 specialisationData[1];
+	specialisationData[0] = workgroupSize;
+
+	VkSpecializationMapEntry specialisationMapEntries[1];
+	specialisationMapEntries[0].constantID = 0;
+	specialisationMapEntries[0].offset = 0;
+	specialisationMapEntries[0].size = sizeof(specialisationData[0]);
+
+	VkSpecializationInfo specialisationInfo;
+	specialisationInfo.mapEntryCount = CZ_COUNTOF(specialisationMapEntries);
+	specialisationInfo.pMapEntries = specialisationMapEntries;
+	specialisationInfo.dataSize = sizeof(specialisationData);
+	specialisationInfo.pData = specialisationData;
+
+	VkPipelineShaderStageRequiredSubgroupSizeCreateInfo requiredSubgroupSizeInfo = {0};
+	requiredSubgroupSizeInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_REQUIRED_SUBGROUP_SIZE_CREATE_INFO;
+	requiredSubgroupSizeInfo.requiredSubgroupSize = subgroupSize;
+
+	VkPipelineShaderStageCreateFlags shaderStageFlags = 0;
+	if (gpu->usingSubgroupSizeControl && !subgroupSize) {
+		shaderStageFlags |= VK_PIPELINE_SHADER_STAGE_CREATE_ALLOW_VARYING_SUBGROUP_SIZE_BIT_EXT;
+	}
+
+	requiredSubgroupSizeInfo.pNext = gpu->usingMaintenance5 ? &shaderInfo : NULL;
+
+	VkPipelineShaderStageCreateInfo shaderStageInfo = {0};
+	shaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+	shaderStageInfo.pNext = subgroupSize ? &requiredSubgroupSizeInfo : requiredSubgroupSizeInfo.pNext;
+	shaderStageInfo.flags = shaderStageFlags;
+	shaderStageInfo.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+	shaderStageInfo.module = shader;
+	shaderStageInfo.pName = entryPointName;
+	shaderStageInfo.pSpecializationInfo = &specialisationInfo;
+
+	VkPipelineCreateFlags pipelineFlags = 0;
+	if (gpu->usingPipelineExecutableProperties) {
+		pipelineFlags |= VK_PIPELINE_CREATE_CAPTURE_STATISTICS_BIT_KHR;
+		pipelineFlags |= VK_PIPELINE_CREATE_CAPTURE_INTERNAL_REPRESENTATIONS_BIT_KHR;
+	}
+
+	VkComputePipelineCreateInfo pipelineInfos[1] = {0};
+	pipelineInfos[0].sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+	pipelineInfos[0].flags = pipelineFlags;
+	pipelineInfos[0].stage = shaderStageInfo;
+	pipelineInfos[0].layout = pipelineLayout;
+
+	VkPipeline pipeline;
+	if (usingPipelineBinary) {
+		bres = create_binary_pipeline(gpu, localRecord, &pipelineInfos[0], cacheName, cacheData, cacheSize);
+		if CZ_NOEXPECT (!bres) { dyrecord_destroy(localRecord); return false; }
+		pipeline = gpu->pipeline;
+	}
+	else {
+		VK_CALLR(
+			vkCreateComputePipelines, device, cache, CZ_COUNTOF(pipelineInfos), pipelineInfos, allocator, &pipeline);
+
+		if CZ_NOEXPECT (vkres) { dyrecord_destroy(localRecord); return false; }
+		gpu->pipeline = pipeline;
+
+		bres = save_pipeline_cache(device, cache, cacheName);
+		if CZ_NOEXPECT (!bres) { dyrecord_destroy(localRecord); return false; }
+	}
+
+	if (gpu->usingPipelineExecutableProperties) {
+		bres = capture_pipeline(device, pipeline);
+		if CZ_NOEXPECT (!bres) { dyrecord_destroy(localRecord); return false; }
+	}
+
+	VK_CALL(vkDestroyPipelineCache, device, cache, allocator);
+	gpu->pipelineCache = VK_NULL_HANDLE;
+
+	if (!gpu->usingMaintenance5) {
+		VK_CALL(vkDestroyShaderModule, device, shader, allocator);
+		gpu->shaderModule = VK_NULL_HANDLE;
+	}
+
+	dyrecord_destroy(localRecord);
+	return true;
+}
+
+bool create_query_pools(struct Gpu* restrict gpu)
+{
+	const VkAllocationCallbacks* allocator = gpu->allocator;
+
+	VkDevice device = gpu->device;
+
+	CzU32 inoutsPerHeap = gpu->inoutsPerHeap;
+	CzU32 stagesPerInout = gpu->stagesPerInout;
+
+	CzU32 computeFamilyTimestampValidBits = gpu->computeFamilyTimestampValidBits;
+	CzU32 transferFamilyTimestampValidBits = gpu->transferFamilyTimestampValidBits;
+
+	VkResult vkres;
+
+	if (computeFamilyTimestampValidBits || transferFamilyTimestampValidBits) {
+		VkQueryPoolCreateInfo queryPoolInfo = {0};
+		queryPoolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+		queryPoolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+		queryPoolInfo.queryCount = inoutsPerHeap * stagesPerInout * 4; // Two per copy, two per dispatch
+
+		VkQueryPool queryPool;
+		VK_CALLR(vkCreateQueryPool, device, &queryPoolInfo, allocator, &queryPool);
+		if CZ_NOEXPECT (vkres) { return false; }
+		gpu->queryPool = queryPool;
+	}
+
+	if (gpu->usingPipelineStatistics) {
+		VkQueryPoolCreateInfo queryPoolInfo = {0};
+		queryPoolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+		queryPoolInfo.queryType = VK_QUERY_TYPE_PIPELINE_STATISTICS;
+		queryPoolInfo.queryCount = inoutsPerHeap * stagesPerInout; // One per compute command buffer
+		queryPoolInfo.pipelineStatistics = VK_QUERY_PIPELINE_STATISTIC_COMPUTE_SHADER_INVOCATIONS_BIT;
+
+		VkQueryPool queryPool;
+		VK_CALLR(vkCreateQueryPool, device, &queryPoolInfo, allocator, &queryPool);
+		if CZ_NOEXPECT (vkres) { return false; }
+		gpu->invocationQueryPool = queryPool;
+	}
+
+	return true;
+}
+
+static bool record_initial_cmdbuffer(
+	VkCommandBuffer cmdBuffer,
+	const VkCopyBufferInfo2* inBufferCopyInfos,
+	const VkDependencyInfo* dependencyInfo,
+	CzU32 buffersPerHeap)
+{
+	VkResult vkres;
+
+	VkCommandBufferBeginInfo beginInfo = {0};
+	beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+	beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+	VK_CALLR(vkBeginCommandBuffer, cmdBuffer, &beginInfo);
+	if CZ_NOEXPECT (vkres) { return false; }
 
 	for (CzU32 i = 0; i < buffersPerHeap; i++) {
-		initialBufferCopyInfos[i].sType = VK_STRUCTURE_TYPE_COPY_BUFFER_INFO_2;
-		initialBufferCopyInfos[i].srcBuffer = hostVisibleBuffers[i];
-		initialBufferCopyInfos[i].dstBuffer = deviceLocalBuffers[i];
-		initialBufferCopyInfos[i].regionCount = inoutsPerBuffer;
-		initialBufferCopyInfos[i].pRegions = inBufferRegions;
+		VK_CALL(vkCmdCopyBuffer2KHR, cmdBuffer, &inBufferCopyInfos[i]);
 	}
 
-	// Specify in-buffer copies
+	VK_CALL(vkCmdPipelineBarrier2KHR, cmdBuffer, dependencyInfo);
+
+	VK_CALLR(vkEndCommandBuffer, cmdBuffer);
+	if CZ_NOEXPECT (vkres) { return false; }
+
+	return true;
+}
+
+static bool record_transfer_cmdbuffer(
+	VkCommandBuffer cmdBuffer,
+	const VkCopyBufferInfo2* inBufferCopyInfo,
+	const VkCopyBufferInfo2* outBufferCopyInfo,
+	const VkDependencyInfo* dependencyInfos,
+	VkQueryPool queryPool,
+	CzU32 firstQuery,
+	CzU32 timestampValidBits)
+{
+	VkResult vkres;
+
+	VkCommandBufferBeginInfo beginInfo = {0};
+	beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+
+	VK_CALLR(vkBeginCommandBuffer, cmdBuffer, &beginInfo);
+	if CZ_NOEXPECT (vkres) { return false; }
+
+	if (timestampValidBits) {
+		// TODO Remove (vkCmdResetQueryPool not guaranteed to work on dedicated transfer queue families)
+		CzU32 queryCount = 2;
+		VK_CALL(vkCmdResetQueryPool, cmdBuffer, queryPool, firstQuery, queryCount);
+
+		VkPipelineStageFlags2 stage = VK_PIPELINE_STAGE_2_NONE;
+		CzU32 query = firstQuery;
+
+		VK_CALL(vkCmdWriteTimestamp2KHR, cmdBuffer, stage, queryPool, query);
+	}
+
+	VK_CALL(vkCmdCopyBuffer2KHR, cmdBuffer, inBufferCopyInfo);
+	VK_CALL(vkCmdPipelineBarrier2KHR, cmdBuffer, &dependencyInfos[0]);
+
+	VK_CALL(vkCmdCopyBuffer2KHR, cmdBuffer, outBufferCopyInfo);
+	VK_CALL(vkCmdPipelineBarrier2KHR, cmdBuffer, &dependencyInfos[1]);
+
+	if (timestampValidBits) {
+		VkPipelineStageFlags2 stage = VK_PIPELINE_STAGE_2_COPY_BIT;
+		CzU32 query = firstQuery + 1;
+
+		VK_CALL(vkCmdWriteTimestamp2KHR, cmdBuffer, stage, queryPool, query);
+	}
+
+	VK_CALLR(vkEndCommandBuffer, cmdBuffer);
+	if CZ_NOEXPECT (vkres) { return false; }
+
+	return true;
+}
+
+static bool record_compute_cmdbuffer(
+	VkCommandBuffer cmdBuffer,
+	VkPipeline pipeline,
+	const VkBindDescriptorSetsInfo* bindDescriptorSetsInfos,
+	const VkPushConstantsInfo* pushConstantsInfo,
+	const VkDependencyInfo* dependencyInfos,
+	VkQueryPool queryPool,
+	CzU32 firstQuery,
+	VkQueryPool invocationQueryPool,
+	CzU32 invocationQuery,
+	CzU32 timestampValidBits,
+	CzU32 workgroupCount,
+	CzU32 dispatchCount)
+{
+	VkResult vkres;
+
+	VkCommandBufferBeginInfo beginInfo = {0};
+	beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+
+	VK_CALLR(vkBeginCommandBuffer, cmdBuffer, &beginInfo);
+	if CZ_NOEXPECT (vkres) { return false; }
+
+	if (timestampValidBits) {
+		CzU32 queryCount = 2;
+		VK_CALL(vkCmdResetQueryPool, cmdBuffer, queryPool, firstQuery, queryCount);
+
+		VkPipelineStageFlags2 stage = VK_PIPELINE_STAGE_2_NONE;
+		CzU32 query = firstQuery;
+
+		VK_CALL(vkCmdWriteTimestamp2KHR, cmdBuffer, stage, queryPool, query);
+	}
+
+	if (invocationQueryPool) {
+		CzU32 queryCount = 1;
+		VK_CALL(vkCmdResetQueryPool, cmdBuffer, invocationQueryPool, invocationQuery, queryCount);
+	}
+
+	VK_CALL(vkCmdPipelineBarrier2KHR, cmdBuffer, &dependencyInfos[0]);
+
+	VkPipelineBindPoint bindPoint = VK_PIPELINE_BIND_POINT_COMPUTE;
+	VK_CALL(vkCmdBindPipeline, cmdBuffer, bindPoint, pipeline);
+	VK_CALL(vkCmdPushConstants2KHR, cmdBuffer, pushConstantsInfo);
+
+	if (invocationQueryPool) {
+		VkQueryControlFlags queryFlags = 0;
+		VK_CALL(vkCmdBeginQuery, cmdBuffer, invocationQueryPool, invocationQuery, queryFlags);
+	}
+
+	CzU32 workgroupCountX = workgroupCount;
+	CzU32 workgroupCountY = 1;
+	CzU32 workgroupCountZ = 1;
+
+	// Each dispatch covers its own slice of the inout-buffer, so no barriers are needed between them
+	for (CzU32 i = 0; i < dispatchCount; i++) {
+		VK_CALL(vkCmdBindDescriptorSets2KHR, cmdBuffer, &bindDescriptorSetsInfos[i]);
+
+		// Use vkCmdDispatchBase if want to alter base value of workgroup index (first value of WorkgroupId)
+		VK_CALL(vkCmdDispatch, cmdBuffer, workgroupCountX, workgroupCountY, workgroupCountZ);
+	}
+
+	if (invocationQueryPool) {
+		VK_CALL(vkCmdEndQuery, cmdBuffer, invocationQueryPool, invocationQuery);
+	}
+
+	VK_CALL(vkCmdPipelineBarrier2KHR, cmdBuffer, &dependencyInfos[1]);
+
+	if (timestampValidBits) {
+		VkPipelineStageFlags2 stage = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+		CzU32 query = firstQuery + 1;
+
+		VK_CALL(vkCmdWriteTimestamp2KHR, cmdBuffer, stage, queryPool, query);
+	}
+
+	VK_CALLR(vkEndCommandBuffer, cmdBuffer);
+	if CZ_NOEXPECT (vkres) { return false; }
+
+	return true;
+}
+
+bool create_commands(struct Gpu* restrict gpu)
+{
+	DyRecord gpuRecord = gpu->allocRecord;
+
+	const VkAllocationCallbacks* allocator = gpu->allocator;
+	const VkBuffer* hostVisibleBuffers = gpu->hostVisibleBuffers;
+	const VkBuffer* hostVisibleOutBuffers = gpu->hostVisibleOutBuffers;
+	const VkBuffer* deviceLocalBuffers = gpu->deviceLocalBuffers;
+	const VkDescriptorSet* descriptorSets  = gpu->descriptorSets;
+
+	VkDevice device = gpu->device;
+	VkPipelineLayout pipelineLayout = gpu->pipelineLayout;
+	VkPipeline pipeline = gpu->pipeline;
+	VkQueryPool queryPool = gpu->queryPool;
+	VkQueryPool invocationQueryPool = gpu->invocationQueryPool;
+	VkBuffer statsBuffer = gpu->statsBuffer;
+
+	VkDeviceSize bytesPerIn = gpu->bytesPerIn;
+	VkDeviceSize bytesPerOut = gpu->bytesPerOut;
+	VkDeviceSize bytesPerInout = gpu->bytesPerInout;
+
+	CzU32 inoutsPerBuffer = gpu->inoutsPerBuffer;
+	CzU32 inoutsPerHeap = gpu->inoutsPerHeap;
+	CzU32 buffersPerHeap = gpu->buffersPerHeap;
+	CzU32 stagesPerInout = gpu->stagesPerInout;
+	CzU32 workgroupCount = gpu->workgroupCount;
+	CzU32 dispatchesPerInout = gpu->dispatchesPerInout;
+
+	CzU32 computeFamilyIndex = gpu->computeFamilyIndex;
+	CzU32 transferFamilyIndex = gpu->transferFamilyIndex;
+	CzU32 computeFamilyTimestampValidBits = gpu->computeFamilyTimestampValidBits;
+	CzU32 transferFamilyTimestampValidBits = gpu->transferFamilyTimestampValidBits;
+
+	VkResult vkres;
+	size_t allocCount;
+	size_t allocSize;
+
+	DyRecord localRecord = dyrecord_create();
+	if CZ_NOEXPECT (!localRecord) { return false; }
+
+	// Create initial command pool
+	VkCommandPoolCreateInfo initialCmdPoolInfo = {0};
+	initialCmdPoolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+	initialCmdPoolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+	initialCmdPoolInfo.queueFamilyIndex = transferFamilyIndex;
+
+	VkCommandPool initialCmdPool;
+	VK_CALLR(vkCreateCommandPool, device, &initialCmdPoolInfo, allocator, &initialCmdPool);
+	if CZ_NOEXPECT (vkres) { dyrecord_destroy(localRecord); return false; }
+	gpu->initialCmdPool = initialCmdPool;
+
+	// Create compute command pool (all compute command buffers allocated from this pool)
+	VkCommandPoolCreateInfo computeCmdPoolInfo = {0};
+	computeCmdPoolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+	computeCmdPoolInfo.queueFamilyIndex = computeFamilyIndex;
+
+	VkCommandPool computeCmdPool;
+	VK_CALLR(vkCreateCommandPool, device, &computeCmdPoolInfo, allocator, &computeCmdPool);
+	if CZ_NOEXPECT (vkres) { dyrecord_destroy(localRecord); return false; }
+	gpu->computeCmdPool = computeCmdPool;
+
+	// Create transfer command pool (all transfer command buffers allocated from this pool)
+	VkCommandPoolCreateInfo transferCmdPoolInfo = {0};
+	transferCmdPoolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+	transferCmdPoolInfo.queueFamilyIndex = transferFamilyIndex;
+
+	VkCommandPool transferCmdPool;
+	VK_CALLR(vkCreateCommandPool, device, &transferCmdPoolInfo, allocator, &transferCmdPool);
+	if CZ_NOEXPECT (vkres) { dyrecord_destroy(localRecord); return false; }
+	gpu->transferCmdPool = transferCmdPool;
+
+	// Allocate initial command buffer
+	VkCommandBufferAllocateInfo initialCmdBufferAllocInfo = {0};
+	initialCmdBufferAllocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+	initialCmdBufferAllocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+	initialCmdBufferAllocInfo.commandPool = initialCmdPool;
+	initialCmdBufferAllocInfo.commandBufferCount = 1;
+
+	VkCommandBuffer initialCmdBuffer;
+	VK_CALLR(vkAllocateCommandBuffers, device, &initialCmdBufferAllocInfo, &initialCmdBuffer);
+	if CZ_NOEXPECT (vkres) { dyrecord_destroy(localRecord); return false; }
+	gpu->initialCmdBuffer = initialCmdBuffer;
+
+	// Allocate compute command buffers (one per staging region)
+	allocCount = inoutsPerHeap * stagesPerInout;
+	allocSize = sizeof(VkCommandBuffer);
+
+	VkCommandBuffer* computeCmdBuffers = dyrecord_calloc(gpuRecord, allocCount, allocSize);
+	if CZ_NOEXPECT (!computeCmdBuffers) { dyrecord_destroy(localRecord); return false; }
+	gpu->computeCmdBuffers = computeCmdBuffers;
+
+	VkCommandBufferAllocateInfo computeCmdBufferAllocInfo = {0};
+	computeCmdBufferAllocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+	computeCmdBufferAllocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+	computeCmdBufferAllocInfo.commandPool = computeCmdPool;
+	computeCmdBufferAllocInfo.commandBufferCount = inoutsPerHeap * stagesPerInout;
+
+	VK_CALLR(vkAllocateCommandBuffers, device, &computeCmdBufferAllocInfo, computeCmdBuffers);
+	if CZ_NOEXPECT (vkres) { dyrecord_destroy(localRecord); return false; }
+
+	// Allocate transfer command buffers (one per staging region)
+	allocCount = inoutsPerHeap * stagesPerInout;
+	allocSize = sizeof(VkCommandBuffer);
+
+	VkCommandBuffer* transferCmdBuffers = dyrecord_calloc(gpuRecord, allocCount, allocSize);
+	if CZ_NOEXPECT (!transferCmdBuffers) { dyrecord_destroy(localRecord); return false; }
+	gpu->transferCmdBuffers = transferCmdBuffers;
+
+	VkCommandBufferAllocateInfo transferCmdBufferAllocInfo = {0};
+	transferCmdBufferAllocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+	transferCmdBufferAllocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+	transferCmdBufferAllocInfo.commandPool = transferCmdPool;
+	transferCmdBufferAllocInfo.commandBufferCount = inoutsPerHeap * stagesPerInout;
+
+	VK_CALLR(vkAllocateCommandBuffers, device, &transferCmdBufferAllocInfo, transferCmdBuffers);
+	if CZ_NOEXPECT (vkres) { dyrecord_destroy(localRecord); return false; }
+
+	// Specify in-buffer copy regions (same region layout per buffer, grouped by staging region)
+	allocCount = inoutsPerBuffer * stagesPerInout;
+	allocSize = sizeof(VkBufferCopy2);
+
+	VkBufferCopy2* inBufferRegions = dyrecord_calloc(localRecord, allocCount, allocSize);
+	if CZ_NOEXPECT (!inBufferRegions) { dyrecord_destroy(localRecord); return false; }
+
+	for (CzU32 i = 0, j = 0; i < stagesPerInout; i++) {
+		for (CzU32 k = 0; k < inoutsPerBuffer; j++, k++) {
+			inBufferRegions[j].sType = VK_STRUCTURE_TYPE_BUFFER_COPY_2;
+			inBufferRegions[j].srcOffset = bytesPerIn * j;
+			inBufferRegions[j].dstOffset = bytesPerInout * k;
+			inBufferRegions[j].size = bytesPerIn;
+		}
+	}
+
+	// Specify out-buffer copy regions (same region layout per buffer, grouped by staging region)
+	allocCount = inoutsPerBuffer * stagesPerInout;
+	allocSize = sizeof(VkBufferCopy2);
+
+	VkBufferCopy2* outBufferRegions = dyrecord_calloc(localRecord, allocCount, allocSize);
+	if CZ_NOEXPECT (!outBufferRegions) { dyrecord_destroy(localRecord); return false; }
+
+	for (CzU32 i = 0, j = 0; i < stagesPerInout; i++) {
+		for (CzU32 k = 0; k < inoutsPerBuffer; j++, k++) {
+			outBufferRegions[j].sType = VK_STRUCTURE_TYPE_BUFFER_COPY_2;
+			outBufferRegions[j].srcOffset = bytesPerInout * k + bytesPerIn;
+			outBufferRegions[j].dstOffset = bytesPerOut * j;
+			outBufferRegions[j].size = bytesPerOut;
+		}
+	}
+
+	// Specify initial buffer copies
+	allocCount = buffersPerHeap;
+	allocSize = sizeof(VkCopyBufferInfo2);
+
+	VkCopyBufferInfo2* initialBufferCopyInfos = dyrecord_calloc(localRecord, allocCount, allocSize);
+	if CZ_NOEXPECT (!initialBufferCopyInfos) { dyrecord_destroy(localRecord); return false; }
+
+	for (CzU32 i = 0; i < buffersPerHeap; i++) {
+		initialBufferCopyInfos[i].sType = VK_STRUCTURE_TYPE_COPY_BUFFER_INFO_2;
+		initialBufferCopyInfos[i].srcBuffer = hostVisibleBuffers[i];
+		initialBufferCopyInfos[i].dstBuffer = deviceLocalBuffers[i];
+		initialBufferCopyInfos[i].regionCount = inoutsPerBuffer;
+		initialBufferCopyInfos[i].pRegions = inBufferRegions; // First staging region
+	}
+
+	// Specify in-buffer copies (one per staging region)
+	allocCount = inoutsPerHeap * stagesPerInout;
+	allocSize = sizeof(VkCopyBufferInfo2);
+
+	VkCopyBufferInfo2* inBufferCopyInfos = dyrecord_calloc(localRecord, allocCount, allocSize);
+	if CZ_NOEXPECT (!inBufferCopyInfos) { dyrecord_destroy(localRecord); return false; }
+
+	for (CzU32 i = 0, j = 0; i < buffersPerHeap; i++) {
+		VkBuffer hostVisibleBuffer = hostVisibleBuffers[i];
+		VkBuffer deviceLocalBuffer = deviceLocalBuffers[i];
+
+		for (CzU32 k = 0; k < inoutsPerBuffer; k++) {
+			for (CzU32 l = 0; l < stagesPerInout; j++, l++) {
+				inBufferCopyInfos[j].sType = VK_STRUCTURE_TYPE_COPY_BUFFER_INFO_2;
+				inBufferCopyInfos[j].srcBuffer = hostVisibleBuffer;
+				inBufferCopyInfos[j].dstBuffer = deviceLocalBuffer;
+				inBufferCopyInfos[j].regionCount = 1;
+				inBufferCopyInfos[j].pRegions = &inBufferRegions[inoutsPerBuffer * l + k];
+			}
+		}
+	}
+
+	// Specify out-buffer copies (one per staging region)
+	allocCount = inoutsPerHeap * stagesPerInout;
+	allocSize = sizeof(VkCopyBufferInfo2);
+
+	VkCopyBufferInfo2* outBufferCopyInfos = dyrecord_calloc(localRecord, allocCount, allocSize);
+	if CZ_NOEXPECT (!outBufferCopyInfos) { dyrecord_destroy(localRecord); return false; }
+
+	for (CzU32 i = 0, j = 0; i < buffersPerHeap; i++) {
+		VkBuffer hostVisibleOutBuffer = hostVisibleOutBuffers[i];
+		VkBuffer deviceLocalBuffer = deviceLocalBuffers[i];
+
+		for (CzU32 k = 0; k < inoutsPerBuffer; k++) {
+			for (CzU32 l = 0; l < stagesPerInout; j++, l++) {
+				outBufferCopyInfos[j].sType = VK_STRUCTURE_TYPE_COPY_BUFFER_INFO_2;
+				outBufferCopyInfos[j].srcBuffer = deviceLocalBuffer;
+				outBufferCopyInfos[j].dstBuffer = hostVisibleOutBuffer;
+				outBufferCopyInfos[j].regionCount = 1;
+				outBufferCopyInfos[j].pRegions = &outBufferRegions[inoutsPerBuffer * l + k];
+			}
+		}
+	}
+
+	// Specify descriptor set bindings (one per dispatch of each inout-buffer)
+	allocCount = (size_t) inoutsPerHeap * dispatchesPerInout;
+	allocSize = sizeof(VkBindDescriptorSetsInfo);
+
+	VkBindDescriptorSetsInfo* bindDescriptorSetsInfos = dyrecord_calloc(localRecord, allocCount, allocSize);
+	if CZ_NOEXPECT (!bindDescriptorSetsInfos) { dyrecord_destroy(localRecord); return false; }
+
+	for (CzU32 i = 0; i < inoutsPerHeap * dispatchesPerInout; i++) {
+		bindDescriptorSetsInfos[i].sType = VK_STRUCTURE_TYPE_BIND_DESCRIPTOR_SETS_INFO;
+		bindDescriptorSetsInfos[i].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+		bindDescriptorSetsInfos[i].layout = pipelineLayout;
+		bindDescriptorSetsInfos[i].firstSet = 0;
+		bindDescriptorSetsInfos[i].descriptorSetCount = 1;
+		bindDescriptorSetsInfos[i].pDescriptorSets = &descriptorSets[i];
+	}
+
+	// Specify push constants (one per staging region of an inout-buffer)
+	CzU32 stageIndices[8];
+	VkPushConstantsInfo pushConstantsInfos[8] = {0};
+
+	for (CzU32 i = 0; i < stagesPerInout; i++) {
+		stageIndices[i] = i;
+
+		pushConstantsInfos[i].sType = VK_STRUCTURE_TYPE_PUSH_CONSTANTS_INFO;
+		pushConstantsInfos[i].layout = pipelineLayout;
+		pushConstantsInfos[i].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+		pushConstantsInfos[i].offset = 0;
+		pushConstantsInfos[i].size = sizeof(stageIndices[i]);
+		pushConstantsInfos[i].pValues = &stageIndices[i];
+	}
+
+	// Specify buffer memory barriers for initial command buffer
+	allocCount = inoutsPerHeap;
+	allocSize = sizeof(VkBufferMemoryBarrier2);
+
+	VkBufferMemoryBarrier2* initialBufferMemoryBarriers = dyrecord_calloc(localRecord, allocCount, allocSize);
+	if CZ_NOEXPECT (!initialBufferMemoryBarriers) { dyrecord_destroy(localRecord); return false; }
+
+	for (CzU32 i = 0, j = 0; i < buffersPerHeap; i++) {
+		VkBuffer deviceLocalBuffer = deviceLocalBuffers[i];
+
+		for (CzU32 k = 0; k < inoutsPerBuffer; j++, k++) {
+			initialBufferMemoryBarriers[j].sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2;
+			initialBufferMemoryBarriers[j].srcStageMask = VK_PIPELINE_STAGE_2_COPY_BIT;
+			initialBufferMemoryBarriers[j].srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+			initialBufferMemoryBarriers[j].srcQueueFamilyIndex = transferFamilyIndex;
+			initialBufferMemoryBarriers[j].dstQueueFamilyIndex = computeFamilyIndex;
+			initialBufferMemoryBarriers[j].buffer = deviceLocalBuffer;
+			initialBufferMemoryBarriers[j].offset = bytesPerInout * k;
+			initialBufferMemoryBarriers[j].size = bytesPerIn;
+		}
+	}
+
+	// Specify buffer memory barriers for compute command buffer
+	allocCount = inoutsPerHeap;
+	allocSize = sizeof(VkBufferMemoryBarrier2[3]);
+
+	VkBufferMemoryBarrier2 (*computeBufferMemoryBarriers)[3] = dyrecord_calloc(localRecord, allocCount, allocSize);
+	if CZ_NOEXPECT (!computeBufferMemoryBarriers) { dyrecord_destroy(localRecord); return false; }
+
+	for (CzU32 i = 0, j = 0; i < buffersPerHeap; i++) {
+		VkBuffer deviceLocalBuffer = deviceLocalBuffers[i];
+
+		for (CzU32 k = 0; k < inoutsPerBuffer; j++, k++) {
+			computeBufferMemoryBarriers[j][0].sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2;
+			computeBufferMemoryBarriers[j][0].dstStageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+			computeBufferMemoryBarriers[j][0].dstAccessMask = VK_ACCESS_2_SHADER_STORAGE_READ_BIT;
+			computeBufferMemoryBarriers[j][0].srcQueueFamilyIndex = transferFamilyIndex;
+			computeBufferMemoryBarriers[j][0].dstQueueFamilyIndex = computeFamilyIndex;
+			computeBufferMemoryBarriers[j][0].buffer = deviceLocalBuffer;
+			computeBufferMemoryBarriers[j][0].offset = bytesPerInout * k;
+			computeBufferMemoryBarriers[j][0].size = bytesPerIn;
+
+			computeBufferMemoryBarriers[j][1].sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2;
+			computeBufferMemoryBarriers[j][1].srcStageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+			computeBufferMemoryBarriers[j][1].srcAccessMask = VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT;
+			computeBufferMemoryBarriers[j][1].srcQueueFamilyIndex = computeFamilyIndex;
+			computeBufferMemoryBarriers[j][1].dstQueueFamilyIndex = transferFamilyIndex;
+			computeBufferMemoryBarriers[j][1].buffer = deviceLocalBuffer;
+			computeBufferMemoryBarriers[j][1].offset = bytesPerInout * k + bytesPerIn;
+			computeBufferMemoryBarriers[j][1].size = bytesPerOut;
+
+			// Step counters and stats are read by the host once the inout-buffer's dispatches complete
+			computeBufferMemoryBarriers[j][2].sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2;
+			computeBufferMemoryBarriers[j][2].srcStageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+			computeBufferMemoryBarriers[j][2].srcAccessMask = VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT;
+			computeBufferMemoryBarriers[j][2].dstStageMask = VK_PIPELINE_STAGE_2_HOST_BIT;
+			computeBufferMemoryBarriers[j][2].dstAccessMask = VK_ACCESS_2_HOST_READ_BIT;
+			computeBufferMemoryBarriers[j][2].srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			computeBufferMemoryBarriers[j][2].dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			computeBufferMemoryBarriers[j][2].buffer = statsBuffer;
+			computeBufferMemoryBarriers[j][2].offset = 0;
+			computeBufferMemoryBarriers[j][2].size = VK_WHOLE_SIZE;
+		}
+	}
+
+	// Specify buffer memory barriers for transfer command buffer (one set per staging region)
+	allocCount = inoutsPerHeap * stagesPerInout;
+	allocSize = sizeof(VkBufferMemoryBarrier2[3]);
+
+	VkBufferMemoryBarrier2 (*transferBufferMemoryBarriers)[3] = dyrecord_calloc(localRecord, allocCount, allocSize);
+	if CZ_NOEXPECT (!transferBufferMemoryBarriers) { dyrecord_destroy(localRecord); return false; }
+
+	for (CzU32 i = 0, j = 0; i < buffersPerHeap; i++) {
+		VkBuffer hostVisibleOutBuffer = hostVisibleOutBuffers[i];
+		VkBuffer deviceLocalBuffer = deviceLocalBuffers[i];
+
+		for (CzU32 k = 0; k < inoutsPerBuffer; k++) {
+			for (CzU32 l = 0; l < stagesPerInout; j++, l++) {
+				transferBufferMemoryBarriers[j][0].sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2;
+				transferBufferMemoryBarriers[j][0].srcStageMask = VK_PIPELINE_STAGE_2_COPY_BIT;
+				transferBufferMemoryBarriers[j][0].srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+				transferBufferMemoryBarriers[j][0].srcQueueFamilyIndex = transferFamilyIndex;
+				transferBufferMemoryBarriers[j][0].dstQueueFamilyIndex = computeFamilyIndex;
+				transferBufferMemoryBarriers[j][0].buffer = deviceLocalBuffer;
+				transferBufferMemoryBarriers[j][0].offset = bytesPerInout * k;
+				transferBufferMemoryBarriers[j][0].size = bytesPerIn;
+
+				transferBufferMemoryBarriers[j][1].sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2;
+				transferBufferMemoryBarriers[j][1].dstStageMask = VK_PIPELINE_STAGE_2_COPY_BIT;
+				transferBufferMemoryBarriers[j][1].dstAccessMask = VK_ACCESS_2_TRANSFER_READ_BIT;
+				transferBufferMemoryBarriers[j][1].srcQueueFamilyIndex = computeFamilyIndex;
+				transferBufferMemoryBarriers[j][1].dstQueueFamilyIndex = transferFamilyIndex;
+				transferBufferMemoryBarriers[j][1].buffer = deviceLocalBuffer;
+				transferBufferMemoryBarriers[j][1].offset = bytesPerInout * k + bytesPerIn;
+				transferBufferMemoryBarriers[j][1].size = bytesPerOut;
+
+				transferBufferMemoryBarriers[j][2].sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2;
+				transferBufferMemoryBarriers[j][2].srcStageMask = VK_PIPELINE_STAGE_2_COPY_BIT;
+				transferBufferMemoryBarriers[j][2].srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+				transferBufferMemoryBarriers[j][2].dstStageMask = VK_PIPELINE_STAGE_2_HOST_BIT;
+				transferBufferMemoryBarriers[j][2].dstAccessMask = VK_ACCESS_2_HOST_READ_BIT;
+				transferBufferMemoryBarriers[j][2].buffer = hostVisibleOutBuffer;
+				transferBufferMemoryBarriers[j][2].offset = bytesPerOut * (inoutsPerBuffer * l + k);
+				transferBufferMemoryBarriers[j][2].size = bytesPerOut;
+			}
+		}
+	}
+
+	// Specify dependency info for initial command buffer
+	VkDependencyInfo initialDependencyInfo = {0};
+	initialDependencyInfo.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+	initialDependencyInfo.bufferMemoryBarrierCount = inoutsPerHeap;
+	initialDependencyInfo.pBufferMemoryBarriers = initialBufferMemoryBarriers;
+
+	// Specify dependency infos for compute command buffers
+	allocCount = inoutsPerHeap;
+	allocSize = sizeof(VkDependencyInfo[2]);
+
+	VkDependencyInfo (*computeDependencyInfos)[2] = dyrecord_calloc(localRecord, allocCount, allocSize);
+	if CZ_NOEXPECT (!computeDependencyInfos) { dyrecord_destroy(localRecord); return false; }
+
+	for (CzU32 i = 0; i < inoutsPerHeap; i++) {
+		computeDependencyInfos[i][0].sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+		computeDependencyInfos[i][0].bufferMemoryBarrierCount = 1;
+		computeDependencyInfos[i][0].pBufferMemoryBarriers = &computeBufferMemoryBarriers[i][0];
+
+		computeDependencyInfos[i][1].sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+		computeDependencyInfos[i][1].bufferMemoryBarrierCount = 2;
+		computeDependencyInfos[i][1].pBufferMemoryBarriers = &computeBufferMemoryBarriers[i][1];
+	}
+
+	// Specify dependency infos for transfer command buffers
+	allocCount = inoutsPerHeap * stagesPerInout;
+	allocSize = sizeof(VkDependencyInfo[2]);
+
+	VkDependencyInfo (*transferDependencyInfos)[2] = dyrecord_calloc(localRecord, allocCount, allocSize);
+	if CZ_NOEXPECT (!transferDependencyInfos) { dyrecord_destroy(localRecord); return false; }
+
+	for (CzU32 i = 0; i < inoutsPerHeap * stagesPerInout; i++) {
+		transferDependencyInfos[i][0].sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+		transferDependencyInfos[i][0].bufferMemoryBarrierCount = 2;
+		transferDependencyInfos[i][0].pBufferMemoryBarriers = &transferBufferMemoryBarriers[i][0];
+
+		transferDependencyInfos[i][1].sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+		transferDependencyInfos[i][1].bufferMemoryBarrierCount = 1;
+		transferDependencyInfos[i][1].pBufferMemoryBarriers = &transferBufferMemoryBarriers[i][2];
+	}
+
+	// Record initial command buffer
+	bool bres = record_initial_cmdbuffer(
+		initialCmdBuffer, initialBufferCopyInfos, &initialDependencyInfo, buffersPerHeap);
+
+	if CZ_NOEXPECT (!bres) { dyrecord_destroy(localRecord); return false; }
+
+	// Record compute command buffers (staging regions of an inout-buffer share its descriptor sets)
+	for (CzU32 i = 0; i < inoutsPerHeap * stagesPerInout; i++) {
+		CzU32 inout = i / stagesPerInout;
+		CzU32 stage = i % stagesPerInout;
+		CzU32 firstQuery = i * 4;
+		bres = record_compute_cmdbuffer(
+			computeCmdBuffers[i], pipeline, &bindDescriptorSetsInfos[inout * dispatchesPerInout],
+			&pushConstantsInfos[stage], computeDependencyInfos[inout], queryPool, firstQuery, invocationQueryPool, i,
+			computeFamilyTimestampValidBits, workgroupCount, dispatchesPerInout);
+
+		if CZ_NOEXPECT (!bres) { dyrecord_destroy(localRecord); return false; }
+	}
+
+	// Record transfer command buffers
+	for (CzU32 i = 0; i < inoutsPerHeap * stagesPerInout; i++) {
+		CzU32 firstQuery = i * 4 + 2;
+		bres = record_transfer_cmdbuffer(
+			transferCmdBuffers[i], &inBufferCopyInfos[i], &outBufferCopyInfos[i], transferDependencyInfos[i], queryPool,
+			firstQuery, transferFamilyTimestampValidBits);
+
+		if CZ_NOEXPECT (!bres) { dyrecord_destroy(localRecord); return false; }
+	}
+
+	// Create semaphores (one per inout-buffer)
+	allocCount = inoutsPerHeap;
+	allocSize = sizeof(VkSemaphore);
+
+	VkSemaphore* semaphores = dyrecord_calloc(gpuRecord, allocCount, allocSize);
+	if CZ_NOEXPECT (!semaphores) { dyrecord_destroy(localRecord); return false; }
+	gpu->semaphores = semaphores;
+
+	VkSemaphoreTypeCreateInfo semaphoreTypeInfo = {0};
+	semaphoreTypeInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+	semaphoreTypeInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+	semaphoreTypeInfo.initialValue = 0;
+
+	VkSemaphoreCreateInfo semaphoreInfo = {0};
+	semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+	semaphoreInfo.pNext = &semaphoreTypeInfo;
+
+	for (CzU32 i = 0; i < inoutsPerHeap; i++) {
+		VkSemaphore semaphore;
+		VK_CALLR(vkCreateSemaphore, device, &semaphoreInfo, allocator, &semaphore);
+		if CZ_NOEXPECT (vkres) { dyrecord_destroy(localRecord); return false; }
+		semaphores[i] = semaphore;
+	}
+
+#if !defined(NDEBUG)
+	set_debug_name(device, VK_OBJECT_TYPE_COMMAND_POOL, (CzU64) transferCmdPool, "Transfer");
+	set_debug_name(device, VK_OBJECT_TYPE_COMMAND_POOL, (CzU64) computeCmdPool, "Compute");
+
+	for (CzU32 i = 0, j = 0; i < buffersPerHeap; i++) {
+		for (CzU32 k = 0; k < inoutsPerBuffer; k++) {
+			for (CzU32 l = 0; l < stagesPerInout; j++, l++) {
+				char objectName[100];
+				char specs[92];
+
+				sprintf(
+					specs,
+					", Stage %" PRIu32 "/%" PRIu32 ", Inout %" PRIu32 "/%" PRIu32 ", Buffer %" PRIu32 "/%" PRIu32,
+					l + 1, stagesPerInout, k + 1, inoutsPerBuffer, i + 1, buffersPerHeap);
+
+				strcpy(objectName, "Compute");
+				strcat(objectName, specs);
+
+				set_debug_name(device, VK_OBJECT_TYPE_COMMAND_BUFFER, (CzU64) computeCmdBuffers[j], objectName);
+
+				strcpy(objectName, "Transfer");
+				strcat(objectName, specs);
+
+				set_debug_name(device, VK_OBJECT_TYPE_COMMAND_BUFFER, (CzU64) transferCmdBuffers[j], objectName);
+			}
+		}
+	}
+#endif
+
+	dyrecord_destroy(localRecord);
+	return true;
+}
+
+static bool record_continuous_cmdbuffer(
+	VkCommandBuffer cmdBuffer,
+	VkPipeline pipeline,
+	const VkBindDescriptorSetsInfo* bindDescriptorSetsInfo,
+	const VkBufferMemoryBarrier2* claimBufferMemoryBarrier,
+	const VkDependencyInfo* dependencyInfos,
+	VkQueryPool queryPool,
+	CzU32 firstQuery,
+	CzU32 timestampValidBits,
+	CzU32 workgroupCount)
+{
+	VkResult vkres;
+
+	VkCommandBufferBeginInfo beginInfo = {0};
+	beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+
+	VK_CALLR(vkBeginCommandBuffer, cmdBuffer, &beginInfo);
+	if CZ_NOEXPECT (vkres) { return false; }
+
+	if (timestampValidBits) {
+		CzU32 queryCount = 2;
+		VK_CALL(vkCmdResetQueryPool, cmdBuffer, queryPool, firstQuery, queryCount);
+
+		VkPipelineStageFlags2 stage = VK_PIPELINE_STAGE_2_NONE;
+		CzU32 query = firstQuery;
+
+		VK_CALL(vkCmdWriteTimestamp2KHR, cmdBuffer, stage, queryPool, query);
+	}
+
+	// Reset claim counter so the dispatch claims its range from the first chunk
+	VkBuffer claimBuffer = claimBufferMemoryBarrier->buffer;
+	VkDeviceSize claimOffset = claimBufferMemoryBarrier->offset;
+	VkDeviceSize claimSize = claimBufferMemoryBarrier->size;
+
+	VK_CALL(vkCmdFillBuffer, cmdBuffer, claimBuffer, claimOffset, claimSize, 0);
+	VK_CALL(vkCmdPipelineBarrier2KHR, cmdBuffer, &dependencyInfos[0]);
+	VK_CALL(vkCmdBindDescriptorSets2KHR, cmdBuffer, bindDescriptorSetsInfo);
+
+	VkPipelineBindPoint bindPoint = VK_PIPELINE_BIND_POINT_COMPUTE;
+	VK_CALL(vkCmdBindPipeline, cmdBuffer, bindPoint, pipeline);
+
+	CzU32 workgroupCountX = workgroupCount;
+	CzU32 workgroupCountY = 1;
+	CzU32 workgroupCountZ = 1;
+
+	VK_CALL(vkCmdDispatch, cmdBuffer, workgroupCountX, workgroupCountY, workgroupCountZ);
+	VK_CALL(vkCmdPipelineBarrier2KHR, cmdBuffer, &dependencyInfos[1]);
+
+	if (timestampValidBits) {
+		VkPipelineStageFlags2 stage = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+		CzU32 query = firstQuery + 1;
+
+		VK_CALL(vkCmdWriteTimestamp2KHR, cmdBuffer, stage, queryPool, query);
+	}
+
+	VK_CALLR(vkEndCommandBuffer, cmdBuffer);
+	if CZ_NOEXPECT (vkres) { return false; }
+
+	return true;
+}
+
+bool create_continuous_commands(struct Gpu* restrict gpu)
+{
+	DyRecord gpuRecord = gpu->allocRecord;
+
+	const VkAllocationCallbacks* allocator = gpu->allocator;
+	const VkBuffer* hostVisibleBuffers = gpu->hostVisibleBuffers;
+	const VkBuffer* deviceLocalBuffers = gpu->deviceLocalBuffers;
+	const VkDescriptorSet* descriptorSets  = gpu->descriptorSets;
+
+	VkDevice device = gpu->device;
+	VkPipelineLayout pipelineLayout = gpu->pipelineLayout;
+	VkPipeline pipeline = gpu->pipeline;
+	VkQueryPool queryPool = gpu->queryPool;
+
+	VkDeviceSize bytesPerInout = gpu->bytesPerInout;
+	VkDeviceSize bytesPerRing = gpu->bytesPerRing;
+	VkDeviceSize bytesPerClaim = gpu->bytesPerClaim;
+
+	CzU32 inoutsPerBuffer = gpu->inoutsPerBuffer;
+	CzU32 inoutsPerHeap = gpu->inoutsPerHeap;
+	CzU32 buffersPerHeap = gpu->buffersPerHeap;
+	CzU32 workgroupCount = gpu->workgroupCount;
+
+	CzU32 computeFamilyIndex = gpu->computeFamilyIndex;
+	CzU32 computeFamilyTimestampValidBits = gpu->computeFamilyTimestampValidBits;
+
+	VkResult vkres;
+	size_t allocCount;
+	size_t allocSize;
+
+	DyRecord localRecord = dyrecord_create();
+	if CZ_NOEXPECT (!localRecord) { return false; }
+
+	// Create compute command pool (all compute command buffers allocated from this pool)
+	VkCommandPoolCreateInfo computeCmdPoolInfo = {0};
+	computeCmdPoolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+	computeCmdPoolInfo.queueFamilyIndex = computeFamilyIndex;
+
+	VkCommandPool computeCmdPool;
+	VK_CALLR(vkCreateCommandPool, device, &computeCmdPoolInfo, allocator, &computeCmdPool);
+	if CZ_NOEXPECT (vkres) { dyrecord_destroy(localRecord); return false; }
+	gpu->computeCmdPool = computeCmdPool;
+
+	// Allocate compute command buffers (one per inout-buffer)
+	allocCount = inoutsPerHeap;
+	allocSize = sizeof(VkCommandBuffer);
+
+	VkCommandBuffer* computeCmdBuffers = dyrecord_calloc(gpuRecord, allocCount, allocSize);
+	if CZ_NOEXPECT (!computeCmdBuffers) { dyrecord_destroy(localRecord); return false; }
+	gpu->computeCmdBuffers = computeCmdBuffers;
+
+	VkCommandBufferAllocateInfo computeCmdBufferAllocInfo = {0};
+	computeCmdBufferAllocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+	computeCmdBufferAllocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+	computeCmdBufferAllocInfo.commandPool = computeCmdPool;
+	computeCmdBufferAllocInfo.commandBufferCount = inoutsPerHeap;
+
+	VK_CALLR(vkAllocateCommandBuffers, device, &computeCmdBufferAllocInfo, computeCmdBuffers);
+	if CZ_NOEXPECT (vkres) { dyrecord_destroy(localRecord); return false; }
+
+	// Specify descriptor set bindings
+	allocCount = inoutsPerHeap;
+	allocSize = sizeof(VkBindDescriptorSetsInfo);
+
+	VkBindDescriptorSetsInfo* bindDescriptorSetsInfos = dyrecord_calloc(localRecord, allocCount, allocSize);
+	if CZ_NOEXPECT (!bindDescriptorSetsInfos) { dyrecord_destroy(localRecord); return false; }
+
+	for (CzU32 i = 0; i < inoutsPerHeap; i++) {
+		bindDescriptorSetsInfos[i].sType = VK_STRUCTURE_TYPE_BIND_DESCRIPTOR_SETS_INFO;
+		bindDescriptorSetsInfos[i].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+		bindDescriptorSetsInfos[i].layout = pipelineLayout;
+		bindDescriptorSetsInfos[i].firstSet = 0;
+		bindDescriptorSetsInfos[i].descriptorSetCount = 1;
+		bindDescriptorSetsInfos[i].pDescriptorSets = &descriptorSets[i];
+	}
+
+	// Specify buffer memory barriers for compute command buffer
+	allocCount = inoutsPerHeap;
+	allocSize = sizeof(VkBufferMemoryBarrier2[2]);
+
+	VkBufferMemoryBarrier2 (*computeBufferMemoryBarriers)[2] = dyrecord_calloc(localRecord, allocCount, allocSize);
+	if CZ_NOEXPECT (!computeBufferMemoryBarriers) { dyrecord_destroy(localRecord); return false; }
+
+	for (CzU32 i = 0, j = 0; i < buffersPerHeap; i++) {
+		VkBuffer hostVisibleBuffer = hostVisibleBuffers[i];
+		VkBuffer deviceLocalBuffer = deviceLocalBuffers[i];
+
+		for (CzU32 k = 0; k < inoutsPerBuffer; j++, k++) {
+			computeBufferMemoryBarriers[j][0].sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2;
+			computeBufferMemoryBarriers[j][0].srcStageMask = VK_PIPELINE_STAGE_2_CLEAR_BIT;
+			computeBufferMemoryBarriers[j][0].srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+			computeBufferMemoryBarriers[j][0].dstStageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+			computeBufferMemoryBarriers[j][0].dstAccessMask =
+				VK_ACCESS_2_SHADER_STORAGE_READ_BIT | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT;
+			computeBufferMemoryBarriers[j][0].buffer = deviceLocalBuffer;
+			computeBufferMemoryBarriers[j][0].offset = bytesPerInout * k;
+			computeBufferMemoryBarriers[j][0].size = bytesPerClaim;
+
+			computeBufferMemoryBarriers[j][1].sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2;
+			computeBufferMemoryBarriers[j][1].srcStageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+			computeBufferMemoryBarriers[j][1].srcAccessMask = VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT;
+			computeBufferMemoryBarriers[j][1].dstStageMask = VK_PIPELINE_STAGE_2_HOST_BIT;
+			computeBufferMemoryBarriers[j][1].dstAccessMask = VK_ACCESS_2_HOST_READ_BIT;
+			computeBufferMemoryBarriers[j][1].buffer = hostVisibleBuffer;
+			computeBufferMemoryBarriers[j][1].offset = bytesPerInout * k;
+			computeBufferMemoryBarriers[j][1].size = bytesPerRing;
+		}
+	}
+
+	// Specify dependency infos for compute command buffers
+	allocCount = inoutsPerHeap;
+	allocSize = sizeof(VkDependencyInfo[2]);
+
+	VkDependencyInfo (*computeDependencyInfos)[2] = dyrecord_calloc(localRecord, allocCount, allocSize);
+	if CZ_NOEXPECT (!computeDependencyInfos) { dyrecord_destroy(localRecord); return false; }
+
+	for (CzU32 i = 0; i < inoutsPerHeap; i++) {
+		computeDependencyInfos[i][0].sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+		computeDependencyInfos[i][0].bufferMemoryBarrierCount = 1;
+		computeDependencyInfos[i][0].pBufferMemoryBarriers = &computeBufferMemoryBarriers[i][0];
+
+		computeDependencyInfos[i][1].sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+		computeDependencyInfos[i][1].bufferMemoryBarrierCount = 1;
+		computeDependencyInfos[i][1].pBufferMemoryBarriers = &computeBufferMemoryBarriers[i][1];
+	}
+
+	/*
+	 * Each dispatch claims workgroupCount chunks of workgroupSize starting values. Dispatch fewer workgroups than
+	 * chunks so each workgroup stays resident and claims several chunks, balancing slow chunks against fast ones.
+	 */
+	CzU32 dispatchCount = (workgroupCount + CZ_CHUNKS_PER_WORKGROUP - 1) / CZ_CHUNKS_PER_WORKGROUP;
+
+	// Record compute command buffers
+	for (CzU32 i = 0; i < inoutsPerHeap; i++) {
+		CzU32 firstQuery = i * 4;
+		bool bres = record_continuous_cmdbuffer(
+			computeCmdBuffers[i], pipeline, &bindDescriptorSetsInfos[i], &computeBufferMemoryBarriers[i][0],
+			computeDependencyInfos[i], queryPool, firstQuery, computeFamilyTimestampValidBits, dispatchCount);
+
+		if CZ_NOEXPECT (!bres) { dyrecord_destroy(localRecord); return false; }
+	}
+
+	// Create semaphores (one per inout-buffer)
+	allocCount = inoutsPerHeap;
+	allocSize = sizeof(VkSemaphore);
+
+	VkSemaphore* semaphores = dyrecord_calloc(gpuRecord, allocCount, allocSize);
+	if CZ_NOEXPECT (!semaphores) { dyrecord_destroy(localRecord); return false; }
+	gpu->semaphores = semaphores;
+
+	VkSemaphoreTypeCreateInfo semaphoreTypeInfo = {0};
+	semaphoreTypeInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+	semaphoreTypeInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+	semaphoreTypeInfo.initialValue = 0;
+
+	VkSemaphoreCreateInfo semaphoreInfo = {0};
+	semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+	semaphoreInfo.pNext = &semaphoreTypeInfo;
+
+	for (CzU32 i = 0; i < inoutsPerHeap; i++) {
+		VkSemaphore semaphore;
+		VK_CALLR(vkCreateSemaphore, device, &semaphoreInfo, allocator, &semaphore);
+		if CZ_NOEXPECT (vkres) { dyrecord_destroy(localRecord); return false; }
+		semaphores[i] = semaphore;
+	}
+
+#if !defined(NDEBUG)
+	set_debug_name(device, VK_OBJECT_TYPE_COMMAND_POOL, (CzU64) computeCmdPool, "Compute");
+
+	for (CzU32 i = 0, j = 0; i < buffersPerHeap; i++) {
+		for (CzU32 k = 0; k < inoutsPerBuffer; j++, k++) {
+			char objectName[70];
+			sprintf(
+				objectName,
+				"Continuous, Inout %" PRIu32 "/%" PRIu32 ", Buffer %" PRIu32 "/%" PRIu32,
+				k + 1, inoutsPerBuffer, i + 1, buffersPerHeap);
+
+			set_debug_name(device, VK_OBJECT_TYPE_COMMAND_BUFFER, (CzU64) computeCmdBuffers[j], objectName);
+		}
+	}
+#endif
+
+	dyrecord_destroy(localRecord);
+	return true;
+}
+
+static bool load_position(struct Position* restrict position)
+{
+	memset(position, 0, sizeof(*position));
+	position->val0mod1off[0] = 1;
+	position->curStartValue = 3;
+
+	size_t fileSize = 0;
+	struct CzFileFlags fileFlags = {0};
+	fileFlags.relativeToExe = true;
+
+	enum CzResult czres = czFileSize(CZ_PROGRESS_FILE_NAME, &fileSize, fileFlags);
+	if CZ_NOEXPECT (czres && czres != CZ_RESULT_NO_FILE) { return false; }
+
+	if (czgConfig.restart || !fileSize) {
+		return true;
+	}
+
+	CzU64 val0mod1off0Upper, val0mod1off0Lower;
+	CzU64 val0mod1off1Upper, val0mod1off1Lower;
+	CzU64 val0mod1off2Upper, val0mod1off2Lower;
+	CzU64 val1mod6off0Upper, val1mod6off0Lower;
+	CzU64 val1mod6off1Upper, val1mod6off1Lower;
+	CzU64 val1mod6off2Upper, val1mod6off2Lower;
+	CzU64 curValueUpper, curValueLower;
+	CzU16 bestTime;
+
+	bool bres = read_text(
+		CZ_PROGRESS_FILE_NAME,
+		"%" SCNx64 " %" SCNx64 "\n"
+		"%" SCNx64 " %" SCNx64 "\n"
+		"%" SCNx64 " %" SCNx64 "\n"
+		"%" SCNx64 " %" SCNx64 "\n"
+		"%" SCNx64 " %" SCNx64 "\n"
+		"%" SCNx64 " %" SCNx64 "\n"
+		"%" SCNx64 " %" SCNx64 "\n"
+		"%" SCNx16,
+		&val0mod1off0Upper, &val0mod1off0Lower,
+		&val0mod1off1Upper, &val0mod1off1Lower,
+		&val0mod1off2Upper, &val0mod1off2Lower,
+		&val1mod6off0Upper, &val1mod6off0Lower,
+		&val1mod6off1Upper, &val1mod6off1Lower,
+		&val1mod6off2Upper, &val1mod6off2Lower,
+		&curValueUpper, &curValueLower, &bestTime);
+
+	if CZ_NOEXPECT (!bres) { return false; }
+
+	position->val0mod1off[0] = CZ_U128(val0mod1off0Upper, val0mod1off0Lower);
+	position->val0mod1off[1] = CZ_U128(val0mod1off1Upper, val0mod1off1Lower);
+	position->val0mod1off[2] = CZ_U128(val0mod1off2Upper, val0mod1off2Lower);
+
+	position->val1mod6off[0] = CZ_U128(val1mod6off0Upper, val1mod6off0Lower);
+	position->val1mod6off[1] = CZ_U128(val1mod6off1Upper, val1mod6off1Lower);
+	position->val1mod6off[2] = CZ_U128(val1mod6off2Upper, val1mod6off2Lower);
+
+	position->curStartValue = CZ_U128(curValueUpper, curValueLower);
+	position->bestStopTime = bestTime;
+
+	return true;
+}
+
+static bool save_position(const struct Position* restrict position)
+{
+	if (czgConfig.restart) {
+		return true;
+	}
+
+	bool bres = write_text(
+		CZ_PROGRESS_FILE_NAME,
+		"%016" PRIx64 " %016" PRIx64 "\n"
+		"%016" PRIx64 " %016" PRIx64 "\n"
+		"%016" PRIx64 " %016" PRIx64 "\n"
+		"%016" PRIx64 " %016" PRIx64 "\n"
+		"%016" PRIx64 " %016" PRIx64 "\n"
+		"%016" PRIx64 " %016" PRIx64 "\n"
+		"%016" PRIx64 " %016" PRIx64 "\n"
+		"%04"  PRIx16,
+		CZ_U128_UPPER(position->val0mod1off[0]), CZ_U128_LOWER(position->val0mod1off[0]),
+		CZ_U128_UPPER(position->val0mod1off[1]), CZ_U128_LOWER(position->val0mod1off[1]),
+		CZ_U128_UPPER(position->val0mod1off[2]), CZ_U128_LOWER(position->val0mod1off[2]),
+		CZ_U128_UPPER(position->val1mod6off[0]), CZ_U128_LOWER(position->val1mod6off[0]),
+		CZ_U128_UPPER(position->val1mod6off[1]), CZ_U128_LOWER(position->val1mod6off[1]),
+		CZ_U128_UPPER(position->val1mod6off[2]), CZ_U128_LOWER(position->val1mod6off[2]),
+		CZ_U128_UPPER(position->curStartValue),  CZ_U128_LOWER(position->curStartValue),
+		position->bestStopTime);
+
+	if CZ_NOEXPECT (!bres) { return false; }
+
+	CZ_PROBE(
+		checkpoint, CZ_U128_UPPER(position->curStartValue), CZ_U128_LOWER(position->curStartValue),
+		position->bestStopTime);
+
+	return true;
+}
+
+static void print_results(
+	const struct Position* restrict position,
+	DyArray bestStartValues,
+	DyArray bestStopTimes,
+	CzU128 initialStartValue,
+	CzU128 total,
+	CzU64 totalSteps,
+	double totalBmark)
+{
+	if (czgConfig.outputLevel > CZ_OUTPUT_LEVEL_SILENT) {
+		printf(
+			"Set of starting values tested: [0x %016" PRIx64 " %016" PRIx64 ", 0x %016" PRIx64 " %016" PRIx64 "]\n",
+			CZ_U128_UPPER(initialStartValue - 2),       CZ_U128_LOWER(initialStartValue - 2),
+			CZ_U128_UPPER(position->curStartValue - 3), CZ_U128_LOWER(position->curStartValue - 3));
+	}
+
+	size_t bestCount = dyarray_size(bestStartValues);
+
+	if (bestCount) {
+		printf(
+			"New highest total stopping times (%zu):\n"
+			"|   #   |   Starting value (hexadecimal)    | Total stopping time |\n",
+			bestCount);
+	}
+
+	for (CzU32 i = 0; i < bestCount; i++) {
+		CzU128 startValue;
+		CzU16 stopTime;
+
+		dyarray_get(bestStartValues, &startValue, i);
+		dyarray_get(bestStopTimes, &stopTime, i);
+
+		printf(
+			"| %5" PRIu32 " | %016" PRIx64 " %016" PRIx64 " | %19" PRIu16 " |\n",
+			i + 1, CZ_U128_UPPER(startValue), CZ_U128_LOWER(startValue), stopTime);
+	}
+
+	if (czgConfig.outputLevel > CZ_OUTPUT_LEVEL_SILENT) {
+		double valuesPerSecond = (double) (1000 * total) / totalBmark;
+		double stepsPerSecond = (double) (1000 * totalSteps) / totalBmark;
+
+		printf(
+			"\n"
+			"Time: %.3fms\n"
+			"Speed: %.3f/s (%.3f steps/s)\n",
+			totalBmark, valuesPerSecond, stepsPerSecond);
+
+		latency_total();
+	}
+}
+
+static bool budget_changed(const struct Gpu* restrict gpu, bool* restrict changed)
+{
+	VkPhysicalDevice physicalDevice = gpu->physicalDevice;
+
+	CzU32 hostVisibleHeapIndex = gpu->hostVisibleHeapIndex;
+	CzU32 hostVisibleOutHeapIndex = gpu->hostVisibleOutHeapIndex;
+	CzU32 deviceLocalHeapIndex = gpu->deviceLocalHeapIndex;
+
+	VkDeviceSize oldHostVisibleBudget = gpu->hostVisibleHeapBudget;
+	VkDeviceSize oldHostVisibleOutBudget = gpu->hostVisibleOutHeapBudget;
+	VkDeviceSize oldDeviceLocalBudget = gpu->deviceLocalHeapBudget;
+
+	VkPhysicalDeviceMemoryBudgetPropertiesEXT deviceBudgetProperties = {0};
+	deviceBudgetProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_BUDGET_PROPERTIES_EXT;
+
+	VkPhysicalDeviceMemoryProperties2 deviceMemoryProperties = {0};
+	deviceMemoryProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PROPERTIES_2;
+	deviceMemoryProperties.pNext = &deviceBudgetProperties;
+
+	VK_CALL(vkGetPhysicalDeviceMemoryProperties2, physicalDevice, &deviceMemoryProperties);
+
+	VkDeviceSize newHostVisibleBudget = deviceBudgetProperties.heapBudget[hostVisibleHeapIndex];
+	VkDeviceSize newHostVisibleOutBudget = deviceBudgetProperties.heapBudget[hostVisibleOutHeapIndex];
+	VkDeviceSize newDeviceLocalBudget = deviceBudgetProperties.heapBudget[deviceLocalHeapIndex];
+
+	VkDeviceSize hostVisibleChange = newHostVisibleBudget > oldHostVisibleBudget ?
+		newHostVisibleBudget - oldHostVisibleBudget : oldHostVisibleBudget - newHostVisibleBudget;
+
+	VkDeviceSize hostVisibleOutChange = newHostVisibleOutBudget > oldHostVisibleOutBudget ?
+		newHostVisibleOutBudget - oldHostVisibleOutBudget : oldHostVisibleOutBudget - newHostVisibleOutBudget;
+
+	VkDeviceSize deviceLocalChange = newDeviceLocalBudget > oldDeviceLocalBudget ?
+		newDeviceLocalBudget - oldDeviceLocalBudget : oldDeviceLocalBudget - newDeviceLocalBudget;
+
+	// Small fluctuations are not worth recreating every inout-buffer for
+	*changed = hostVisibleChange > oldHostVisibleBudget / 8 || hostVisibleOutChange > oldHostVisibleOutBudget / 8 ||
+		deviceLocalChange > oldDeviceLocalBudget / 8;
+
+	if (*changed && czgConfig.outputLevel > CZ_OUTPUT_LEVEL_DEFAULT) {
+		printf(
+			"Memory budget:\n"
+			"\tHV in heap budget:  %" PRIu64 " -> %" PRIu64 " bytes\n"
+			"\tHV out heap budget: %" PRIu64 " -> %" PRIu64 " bytes\n"
+			"\tDL heap budget:     %" PRIu64 " -> %" PRIu64 " bytes\n\n",
+			(CzU64) oldHostVisibleBudget, (CzU64) newHostVisibleBudget,
+			(CzU64) oldHostVisibleOutBudget, (CzU64) newHostVisibleOutBudget,
+			(CzU64) oldDeviceLocalBudget, (CzU64) newDeviceLocalBudget);
+	}
+
+	return true;
+}
+
+// A device timestamp and the wall_time at which it was sampled, relating device timestamps to the trace timeline
+struct TimestampCalibration
+{
+	CzU64 timestamp;
+	double time;
+};
+
+// Sample the device timestamp and wall_time together, via VK_KHR_calibrated_timestamps
+static bool calibrate_timestamps(VkDevice device, struct TimestampCalibration* restrict calibration)
+{
+	VkResult vkres;
+
+	VkCalibratedTimestampInfoKHR timestampInfos[2] = {0};
+	timestampInfos[0].sType = VK_STRUCTURE_TYPE_CALIBRATED_TIMESTAMP_INFO_KHR;
+	timestampInfos[0].timeDomain = VK_TIME_DOMAIN_DEVICE_KHR;
+	timestampInfos[1].sType = VK_STRUCTURE_TYPE_CALIBRATED_TIMESTAMP_INFO_KHR;
+	timestampInfos[1].timeDomain = CZ_WALL_TIME_DOMAIN;
+
+	CzU64 timestamps[2];
+	CzU64 maxDeviation;
+
+	VK_CALLR(vkGetCalibratedTimestampsKHR,
+		device, CZ_COUNTOF(timestampInfos), timestampInfos, timestamps, &maxDeviation);
+
+	if CZ_NOEXPECT (vkres) { return false; }
+
+	calibration->timestamp = timestamps[0];
+	calibration->time = wall_time_at(timestamps[1]);
+	return true;
+}
+
+// Add device work spanning two timestamps to the trace, placed on the timeline relative to calibration
+static void trace_timestamps(
+	const char* restrict name,
+	enum CzTraceTrack track,
+	CzU32 inout,
+	const CzU64* restrict timestamps,
+	const struct TimestampCalibration* restrict calibration,
+	CzU32 validBits,
+	double timestampPeriod)
+{
+	// Timestamps wrap after validBits bits, so differences are sign-extended from validBits bits
+	CzU32 shift = 64 - validBits;
+	Cz64 startTicks = (Cz64) ((timestamps[0] - calibration->timestamp) << shift) >> shift;
+	Cz64 endTicks = (Cz64) ((timestamps[1] - calibration->timestamp) << shift) >> shift;
+
+	double start = calibration->time + (double) startTicks * timestampPeriod / 1000000;
+	double end = calibration->time + (double) endTicks * timestampPeriod / 1000000;
+
+	trace_event(name, track, inout, start, end);
+}
+
+// Zero size bytes of the stats, starting offset bytes into the stats buffer
+static bool clear_stats(const struct Gpu* restrict gpu, VkDeviceSize offset, VkDeviceSize size)
+{
+	VkDevice device = gpu->device;
+	VkResult vkres;
+
+	memset((char*) gpu->mappedStats + offset, 0, size);
+
+	if (gpu->hostOutNonCoherent) {
+		VkMappedMemoryRange mappedRange = {0};
+		mappedRange.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
+		mappedRange.memory = gpu->statsDeviceMemory;
+		mappedRange.offset = offset;
+		mappedRange.size = size;
+
+		VK_CALLR(vkFlushMappedMemoryRanges, device, 1, &mappedRange);
+		if CZ_NOEXPECT (vkres) { return false; }
+	}
+
+	return true;
+}
+
+/*
+ * Sum the step counters of a staging region over each dispatch of an inout-buffer. The counters are never reset, as
+ * younger generations of the inout-buffer may still be dispatching, so the caller takes the difference between sums.
+ */
+static bool read_steps(const struct Gpu* restrict gpu, CzU32 inout, CzU32 stage, CzU64* restrict steps)
+{
+	VkDevice device = gpu->device;
+
+	VkDeviceSize bytesPerSteps = gpu->bytesPerSteps;
+	VkDeviceSize bytesPerInoutSteps = bytesPerSteps * gpu->dispatchesPerInout;
+	VkDeviceSize offset = bytesPerInoutSteps * inout;
+
+	CzU32 dispatchesPerInout = gpu->dispatchesPerInout;
+
+	VkResult vkres;
+
+	if (gpu->hostOutNonCoherent) {
+		VkMappedMemoryRange mappedRange = {0};
+		mappedRange.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
+		mappedRange.memory = gpu->statsDeviceMemory;
+		mappedRange.offset = offset;
+		mappedRange.size = bytesPerInoutSteps;
+
+		VK_CALLR(vkInvalidateMappedMemoryRanges, device, 1, &mappedRange);
+		if CZ_NOEXPECT (vkres) { return false; }
+	}
+
+	const char* mappedSteps = (const char*) gpu->mappedStats + offset;
+	CzU64 sum = 0;
+
+	for (CzU32 i = 0; i < dispatchesPerInout; i++) {
+		const struct StepCounters* counters = (const struct StepCounters*) (mappedSteps + bytesPerSteps * i);
+
+		CzU64 low = counters->stepSums[stage * 2];
+		CzU64 high = counters->stepSums[stage * 2 + 1];
+		sum += low | high << 32;
+	}
+
+	*steps = sum;
+	return true;
+}
+
+// Add the stats of each dispatch of an inout-buffer to the divergence of the main loop iteration, then zero them
+static bool read_stats(const struct Gpu* restrict gpu, CzU32 inout, struct DivergenceMetrics* restrict divergence)
+{
+	VkDevice device = gpu->device;
+
+	VkDeviceSize bytesPerStats = gpu->bytesPerStats;
+	VkDeviceSize bytesPerInoutStats = bytesPerStats * gpu->dispatchesPerInout;
+	VkDeviceSize bytesPerStepsSection = gpu->bytesPerSteps * gpu->dispatchesPerInout * gpu->inoutsPerHeap;
+	VkDeviceSize offset = bytesPerStepsSection + bytesPerInoutStats * inout;
+
+	CzU32 dispatchesPerInout = gpu->dispatchesPerInout;
+	CzU32 workgroupSize = gpu->workgroupSize;
+	CzU32 workgroupCount = gpu->workgroupCount;
+
+	VkResult vkres;
+
+	if (gpu->hostOutNonCoherent) {
+		VkMappedMemoryRange mappedRange = {0};
+		mappedRange.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
+		mappedRange.memory = gpu->statsDeviceMemory;
+		mappedRange.offset = offset;
+		mappedRange.size = bytesPerInoutStats;
+
+		VK_CALLR(vkInvalidateMappedMemoryRanges, device, 1, &mappedRange);
+		if CZ_NOEXPECT (vkres) { return false; }
+	}
+
+	const char* mappedStats = (const char*) gpu->mappedStats + offset;
+
+	for (CzU32 i = 0; i < dispatchesPerInout; i++) {
+		const struct StatsHeader* header = (const struct StatsHeader*) (mappedStats + bytesPerStats * i);
+		const struct StatsRecord* records = (const struct StatsRecord*) (header + 1);
+
+		for (CzU32 j = 0; j < CZ_COUNTOF(header->histogram); j++) {
+			divergence->histogram[j] += header->histogram[j];
+		}
+
+		for (CzU32 j = 0; j < workgroupCount; j++) {
+			divergence->minStopTime = minu32(divergence->minStopTime, records[j].minCount);
+			divergence->maxStopTime = maxu32(divergence->maxStopTime, records[j].maxCount);
+			divergence->stopTimeSum += records[j].countSum;
+			divergence->busyStopTimeSum += records[j].busyCount;
+			divergence->spreadSum += records[j].spreadSum;
+			divergence->subgroupCount += records[j].subgroupCount;
+			divergence->cycleSum += records[j].cycles;
+		}
+
+		divergence->workgroupCount += workgroupCount;
+		divergence->invocationCount += (CzU64) workgroupCount * workgroupSize;
+	}
+
+	bool bres = clear_stats(gpu, offset, bytesPerInoutStats);
+	if CZ_NOEXPECT (!bres) { return false; }
+
+	return true;
+}
+
+// Display the divergence of the instrumented dispatches of a main loop iteration
+static void print_divergence(const struct DivergenceMetrics* restrict divergence)
+{
+	if (!divergence->invocationCount) {
+		return;
+	}
+
+	double meanStopTime = (double) divergence->stopTimeSum / (double) divergence->invocationCount;
+	double meanSpread = (double) divergence->spreadSum / (double) divergence->subgroupCount;
+	double laneEfficiency = (double) divergence->stopTimeSum / (double) divergence->busyStopTimeSum;
+
+	printf(
+		"Total stopping times: %" PRIu32 " min, %.1f mean, %" PRIu32 " max\n"
+		"Lane efficiency:      %.1f%% (mean subgroup spread %.1f)\n",
+		divergence->minStopTime, meanStopTime, divergence->maxStopTime,
+		laneEfficiency * 100, meanSpread);
+
+	if (divergence->cycleSum) {
+		double meanCycles = (double) divergence->cycleSum / (double) divergence->workgroupCount;
+		printf("Workgroup cycles:     %.0f mean\n", meanCycles);
+	}
+
+	if (czgConfig.outputLevel > CZ_OUTPUT_LEVEL_DEFAULT) {
+		printf("| Total stopping times | Invocations |\n");
+
+		// Each bin holds the total stopping times with the same most significant bit
+		for (CzU32 i = 0; i < CZ_COUNTOF(divergence->histogram); i++) {
+			if (!divergence->histogram[i]) {
+				continue;
+			}
+
+			CzU32 lower = UINT32_C(1) << i;
+			CzU32 upper = (UINT32_C(2) << i) - 1;
+
+			printf("| %8" PRIu32 " - %-9" PRIu32 " | %11" PRIu64 " |\n", lower, upper, divergence->histogram[i]);
+		}
+	}
+}
+
+bool submit_commands(struct Gpu* restrict gpu)
+{
+	const VkAllocationCallbacks* allocator = gpu->allocator;
+	const VkDeviceMemory* hostVisibleMemories = gpu->hostVisibleDeviceMemories;
+	const VkDeviceMemory* hostVisibleOutMemories = gpu->hostVisibleOutDeviceMemories;
+	const VkCommandBuffer* computeCmdBuffers = gpu->computeCmdBuffers;
+	const VkCommandBuffer* transferCmdBuffers = gpu->transferCmdBuffers;
+	const VkSemaphore* semaphores = gpu->semaphores;
+
+	CzU128* const* mappedInBuffers = gpu->mappedInBuffers;
+	CzU16* const* mappedOutBuffers = gpu->mappedOutBuffers;
+
+	VkDevice device = gpu->device;
+
+	VkQueue computeQueue = gpu->computeQueue;
+	VkQueue transferQueue = gpu->transferQueue;
+
+	VkCommandPool initialCmdPool = gpu->initialCmdPool;
+	VkCommandBuffer initialCmdBuffer = gpu->initialCmdBuffer;
+
+	VkQueryPool queryPool = gpu->queryPool;
+
+	VkDeviceSize bytesPerIn = gpu->bytesPerIn;
+	VkDeviceSize bytesPerOut = gpu->bytesPerOut;
+
+	CzU64 valuesPerInout = gpu->valuesPerInout;
+	CzU64 valuesPerHeap = gpu->valuesPerHeap;
+	CzU32 inoutsPerBuffer = gpu->inoutsPerBuffer;
+	CzU32 inoutsPerHeap = gpu->inoutsPerHeap;
+	CzU32 buffersPerHeap = gpu->buffersPerHeap;
+	CzU32 stagesPerInout = gpu->stagesPerInout;
+
+	CzU32 computeFamilyTimestampValidBits = gpu->computeFamilyTimestampValidBits;
+	CzU32 transferFamilyTimestampValidBits = gpu->transferFamilyTimestampValidBits;
+
+	double timestampPeriod = (double) gpu->timestampPeriod;
+	bool hostNonCoherent = gpu->hostNonCoherent;
+	bool hostOutNonCoherent = gpu->hostOutNonCoherent;
+
+	VkResult vkres;
+	size_t allocCount;
+	size_t allocSize;
+	int ires;
+
+	DyRecord localRecord = dyrecord_create();
+	if CZ_NOEXPECT (!localRecord) { return false; }
+
+	// Progress is kept in the gpu struct when resuming after the inout-buffers were resized
+	DyRecord gpuRecord = gpu->allocRecord;
+	DyArray bestStartValues = gpu->bestStartValues;
+	DyArray bestStopTimes = gpu->bestStopTimes;
+	struct Position position = gpu->position;
+
+	bool resuming = bestStartValues != NULL;
+	bool bres;
+
+	if (!resuming) {
+		// Create array of starting values with longest total stopping times
+		size_t elmSize = sizeof(CzU128);
+		size_t elmCount = 32;
+
+		bestStartValues = dyarray_create(elmSize, elmCount);
+		if CZ_NOEXPECT (!bestStartValues) { dyrecord_destroy(localRecord); return false; }
+
+		bres = dyrecord_add(gpuRecord, bestStartValues, dyarray_destroy_stub);
+		if CZ_NOEXPECT (!bres) { dyarray_destroy(bestStartValues); dyrecord_destroy(localRecord); return false; }
+
+		gpu->bestStartValues = bestStartValues;
+
+		// Create array of longest total stopping times found
+		elmSize = sizeof(CzU16);
+		elmCount = 32;
+
+		bestStopTimes = dyarray_create(elmSize, elmCount);
+		if CZ_NOEXPECT (!bestStopTimes) { dyrecord_destroy(localRecord); return false; }
+
+		bres = dyrecord_add(gpuRecord, bestStopTimes, dyarray_destroy_stub);
+		if CZ_NOEXPECT (!bres) { dyarray_destroy(bestStopTimes); dyrecord_destroy(localRecord); return false; }
+
+		gpu->bestStopTimes = bestStopTimes;
+
+		// Use progress file, if it exists
+		bres = load_position(&position);
+		if CZ_NOEXPECT (!bres) { dyrecord_destroy(localRecord); return false; }
+
+		gpu->initialStartValue = position.curStartValue;
+	}
+
+	gpu->resizing = false;
+
+	// Variant benchmarks may have dispatched into the step counters and stats, so both must be zeroed first
+	VkDeviceSize bytesPerStatsBuffer =
+		(gpu->bytesPerSteps + gpu->bytesPerStats) * inoutsPerHeap * gpu->dispatchesPerInout;
+
+	bres = clear_stats(gpu, 0, bytesPerStatsBuffer);
+	if CZ_NOEXPECT (!bres) { dyrecord_destroy(localRecord); return false; }
+
+	// Specify mapped memory ranges of host visible in-buffers
+	VkMappedMemoryRange* inBuffersMappedRanges = NULL;
+
+	if (hostNonCoherent) {
+		allocCount = inoutsPerHeap * stagesPerInout;
+		allocSize = sizeof(VkMappedMemoryRange);
+
+		inBuffersMappedRanges = dyrecord_calloc(localRecord, allocCount, allocSize);
+		if CZ_NOEXPECT (!inBuffersMappedRanges) { dyrecord_destroy(localRecord); return false; }
+
+		for (CzU32 i = 0, j = 0; i < buffersPerHeap; i++) {
+			for (CzU32 k = 0; k < inoutsPerBuffer; k++) {
+				for (CzU32 l = 0; l < stagesPerInout; j++, l++) {
+					inBuffersMappedRanges[j].sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
+					inBuffersMappedRanges[j].memory = hostVisibleMemories[i];
+					inBuffersMappedRanges[j].offset = bytesPerIn * (inoutsPerBuffer * l + k);
+					inBuffersMappedRanges[j].size = bytesPerIn;
+				}
+			}
+		}
+	}
+
+	// Specify mapped memory ranges of host visible out-buffers
+	VkMappedMemoryRange* outBuffersMappedRanges = NULL;
+
+	if (hostOutNonCoherent) {
+		allocCount = inoutsPerHeap * stagesPerInout;
+		allocSize = sizeof(VkMappedMemoryRange);
+
+		outBuffersMappedRanges = dyrecord_calloc(localRecord, allocCount, allocSize);
+		if CZ_NOEXPECT (!outBuffersMappedRanges) { dyrecord_destroy(localRecord); return false; }
+
+		for (CzU32 i = 0, j = 0; i < buffersPerHeap; i++) {
+			for (CzU32 k = 0; k < inoutsPerBuffer; k++) {
+				for (CzU32 l = 0; l < stagesPerInout; j++, l++) {
+					outBuffersMappedRanges[j].sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
+					outBuffersMappedRanges[j].memory = hostVisibleOutMemories[i];
+					outBuffersMappedRanges[j].offset = bytesPerOut * (inoutsPerBuffer * l + k);
+					outBuffersMappedRanges[j].size = bytesPerOut;
+				}
+			}
+		}
+	}
+
+	// Specify initial command buffer for submission
+	VkCommandBufferSubmitInfo initialCmdBufferSubmitInfo = {0};
+	initialCmdBufferSubmitInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO;
+	initialCmdBufferSubmitInfo.commandBuffer = initialCmdBuffer;
+
+	// Specify transfer command buffers for submission (one per staging region)
+	allocCount = inoutsPerHeap * stagesPerInout;
+	allocSize = sizeof(VkCommandBufferSubmitInfo);
+
+	VkCommandBufferSubmitInfo* transferCmdBufferSubmitInfos = dyrecord_calloc(localRecord, allocCount, allocSize);
+	if CZ_NOEXPECT (!transferCmdBufferSubmitInfos) { dyrecord_destroy(localRecord); return false; }
+
+	for (CzU32 i = 0; i < inoutsPerHeap * stagesPerInout; i++) {
+		transferCmdBufferSubmitInfos[i].sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO;
+		transferCmdBufferSubmitInfos[i].commandBuffer = transferCmdBuffers[i];
+	}
+
+	// Specify compute command buffers for submission (one per staging region)
+	allocCount = inoutsPerHeap * stagesPerInout;
+	allocSize = sizeof(VkCommandBufferSubmitInfo);
+
+	VkCommandBufferSubmitInfo* computeCmdBufferSubmitInfos = dyrecord_calloc(localRecord, allocCount, allocSize);
+	if CZ_NOEXPECT (!computeCmdBufferSubmitInfos) { dyrecord_destroy(localRecord); return false; }
+
+	for (CzU32 i = 0; i < inoutsPerHeap * stagesPerInout; i++) {
+		computeCmdBufferSubmitInfos[i].sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO;
+		computeCmdBufferSubmitInfos[i].commandBuffer = computeCmdBuffers[i];
+	}
+
+	// Specify semaphore wait operations for submissions to transfer queue
+	allocCount = inoutsPerHeap;
+	allocSize = sizeof(VkSemaphoreSubmitInfo);
+
+	VkSemaphoreSubmitInfo* transferWaitSemaphoreSubmitInfos = dyrecord_calloc(localRecord, allocCount, allocSize);
+	if CZ_NOEXPECT (!transferWaitSemaphoreSubmitInfos) { dyrecord_destroy(localRecord); return false; }
+
+	for (CzU32 i = 0; i < inoutsPerHeap; i++) {
+		transferWaitSemaphoreSubmitInfos[i].sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO;
+		transferWaitSemaphoreSubmitInfos[i].semaphore = semaphores[i];
+		transferWaitSemaphoreSubmitInfos[i].value = 0;
+		transferWaitSemaphoreSubmitInfos[i].stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT; // Include acquire op
+	}
+
+	// Specify semaphore signal operations for submissions to transfer queue
+	allocCount = inoutsPerHeap;
+	allocSize = sizeof(VkSemaphoreSubmitInfo);
+
+	VkSemaphoreSubmitInfo* transferSignalSemaphoreSubmitInfos = dyrecord_calloc(localRecord, allocCount, allocSize);
+	if CZ_NOEXPECT (!transferSignalSemaphoreSubmitInfos) { dyrecord_destroy(localRecord); return false; }
+
+	for (CzU32 i = 0; i < inoutsPerHeap; i++) {
+		transferSignalSemaphoreSubmitInfos[i].sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO;
+		transferSignalSemaphoreSubmitInfos[i].semaphore = semaphores[i];
+		transferSignalSemaphoreSubmitInfos[i].value = 1;
+		transferSignalSemaphoreSubmitInfos[i].stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT; // Include release op
+	}
+
+	// Specify semaphore wait operations for submissions to compute queue
+	allocCount = inoutsPerHeap;
+	allocSize = sizeof(VkSemaphoreSubmitInfo);
+
+	VkSemaphoreSubmitInfo* computeWaitSemaphoreSubmitInfos = dyrecord_calloc(localRecord, allocCount, allocSize);
+	if CZ_NOEXPECT (!computeWaitSemaphoreSubmitInfos) { dyrecord_destroy(localRecord); return false; }
+
+	for (CzU32 i = 0; i < inoutsPerHeap; i++) {
+		computeWaitSemaphoreSubmitInfos[i].sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO;
+		computeWaitSemaphoreSubmitInfos[i].semaphore = semaphores[i];
+		computeWaitSemaphoreSubmitInfos[i].value = 1;
+		computeWaitSemaphoreSubmitInfos[i].stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT; // Include acquire op
+	}
+
+	// Specify semaphore signal operations for submissions to compute queue
+	allocCount = inoutsPerHeap;
+	allocSize = sizeof(VkSemaphoreSubmitInfo);
+
+	VkSemaphoreSubmitInfo* computeSignalSemaphoreSubmitInfos = dyrecord_calloc(localRecord, allocCount, allocSize);
+	if CZ_NOEXPECT (!computeSignalSemaphoreSubmitInfos) { dyrecord_destroy(localRecord); return false; }
+
+	for (CzU32 i = 0; i < inoutsPerHeap; i++) {
+		computeSignalSemaphoreSubmitInfos[i].sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO;
+		computeSignalSemaphoreSubmitInfos[i].semaphore = semaphores[i];
+		computeSignalSemaphoreSubmitInfos[i].value = 2;
+		computeSignalSemaphoreSubmitInfos[i].stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT; // Include release op
+	}
+
+	// Specify submission of initial command buffer
+	VkSubmitInfo2 initialSubmitInfo = {0};
+	initialSubmitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO_2;
+	initialSubmitInfo.commandBufferInfoCount = 1;
+	initialSubmitInfo.pCommandBufferInfos = &initialCmdBufferSubmitInfo;
+	initialSubmitInfo.signalSemaphoreInfoCount = inoutsPerHeap;
+	initialSubmitInfo.pSignalSemaphoreInfos = transferSignalSemaphoreSubmitInfos;
+
+	// Specify submissions to transfer queue
+	allocCount = inoutsPerHeap;
+	allocSize = sizeof(VkSubmitInfo2);
+
+	VkSubmitInfo2* transferSubmitInfos = dyrecord_calloc(localRecord, allocCount, allocSize);
+	if CZ_NOEXPECT (!transferSubmitInfos) { dyrecord_destroy(localRecord); return false; }
+
+	for (CzU32 i = 0; i < inoutsPerHeap; i++) {
+		transferSubmitInfos[i].sType = VK_STRUCTURE_TYPE_SUBMIT_INFO_2;
+		transferSubmitInfos[i].waitSemaphoreInfoCount = 1;
+		transferSubmitInfos[i].pWaitSemaphoreInfos = &transferWaitSemaphoreSubmitInfos[i];
+		transferSubmitInfos[i].commandBufferInfoCount = 1;
+		transferSubmitInfos[i].pCommandBufferInfos = &transferCmdBufferSubmitInfos[i * stagesPerInout];
+		transferSubmitInfos[i].signalSemaphoreInfoCount = 1;
+		transferSubmitInfos[i].pSignalSemaphoreInfos = &transferSignalSemaphoreSubmitInfos[i];
+	}
+
+	// Specify submissions to compute queue
+	allocCount = inoutsPerHeap;
+	allocSize = sizeof(VkSubmitInfo2);
+
+	VkSubmitInfo2* computeSubmitInfos = dyrecord_calloc(localRecord, allocCount, allocSize);
+	if CZ_NOEXPECT (!computeSubmitInfos) { dyrecord_destroy(localRecord); return false; }
+
+	for (CzU32 i = 0; i < inoutsPerHeap; i++) {
+		computeSubmitInfos[i].sType = VK_STRUCTURE_TYPE_SUBMIT_INFO_2;
+		computeSubmitInfos[i].waitSemaphoreInfoCount = 1;
+		computeSubmitInfos[i].pWaitSemaphoreInfos = &computeWaitSemaphoreSubmitInfos[i];
+		computeSubmitInfos[i].commandBufferInfoCount = 1;
+		computeSubmitInfos[i].pCommandBufferInfos = &computeCmdBufferSubmitInfos[i * stagesPerInout];
+		computeSubmitInfos[i].signalSemaphoreInfoCount = 1;
+		computeSubmitInfos[i].pSignalSemaphoreInfos = &computeSignalSemaphoreSubmitInfos[i];
+	}
+
+	// Specify semaphore values awaited on host for transfer queue (trailing submitted values when pipelining)
+	allocCount = inoutsPerHeap;
+	allocSize = sizeof(CzU64);
+
+	CzU64* transferWaitValues = dyrecord_calloc(localRecord, allocCount, allocSize);
+	if CZ_NOEXPECT (!transferWaitValues) { dyrecord_destroy(localRecord); return false; }
+
+	for (CzU32 i = 0; i < inoutsPerHeap; i++) {
+		transferWaitValues[i] = 1;
+	}
+
+	// Specify semaphore wait operations for transfer queue on host
+	allocCount = inoutsPerHeap;
+	allocSize = sizeof(VkSemaphoreWaitInfo);
+
+	VkSemaphoreWaitInfo* transferSemaphoreWaitInfos = dyrecord_calloc(localRecord, allocCount, allocSize);
+	if CZ_NOEXPECT (!transferSemaphoreWaitInfos) { dyrecord_destroy(localRecord); return false; }
+
+	for (CzU32 i = 0; i < inoutsPerHeap; i++) {
+		transferSemaphoreWaitInfos[i].sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+		transferSemaphoreWaitInfos[i].semaphoreCount = 1;
+		transferSemaphoreWaitInfos[i].pSemaphores = &semaphores[i];
+		transferSemaphoreWaitInfos[i].pValues = &transferWaitValues[i];
+	}
+
+	// Specify semaphore values awaited on host for compute queue (trailing submitted values when pipelining)
+	allocCount = inoutsPerHeap;
+	allocSize = sizeof(CzU64);
+
+	CzU64* computeWaitValues = dyrecord_calloc(localRecord, allocCount, allocSize);
+	if CZ_NOEXPECT (!computeWaitValues) { dyrecord_destroy(localRecord); return false; }
+
+	for (CzU32 i = 0; i < inoutsPerHeap; i++) {
+		computeWaitValues[i] = 2;
+	}
+
+	// Specify semaphore wait operations for compute queue on host
+	allocCount = inoutsPerHeap;
+	allocSize = sizeof(VkSemaphoreWaitInfo);
+
+	VkSemaphoreWaitInfo* computeSemaphoreWaitInfos = dyrecord_calloc(localRecord, allocCount, allocSize);
+	if CZ_NOEXPECT (!computeSemaphoreWaitInfos) { dyrecord_destroy(localRecord); return false; }
+
+	for (CzU32 i = 0; i < inoutsPerHeap; i++) {
+		computeSemaphoreWaitInfos[i].sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+		computeSemaphoreWaitInfos[i].semaphoreCount = 1;
+		computeSemaphoreWaitInfos[i].pSemaphores = &semaphores[i];
+		computeSemaphoreWaitInfos[i].pValues = &computeWaitValues[i];
+	}
+
+	// Create array keeping track of initial tested starting value for each inout-buffer
+	allocCount = inoutsPerHeap;
+	allocSize = sizeof(CzU128);
+
+	CzU128* testedValues = dyrecord_calloc(localRecord, allocCount, allocSize);
+	if CZ_NOEXPECT (!testedValues) { dyrecord_destroy(localRecord); return false; }
+
+	// Create arrays keeping track of latest read/write benchmarks for each inout-buffer
 	allocCount = inoutsPerHeap;
-	allocSize = sizeof(VkCopyBufferInfo2);
+	allocSize = sizeof(double);
 
-	VkCopyBufferInfo2* inBufferCopyInfos = dyrecord_calloc(localRecord, allocCount, allocSize);
-	if CZ_NOEXPECT (!inBufferCopyInfos) { dyrecord_destroy(localRecord); return false; }
+	double* readBmarks = dyrecord_calloc(localRecord, allocCount, allocSize);
+	if CZ_NOEXPECT (!readBmarks) { dyrecord_destroy(localRecord); return false; }
 
-	for (CzU32 i = 0, j = 0; i < buffersPerHeap; i++) {
-		VkBuffer hostVisibleBuffer = hostVisibleBuffers[i];
-		VkBuffer deviceLocalBuffer = deviceLocalBuffers[i];
+	double* writeBmarks = dyrecord_calloc(localRecord, allocCount, allocSize);
+	if CZ_NOEXPECT (!writeBmarks) { dyrecord_destroy(localRecord); return false; }
 
-		for (CzU32 k = 0; k < inoutsPerBuffer; j++, k++) {
-			inBufferCopyInfos[j].sType = VK_STRUCTURE_TYPE_COPY_BUFFER_INFO_2;
-			inBufferCopyInfos[j].srcBuffer = hostVisibleBuffer;
-			inBufferCopyInfos[j].dstBuffer = deviceLocalBuffer;
-			inBufferCopyInfos[j].regionCount = 1;
-			inBufferCopyInfos[j].pRegions = &inBufferRegions[k];
+	// Create array keeping track of latest step counter sums for each staging region
+	allocCount = inoutsPerHeap * stagesPerInout;
+	allocSize = sizeof(CzU64);
+
+	CzU64* lastSteps = dyrecord_calloc(localRecord, allocCount, allocSize);
+	if CZ_NOEXPECT (!lastSteps) { dyrecord_destroy(localRecord); return false; }
+
+	double totalBmStart = wall_time();
+	CzU128 tested = position.curStartValue;
+
+	// Write starting values to mapped in-buffers (one generation per staging region)
+	for (CzU32 i = 0; i < inoutsPerHeap; i++) {
+		testedValues[i] = tested;
+
+		for (CzU32 j = 0; j < stagesPerInout; j++) {
+			write_inbuffer(mappedInBuffers[i * stagesPerInout + j], &testedValues[i], valuesPerInout, valuesPerHeap);
 		}
+
+		tested += valuesPerInout * 4;
 	}
 
-	// Specify out-buffer copies
-	allocCount = inoutsPerHeap;
-	allocSize = sizeof(VkCopyBufferInfo2);
+	if (hostNonCoherent) {
+		CzU32 rangeCount = inoutsPerHeap * stagesPerInout;
+		VK_CALLR(vkFlushMappedMemoryRanges, device, rangeCount, inBuffersMappedRanges);
+		if CZ_NOEXPECT (vkres) { dyrecord_destroy(localRecord); return false; }
+	}
 
-	VkCopyBufferInfo2* outBufferCopyInfos = dyrecord_calloc(localRecord, allocCount, allocSize);
-	if CZ_NOEXPECT (!outBufferCopyInfos) { dyrecord_destroy(localRecord); return false; }
+	// Initiate the first cycle
+	CzU32 submitInfoCount = 1;
+	VK_CALLR(vkQueueSubmit2KHR, transferQueue, submitInfoCount, &initialSubmitInfo, VK_NULL_HANDLE);
+	if CZ_NOEXPECT (vkres) { dyrecord_destroy(localRecord); return false; }
 
-	for (CzU32 i = 0, j = 0; i < buffersPerHeap; i++) {
-		VkBuffer hostVisibleBuffer = hostVisibleBuffers[i];
-		VkBuffer deviceLocalBuffer = deviceLocalBuffers[i];
+	submitInfoCount = inoutsPerHeap;
+	VK_CALLR(vkQueueSubmit2KHR, computeQueue, submitInfoCount, computeSubmitInfos, VK_NULL_HANDLE);
+	if CZ_NOEXPECT (vkres) { dyrecord_destroy(localRecord); return false; }
 
-		for (CzU32 k = 0; k < inoutsPerBuffer; j++, k++) {
-			outBufferCopyInfos[j].sType = VK_STRUCTURE_TYPE_COPY_BUFFER_INFO_2;
-			outBufferCopyInfos[j].srcBuffer = deviceLocalBuffer;
-			outBufferCopyInfos[j].dstBuffer = hostVisibleBuffer;
-			outBufferCopyInfos[j].regionCount = 1;
-			outBufferCopyInfos[j].pRegions = &outBufferRegions[k];
+	/*
+	 * Queue the cycles of the remaining staging regions. Every submission only waits on semaphore values signalled by
+	 * earlier submissions, so neither queue stalls on work the host is yet to submit.
+	 */
+	for (CzU32 i = 1; i < stagesPerInout; i++) {
+		for (CzU32 j = 0; j < inoutsPerHeap; j++) {
+			transferWaitSemaphoreSubmitInfos[j].value += 2;
+			transferSignalSemaphoreSubmitInfos[j].value += 2;
+			transferSubmitInfos[j].pCommandBufferInfos = &transferCmdBufferSubmitInfos[j * stagesPerInout + i];
 		}
-	}
 
-	// Specify descriptor set bindings
-	allocCount = inoutsPerHeap;
-	allocSize = sizeof(VkBindDescriptorSetsInfo);
+		submitInfoCount = inoutsPerHeap;
+		VK_CALLR(vkQueueSubmit2KHR, transferQueue, submitInfoCount, transferSubmitInfos, VK_NULL_HANDLE);
+		if CZ_NOEXPECT (vkres) { dyrecord_destroy(localRecord); return false; }
 
-	VkBindDescriptorSetsInfo* bindDescriptorSetsInfos = dyrecord_calloc(localRecord, allocCount, allocSize);
-	if CZ_NOEXPECT (!bindDescriptorSetsInfos) { dyrecord_destroy(localRecord); return false; }
+		for (CzU32 j = 0; j < inoutsPerHeap; j++) {
+			computeWaitSemaphoreSubmitInfos[j].value += 2;
+			computeSignalSemaphoreSubmitInfos[j].value += 2;
+			computeSubmitInfos[j].pCommandBufferInfos = &computeCmdBufferSubmitInfos[j * stagesPerInout + i];
+		}
+
+		submitInfoCount = inoutsPerHeap;
+		VK_CALLR(vkQueueSubmit2KHR, computeQueue, submitInfoCount, computeSubmitInfos, VK_NULL_HANDLE);
+		if CZ_NOEXPECT (vkres) { dyrecord_destroy(localRecord); return false; }
+	}
 
 	for (CzU32 i = 0; i < inoutsPerHeap; i++) {
-		bindDescriptorSetsInfos[i].sType = VK_STRUCTURE_TYPE_BIND_DESCRIPTOR_SETS_INFO;
-		bindDescriptorSetsInfos[i].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
-		bindDescriptorSetsInfos[i].layout = pipelineLayout;
-		bindDescriptorSetsInfos[i].firstSet = 0;
-		bindDescriptorSetsInfos[i].descriptorSetCount = 1;
-		bindDescriptorSetsInfos[i].pDescriptorSets = &descriptorSets[i];
+		// Wait for transfers to complete execution
+		CzU64 transferTimeout = UINT64_MAX;
+		VK_CALLR(vkWaitSemaphoresKHR, device, &transferSemaphoreWaitInfos[i], transferTimeout);
+		if CZ_NOEXPECT (vkres) { dyrecord_destroy(localRecord); return false; }
+
+		// Write starting values to first mapped in-buffer
+		CzU32 staging = i * stagesPerInout;
+		write_inbuffer(mappedInBuffers[staging], &testedValues[i], valuesPerInout, valuesPerHeap);
+
+		if (hostNonCoherent) {
+			CzU32 rangeCount = 1;
+			VK_CALLR(vkFlushMappedMemoryRanges, device, rangeCount, &inBuffersMappedRanges[staging]);
+			if CZ_NOEXPECT (vkres) { dyrecord_destroy(localRecord); return false; }
+		}
+
+		// Update semaphore wait/signal values
+		transferWaitValues[i] += 2;
+		transferWaitSemaphoreSubmitInfos[i].value += 2;
+		transferSignalSemaphoreSubmitInfos[i].value += 2;
+		transferSubmitInfos[i].pCommandBufferInfos = &transferCmdBufferSubmitInfos[staging];
+	}
+
+	// Complete the first cycle (and initiate the next)
+	submitInfoCount = inoutsPerHeap;
+	VK_CALLR(vkQueueSubmit2KHR, transferQueue, submitInfoCount, transferSubmitInfos, VK_NULL_HANDLE);
+	if CZ_NOEXPECT (vkres) { dyrecord_destroy(localRecord); return false; }
+
+	// Initial command buffer and pool are no longer needed
+	VK_CALL(vkDestroyCommandPool, device, initialCmdPool, allocator);
+	gpu->initialCmdPool = VK_NULL_HANDLE;
+
+	CzU128 total = 0;
+	CzU64 totalSteps = 0;
+	CzU64 loopCount = gpu->loopCount; // Main loop iterations completed before any resize
+	CzU128 curStartValue = position.curStartValue; // Position itself is owned by the reader thread from here
+	CzU16 bestStopTime = position.bestStopTime;
+	CzU64 recordCount = dyarray_size(bestStartValues);
+	CzU128 bestStartValue = 0;
+
+	if (recordCount) {
+		dyarray_last(bestStartValues, &bestStartValue);
+	}
+
+	// Create array keeping track of greatest total stopping time of each chunk of an out-buffer
+	CzU32 valuesPerChunk = (CzU32) minu64(valuesPerInout, 4096); // Multiple of 128, as required by read_outbuffer
+	CzU32 chunksPerInout = (CzU32) ((valuesPerInout + valuesPerChunk - 1) / valuesPerChunk);
+	CzU32 scannerCount = (CzU32) czgConfig.readThreads - 1;
+
+	allocCount = chunksPerInout;
+	allocSize = sizeof(CzU16);
+
+	CzU16* maxStopTimes = dyrecord_calloc(localRecord, allocCount, allocSize);
+	if CZ_NOEXPECT (!maxStopTimes) { dyrecord_destroy(localRecord); return false; }
+
+	// Create array of scanner threads helping the reader thread
+	allocCount = scannerCount + 1;
+	allocSize = sizeof(pthread_t);
+
+	pthread_t* scannerThreads = dyrecord_calloc(localRecord, allocCount, allocSize);
+	if CZ_NOEXPECT (!scannerThreads) { dyrecord_destroy(localRecord); return false; }
+
+	allocCount = scannerCount + 1;
+	allocSize = sizeof(struct OutbufferScanner);
+
+	struct OutbufferScanner* scanners = dyrecord_calloc(localRecord, allocCount, allocSize);
+	if CZ_NOEXPECT (!scanners) { dyrecord_destroy(localRecord); return false; }
+
+	/*
+	 * Create queues between threads. The first four connect the main thread to the writer and reader threads, with at
+	 * most two tasks and a stop task in flight at once. The rest connect the reader thread to each scanner thread,
+	 * with at most one task and a stop task in flight at once.
+	 */
+	allocCount = 4 + scannerCount * 2;
+	allocSize = sizeof(struct HostQueue);
+
+	struct HostQueue* hostQueues = dyrecord_calloc(localRecord, allocCount, allocSize);
+	if CZ_NOEXPECT (!hostQueues) { dyrecord_destroy(localRecord); return false; }
+
+	struct HostQueue* writerTasks = &hostQueues[0];
+	struct HostQueue* writerResults = &hostQueues[1];
+	struct HostQueue* readerTasks = &hostQueues[2];
+	struct HostQueue* readerResults = &hostQueues[3];
+
+	struct HostTask stopTask = {0};
+	stopTask.inout = UINT32_MAX;
+
+	struct ScanTask scanStopTask = {0};
+	scanStopTask.stopTimes = NULL;
+
+	pthread_t writerThread;
+	pthread_t readerThread;
+
+	CzU32 hostQueueCount = 0;
+	CzU32 scannerThreadCount = 0;
+	bool writerCreated = false;
+	bool readerCreated = false;
+
+	for (; hostQueueCount < 4 + scannerCount * 2; hostQueueCount++) {
+		size_t taskSize = hostQueueCount < 4 ? sizeof(struct HostTask) : sizeof(struct ScanTask);
+		size_t taskCount = hostQueueCount < 4 ? 3 : 2;
+
+		bres = host_queue_init(&hostQueues[hostQueueCount], taskSize, taskCount);
+		if CZ_NOEXPECT (!bres) { goto err_stop_workers; }
+	}
+
+	// Create threads to find greatest total stopping time of each chunk of an out-buffer
+	for (; scannerThreadCount < scannerCount; scannerThreadCount++) {
+		CzU32 i = scannerThreadCount;
+		scanners[i].tasks = &hostQueues[4 + i * 2];
+		scanners[i].results = &hostQueues[5 + i * 2];
+
+		ires = pthread_create(&scannerThreads[i], NULL, scan_outbuffers, &scanners[i]);
+		if CZ_NOEXPECT (ires) { PCREATE_FAILURE(ires); goto err_stop_workers; }
 	}
 
-	// Specify buffer memory barriers for initial command buffer
-	allocCount = inoutsPerHeap;
-	allocSize = sizeof(VkBufferMemoryBarrier2);
+	// Create thread to write starting values to mapped in-buffers
+	struct InbufferWriter writer;
+	writer.tasks = writerTasks;
+	writer.results = writerResults;
+	writer.mappedInBuffers = mappedInBuffers;
+	writer.testedValues = testedValues;
+	writer.valuesPerInout = valuesPerInout;
+	writer.valuesPerHeap = valuesPerHeap;
+
+	ires = pthread_create(&writerThread, NULL, write_inbuffers, &writer);
+	if CZ_NOEXPECT (ires) { PCREATE_FAILURE(ires); goto err_stop_workers; }
+
+	writerCreated = true;
+
+	// Create thread to read total stopping times from mapped out-buffers
+	struct OutbufferReader reader;
+	reader.tasks = readerTasks;
+	reader.results = readerResults;
+	reader.scanners = scanners;
+	reader.maxStopTimes = maxStopTimes;
+	reader.mappedOutBuffers = mappedOutBuffers;
+	reader.position = &position;
+	reader.bestStartValues = bestStartValues;
+	reader.bestStopTimes = bestStopTimes;
+	reader.valuesPerInout = valuesPerInout;
+	reader.valuesPerChunk = valuesPerChunk;
+	reader.scannerCount = scannerCount;
+
+	ires = pthread_create(&readerThread, NULL, read_outbuffers, &reader);
+	if CZ_NOEXPECT (ires) { PCREATE_FAILURE(ires); goto err_stop_workers; }
+
+	readerCreated = true;
+
+	/*
+	 * The main thread only waits on semaphores and submits command buffers. Writing in-buffers and reading out-buffers
+	 * is sent to the worker threads, and the transfer command buffer of an inout-buffer is resubmitted once both are
+	 * done. Tasks are collected one inout-buffer late, so the host work overlaps the waits of the next inout-buffer.
+	 */
+	CzU32 pendingCount = 0; // Number of tasks sent to worker threads and not yet collected
+	bool stopping = loopCount >= czgConfig.maxLoops || atomic_load(gpu->input);
+
+	// ===== Enter main loop =====
+	for (CzU64 i = 0; !stopping; i++) {
+		double mainLoopBmStart = wall_time();
+		CzU128 initialValue = curStartValue;
+
+		// Recalibrate every iteration, so drift between the device and host clocks cannot accumulate
+		struct TimestampCalibration calibration = {0};
+
+		if (gpu->usingCalibratedTimestamps) {
+			bres = calibrate_timestamps(device, &calibration);
+			if CZ_NOEXPECT (!bres) { goto err_stop_workers; }
+		}
+
+		double readBmTotal = 0;
+		double writeBmTotal = 0;
+		double waitComputeBmTotal = 0;
+		double waitTransferBmTotal = 0;
+		double computeBmTotal = 0;
+		double transferBmTotal = 0;
+
+		CzU64 loopSteps = 0;
+		CzU64 loopInvocations = 0;
+
+		struct DivergenceMetrics divergence = {0};
+		divergence.minStopTime = UINT32_MAX;
+
+		if (czgConfig.outputLevel > CZ_OUTPUT_LEVEL_SILENT) {
+			printf("Loop #%" PRIu64 "\n", loopCount + i + 1);
+		}
+
+		/*
+		 * Each cycle reads the oldest generation of an inout-buffer, while its stagesPerInout - 1 younger generations
+		 * remain queued on the device. The command buffers resubmitted are those of the dispatch and transfer just
+		 * waited on, so no command buffer is resubmitted while still pending.
+		 */
+		CzU32 computeStage = (CzU32) (i % stagesPerInout);
+		CzU32 transferStage = (CzU32) ((i + 1) % stagesPerInout);
+
+		/*
+		 * The following loop has two invocations of the vkGetQueryPoolResults function. On my Windows/Linux PC, these
+		 * functions always return VK_SUCCESS. But on my Macbook, they very rarely return VK_NOT_READY. I'm yet to find
+		 * a consistent pattern regarding when these failures occur, nor have I found a way to reliably replicate them.
+		 * TODO Figure out what on Earth is going on here???
+		 */
+		for (CzU32 j = 0; j < inoutsPerHeap; j++) {
+			CzU32 computeStaging = j * stagesPerInout + computeStage;
+			CzU32 transferStaging = j * stagesPerInout + transferStage;
+
+			double computeBmark = 0;
+			double transferBmark = 0;
+
+			// Wait for dispatch to complete execution
+			double waitComputeBmStart = wall_time();
+			CZ_PROBE(wait_begin, j, CZ_PROBE_QUEUE_COMPUTE);
+
+			CzU64 computeTimeout = UINT64_MAX;
+			VK_CALLR(vkWaitSemaphoresKHR, device, &computeSemaphoreWaitInfos[j], computeTimeout);
+			if CZ_NOEXPECT (vkres) { goto err_stop_workers; }
+
+			double waitComputeBmEnd = wall_time();
+			CZ_PROBE(wait_end, j, CZ_PROBE_QUEUE_COMPUTE, CZ_PROBE_NS(waitComputeBmEnd - waitComputeBmStart));
+			trace_event("Wait (compute)", CZ_TRACE_TRACK_MAIN, j, waitComputeBmStart, waitComputeBmEnd);
+
+			// Calculate approx time taken for dispatch to execute
+			if (computeFamilyTimestampValidBits) {
+				CzU32 firstQuery = computeStaging * 4;
+				CzU32 queryCount = 2;
+				VkQueryResultFlags queryFlags = VK_QUERY_RESULT_64_BIT;
+
+				CzU64 timestamps[2];
+				VK_CALLR(vkGetQueryPoolResults,
+					device, queryPool, firstQuery, queryCount, sizeof(timestamps), timestamps, sizeof(timestamps[0]),
+					queryFlags);
+
+				if CZ_NOEXPECT (vkres) { goto err_stop_workers; }
+				CzU64 ticks = get_timestamp_ticks(timestamps, computeFamilyTimestampValidBits);
+				computeBmark = (double) ticks * timestampPeriod / 1000000;
+
+				// Without calibration, the dispatch is placed to end when the host saw it complete
+				struct TimestampCalibration waitCalibration = {timestamps[1], waitComputeBmEnd};
+
+				trace_timestamps(
+					"Dispatch", CZ_TRACE_TRACK_COMPUTE, j, timestamps,
+					gpu->usingCalibratedTimestamps ? &calibration : &waitCalibration, computeFamilyTimestampValidBits,
+					timestampPeriod);
+			}
+
+			// Read step counters and stats before the dispatches are resubmitted, as they write to the same regions
+			CzU64 steps;
+			bres = read_steps(gpu, j, computeStage, &steps);
+			if CZ_NOEXPECT (!bres) { goto err_stop_workers; }
+
+			loopSteps += steps - lastSteps[computeStaging];
+			lastSteps[computeStaging] = steps;
+
+			if (gpu->usingPipelineStatistics) {
+				CzU32 firstQuery = computeStaging;
+				CzU32 queryCount = 1;
+				VkQueryResultFlags queryFlags = VK_QUERY_RESULT_64_BIT;
+
+				CzU64 invocations;
+				VK_CALLR(vkGetQueryPoolResults,
+					device, gpu->invocationQueryPool, firstQuery, queryCount, sizeof(invocations), &invocations,
+					sizeof(invocations), queryFlags);
+
+				if CZ_NOEXPECT (vkres) { goto err_stop_workers; }
+				loopInvocations += invocations;
+			}
+
+			if (gpu->instrumenting) {
+				bres = read_stats(gpu, j, &divergence);
+				if CZ_NOEXPECT (!bres) { goto err_stop_workers; }
+			}
+
+			// Update semaphore wait/signal values
+			computeWaitValues[j] += 2;
+			computeWaitSemaphoreSubmitInfos[j].value += 2;
+			computeSignalSemaphoreSubmitInfos[j].value += 2;
+			computeSubmitInfos[j].pCommandBufferInfos = &computeCmdBufferSubmitInfos[computeStaging];
+
+			// Resubmit compute command buffer for next cycle
+			double submitBmStart = wall_time();
+
+			submitInfoCount = 1;
+			VK_CALLR(vkQueueSubmit2KHR, computeQueue, submitInfoCount, &computeSubmitInfos[j], VK_NULL_HANDLE);
+			if CZ_NOEXPECT (vkres) { goto err_stop_workers; }
+
+			CZ_PROBE(submit, j, CZ_PROBE_QUEUE_COMPUTE);
+			trace_event("Submit (compute)", CZ_TRACE_TRACK_MAIN, j, submitBmStart, wall_time());
+
+			// Wait for transfers to complete execution
+			double waitTransferBmStart = wall_time();
+			CZ_PROBE(wait_begin, j, CZ_PROBE_QUEUE_TRANSFER);
+
+			CzU64 transferTimeout = UINT64_MAX;
+			VK_CALLR(vkWaitSemaphoresKHR, device, &transferSemaphoreWaitInfos[j], transferTimeout);
+			if CZ_NOEXPECT (vkres) { goto err_stop_workers; }
+
+			double waitTransferBmEnd = wall_time();
+			CZ_PROBE(wait_end, j, CZ_PROBE_QUEUE_TRANSFER, CZ_PROBE_NS(waitTransferBmEnd - waitTransferBmStart));
+			trace_event("Wait (transfer)", CZ_TRACE_TRACK_MAIN, j, waitTransferBmStart, waitTransferBmEnd);
+
+			// Calculate approx time taken for transfers to execute
+			if (transferFamilyTimestampValidBits) {
+				CzU32 firstQuery = transferStaging * 4 + 2;
+				CzU32 queryCount = 2;
+				VkQueryResultFlags queryFlags = VK_QUERY_RESULT_64_BIT;
+
+				CzU64 timestamps[2];
+				VK_CALLR(vkGetQueryPoolResults,
+					device, queryPool, firstQuery, queryCount, sizeof(timestamps), timestamps, sizeof(timestamps[0]),
+					queryFlags);
+
+				if CZ_NOEXPECT (vkres) { goto err_stop_workers; }
+				CzU64 ticks = get_timestamp_ticks(timestamps, transferFamilyTimestampValidBits);
+				transferBmark = (double) ticks * timestampPeriod / 1000000;
+
+				struct TimestampCalibration waitCalibration = {timestamps[1], waitTransferBmEnd};
+
+				trace_timestamps(
+					"Copy", CZ_TRACE_TRACK_TRANSFER, j, timestamps,
+					gpu->usingCalibratedTimestamps ? &calibration : &waitCalibration, transferFamilyTimestampValidBits,
+					timestampPeriod);
+			}
+
+			if (hostOutNonCoherent) {
+				CzU32 rangeCount = 1;
+				VK_CALLR(vkInvalidateMappedMemoryRanges, device, rangeCount, &outBuffersMappedRanges[transferStaging]);
+				if CZ_NOEXPECT (vkres) { goto err_stop_workers; }
+			}
+
+			// Send staging region to worker threads
+			struct HostTask task = {0};
+			task.inout = j;
+			task.staging = transferStaging;
+
+			bres = host_queue_push(writerTasks, &task);
+			if CZ_NOEXPECT (!bres) { goto err_stop_workers; }
+
+			bres = host_queue_push(readerTasks, &task);
+			if CZ_NOEXPECT (!bres) { goto err_stop_workers; }
+
+			pendingCount++;
+
+			if (j + 1 == inoutsPerHeap) {
+				stopping = loopCount + i + 1 >= czgConfig.maxLoops || atomic_load(gpu->input);
+			}
+
+			// Stop early to join the full memory layout once it has been created in the background
+			if (j + 1 == inoutsPerHeap && !stopping && gpu->rampingUp) {
+				stopping = atomic_load(gpu->rampUpDone);
+				gpu->resizing = stopping;
+			}
+			// Stop early to resize the inout-buffers if the memory budget has since changed
+			else if (j + 1 == inoutsPerHeap && !stopping && gpu->usingMemoryBudget && !gpu->tuningTrial) {
+				bres = budget_changed(gpu, &stopping);
+				if CZ_NOEXPECT (!bres) { goto err_stop_workers; }
+
+				gpu->resizing = stopping;
+			}
+
+			// Collect finished tasks, leaving the latest in flight unless it is of the only inout-buffer
+			CzU32 pendingLimit = inoutsPerHeap > 1 && !stopping ? 1 : 0;
+
+			while (pendingCount > pendingLimit) {
+				struct HostTask writeTask;
+				struct HostTask readTask;
+
+				bres = host_queue_pop(writerResults, &writeTask);
+				if CZ_NOEXPECT (!bres) { goto err_stop_workers; }
+
+				bres = host_queue_pop(readerResults, &readTask);
+				if CZ_NOEXPECT (!bres) { goto err_stop_workers; }
+
+				if CZ_NOEXPECT (writeTask.failed || readTask.failed) { goto err_stop_workers; }
+
+				CzU32 inout = writeTask.inout;
+				CzU32 staging = writeTask.staging;
+
+				if (hostNonCoherent) {
+					CzU32 rangeCount = 1;
+					VK_CALLR(vkFlushMappedMemoryRanges, device, rangeCount, &inBuffersMappedRanges[staging]);
+					if CZ_NOEXPECT (vkres) { goto err_stop_workers; }
+				}
+
+				// Update semaphore wait/signal values
+				transferWaitValues[inout] += 2;
+				transferWaitSemaphoreSubmitInfos[inout].value += 2;
+				transferSignalSemaphoreSubmitInfos[inout].value += 2;
+				transferSubmitInfos[inout].pCommandBufferInfos = &transferCmdBufferSubmitInfos[staging];
+
+				// Resubmit transfer command buffer for next cycle
+				double submitBmStart = wall_time();
+
+				submitInfoCount = 1;
+				VK_CALLR(vkQueueSubmit2KHR,
+					transferQueue, submitInfoCount, &transferSubmitInfos[inout], VK_NULL_HANDLE);
+
+				if CZ_NOEXPECT (vkres) { goto err_stop_workers; }
+
+				CZ_PROBE(submit, inout, CZ_PROBE_QUEUE_TRANSFER);
+				trace_event("Submit (transfer)", CZ_TRACE_TRACK_MAIN, inout, submitBmStart, wall_time());
+
+				readBmarks[inout] = readTask.bmark;
+				writeBmarks[inout] = writeTask.bmark;
+				readBmTotal += readTask.bmark;
+				writeBmTotal += writeTask.bmark;
+
+				curStartValue = readTask.curStartValue;
+				bestStopTime = readTask.bestStopTime;
+				recordCount = readTask.recordCount;
+				bestStartValue = readTask.bestStartValue;
+				pendingCount--;
+			}
+
+			// Calculate and display benchmarks for current inout-buffer
+			double readBmark = readBmarks[j];
+			double writeBmark = writeBmarks[j];
+			double waitComputeBmark = waitComputeBmEnd - waitComputeBmStart;
+			double waitTransferBmark = waitTransferBmEnd - waitTransferBmStart;
+
+			computeBmTotal += computeBmark;
+			transferBmTotal += transferBmark;
+			waitComputeBmTotal += waitComputeBmark;
+			waitTransferBmTotal += waitTransferBmark;
+
+			if (czgConfig.outputLevel > CZ_OUTPUT_LEVEL_QUIET) {
+				printf(
+					"Inout-buffer %" PRIu32 "/%" PRIu32 "\n"
+					"\tReading buffers:    %8.0fms\n"
+					"\tWriting buffers:    %8.0fms\n"
+					"\tCompute execution:  %8.0fms\n"
+					"\tTransfer execution: %8.0fms\n"
+					"\tIdle (compute):     %8.0fms\n"
+					"\tIdle (transfer):    %8.0fms\n",
+					j + 1, inoutsPerHeap,
+					readBmark,        writeBmark,
+					computeBmark,     transferBmark,
+					waitComputeBmark, waitTransferBmark);
+			}
+
+			struct InoutMetrics inoutMetrics;
+			inoutMetrics.loop = loopCount + i + 1;
+			inoutMetrics.inout = j;
+			inoutMetrics.read = readBmark;
+			inoutMetrics.write = writeBmark;
+			inoutMetrics.compute = computeBmark;
+			inoutMetrics.transfer = transferBmark;
+			inoutMetrics.idleCompute = waitComputeBmark;
+			inoutMetrics.idleTransfer = waitTransferBmark;
+
+			if (czgConfig.outputLevel > CZ_OUTPUT_LEVEL_DEFAULT) {
+				metrics_inout(&inoutMetrics);
+			}
 
-	VkBufferMemoryBarrier2* initialBufferMemoryBarriers = dyrecord_calloc(localRecord, allocCount, allocSize);
-	if CZ_NOEXPECT (!initialBufferMemoryBarriers) { dyrecord_destroy(localRecord); return false; }
+			struct StatsProgress progress;
+			progress.currentValue = curStartValue - 3;
+			progress.bestStartValue = bestStartValue;
+			progress.recordCount = recordCount;
+			progress.bestStopTime = bestStopTime;
 
-	for (CzU32 i = 0, j = 0; i < buffersPerHeap; i++) {
-		VkBuffer deviceLocalBuffer = deviceLocalBuffers[i];
+			stats_inout(&inoutMetrics, &progress);
 
-		for (CzU32 k = 0; k < inoutsPerBuffer; j++, k++) {
-			initialBufferMemoryBarriers[j].sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2;
-			initialBufferMemoryBarriers[j].srcStageMask = VK_PIPELINE_STAGE_2_COPY_BIT;
-			initialBufferMemoryBarriers[j].srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
-			initialBufferMemoryBarriers[j].srcQueueFamilyIndex = transferFamilyIndex;
-			initialBufferMemoryBarriers[j].dstQueueFamilyIndex = computeFamilyIndex;
-			initialBufferMemoryBarriers[j].buffer = deviceLocalBuffer;
-			initialBufferMemoryBarriers[j].offset = bytesPerInout * k;
-			initialBufferMemoryBarriers[j].size = bytesPerIn;
+			if (!gpu->tuningTrial) {
+				latency_inout(&inoutMetrics);
+			}
 		}
-	}
-
-	// Specify buffer memory barriers for compute command buffer
-	allocCount = inoutsPerHeap;
-	allocSize = sizeof(VkBufferMemoryBarrier2[2]);
 
-	VkBufferMemoryBarrier2 (*computeBufferMemoryBarriers)[2] = dyrecord_calloc(localRecord, allocCount, allocSize);
-	if CZ_NOEXPECT (!computeBufferMemoryBarriers) { dyrecord_destroy(localRecord); return false; }
+		// Calculate and display benchmarks for current loop iteration
+		total += valuesPerHeap * 4;
+		totalSteps += loopSteps;
+		gpu->loopCount = loopCount + i + 1;
 
-	for (CzU32 i = 0, j = 0; i < buffersPerHeap; i++) {
-		VkBuffer deviceLocalBuffer = deviceLocalBuffers[i];
+		double mainLoopBmark = wall_time() - mainLoopBmStart;
 
-		for (CzU32 k = 0; k < inoutsPerBuffer; j++, k++) {
-			computeBufferMemoryBarriers[j][0].sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2;
-			computeBufferMemoryBarriers[j][0].dstStageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
-			computeBufferMemoryBarriers[j][0].dstAccessMask = VK_ACCESS_2_SHADER_STORAGE_READ_BIT;
-			computeBufferMemoryBarriers[j][0].srcQueueFamilyIndex = transferFamilyIndex;
-			computeBufferMemoryBarriers[j][0].dstQueueFamilyIndex = computeFamilyIndex;
-			computeBufferMemoryBarriers[j][0].buffer = deviceLocalBuffer;
-			computeBufferMemoryBarriers[j][0].offset = bytesPerInout * k;
-			computeBufferMemoryBarriers[j][0].size = bytesPerIn;
+		double readBmAvg = readBmTotal / (double) inoutsPerHeap;
+		double writeBmAvg = writeBmTotal / (double) inoutsPerHeap;
+		double computeBmAvg = computeBmTotal / (double) inoutsPerHeap;
+		double transferBmAvg = transferBmTotal / (double) inoutsPerHeap;
+		double waitComputeBmAvg = waitComputeBmTotal / (double) inoutsPerHeap;
+		double waitTransferBmAvg = waitTransferBmTotal / (double) inoutsPerHeap;
 
-			computeBufferMemoryBarriers[j][1].sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2;
-			computeBufferMemoryBarriers[j][1].srcStageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
-			computeBufferMemoryBarriers[j][1].srcAccessMask = VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT;
-			computeBufferMemoryBarriers[j][1].srcQueueFamilyIndex = computeFamilyIndex;
-			computeBufferMemoryBarriers[j][1].dstQueueFamilyIndex = transferFamilyIndex;
-			computeBufferMemoryBarriers[j][1].buffer = deviceLocalBuffer;
-			computeBufferMemoryBarriers[j][1].offset = bytesPerInout * k + bytesPerIn;
-			computeBufferMemoryBarriers[j][1].size = bytesPerOut;
+		struct LoopMetrics loopMetrics;
+		loopMetrics.initialValue = initialValue - 2;
+		loopMetrics.currentValue = curStartValue - 3;
+		loopMetrics.loop = loopCount + i + 1;
+		loopMetrics.valueCount = valuesPerHeap * 4;
+		loopMetrics.recordCount = recordCount;
+		loopMetrics.bestStopTime = bestStopTime;
+		loopMetrics.mainLoop = mainLoopBmark;
+		loopMetrics.valuesPerSecond = (double) (1000 * loopMetrics.valueCount) / mainLoopBmark;
+		loopMetrics.stepCount = loopSteps;
+		loopMetrics.invocationCount = loopInvocations;
+		loopMetrics.stepsPerSecond = (double) (1000 * loopSteps) / mainLoopBmark;
+		loopMetrics.read = readBmTotal;
+		loopMetrics.write = writeBmTotal;
+		loopMetrics.compute = computeBmTotal;
+		loopMetrics.transfer = transferBmTotal;
+		loopMetrics.idleCompute = waitComputeBmTotal;
+		loopMetrics.idleTransfer = waitTransferBmTotal;
+		loopMetrics.valuesPerInout = valuesPerInout;
+		loopMetrics.inoutsPerHeap = inoutsPerHeap;
+		loopMetrics.stagesPerInout = stagesPerInout;
+		loopMetrics.dispatchesPerInout = gpu->dispatchesPerInout;
+		loopMetrics.hostVisibleTypeIndex = gpu->hostVisibleTypeIndex;
+		loopMetrics.hostVisibleOutTypeIndex = gpu->hostVisibleOutTypeIndex;
+		loopMetrics.deviceLocalTypeIndex = gpu->deviceLocalTypeIndex;
+
+		if (gpu->instrumenting) {
+			metrics_divergence(loopMetrics.loop, &divergence);
 		}
-	}
-
-	// Specify buffer memory barriers for transfer command buffer
-	allocCount = inoutsPerHeap;
-	allocSize = sizeof(VkBufferMemoryBarrier2[3]);
 
-	VkBufferMemoryBarrier2 (*transferBufferMemoryBarriers)[3] = dyrecord_calloc(localRecord, allocCount, allocSize);
-	if CZ_NOEXPECT (!transferBufferMemoryBarriers) { dyrecord_destroy(localRecord); return false; }
+		metrics_loop(&loopMetrics);
+		exporter_publish(&loopMetrics);
+		stats_loop(&loopMetrics);
 
-	for (CzU32 i = 0, j = 0; i < buffersPerHeap; i++) {
-		VkBuffer hostVisibleBuffer = hostVisibleBuffers[i];
-		VkBuffer deviceLocalBuffer = deviceLocalBuffers[i];
+		CZ_PROBE(
+			loop_end, loopMetrics.loop, CZ_U128_UPPER(loopMetrics.initialValue),
+			CZ_U128_LOWER(loopMetrics.initialValue), loopMetrics.valueCount, CZ_PROBE_NS(mainLoopBmark));
 
-		for (CzU32 k = 0; k < inoutsPerBuffer; j++, k++) {
-			transferBufferMemoryBarriers[j][0].sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2;
-			transferBufferMemoryBarriers[j][0].srcStageMask = VK_PIPELINE_STAGE_2_COPY_BIT;
-			transferBufferMemoryBarriers[j][0].srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
-			transferBufferMemoryBarriers[j][0].srcQueueFamilyIndex = transferFamilyIndex;
-			transferBufferMemoryBarriers[j][0].dstQueueFamilyIndex = computeFamilyIndex;
-			transferBufferMemoryBarriers[j][0].buffer = deviceLocalBuffer;
-			transferBufferMemoryBarriers[j][0].offset = bytesPerInout * k;
-			transferBufferMemoryBarriers[j][0].size = bytesPerIn;
-
-			transferBufferMemoryBarriers[j][1].sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2;
-			transferBufferMemoryBarriers[j][1].dstStageMask = VK_PIPELINE_STAGE_2_COPY_BIT;
-			transferBufferMemoryBarriers[j][1].dstAccessMask = VK_ACCESS_2_TRANSFER_READ_BIT;
-			transferBufferMemoryBarriers[j][1].srcQueueFamilyIndex = computeFamilyIndex;
-			transferBufferMemoryBarriers[j][1].dstQueueFamilyIndex = transferFamilyIndex;
-			transferBufferMemoryBarriers[j][1].buffer = deviceLocalBuffer;
-			transferBufferMemoryBarriers[j][1].offset = bytesPerInout * k + bytesPerIn;
-			transferBufferMemoryBarriers[j][1].size = bytesPerOut;
-
-			transferBufferMemoryBarriers[j][2].sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2;
-			transferBufferMemoryBarriers[j][2].srcStageMask = VK_PIPELINE_STAGE_2_COPY_BIT;
-			transferBufferMemoryBarriers[j][2].srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
-			transferBufferMemoryBarriers[j][2].dstStageMask = VK_PIPELINE_STAGE_2_HOST_BIT;
-			transferBufferMemoryBarriers[j][2].dstAccessMask = VK_ACCESS_2_HOST_READ_BIT;
-			transferBufferMemoryBarriers[j][2].buffer = hostVisibleBuffer;
-			transferBufferMemoryBarriers[j][2].offset = bytesPerInout * k + bytesPerIn;
-			transferBufferMemoryBarriers[j][2].size = bytesPerOut;
+		if (gpu->instrumenting && czgConfig.outputLevel > CZ_OUTPUT_LEVEL_QUIET) {
+			print_divergence(&divergence);
 		}
-	}
 
-	// Specify dependency info for initial command buffer
-	VkDependencyInfo initialDependencyInfo = {0};
-	initialDependencyInfo.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
-	initialDependencyInfo.bufferMemoryBarrierCount = inoutsPerHeap;
-	initialDependencyInfo.pBufferMemoryBarriers = initialBufferMemoryBarriers;
+		if (gpu->usingPipelineStatistics && czgConfig.outputLevel > CZ_OUTPUT_LEVEL_QUIET) {
+			printf("Shader invocations: %" PRIu64 "\n", loopInvocations);
+		}
 
-	// Specify dependency infos for compute command buffers
-	allocCount = inoutsPerHeap;
-	allocSize = sizeof(VkDependencyInfo[2]);
+		switch (czgConfig.outputLevel) {
+		case CZ_OUTPUT_LEVEL_QUIET:
+			printf(
+				"Main loop: %.0fms\n"
+				"Current value: 0x %016" PRIx64 " %016" PRIx64 "\n\n",
+				mainLoopBmark,
+				CZ_U128_UPPER(curStartValue - 3), CZ_U128_LOWER(curStartValue - 3));
 
-	VkDependencyInfo (*computeDependencyInfos)[2] = dyrecord_calloc(localRecord, allocCount, allocSize);
-	if CZ_NOEXPECT (!computeDependencyInfos) { dyrecord_destroy(localRecord); return false; }
+			break;
 
-	for (CzU32 i = 0; i < inoutsPerHeap; i++) {
-		computeDependencyInfos[i][0].sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
-		computeDependencyInfos[i][0].bufferMemoryBarrierCount = 1;
-		computeDependencyInfos[i][0].pBufferMemoryBarriers = &computeBufferMemoryBarriers[i][0];
+		case CZ_OUTPUT_LEVEL_DEFAULT:
+			printf(
+				"Main loop: %.0fms\n"
+				"Speed: %.3f/s (%.3f steps/s)\n"
+				"Reading buffers:    %8.1fms\n"
+				"Writing buffers:    %8.1fms\n"
+				"Compute execution:  %8.1fms\n"
+				"Transfer execution: %8.1fms\n"
+				"Idle (compute):     %8.1fms\n"
+				"Idle (transfer):    %8.1fms\n"
+				"Initial value: 0x %016" PRIx64 " %016" PRIx64 "\n"
+				"Current value: 0x %016" PRIx64 " %016" PRIx64 "\n\n",
+				mainLoopBmark,
+				loopMetrics.valuesPerSecond, loopMetrics.stepsPerSecond,
+				readBmAvg,        writeBmAvg,
+				computeBmAvg,     transferBmAvg,
+				waitComputeBmAvg, waitTransferBmAvg,
+				CZ_U128_UPPER(initialValue - 2),  CZ_U128_LOWER(initialValue - 2),
+				CZ_U128_UPPER(curStartValue - 3), CZ_U128_LOWER(curStartValue - 3));
 
-		computeDependencyInfos[i][1].sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
-		computeDependencyInfos[i][1].bufferMemoryBarrierCount = 1;
-		computeDependencyInfos[i][1].pBufferMemoryBarriers = &computeBufferMemoryBarriers[i][1];
-	}
+			break;
 
-	// Specify dependency infos for transfer command buffers
-	allocCount = inoutsPerHeap;
-	allocSize = sizeof(VkDependencyInfo[2]);
+		case CZ_OUTPUT_LEVEL_VERBOSE:
+			printf(
+				"Main loop: %.0fms\n"
+				"Speed: %.3f/s (%.3f steps/s)\n"
+				"|      Benchmark     | Total (ms) | Average (ms) |\n"
+				"|    Reading buffers | %10.0f | %12.1f |\n"
+				"|    Writing buffers | %10.0f | %12.1f |\n"
+				"|  Compute execution | %10.0f | %12.1f |\n"
+				"| Transfer execution | %10.0f | %12.1f |\n"
+				"|     Idle (compute) | %10.0f | %12.1f |\n"
+				"|    Idle (transfer) | %10.0f | %12.1f |\n"
+				"Initial value: 0x %016" PRIx64 " %016" PRIx64 "\n"
+				"Current value: 0x %016" PRIx64 " %016" PRIx64 "\n\n",
+				mainLoopBmark,
+				loopMetrics.valuesPerSecond, loopMetrics.stepsPerSecond,
+				readBmTotal,        readBmAvg,        writeBmTotal,        writeBmAvg,
+				computeBmTotal,     computeBmAvg,     transferBmTotal,     transferBmAvg,
+				waitComputeBmTotal, waitComputeBmAvg, waitTransferBmTotal, waitTransferBmAvg,
+				CZ_U128_UPPER(initialValue - 2),  CZ_U128_LOWER(initialValue - 2),
+				CZ_U128_UPPER(curStartValue - 3), CZ_U128_LOWER(curStartValue - 3));
 
-	VkDependencyInfo (*transferDependencyInfos)[2] = dyrecord_calloc(localRecord, allocCount, allocSize);
-	if CZ_NOEXPECT (!transferDependencyInfos) { dyrecord_destroy(localRecord); return false; }
+			break;
 
-	for (CzU32 i = 0; i < inoutsPerHeap; i++) {
-		transferDependencyInfos[i][0].sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
-		transferDependencyInfos[i][0].bufferMemoryBarrierCount = 2;
-		transferDependencyInfos[i][0].pBufferMemoryBarriers = &transferBufferMemoryBarriers[i][0];
+		default:
+			break;
+		}
 
-		transferDependencyInfos[i][1].sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
-		transferDependencyInfos[i][1].bufferMemoryBarrierCount = 1;
-		transferDependencyInfos[i][1].pBufferMemoryBarriers = &transferBufferMemoryBarriers[i][2];
+		bool latencyDue = czgConfig.latencyInterval && loopMetrics.loop % czgConfig.latencyInterval == 0;
+		if (latencyDue && !gpu->tuningTrial && czgConfig.outputLevel > CZ_OUTPUT_LEVEL_SILENT) {
+			latency_interval(czgConfig.latencyInterval);
+		}
 	}
+	CZ_NEWLINE();
 
-	// Record initial command buffer
-	bool bres = record_initial_cmdbuffer(
-		initialCmdBuffer, initialBufferCopyInfos, &initialDependencyInfo, buffersPerHeap);
+	// Stop worker threads (reader thread before scanner threads it depends on)
+	bres = host_queue_push(writerTasks, &stopTask);
+	if CZ_NOEXPECT (!bres) { goto err_stop_workers; }
 
-	if CZ_NOEXPECT (!bres) { dyrecord_destroy(localRecord); return false; }
+	bres = host_queue_push(readerTasks, &stopTask);
+	if CZ_NOEXPECT (!bres) { goto err_stop_workers; }
 
-	// Record compute command buffers
-	for (CzU32 i = 0; i < inoutsPerHeap; i++) {
-		CzU32 firstQuery = i * 4;
-		bres = record_compute_cmdbuffer(
-			computeCmdBuffers[i], pipeline, &bindDescriptorSetsInfos[i], computeDependencyInfos[i], queryPool,
-			firstQuery, computeFamilyTimestampValidBits, workgroupCount);
+	ires = pthread_join(writerThread, NULL);
+	if CZ_NOEXPECT (ires) { PJOIN_FAILURE(ires); dyrecord_destroy(localRecord); return false; }
+
+	ires = pthread_join(readerThread, NULL);
+	if CZ_NOEXPECT (ires) { PJOIN_FAILURE(ires); dyrecord_destroy(localRecord); return false; }
 
+	for (CzU32 i = 0; i < scannerThreadCount; i++) {
+		bres = host_queue_push(scanners[i].tasks, &scanStopTask);
 		if CZ_NOEXPECT (!bres) { dyrecord_destroy(localRecord); return false; }
-	}
 
-	// Record transfer command buffers
-	for (CzU32 i = 0; i < inoutsPerHeap; i++) {
-		CzU32 firstQuery = i * 4 + 2;
-		bres = record_transfer_cmdbuffer(
-			transferCmdBuffers[i], &inBufferCopyInfos[i], &outBufferCopyInfos[i], transferDependencyInfos[i], queryPool,
-			firstQuery, transferFamilyTimestampValidBits);
+		ires = pthread_join(scannerThreads[i], NULL);
+		if CZ_NOEXPECT (ires) { PJOIN_FAILURE(ires); dyrecord_destroy(localRecord); return false; }
+	}
 
-		if CZ_NOEXPECT (!bres) { dyrecord_destroy(localRecord); return false; }
+	for (CzU32 i = 0; i < hostQueueCount; i++) {
+		host_queue_fini(&hostQueues[i]);
 	}
 
-	// Create semaphores (one per inout-buffer)
-	allocCount = inoutsPerHeap;
-	allocSize = sizeof(VkSemaphore);
+	double totalBmark = wall_time() - totalBmStart;
 
-	VkSemaphore* semaphores = dyrecord_calloc(gpuRecord, allocCount, allocSize);
-	if CZ_NOEXPECT (!semaphores) { dyrecord_destroy(localRecord); return false; }
-	gpu->semaphores = semaphores;
+	gpu->valuesPerSecond = (double) (1000 * total) / totalBmark;
 
-	VkSemaphoreTypeCreateInfo semaphoreTypeInfo = {0};
-	semaphoreTypeInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
-	semaphoreTypeInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
-	semaphoreTypeInfo.initialValue = 0;
+	// Tuning trials only measure speed, so neither display results nor save progress
+	if (gpu->tuningTrial) {
+		dyrecord_destroy(localRecord);
+		return true;
+	}
 
-	VkSemaphoreCreateInfo semaphoreInfo = {0};
-	semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
-	semaphoreInfo.pNext = &semaphoreTypeInfo;
+	gpu->position = position;
+	gpu->totalTested += total;
+	gpu->totalSteps += totalSteps;
+	gpu->totalBmark += totalBmark;
 
-	for (CzU32 i = 0; i < inoutsPerHeap; i++) {
-		VkSemaphore semaphore;
-		VK_CALLR(vkCreateSemaphore, device, &semaphoreInfo, allocator, &semaphore);
-		if CZ_NOEXPECT (vkres) { dyrecord_destroy(localRecord); return false; }
-		semaphores[i] = semaphore;
-	}
+	// Results are only displayed once the run ends, so not when stopping to resize
+	if (gpu->resizing) {
+		if (czgConfig.outputLevel > CZ_OUTPUT_LEVEL_SILENT && gpu->rampingUp) {
+			printf("Ramp-up complete, joining remaining inout-buffers\n\n");
+		}
+		else if (czgConfig.outputLevel > CZ_OUTPUT_LEVEL_SILENT) {
+			printf("Memory budget changed, resizing inout-buffers\n\n");
+		}
 
-#if !defined(NDEBUG)
-	set_debug_name(device, VK_OBJECT_TYPE_COMMAND_POOL, (CzU64) transferCmdPool, "Transfer");
-	set_debug_name(device, VK_OBJECT_TYPE_COMMAND_POOL, (CzU64) computeCmdPool, "Compute");
+		dyrecord_destroy(localRecord);
+		return true;
+	}
 
-	for (CzU32 i = 0, j = 0; i < buffersPerHeap; i++) {
-		for (CzU32 k = 0; k < inoutsPerBuffer; j++, k++) {
-			char objectName[68];
-			char specs[60];
+	// Display results of calculations
+	print_results(
+		&position, bestStartValues, bestStopTimes, gpu->initialStartValue, gpu->totalTested, gpu->totalSteps,
+		gpu->totalBmark);
 
-			sprintf(
-				specs,
-				", Inout %" PRIu32 "/%" PRIu32 ", Buffer %" PRIu32 "/%" PRIu32,
-				k + 1, inoutsPerBuffer, i + 1, buffersPerHeap);
+	// Write current position to progress file
+	bres = save_position(&position);
+	if CZ_NOEXPECT (!bres) { dyrecord_destroy(localRecord); return false; }
 
-			strcpy(objectName, "Compute");
-			strcat(objectName, specs);
+	dyrecord_destroy(localRecord);
+	return true;
 
-			set_debug_name(device, VK_OBJECT_TYPE_COMMAND_BUFFER, (CzU64) computeCmdBuffers[j], objectName);
+err_stop_workers:
+	// Only join worker threads which were successfully sent a stop task
+	if (writerCreated && host_queue_push(writerTasks, &stopTask)) {
+		pthread_join(writerThread, NULL);
+	}
 
-			strcpy(objectName, "Transfer");
-			strcat(objectName, specs);
+	if (readerCreated && host_queue_push(readerTasks, &stopTask)) {
+		pthread_join(readerThread, NULL);
+	}
 
-			set_debug_name(device, VK_OBJECT_TYPE_COMMAND_BUFFER, (CzU64) transferCmdBuffers[j], objectName);
+	for (CzU32 i = 0; i < scannerThreadCount; i++) {
+		if (host_queue_push(scanners[i].tasks, &scanStopTask)) {
+			pthread_join(scannerThreads[i], NULL);
 		}
 	}
-#endif
 
-	VK_CALL(vkDestroyPipelineLayout, device, pipelineLayout, allocator);
-	gpu->pipelineLayout = VK_NULL_HANDLE;
+	for (CzU32 i = 0; i < hostQueueCount; i++) {
+		host_queue_fini(&hostQueues[i]);
+	}
 
 	dyrecord_destroy(localRecord);
-	return true;
+	return false;
 }
 
-bool submit_commands(struct Gpu* restrict gpu)
+bool submit_continuous(struct Gpu* restrict gpu)
 {
-	const VkAllocationCallbacks* allocator = gpu->allocator;
 	const VkDeviceMemory* hostVisibleMemories = gpu->hostVisibleDeviceMemories;
 	const VkCommandBuffer* computeCmdBuffers = gpu->computeCmdBuffers;
-	const VkCommandBuffer* transferCmdBuffers = gpu->transferCmdBuffers;
 	const VkSemaphore* semaphores = gpu->semaphores;
 
 	CzU128* const* mappedInBuffers = gpu->mappedInBuffers;
-	CzU16* const* mappedOutBuffers = gpu->mappedOutBuffers;
 
 	VkDevice device = gpu->device;
-
 	VkQueue computeQueue = gpu->computeQueue;
-	VkQueue transferQueue = gpu->transferQueue;
-
-	VkCommandPool initialCmdPool = gpu->initialCmdPool;
-	VkCommandBuffer initialCmdBuffer = gpu->initialCmdBuffer;
-
 	VkQueryPool queryPool = gpu->queryPool;
 
-	VkDeviceSize bytesPerIn = gpu->bytesPerIn;
-	VkDeviceSize bytesPerOut = gpu->bytesPerOut;
 	VkDeviceSize bytesPerInout = gpu->bytesPerInout;
+	VkDeviceSize bytesPerRing = gpu->bytesPerRing;
 
-	CzU32 valuesPerInout = gpu->valuesPerInout;
-	CzU32 valuesPerHeap = gpu->valuesPerHeap;
+	CzU64 valuesPerInout = gpu->valuesPerInout;
+	CzU64 valuesPerHeap = gpu->valuesPerHeap;
 	CzU32 inoutsPerBuffer = gpu->inoutsPerBuffer;
 	CzU32 inoutsPerHeap = gpu->inoutsPerHeap;
 	CzU32 buffersPerHeap = gpu->buffersPerHeap;
+	CzU32 workgroupCount = gpu->workgroupCount;
 
 	CzU32 computeFamilyTimestampValidBits = gpu->computeFamilyTimestampValidBits;
-	CzU32 transferFamilyTimestampValidBits = gpu->transferFamilyTimestampValidBits;
 
 	double timestampPeriod = (double) gpu->timestampPeriod;
 	bool hostNonCoherent = gpu->hostNonCoherent;
@@ -2516,7 +6485,7 @@ bool submit_commands(struct Gpu* restrict gpu)
 
 	DyRecord localRecord = dyrecord_create();
 	if CZ_NOEXPECT (!localRecord) { return false; }
-	
+
 	// Create array of starting values with longest total stopping times
 	size_t elmSize = sizeof(CzU128);
 	size_t elmCount = 32;
@@ -2538,114 +6507,57 @@ bool submit_commands(struct Gpu* restrict gpu)
 	if CZ_NOEXPECT (!bres) { dyarray_destroy(bestStopTimes); dyrecord_destroy(localRecord); return false; }
 
 	// Use progress file, if it exists
-	struct Position position = {0};
-	position.val0mod1off[0] = 1;
-	position.curStartValue = 3;
-
-	size_t fileSize = 0;
-	struct CzFileFlags fileFlags = {0};
-	fileFlags.relativeToExe = true;
-
-	enum CzResult czres = czFileSize(CZ_PROGRESS_FILE_NAME, &fileSize, fileFlags);
-	if CZ_NOEXPECT (czres && czres != CZ_RESULT_NO_FILE) { dyrecord_destroy(localRecord); return false; }
-
-	if (!czgConfig.restart && fileSize) {
-		CzU64 val0mod1off0Upper, val0mod1off0Lower;
-		CzU64 val0mod1off1Upper, val0mod1off1Lower;
-		CzU64 val0mod1off2Upper, val0mod1off2Lower;
-		CzU64 val1mod6off0Upper, val1mod6off0Lower;
-		CzU64 val1mod6off1Upper, val1mod6off1Lower;
-		CzU64 val1mod6off2Upper, val1mod6off2Lower;
-		CzU64 curValueUpper, curValueLower;
-		CzU16 bestTime;
-
-		bres = read_text(
-			CZ_PROGRESS_FILE_NAME,
-			"%" SCNx64 " %" SCNx64 "\n"
-			"%" SCNx64 " %" SCNx64 "\n"
-			"%" SCNx64 " %" SCNx64 "\n"
-			"%" SCNx64 " %" SCNx64 "\n"
-			"%" SCNx64 " %" SCNx64 "\n"
-			"%" SCNx64 " %" SCNx64 "\n"
-			"%" SCNx64 " %" SCNx64 "\n"
-			"%" SCNx16,
-			&val0mod1off0Upper, &val0mod1off0Lower,
-			&val0mod1off1Upper, &val0mod1off1Lower,
-			&val0mod1off2Upper, &val0mod1off2Lower,
-			&val1mod6off0Upper, &val1mod6off0Lower,
-			&val1mod6off1Upper, &val1mod6off1Lower,
-			&val1mod6off2Upper, &val1mod6off2Lower,
-			&curValueUpper, &curValueLower, &bestTime);
-
-		if CZ_NOEXPECT (!bres) { dyrecord_destroy(localRecord); return false; }
-
-		position.val0mod1off[0] = CZ_U128(val0mod1off0Upper, val0mod1off0Lower);
-		position.val0mod1off[1] = CZ_U128(val0mod1off1Upper, val0mod1off1Lower);
-		position.val0mod1off[2] = CZ_U128(val0mod1off2Upper, val0mod1off2Lower);
-
-		position.val1mod6off[0] = CZ_U128(val1mod6off0Upper, val1mod6off0Lower);
-		position.val1mod6off[1] = CZ_U128(val1mod6off1Upper, val1mod6off1Lower);
-		position.val1mod6off[2] = CZ_U128(val1mod6off2Upper, val1mod6off2Lower);
-
-		position.curStartValue = CZ_U128(curValueUpper, curValueLower);
-		position.bestStopTime = bestTime;
-	}
-
-	// Specify mapped memory ranges of host visible in-buffers
-	VkMappedMemoryRange* inBuffersMappedRanges = NULL;
-
-	if (hostNonCoherent) {
-		allocCount = inoutsPerHeap;
-		allocSize = sizeof(VkMappedMemoryRange);
+	struct Position position;
+	bres = load_position(&position);
+	if CZ_NOEXPECT (!bres) { dyrecord_destroy(localRecord); return false; }
 
-		inBuffersMappedRanges = dyrecord_calloc(localRecord, allocCount, allocSize);
-		if CZ_NOEXPECT (!inBuffersMappedRanges) { dyrecord_destroy(localRecord); return false; }
+	// Record ring buffers occupy the start of each host visible inout-buffer
+	allocSize = inoutsPerHeap * sizeof(struct RingHeader*);
+	struct RingHeader** ringHeaders = dyrecord_malloc(localRecord, allocSize);
+	if CZ_NOEXPECT (!ringHeaders) { dyrecord_destroy(localRecord); return false; }
 
-		for (CzU32 i = 0, j = 0; i < buffersPerHeap; i++) {
-			for (CzU32 k = 0; k < inoutsPerBuffer; j++, k++) {
-				inBuffersMappedRanges[j].sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
-				inBuffersMappedRanges[j].memory = hostVisibleMemories[i];
-				inBuffersMappedRanges[j].offset = bytesPerInout * k;
-				inBuffersMappedRanges[j].size = bytesPerIn;
-			}
-		}
+	for (CzU32 i = 0; i < inoutsPerHeap; i++) {
+		ringHeaders[i] = (struct RingHeader*) mappedInBuffers[i];
 	}
 
-	// Specify mapped memory ranges of host visible out-buffers
-	VkMappedMemoryRange* outBuffersMappedRanges = NULL;
+	// Specify mapped memory ranges of ring headers (written by host)
+	VkMappedMemoryRange* headersMappedRanges = NULL;
 
 	if (hostNonCoherent) {
 		allocCount = inoutsPerHeap;
 		allocSize = sizeof(VkMappedMemoryRange);
 
-		outBuffersMappedRanges = dyrecord_calloc(localRecord, allocCount, allocSize);
-		if CZ_NOEXPECT (!outBuffersMappedRanges) { dyrecord_destroy(localRecord); return false; }
+		headersMappedRanges = dyrecord_calloc(localRecord, allocCount, allocSize);
+		if CZ_NOEXPECT (!headersMappedRanges) { dyrecord_destroy(localRecord); return false; }
 
 		for (CzU32 i = 0, j = 0; i < buffersPerHeap; i++) {
 			for (CzU32 k = 0; k < inoutsPerBuffer; j++, k++) {
-				outBuffersMappedRanges[j].sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
-				outBuffersMappedRanges[j].memory = hostVisibleMemories[i];
-				outBuffersMappedRanges[j].offset = bytesPerInout * k + bytesPerIn;
-				outBuffersMappedRanges[j].size = bytesPerOut;
+				headersMappedRanges[j].sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
+				headersMappedRanges[j].memory = hostVisibleMemories[i];
+				headersMappedRanges[j].offset = bytesPerInout * k;
+				headersMappedRanges[j].size = sizeof(struct RingHeader);
 			}
 		}
 	}
 
-	// Specify initial command buffer for submission
-	VkCommandBufferSubmitInfo initialCmdBufferSubmitInfo = {0};
-	initialCmdBufferSubmitInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO;
-	initialCmdBufferSubmitInfo.commandBuffer = initialCmdBuffer;
+	// Specify mapped memory ranges of ring buffers (written by device)
+	VkMappedMemoryRange* ringsMappedRanges = NULL;
 
-	// Specify transfer command buffers for submission
-	allocCount = inoutsPerHeap;
-	allocSize = sizeof(VkCommandBufferSubmitInfo);
+	if (hostNonCoherent) {
+		allocCount = inoutsPerHeap;
+		allocSize = sizeof(VkMappedMemoryRange);
 
-	VkCommandBufferSubmitInfo* transferCmdBufferSubmitInfos = dyrecord_calloc(localRecord, allocCount, allocSize);
-	if CZ_NOEXPECT (!transferCmdBufferSubmitInfos) { dyrecord_destroy(localRecord); return false; }
+		ringsMappedRanges = dyrecord_calloc(localRecord, allocCount, allocSize);
+		if CZ_NOEXPECT (!ringsMappedRanges) { dyrecord_destroy(localRecord); return false; }
 
-	for (CzU32 i = 0; i < inoutsPerHeap; i++) {
-		transferCmdBufferSubmitInfos[i].sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO;
-		transferCmdBufferSubmitInfos[i].commandBuffer = transferCmdBuffers[i];
+		for (CzU32 i = 0, j = 0; i < buffersPerHeap; i++) {
+			for (CzU32 k = 0; k < inoutsPerBuffer; j++, k++) {
+				ringsMappedRanges[j].sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
+				ringsMappedRanges[j].memory = hostVisibleMemories[i];
+				ringsMappedRanges[j].offset = bytesPerInout * k;
+				ringsMappedRanges[j].size = bytesPerRing;
+			}
+		}
 	}
 
 	// Specify compute command buffers for submission
@@ -2660,48 +6572,6 @@ bool submit_commands(struct Gpu* restrict gpu)
 		computeCmdBufferSubmitInfos[i].commandBuffer = computeCmdBuffers[i];
 	}
 
-	// Specify semaphore wait operations for submissions to transfer queue
-	allocCount = inoutsPerHeap;
-	allocSize = sizeof(VkSemaphoreSubmitInfo);
-
-	VkSemaphoreSubmitInfo* transferWaitSemaphoreSubmitInfos = dyrecord_calloc(localRecord, allocCount, allocSize);
-	if CZ_NOEXPECT (!transferWaitSemaphoreSubmitInfos) { dyrecord_destroy(localRecord); return false; }
-
-	for (CzU32 i = 0; i < inoutsPerHeap; i++) {
-		transferWaitSemaphoreSubmitInfos[i].sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO;
-		transferWaitSemaphoreSubmitInfos[i].semaphore = semaphores[i];
-		transferWaitSemaphoreSubmitInfos[i].value = 0;
-		transferWaitSemaphoreSubmitInfos[i].stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT; // Include acquire op
-	}
-
-	// Specify semaphore signal operations for submissions to transfer queue
-	allocCount = inoutsPerHeap;
-	allocSize = sizeof(VkSemaphoreSubmitInfo);
-
-	VkSemaphoreSubmitInfo* transferSignalSemaphoreSubmitInfos = dyrecord_calloc(localRecord, allocCount, allocSize);
-	if CZ_NOEXPECT (!transferSignalSemaphoreSubmitInfos) { dyrecord_destroy(localRecord); return false; }
-
-	for (CzU32 i = 0; i < inoutsPerHeap; i++) {
-		transferSignalSemaphoreSubmitInfos[i].sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO;
-		transferSignalSemaphoreSubmitInfos[i].semaphore = semaphores[i];
-		transferSignalSemaphoreSubmitInfos[i].value = 1;
-		transferSignalSemaphoreSubmitInfos[i].stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT; // Include release op
-	}
-
-	// Specify semaphore wait operations for submissions to compute queue
-	allocCount = inoutsPerHeap;
-	allocSize = sizeof(VkSemaphoreSubmitInfo);
-
-	VkSemaphoreSubmitInfo* computeWaitSemaphoreSubmitInfos = dyrecord_calloc(localRecord, allocCount, allocSize);
-	if CZ_NOEXPECT (!computeWaitSemaphoreSubmitInfos) { dyrecord_destroy(localRecord); return false; }
-
-	for (CzU32 i = 0; i < inoutsPerHeap; i++) {
-		computeWaitSemaphoreSubmitInfos[i].sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO;
-		computeWaitSemaphoreSubmitInfos[i].semaphore = semaphores[i];
-		computeWaitSemaphoreSubmitInfos[i].value = 1;
-		computeWaitSemaphoreSubmitInfos[i].stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT; // Include acquire op
-	}
-
 	// Specify semaphore signal operations for submissions to compute queue
 	allocCount = inoutsPerHeap;
 	allocSize = sizeof(VkSemaphoreSubmitInfo);
@@ -2712,33 +6582,8 @@ bool submit_commands(struct Gpu* restrict gpu)
 	for (CzU32 i = 0; i < inoutsPerHeap; i++) {
 		computeSignalSemaphoreSubmitInfos[i].sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO;
 		computeSignalSemaphoreSubmitInfos[i].semaphore = semaphores[i];
-		computeSignalSemaphoreSubmitInfos[i].value = 2;
-		computeSignalSemaphoreSubmitInfos[i].stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT; // Include release op
-	}
-
-	// Specify submission of initial command buffer
-	VkSubmitInfo2 initialSubmitInfo = {0};
-	initialSubmitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO_2;
-	initialSubmitInfo.commandBufferInfoCount = 1;
-	initialSubmitInfo.pCommandBufferInfos = &initialCmdBufferSubmitInfo;
-	initialSubmitInfo.signalSemaphoreInfoCount = inoutsPerHeap;
-	initialSubmitInfo.pSignalSemaphoreInfos = transferSignalSemaphoreSubmitInfos;
-
-	// Specify submissions to transfer queue
-	allocCount = inoutsPerHeap;
-	allocSize = sizeof(VkSubmitInfo2);
-
-	VkSubmitInfo2* transferSubmitInfos = dyrecord_calloc(localRecord, allocCount, allocSize);
-	if CZ_NOEXPECT (!transferSubmitInfos) { dyrecord_destroy(localRecord); return false; }
-
-	for (CzU32 i = 0; i < inoutsPerHeap; i++) {
-		transferSubmitInfos[i].sType = VK_STRUCTURE_TYPE_SUBMIT_INFO_2;
-		transferSubmitInfos[i].waitSemaphoreInfoCount = 1;
-		transferSubmitInfos[i].pWaitSemaphoreInfos = &transferWaitSemaphoreSubmitInfos[i];
-		transferSubmitInfos[i].commandBufferInfoCount = 1;
-		transferSubmitInfos[i].pCommandBufferInfos = &transferCmdBufferSubmitInfos[i];
-		transferSubmitInfos[i].signalSemaphoreInfoCount = 1;
-		transferSubmitInfos[i].pSignalSemaphoreInfos = &transferSignalSemaphoreSubmitInfos[i];
+		computeSignalSemaphoreSubmitInfos[i].value = 1;
+		computeSignalSemaphoreSubmitInfos[i].stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
 	}
 
 	// Specify submissions to compute queue
@@ -2750,28 +6595,12 @@ bool submit_commands(struct Gpu* restrict gpu)
 
 	for (CzU32 i = 0; i < inoutsPerHeap; i++) {
 		computeSubmitInfos[i].sType = VK_STRUCTURE_TYPE_SUBMIT_INFO_2;
-		computeSubmitInfos[i].waitSemaphoreInfoCount = 1;
-		computeSubmitInfos[i].pWaitSemaphoreInfos = &computeWaitSemaphoreSubmitInfos[i];
 		computeSubmitInfos[i].commandBufferInfoCount = 1;
 		computeSubmitInfos[i].pCommandBufferInfos = &computeCmdBufferSubmitInfos[i];
 		computeSubmitInfos[i].signalSemaphoreInfoCount = 1;
 		computeSubmitInfos[i].pSignalSemaphoreInfos = &computeSignalSemaphoreSubmitInfos[i];
 	}
 
-	// Specify semaphore wait operations for transfer queue on host
-	allocCount = inoutsPerHeap;
-	allocSize = sizeof(VkSemaphoreWaitInfo);
-
-	VkSemaphoreWaitInfo* transferSemaphoreWaitInfos = dyrecord_calloc(localRecord, allocCount, allocSize);
-	if CZ_NOEXPECT (!transferSemaphoreWaitInfos) { dyrecord_destroy(localRecord); return false; }
-
-	for (CzU32 i = 0; i < inoutsPerHeap; i++) {
-		transferSemaphoreWaitInfos[i].sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
-		transferSemaphoreWaitInfos[i].semaphoreCount = 1;
-		transferSemaphoreWaitInfos[i].pSemaphores = &semaphores[i];
-		transferSemaphoreWaitInfos[i].pValues = &transferSignalSemaphoreSubmitInfos[i].value;
-	}
-
 	// Specify semaphore wait operations for compute queue on host
 	allocCount = inoutsPerHeap;
 	allocSize = sizeof(VkSemaphoreWaitInfo);
@@ -2786,110 +6615,79 @@ bool submit_commands(struct Gpu* restrict gpu)
 		computeSemaphoreWaitInfos[i].pValues = &computeSignalSemaphoreSubmitInfos[i].value;
 	}
 
-	// Create array keeping track of initial tested starting value for each inout-buffer
+	// Create array keeping track of base starting value for each ring buffer
 	allocCount = inoutsPerHeap;
 	allocSize = sizeof(CzU128);
 
-	CzU128* testedValues = dyrecord_calloc(localRecord, allocCount, allocSize);
-	if CZ_NOEXPECT (!testedValues) { dyrecord_destroy(localRecord); return false; }
-
-	// Create thread to wait for user input
-	atomic_bool input;
-	atomic_init(&input, false);
+	CzU128* baseValues = dyrecord_calloc(localRecord, allocCount, allocSize);
+	if CZ_NOEXPECT (!baseValues) { dyrecord_destroy(localRecord); return false; }
 
-	pthread_t waitThread;
-	int ires = pthread_create(&waitThread, NULL, wait_for_input, &input);
-	if CZ_NOEXPECT (ires) { PCREATE_FAILURE(ires); dyrecord_destroy(localRecord); return false; }
+	// Create array of total stopping times rebuilt from each ring buffer
+	allocSize = (size_t) valuesPerInout * sizeof(CzU16);
+	CzU16* stopTimes = dyrecord_malloc(localRecord, allocSize);
+	if CZ_NOEXPECT (!stopTimes) { dyrecord_destroy(localRecord); return false; }
 
-	clock_t totalBmStart = clock();
+	double totalBmStart = wall_time();
 	CzU128 tested = position.curStartValue;
 
-	// Write starting values to mapped in-buffers
+	// Write ring headers and initiate the first cycle
 	for (CzU32 i = 0; i < inoutsPerHeap; i++) {
-		testedValues[i] = tested;
-		write_inbuffer(mappedInBuffers[i], &testedValues[i], valuesPerInout, valuesPerHeap);
+		baseValues[i] = tested;
+		write_ringheader(ringHeaders[i], &baseValues[i], position.bestStopTime, workgroupCount, valuesPerHeap);
 		tested += valuesPerInout * 4;
 	}
 
 	if (hostNonCoherent) {
-		VK_CALLR(vkFlushMappedMemoryRanges, device, inoutsPerHeap, inBuffersMappedRanges);
+		VK_CALLR(vkFlushMappedMemoryRanges, device, inoutsPerHeap, headersMappedRanges);
 		if CZ_NOEXPECT (vkres) { dyrecord_destroy(localRecord); return false; }
 	}
 
-	// Initiate the first cycle
-	CzU32 submitInfoCount = 1;
-	VK_CALLR(vkQueueSubmit2KHR, transferQueue, submitInfoCount, &initialSubmitInfo, VK_NULL_HANDLE);
-	if CZ_NOEXPECT (vkres) { dyrecord_destroy(localRecord); return false; }
-
-	submitInfoCount = inoutsPerHeap;
+	CzU32 submitInfoCount = inoutsPerHeap;
 	VK_CALLR(vkQueueSubmit2KHR, computeQueue, submitInfoCount, computeSubmitInfos, VK_NULL_HANDLE);
 	if CZ_NOEXPECT (vkres) { dyrecord_destroy(localRecord); return false; }
 
-	for (CzU32 i = 0; i < inoutsPerHeap; i++) {
-		// Wait for transfers to complete execution
-		CzU64 transferTimeout = UINT64_MAX;
-		VK_CALLR(vkWaitSemaphoresKHR, device, &transferSemaphoreWaitInfos[i], transferTimeout);
-		if CZ_NOEXPECT (vkres) { dyrecord_destroy(localRecord); return false; }
-
-		// Write starting values to mapped in-buffer
-		write_inbuffer(mappedInBuffers[i], &testedValues[i], valuesPerInout, valuesPerHeap);
-
-		// Update semaphore wait/signal values
-		transferWaitSemaphoreSubmitInfos[i].value += 2;
-		transferSignalSemaphoreSubmitInfos[i].value += 2;
-	}
-
-	if (hostNonCoherent) {
-		VK_CALLR(vkFlushMappedMemoryRanges, device, inoutsPerHeap, inBuffersMappedRanges);
-		if CZ_NOEXPECT (vkres) { dyrecord_destroy(localRecord); return false; }
-	}
-
-	// Complete the first cycle (and initiate the second)
-	submitInfoCount = inoutsPerHeap;
-	VK_CALLR(vkQueueSubmit2KHR, transferQueue, submitInfoCount, transferSubmitInfos, VK_NULL_HANDLE);
-	if CZ_NOEXPECT (vkres) { dyrecord_destroy(localRecord); return false; }
-
-	// Initial command buffer and pool are no longer needed
-	VK_CALL(vkDestroyCommandPool, device, initialCmdPool, allocator);
-	gpu->initialCmdPool = VK_NULL_HANDLE;
-
 	CzU128 total = 0;
+	CzU64 totalSteps = 0;
 	CzU128 initialStartValue = position.curStartValue;
 
 	// ===== Enter main loop =====
-	for (CzU64 i = 0; i < czgConfig.maxLoops && !atomic_load(&input); i++) {
-		clock_t mainLoopBmStart = clock();
+	for (CzU64 i = 0; i < czgConfig.maxLoops && !atomic_load(gpu->input); i++) {
+		double mainLoopBmStart = wall_time();
 		CzU128 initialValue = position.curStartValue;
 
+		struct TimestampCalibration calibration = {0};
+
+		if (gpu->usingCalibratedTimestamps) {
+			bool bres = calibrate_timestamps(device, &calibration);
+			if CZ_NOEXPECT (!bres) { dyrecord_destroy(localRecord); return false; }
+		}
+
 		double readBmTotal = 0;
 		double writeBmTotal = 0;
 		double waitComputeBmTotal = 0;
-		double waitTransferBmTotal = 0;
 		double computeBmTotal = 0;
-		double transferBmTotal = 0;
+
+		CzU64 candidateTotal = 0;
+		CzU64 loopSteps = 0;
 
 		if (czgConfig.outputLevel > CZ_OUTPUT_LEVEL_SILENT) {
 			printf("Loop #%" PRIu64 "\n", i + 1);
 		}
 
-		/*
-		 * The following loop has two invocations of the vkGetQueryPoolResults function. On my Windows/Linux PC, these
-		 * functions always return VK_SUCCESS. But on my Macbook, they very rarely return VK_NOT_READY. I'm yet to find
-		 * a consistent pattern regarding when these failures occur, nor have I found a way to reliably replicate them.
-		 * TODO Figure out what on Earth is going on here???
-		 */
 		for (CzU32 j = 0; j < inoutsPerHeap; j++) {
 			double computeBmark = 0;
-			double transferBmark = 0;
 
 			// Wait for dispatch to complete execution
-			clock_t waitComputeBmStart = clock();
+			double waitComputeBmStart = wall_time();
+			CZ_PROBE(wait_begin, j, CZ_PROBE_QUEUE_COMPUTE);
 
 			CzU64 computeTimeout = UINT64_MAX;
 			VK_CALLR(vkWaitSemaphoresKHR, device, &computeSemaphoreWaitInfos[j], computeTimeout);
 			if CZ_NOEXPECT (vkres) { dyrecord_destroy(localRecord); return false; }
 
-			clock_t waitComputeBmEnd = clock();
+			double waitComputeBmEnd = wall_time();
+			CZ_PROBE(wait_end, j, CZ_PROBE_QUEUE_COMPUTE, CZ_PROBE_NS(waitComputeBmEnd - waitComputeBmStart));
+			trace_event("Wait (compute)", CZ_TRACE_TRACK_MAIN, j, waitComputeBmStart, waitComputeBmEnd);
 
 			// Calculate approx time taken for dispatch to execute
 			if (computeFamilyTimestampValidBits) {
@@ -2903,114 +6701,157 @@ bool submit_commands(struct Gpu* restrict gpu)
 					queryFlags);
 
 				if CZ_NOEXPECT (vkres) { dyrecord_destroy(localRecord); return false; }
-				computeBmark = (double) (timestamps[1] - timestamps[0]) * timestampPeriod / 1000000;
-			}
-
-			// Update semaphore wait/signal values
-			computeWaitSemaphoreSubmitInfos[j].value += 2;
-			computeSignalSemaphoreSubmitInfos[j].value += 2;
-
-			// Resubmit compute command buffer for next cycle
-			submitInfoCount = 1;
-			VK_CALLR(vkQueueSubmit2KHR, computeQueue, submitInfoCount, &computeSubmitInfos[j], VK_NULL_HANDLE);
-			if CZ_NOEXPECT (vkres) { dyrecord_destroy(localRecord); return false; }
+				CzU64 ticks = get_timestamp_ticks(timestamps, computeFamilyTimestampValidBits);
+				computeBmark = (double) ticks * timestampPeriod / 1000000;
 
-			// Wait for transfers to complete execution
-			clock_t waitTransferBmStart = clock();
-
-			CzU64 transferTimeout = UINT64_MAX;
-			VK_CALLR(vkWaitSemaphoresKHR, device, &transferSemaphoreWaitInfos[j], transferTimeout);
-			if CZ_NOEXPECT (vkres) { dyrecord_destroy(localRecord); return false; }
-
-			clock_t waitTransferBmEnd = clock();
-
-			// Calculate approx time taken for transfers to execute
-			if (transferFamilyTimestampValidBits) {
-				CzU32 firstQuery = j * 4 + 2;
-				CzU32 queryCount = 2;
-				VkQueryResultFlags queryFlags = VK_QUERY_RESULT_64_BIT;
-
-				CzU64 timestamps[2];
-				VK_CALLR(vkGetQueryPoolResults,
-					device, queryPool, firstQuery, queryCount, sizeof(timestamps), timestamps, sizeof(timestamps[0]),
-					queryFlags);
+				struct TimestampCalibration waitCalibration = {timestamps[1], waitComputeBmEnd};
 
-				if CZ_NOEXPECT (vkres) { dyrecord_destroy(localRecord); return false; }
-				transferBmark = (double) (timestamps[1] - timestamps[0]) * timestampPeriod / 1000000;
+				trace_timestamps(
+					"Dispatch", CZ_TRACE_TRACK_COMPUTE, j, timestamps,
+					gpu->usingCalibratedTimestamps ? &calibration : &waitCalibration, computeFamilyTimestampValidBits,
+					timestampPeriod);
 			}
 
 			if (hostNonCoherent) {
 				CzU32 rangeCount = 1;
-				VK_CALLR(vkInvalidateMappedMemoryRanges, device, rangeCount, &outBuffersMappedRanges[j]);
+				VK_CALLR(vkInvalidateMappedMemoryRanges, device, rangeCount, &ringsMappedRanges[j]);
 				if CZ_NOEXPECT (vkres) { dyrecord_destroy(localRecord); return false; }
 			}
 
-			// Read total stopping times from mapped out-buffer
-			clock_t readBmStart = clock();
-			read_outbuffer(mappedOutBuffers[j], &position, bestStartValues, bestStopTimes, valuesPerInout);
-			clock_t readBmEnd = clock();
+			// Read candidate total stopping times and total steps from mapped ring buffer
+			candidateTotal += ringHeaders[j]->candidateCount;
+			loopSteps += ringHeaders[j]->stepSums[0] | (CzU64) ringHeaders[j]->stepSums[1] << 32;
+
+			double readBmStart = wall_time();
+			CZ_PROBE(
+				read_begin, j, CZ_U128_UPPER(position.curStartValue), CZ_U128_LOWER(position.curStartValue),
+				valuesPerInout);
+
+			read_ringbuffer(ringHeaders[j], stopTimes, &position, bestStartValues, bestStopTimes, valuesPerInout);
+
+			double readBmEnd = wall_time();
+			CZ_PROBE(read_end, j, position.bestStopTime, CZ_PROBE_NS(readBmEnd - readBmStart));
 
-			// Write starting values to mapped in-buffer
-			clock_t writeBmStart = clock();
-			write_inbuffer(mappedInBuffers[j], &testedValues[j], valuesPerInout, valuesPerHeap);
-			clock_t writeBmEnd = clock();
+			trace_event("Read", CZ_TRACE_TRACK_MAIN, j, readBmStart, readBmEnd);
+
+			// Write next range to mapped ring header
+			double writeBmStart = wall_time();
+			write_ringheader(ringHeaders[j], &baseValues[j], position.bestStopTime, workgroupCount, valuesPerHeap);
+			double writeBmEnd = wall_time();
+
+			trace_event("Write", CZ_TRACE_TRACK_MAIN, j, writeBmStart, writeBmEnd);
 
 			if (hostNonCoherent) {
 				CzU32 rangeCount = 1;
-				VK_CALLR(vkFlushMappedMemoryRanges, device, rangeCount, &inBuffersMappedRanges[j]);
+				VK_CALLR(vkFlushMappedMemoryRanges, device, rangeCount, &headersMappedRanges[j]);
 				if CZ_NOEXPECT (vkres) { dyrecord_destroy(localRecord); return false; }
 			}
 
-			// Update semaphore wait/signal values
-			transferWaitSemaphoreSubmitInfos[j].value += 2;
-			transferSignalSemaphoreSubmitInfos[j].value += 2;
+			// Update semaphore signal value
+			computeSignalSemaphoreSubmitInfos[j].value++;
+
+			// Resubmit compute command buffer for next cycle
+			double submitBmStart = wall_time();
 
-			// Resubmit transfer command buffer for next cycle
 			submitInfoCount = 1;
-			VK_CALLR(vkQueueSubmit2KHR, transferQueue, submitInfoCount, &transferSubmitInfos[j], VK_NULL_HANDLE);
-			if CZ_NOEXPECT (vkres) { dyrecord_destroy(localRecord); return NULL; }
+			VK_CALLR(vkQueueSubmit2KHR, computeQueue, submitInfoCount, &computeSubmitInfos[j], VK_NULL_HANDLE);
+			if CZ_NOEXPECT (vkres) { dyrecord_destroy(localRecord); return false; }
 
-			// Calculate and display benchmarks for current inout-buffer
-			double readBmark = get_benchmark(readBmStart, readBmEnd);
-			double writeBmark = get_benchmark(writeBmStart, writeBmEnd);
-			double waitComputeBmark = get_benchmark(waitComputeBmStart, waitComputeBmEnd);
-			double waitTransferBmark = get_benchmark(waitTransferBmStart, waitTransferBmEnd);
+			CZ_PROBE(submit, j, CZ_PROBE_QUEUE_COMPUTE);
+			trace_event("Submit (compute)", CZ_TRACE_TRACK_MAIN, j, submitBmStart, wall_time());
+
+			// Calculate and display benchmarks for current ring buffer
+			double readBmark = readBmEnd - readBmStart;
+			double writeBmark = writeBmEnd - writeBmStart;
+			double waitComputeBmark = waitComputeBmEnd - waitComputeBmStart;
 
 			readBmTotal += readBmark;
 			writeBmTotal += writeBmark;
 			computeBmTotal += computeBmark;
-			transferBmTotal += transferBmark;
 			waitComputeBmTotal += waitComputeBmark;
-			waitTransferBmTotal += waitTransferBmark;
 
 			if (czgConfig.outputLevel > CZ_OUTPUT_LEVEL_QUIET) {
 				printf(
-					"Inout-buffer %" PRIu32 "/%" PRIu32 "\n"
+					"Ring buffer %" PRIu32 "/%" PRIu32 "\n"
 					"\tReading buffers:    %8.0fms\n"
 					"\tWriting buffers:    %8.0fms\n"
 					"\tCompute execution:  %8.0fms\n"
-					"\tTransfer execution: %8.0fms\n"
-					"\tIdle (compute):     %8.0fms\n"
-					"\tIdle (transfer):    %8.0fms\n",
+					"\tIdle (compute):     %8.0fms\n",
 					j + 1, inoutsPerHeap,
-					readBmark,        writeBmark,
-					computeBmark,     transferBmark,
-					waitComputeBmark, waitTransferBmark);
+					readBmark,    writeBmark,
+					computeBmark, waitComputeBmark);
+			}
+
+			struct InoutMetrics inoutMetrics = {0};
+			inoutMetrics.loop = i + 1;
+			inoutMetrics.inout = j;
+			inoutMetrics.read = readBmark;
+			inoutMetrics.write = writeBmark;
+			inoutMetrics.compute = computeBmark;
+			inoutMetrics.idleCompute = waitComputeBmark;
+
+			if (czgConfig.outputLevel > CZ_OUTPUT_LEVEL_DEFAULT) {
+				metrics_inout(&inoutMetrics);
+			}
+
+			struct StatsProgress progress = {0};
+			progress.currentValue = position.curStartValue - 3;
+			progress.recordCount = dyarray_size(bestStartValues);
+			progress.bestStopTime = position.bestStopTime;
+
+			if (progress.recordCount) {
+				dyarray_last(bestStartValues, &progress.bestStartValue);
+			}
+
+			stats_inout(&inoutMetrics, &progress);
+
+			if (!gpu->tuningTrial) {
+				latency_inout(&inoutMetrics);
 			}
 		}
 
 		// Calculate and display benchmarks for current loop iteration
 		total += valuesPerHeap * 4;
+		totalSteps += loopSteps;
 
-		clock_t mainLoopBmEnd = clock();
-		double mainLoopBmark = get_benchmark(mainLoopBmStart, mainLoopBmEnd);
+		double mainLoopBmark = wall_time() - mainLoopBmStart;
 
 		double readBmAvg = readBmTotal / (double) inoutsPerHeap;
 		double writeBmAvg = writeBmTotal / (double) inoutsPerHeap;
 		double computeBmAvg = computeBmTotal / (double) inoutsPerHeap;
-		double transferBmAvg = transferBmTotal / (double) inoutsPerHeap;
 		double waitComputeBmAvg = waitComputeBmTotal / (double) inoutsPerHeap;
-		double waitTransferBmAvg = waitTransferBmTotal / (double) inoutsPerHeap;
+
+		// Continuous mode has no transfers
+		struct LoopMetrics loopMetrics = {0};
+		loopMetrics.initialValue = initialValue - 2;
+		loopMetrics.currentValue = position.curStartValue - 3;
+		loopMetrics.loop = i + 1;
+		loopMetrics.valueCount = valuesPerHeap * 4;
+		loopMetrics.recordCount = dyarray_size(bestStartValues);
+		loopMetrics.bestStopTime = position.bestStopTime;
+		loopMetrics.mainLoop = mainLoopBmark;
+		loopMetrics.valuesPerSecond = (double) (1000 * loopMetrics.valueCount) / mainLoopBmark;
+		loopMetrics.stepCount = loopSteps;
+		loopMetrics.stepsPerSecond = (double) (1000 * loopSteps) / mainLoopBmark;
+		loopMetrics.read = readBmTotal;
+		loopMetrics.write = writeBmTotal;
+		loopMetrics.compute = computeBmTotal;
+		loopMetrics.idleCompute = waitComputeBmTotal;
+		loopMetrics.valuesPerInout = valuesPerInout;
+		loopMetrics.inoutsPerHeap = inoutsPerHeap;
+		loopMetrics.stagesPerInout = gpu->stagesPerInout;
+		loopMetrics.dispatchesPerInout = gpu->dispatchesPerInout;
+		loopMetrics.hostVisibleTypeIndex = gpu->hostVisibleTypeIndex;
+		loopMetrics.hostVisibleOutTypeIndex = gpu->hostVisibleOutTypeIndex;
+		loopMetrics.deviceLocalTypeIndex = gpu->deviceLocalTypeIndex;
+
+		metrics_loop(&loopMetrics);
+		exporter_publish(&loopMetrics);
+		stats_loop(&loopMetrics);
+
+		CZ_PROBE(
+			loop_end, loopMetrics.loop, CZ_U128_UPPER(loopMetrics.initialValue),
+			CZ_U128_LOWER(loopMetrics.initialValue), loopMetrics.valueCount, CZ_PROBE_NS(mainLoopBmark));
 
 		switch (czgConfig.outputLevel) {
 		case CZ_OUTPUT_LEVEL_QUIET:
@@ -3025,18 +6866,19 @@ bool submit_commands(struct Gpu* restrict gpu)
 		case CZ_OUTPUT_LEVEL_DEFAULT:
 			printf(
 				"Main loop: %.0fms\n"
+				"Speed: %.3f/s (%.3f steps/s)\n"
 				"Reading buffers:    %8.1fms\n"
 				"Writing buffers:    %8.1fms\n"
 				"Compute execution:  %8.1fms\n"
-				"Transfer execution: %8.1fms\n"
 				"Idle (compute):     %8.1fms\n"
-				"Idle (transfer):    %8.1fms\n"
+				"Candidates:         %8" PRIu64 "\n"
 				"Initial value: 0x %016" PRIx64 " %016" PRIx64 "\n"
 				"Current value: 0x %016" PRIx64 " %016" PRIx64 "\n\n",
 				mainLoopBmark,
-				readBmAvg,        writeBmAvg,
-				computeBmAvg,     transferBmAvg,
-				waitComputeBmAvg, waitTransferBmAvg,
+				loopMetrics.valuesPerSecond, loopMetrics.stepsPerSecond,
+				readBmAvg,    writeBmAvg,
+				computeBmAvg, waitComputeBmAvg,
+				candidateTotal,
 				CZ_U128_UPPER(initialValue - 2),           CZ_U128_LOWER(initialValue - 2),
 				CZ_U128_UPPER(position.curStartValue - 3), CZ_U128_LOWER(position.curStartValue - 3));
 
@@ -3045,108 +6887,163 @@ bool submit_commands(struct Gpu* restrict gpu)
 		case CZ_OUTPUT_LEVEL_VERBOSE:
 			printf(
 				"Main loop: %.0fms\n"
+				"Speed: %.3f/s (%.3f steps/s)\n"
 				"|      Benchmark     | Total (ms) | Average (ms) |\n"
 				"|    Reading buffers | %10.0f | %12.1f |\n"
 				"|    Writing buffers | %10.0f | %12.1f |\n"
 				"|  Compute execution | %10.0f | %12.1f |\n"
-				"| Transfer execution | %10.0f | %12.1f |\n"
 				"|     Idle (compute) | %10.0f | %12.1f |\n"
-				"|    Idle (transfer) | %10.0f | %12.1f |\n"
+				"Candidates: %" PRIu64 "\n"
 				"Initial value: 0x %016" PRIx64 " %016" PRIx64 "\n"
 				"Current value: 0x %016" PRIx64 " %016" PRIx64 "\n\n",
 				mainLoopBmark,
-				readBmTotal,        readBmAvg,        writeBmTotal,        writeBmAvg,
-				computeBmTotal,     computeBmAvg,     transferBmTotal,     transferBmAvg,
-				waitComputeBmTotal, waitComputeBmAvg, waitTransferBmTotal, waitTransferBmAvg,
+				loopMetrics.valuesPerSecond, loopMetrics.stepsPerSecond,
+				readBmTotal,    readBmAvg,    writeBmTotal,       writeBmAvg,
+				computeBmTotal, computeBmAvg, waitComputeBmTotal, waitComputeBmAvg,
+				candidateTotal,
 				CZ_U128_UPPER(initialValue - 2),           CZ_U128_LOWER(initialValue - 2),
 				CZ_U128_UPPER(position.curStartValue - 3), CZ_U128_LOWER(position.curStartValue - 3));
 
-			break;
+			break;
+
+		default:
+			break;
+		}
+
+		bool latencyDue = czgConfig.latencyInterval && loopMetrics.loop % czgConfig.latencyInterval == 0;
+		if (latencyDue && !gpu->tuningTrial && czgConfig.outputLevel > CZ_OUTPUT_LEVEL_SILENT) {
+			latency_interval(czgConfig.latencyInterval);
+		}
+	}
+	CZ_NEWLINE();
+
+	double totalBmark = wall_time() - totalBmStart;
+
+	gpu->valuesPerSecond = (double) (1000 * total) / totalBmark;
+
+	// Tuning trials only measure speed, so neither display results nor save progress
+	if (gpu->tuningTrial) {
+		dyrecord_destroy(localRecord);
+		return true;
+	}
+
+	// Display results of calculations
+	print_results(&position, bestStartValues, bestStopTimes, initialStartValue, total, totalSteps, totalBmark);
+
+	// Write current position to progress file
+	bres = save_position(&position);
+	if CZ_NOEXPECT (!bres) { dyrecord_destroy(localRecord); return false; }
+
+	dyrecord_destroy(localRecord);
+	return true;
+}
+
+bool release_memory(struct Gpu* restrict gpu)
+{
+	const VkAllocationCallbacks* allocator = gpu->allocator;
+	const VkBuffer* hostVisibleBuffers = gpu->hostVisibleBuffers;
+	const VkBuffer* hostVisibleOutBuffers = gpu->hostVisibleOutBuffers;
+	const VkBuffer* deviceLocalBuffers = gpu->deviceLocalBuffers;
+	const VkDeviceMemory* hostVisibleMemories = gpu->hostVisibleDeviceMemories;
+	const VkDeviceMemory* hostVisibleOutMemories = gpu->hostVisibleOutDeviceMemories;
+	const VkDeviceMemory* deviceLocalMemories = gpu->deviceLocalDeviceMemories;
+	const VkSemaphore* semaphores = gpu->semaphores;
+	void* const* hostImports = gpu->hostImports;
+	void* const* hostOutImports = gpu->hostOutImports;
+
+	VkDevice device = gpu->device;
+
+	CzU32 inoutsPerHeap = gpu->inoutsPerHeap;
+	CzU32 buffersPerHeap = gpu->buffersPerHeap;
 
-		default:
-			break;
+	VkResult vkres;
+
+	// Make sure no command buffers are in the pending state
+	VK_CALLR(vkDeviceWaitIdle, device);
+	if CZ_NOEXPECT (vkres) { return false; }
+
+	/*
+	 * Destroy every object whose size depends on the memory layout, freeing whole device memory objects. The instance,
+	 * device, queues, descriptor set layout, and pipeline are kept, so only the objects sized by the layout need be
+	 * created anew once it is planned again.
+	 */
+	if (semaphores) {
+		for (CzU32 i = 0; i < inoutsPerHeap; i++) {
+			VK_CALL(vkDestroySemaphore, device, semaphores[i], allocator);
 		}
 	}
-	CZ_NEWLINE();
 
-	clock_t totalBmEnd = clock();
-	double totalBmark = get_benchmark(totalBmStart, totalBmEnd);
+	VK_CALL(vkDestroyCommandPool, device, gpu->initialCmdPool, allocator);
+	VK_CALL(vkDestroyCommandPool, device, gpu->computeCmdPool, allocator);
+	VK_CALL(vkDestroyCommandPool, device, gpu->transferCmdPool, allocator);
 
-	// Stop waiting thread
-	if (atomic_load(&input)) {
-		ires = pthread_join(waitThread, NULL);
-		if CZ_NOEXPECT (ires) { PJOIN_FAILURE(ires); dyrecord_destroy(localRecord); return false; }
+	VK_CALL(vkDestroyQueryPool, device, gpu->queryPool, allocator);
+	VK_CALL(vkDestroyQueryPool, device, gpu->invocationQueryPool, allocator);
+	VK_CALL(vkDestroyDescriptorPool, device, gpu->descriptorPool, allocator);
+
+	if (hostVisibleBuffers) {
+		for (CzU32 i = 0; i < buffersPerHeap; i++) {
+			VK_CALL(vkDestroyBuffer, device, hostVisibleBuffers[i], allocator);
+		}
 	}
-	else {
-		atomic_store(&input, true);
-		ires = pthread_cancel(waitThread);
-		if CZ_NOEXPECT (ires) { PCANCEL_FAILURE(ires); dyrecord_destroy(localRecord); return false; }
+	if (hostVisibleOutBuffers) {
+		for (CzU32 i = 0; i < buffersPerHeap; i++) {
+			VK_CALL(vkDestroyBuffer, device, hostVisibleOutBuffers[i], allocator);
+		}
 	}
-
-	// Display results of calculations
-	if (czgConfig.outputLevel > CZ_OUTPUT_LEVEL_SILENT) {
-		printf(
-			"Set of starting values tested: [0x %016" PRIx64 " %016" PRIx64 ", 0x %016" PRIx64 " %016" PRIx64 "]\n",
-			CZ_U128_UPPER(initialStartValue - 2),      CZ_U128_LOWER(initialStartValue - 2),
-			CZ_U128_UPPER(position.curStartValue - 3), CZ_U128_LOWER(position.curStartValue - 3));
+	if (deviceLocalBuffers) {
+		for (CzU32 i = 0; i < buffersPerHeap; i++) {
+			VK_CALL(vkDestroyBuffer, device, deviceLocalBuffers[i], allocator);
+		}
 	}
-
-	size_t bestCount = dyarray_size(bestStartValues);
-
-	if (bestCount) {
-		printf(
-			"New highest total stopping times (%zu):\n"
-			"|   #   |   Starting value (hexadecimal)    | Total stopping time |\n",
-			bestCount);
+	if (hostVisibleMemories) {
+		for (CzU32 i = 0; i < buffersPerHeap; i++) {
+			VK_CALL(vkFreeMemory, device, hostVisibleMemories[i], allocator);
+		}
 	}
-
-	for (CzU32 i = 0; i < bestCount; i++) {
-		CzU128 startValue;
-		CzU16 stopTime;
-
-		dyarray_get(bestStartValues, &startValue, i);
-		dyarray_get(bestStopTimes, &stopTime, i);
-
-		printf(
-			"| %5" PRIu32 " | %016" PRIx64 " %016" PRIx64 " | %19" PRIu16 " |\n",
-			i + 1, CZ_U128_UPPER(startValue), CZ_U128_LOWER(startValue), stopTime);
+	if (hostVisibleOutMemories) {
+		for (CzU32 i = 0; i < buffersPerHeap; i++) {
+			VK_CALL(vkFreeMemory, device, hostVisibleOutMemories[i], allocator);
+		}
 	}
-
-	if (czgConfig.outputLevel > CZ_OUTPUT_LEVEL_SILENT) {
-		double valuesPerSecond = (double) (1000 * total) / totalBmark;
-
-		printf(
-			"\n"
-			"Time: %.3fms\n"
-			"Speed: %.3f/s\n",
-			totalBmark, valuesPerSecond);
+	if (deviceLocalMemories) {
+		for (CzU32 i = 0; i < buffersPerHeap; i++) {
+			VK_CALL(vkFreeMemory, device, deviceLocalMemories[i], allocator);
+		}
+	}
+	if (hostImports) {
+		for (CzU32 i = 0; i < buffersPerHeap; i++) {
+			czFreeHuge(hostImports[i], (size_t) gpu->bytesPerHostImport);
+		}
+	}
+	if (hostOutImports) {
+		for (CzU32 i = 0; i < buffersPerHeap; i++) {
+			czFreeHuge(hostOutImports[i], (size_t) gpu->bytesPerHostOutImport);
+		}
 	}
 
-	// Write current position to progress file
-	if (!czgConfig.restart) {
-		bres = write_text(
-			CZ_PROGRESS_FILE_NAME,
-			"%016" PRIx64 " %016" PRIx64 "\n"
-			"%016" PRIx64 " %016" PRIx64 "\n"
-			"%016" PRIx64 " %016" PRIx64 "\n"
-			"%016" PRIx64 " %016" PRIx64 "\n"
-			"%016" PRIx64 " %016" PRIx64 "\n"
-			"%016" PRIx64 " %016" PRIx64 "\n"
-			"%016" PRIx64 " %016" PRIx64 "\n"
-			"%04"  PRIx16,
-			CZ_U128_UPPER(position.val0mod1off[0]), CZ_U128_LOWER(position.val0mod1off[0]),
-			CZ_U128_UPPER(position.val0mod1off[1]), CZ_U128_LOWER(position.val0mod1off[1]),
-			CZ_U128_UPPER(position.val0mod1off[2]), CZ_U128_LOWER(position.val0mod1off[2]),
-			CZ_U128_UPPER(position.val1mod6off[0]), CZ_U128_LOWER(position.val1mod6off[0]),
-			CZ_U128_UPPER(position.val1mod6off[1]), CZ_U128_LOWER(position.val1mod6off[1]),
-			CZ_U128_UPPER(position.val1mod6off[2]), CZ_U128_LOWER(position.val1mod6off[2]),
-			CZ_U128_UPPER(position.curStartValue),  CZ_U128_LOWER(position.curStartValue),
-			position.bestStopTime);
+	VK_CALL(vkDestroyBuffer, device, gpu->statsBuffer, allocator);
+	VK_CALL(vkFreeMemory, device, gpu->statsDeviceMemory, allocator);
 
-		if CZ_NOEXPECT (!bres) { dyrecord_destroy(localRecord); return false; }
-	}
+	gpu->semaphores = NULL;
+	gpu->initialCmdPool = VK_NULL_HANDLE;
+	gpu->computeCmdPool = VK_NULL_HANDLE;
+	gpu->transferCmdPool = VK_NULL_HANDLE;
+	gpu->queryPool = VK_NULL_HANDLE;
+	gpu->invocationQueryPool = VK_NULL_HANDLE;
+	gpu->descriptorPool = VK_NULL_HANDLE;
+	gpu->hostVisibleBuffers = NULL;
+	gpu->hostVisibleOutBuffers = NULL;
+	gpu->deviceLocalBuffers = NULL;
+	gpu->hostVisibleDeviceMemories = NULL;
+	gpu->hostVisibleOutDeviceMemories = NULL;
+	gpu->deviceLocalDeviceMemories = NULL;
+	gpu->hostImports = NULL;
+	gpu->hostOutImports = NULL;
+	gpu->statsBuffer = VK_NULL_HANDLE;
+	gpu->statsDeviceMemory = VK_NULL_HANDLE;
+	gpu->mappedStats = NULL;
 
-	dyrecord_destroy(localRecord);
 	return true;
 }
 
@@ -3156,10 +7053,14 @@ bool destroy_gpu(struct Gpu* restrict gpu)
 
 	const VkAllocationCallbacks* allocator = gpu->allocator;
 	const VkBuffer* hostVisibleBuffers = gpu->hostVisibleBuffers;
+	const VkBuffer* hostVisibleOutBuffers = gpu->hostVisibleOutBuffers;
 	const VkBuffer* deviceLocalBuffers = gpu->deviceLocalBuffers;
 	const VkDeviceMemory* hostVisibleMemories = gpu->hostVisibleDeviceMemories;
+	const VkDeviceMemory* hostVisibleOutMemories = gpu->hostVisibleOutDeviceMemories;
 	const VkDeviceMemory* deviceLocalMemories = gpu->deviceLocalDeviceMemories;
 	const VkSemaphore* semaphores = gpu->semaphores;
+	void* const* hostImports = gpu->hostImports;
+	void* const* hostOutImports = gpu->hostOutImports;
 
 	VkDevice device = gpu->device;
 
@@ -3189,6 +7090,7 @@ bool destroy_gpu(struct Gpu* restrict gpu)
 
 		VK_CALL(vkDestroyPipeline, device, gpu->pipeline, allocator);
 		VK_CALL(vkDestroyQueryPool, device, gpu->queryPool, allocator);
+		VK_CALL(vkDestroyQueryPool, device, gpu->invocationQueryPool, allocator);
 		VK_CALL(vkDestroyDescriptorPool, device, gpu->descriptorPool, allocator);
 
 		if (hostVisibleBuffers) {
@@ -3196,6 +7098,11 @@ bool destroy_gpu(struct Gpu* restrict gpu)
 				VK_CALL(vkDestroyBuffer, device, hostVisibleBuffers[i], allocator);
 			}
 		}
+		if (hostVisibleOutBuffers) {
+			for (CzU32 i = 0; i < buffersPerHeap; i++) {
+				VK_CALL(vkDestroyBuffer, device, hostVisibleOutBuffers[i], allocator);
+			}
+		}
 		if (deviceLocalBuffers) {
 			for (CzU32 i = 0; i < buffersPerHeap; i++) {
 				VK_CALL(vkDestroyBuffer, device, deviceLocalBuffers[i], allocator);
@@ -3206,11 +7113,29 @@ bool destroy_gpu(struct Gpu* restrict gpu)
 				VK_CALL(vkFreeMemory, device, hostVisibleMemories[i], allocator);
 			}
 		}
+		if (hostVisibleOutMemories) {
+			for (CzU32 i = 0; i < buffersPerHeap; i++) {
+				VK_CALL(vkFreeMemory, device, hostVisibleOutMemories[i], allocator);
+			}
+		}
 		if (deviceLocalMemories) {
 			for (CzU32 i = 0; i < buffersPerHeap; i++) {
 				VK_CALL(vkFreeMemory, device, deviceLocalMemories[i], allocator);
 			}
 		}
+		if (hostImports) {
+			for (CzU32 i = 0; i < buffersPerHeap; i++) {
+				czFreeHuge(hostImports[i], (size_t) gpu->bytesPerHostImport);
+			}
+		}
+		if (hostOutImports) {
+			for (CzU32 i = 0; i < buffersPerHeap; i++) {
+				czFreeHuge(hostOutImports[i], (size_t) gpu->bytesPerHostOutImport);
+			}
+		}
+
+		VK_CALL(vkDestroyBuffer, device, gpu->statsBuffer, allocator);
+		VK_CALL(vkFreeMemory, device, gpu->statsDeviceMemory, allocator);
 
 		VK_CALL(vkDestroyDevice, device, allocator);
 	}
@@ -3405,8 +7330,310 @@ void* wait_for_input(void* ptr)
 	return NULL;
 }
 
+bool host_queue_init(struct HostQueue* restrict queue, size_t size, size_t count)
+{
+	DyRing ring = dyring_create(size, count);
+	if CZ_NOEXPECT (!ring) { return false; }
+
+	int ires = pthread_mutex_init(&queue->mutex, NULL);
+	if CZ_NOEXPECT (ires) { PMUTEX_FAILURE(ires); dyring_destroy(ring); return false; }
+
+	ires = pthread_cond_init(&queue->notEmpty, NULL);
+	if CZ_NOEXPECT (ires) {
+		PCOND_FAILURE(ires);
+		pthread_mutex_destroy(&queue->mutex);
+		dyring_destroy(ring);
+		return false;
+	}
+
+	ires = pthread_cond_init(&queue->notFull, NULL);
+	if CZ_NOEXPECT (ires) {
+		PCOND_FAILURE(ires);
+		pthread_cond_destroy(&queue->notEmpty);
+		pthread_mutex_destroy(&queue->mutex);
+		dyring_destroy(ring);
+		return false;
+	}
+
+	atomic_init(&queue->consumerWaiting, false);
+	atomic_init(&queue->producerWaiting, false);
+
+	queue->ring = ring;
+	return true;
+}
+
+void host_queue_fini(struct HostQueue* restrict queue)
+{
+	pthread_cond_destroy(&queue->notFull);
+	pthread_cond_destroy(&queue->notEmpty);
+	pthread_mutex_destroy(&queue->mutex);
+	dyring_destroy(queue->ring);
+}
+
+/*
+ * A thread only sleeps on a queue after setting its waiting flag and then checking the ring again, and the other thread
+ * only checks the flag after pushing or popping. The fences between each store and load ensure either the sleeping
+ * thread sees the task or freed slot, or the other thread sees the flag and wakes it. So the mutex is only locked when
+ * a thread is asleep, or about to sleep, rather than on every push and pop.
+ */
+
+// Wake the other thread of a queue if it has set waiting, and so may be asleep on cond
+static bool host_queue_wake(
+	struct HostQueue* restrict queue, const atomic_bool* restrict waiting, pthread_cond_t* restrict cond)
+{
+	atomic_thread_fence(memory_order_seq_cst);
+	if CZ_EXPECT (!atomic_load_explicit(waiting, memory_order_relaxed)) { return true; }
+
+	// Locking before signalling ensures the thread is either yet to check the ring again, or is asleep
+	int ires = pthread_mutex_lock(&queue->mutex);
+	if CZ_NOEXPECT (ires) { PMUTEX_FAILURE(ires); return false; }
+
+	ires = pthread_cond_signal(cond);
+	if CZ_NOEXPECT (ires) { PCOND_FAILURE(ires); pthread_mutex_unlock(&queue->mutex); return false; }
+
+	ires = pthread_mutex_unlock(&queue->mutex);
+	if CZ_NOEXPECT (ires) { PMUTEX_FAILURE(ires); return false; }
+
+	return true;
+}
+
+bool host_queue_push(struct HostQueue* restrict queue, const void* restrict task)
+{
+	// Rings are created with room for every task that can be in flight at once, so are rarely full
+	bool bres = dyring_push(queue->ring, task);
+
+	if CZ_NOEXPECT (!bres) {
+		int ires = pthread_mutex_lock(&queue->mutex);
+		if CZ_NOEXPECT (ires) { PMUTEX_FAILURE(ires); return false; }
+
+		atomic_store_explicit(&queue->producerWaiting, true, memory_order_relaxed);
+		atomic_thread_fence(memory_order_seq_cst);
+
+		while (!dyring_push(queue->ring, task)) {
+			ires = pthread_cond_wait(&queue->notFull, &queue->mutex);
+			if CZ_NOEXPECT (ires) { PCOND_FAILURE(ires); pthread_mutex_unlock(&queue->mutex); return false; }
+		}
+
+		atomic_store_explicit(&queue->producerWaiting, false, memory_order_relaxed);
+
+		ires = pthread_mutex_unlock(&queue->mutex);
+		if CZ_NOEXPECT (ires) { PMUTEX_FAILURE(ires); return false; }
+	}
+
+	bres = host_queue_wake(queue, &queue->consumerWaiting, &queue->notEmpty);
+	return bres;
+}
+
+bool host_queue_pop(struct HostQueue* restrict queue, void* restrict task)
+{
+	bool bres = dyring_pop(queue->ring, task);
+
+	if (!bres) {
+		int ires = pthread_mutex_lock(&queue->mutex);
+		if CZ_NOEXPECT (ires) { PMUTEX_FAILURE(ires); return false; }
+
+		atomic_store_explicit(&queue->consumerWaiting, true, memory_order_relaxed);
+		atomic_thread_fence(memory_order_seq_cst);
+
+		while (!dyring_pop(queue->ring, task)) {
+			ires = pthread_cond_wait(&queue->notEmpty, &queue->mutex);
+			if CZ_NOEXPECT (ires) { PCOND_FAILURE(ires); pthread_mutex_unlock(&queue->mutex); return false; }
+		}
+
+		atomic_store_explicit(&queue->consumerWaiting, false, memory_order_relaxed);
+
+		ires = pthread_mutex_unlock(&queue->mutex);
+		if CZ_NOEXPECT (ires) { PMUTEX_FAILURE(ires); return false; }
+	}
+
+	bres = host_queue_wake(queue, &queue->producerWaiting, &queue->notFull);
+	return bres;
+}
+
+void* write_inbuffers(void* ptr)
+{
+	struct InbufferWriter* writer = (struct InbufferWriter*) ptr;
+
+	CzU128* const* mappedInBuffers = writer->mappedInBuffers;
+	CzU128* testedValues = writer->testedValues;
+
+	CzU64 valuesPerInout = writer->valuesPerInout;
+	CzU64 valuesPerHeap = writer->valuesPerHeap;
+
+	struct HostTask task;
+
+	while (true) {
+		bool bres = host_queue_pop(writer->tasks, &task);
+		if CZ_NOEXPECT (!bres) { goto err_send_failure; }
+
+		if (task.inout == UINT32_MAX) { break; }
+
+		// Write starting values to mapped in-buffer
+		double writeBmStart = wall_time();
+		write_inbuffer(mappedInBuffers[task.staging], &testedValues[task.inout], valuesPerInout, valuesPerHeap);
+		double writeBmEnd = wall_time();
+
+		trace_event("Write", CZ_TRACE_TRACK_WRITER, task.inout, writeBmStart, writeBmEnd);
+
+		task.bmark = writeBmEnd - writeBmStart;
+
+		bres = host_queue_push(writer->results, &task);
+		if CZ_NOEXPECT (!bres) { break; }
+	}
+
+	return NULL;
+
+err_send_failure:
+	// Otherwise the main thread would wait forever for the result of the task
+	memset(&task, 0, sizeof(task));
+	task.failed = true;
+
+	host_queue_push(writer->results, &task);
+	return NULL;
+}
+
+void* read_outbuffers(void* ptr)
+{
+	struct OutbufferReader* reader = (struct OutbufferReader*) ptr;
+
+	const struct OutbufferScanner* scanners = reader->scanners;
+	CzU16* maxStopTimes = reader->maxStopTimes;
+
+	CzU16* const* mappedOutBuffers = reader->mappedOutBuffers;
+	struct Position* position = reader->position;
+
+	DyArray bestStartValues = reader->bestStartValues;
+	DyArray bestStopTimes = reader->bestStopTimes;
+
+	CzU64 valuesPerInout = reader->valuesPerInout;
+	CzU32 valuesPerChunk = reader->valuesPerChunk;
+	CzU32 scannerCount = reader->scannerCount;
+
+	CzU32 chunkCount = (CzU32) ((valuesPerInout + valuesPerChunk - 1) / valuesPerChunk);
+	CzU32 chunksPerThread = (chunkCount + scannerCount) / (scannerCount + 1);
+
+	struct HostTask task;
+
+	while (true) {
+		bool bres = host_queue_pop(reader->tasks, &task);
+		if CZ_NOEXPECT (!bres) { goto err_send_failure; }
+
+		if (task.inout == UINT32_MAX) { break; }
+
+		const CzU16* mappedOutBuffer = mappedOutBuffers[task.staging];
+
+#if !defined(NDEBUG)
+		// Spot-check total stopping times against the host kernel
+		if (czgConfig.iterSize == 128) {
+			CzU32 sampleCount = 16;
+			cpu_check_outbuffer(mappedOutBuffer, position->curStartValue, valuesPerInout, sampleCount);
+		}
+#endif
+
+		double readBmStart = wall_time();
+		CZ_PROBE(
+			read_begin, task.inout, CZ_U128_UPPER(position->curStartValue), CZ_U128_LOWER(position->curStartValue),
+			valuesPerInout);
+
+		// Find greatest total stopping time of each chunk, sharing the chunks with the scanner threads
+		CzU32 firstChunk = 0;
+		CzU32 busyCount = 0;
+		bool scanFailed = false;
+
+		for (; busyCount < scannerCount && firstChunk + chunksPerThread < chunkCount; busyCount++) {
+			struct ScanTask scanTask = {0};
+			scanTask.stopTimes = mappedOutBuffer + (CzU64) firstChunk * valuesPerChunk;
+			scanTask.maxStopTimes = maxStopTimes + firstChunk;
+			scanTask.valueCount = (CzU64) chunksPerThread * valuesPerChunk;
+			scanTask.valuesPerChunk = valuesPerChunk;
+
+			bres = host_queue_push(scanners[busyCount].tasks, &scanTask);
+			if CZ_NOEXPECT (!bres) { scanFailed = true; break; }
+
+			firstChunk += chunksPerThread;
+		}
+
+		CzU64 firstValue = (CzU64) firstChunk * valuesPerChunk;
+		CzU64 valueCount = valuesPerInout - firstValue;
+		scan_outbuffer(mappedOutBuffer + firstValue, maxStopTimes + firstChunk, valueCount, valuesPerChunk);
+
+		// Collect every scanner thread which was sent chunks, even after a failure, so none is left mid-scan
+		for (CzU32 i = 0; i < busyCount; i++) {
+			struct ScanTask scanTask;
+			bres = host_queue_pop(scanners[i].results, &scanTask);
+
+			if CZ_NOEXPECT (!bres || scanTask.failed) {
+				scanFailed = true;
+			}
+		}
+
+		if CZ_NOEXPECT (scanFailed) { goto err_send_failure; }
+
+		// Update position in order, only stepping through chunks which can affect it
+		merge_outbuffer(
+			mappedOutBuffer, maxStopTimes, position, bestStartValues, bestStopTimes, valuesPerInout, valuesPerChunk);
+
+		double readBmEnd = wall_time();
+		CZ_PROBE(read_end, task.inout, position->bestStopTime, CZ_PROBE_NS(readBmEnd - readBmStart));
+
+		trace_event("Read", CZ_TRACE_TRACK_READER, task.inout, readBmStart, readBmEnd);
+
+		task.bmark = readBmEnd - readBmStart;
+		task.curStartValue = position->curStartValue;
+		task.bestStopTime = position->bestStopTime;
+		task.recordCount = dyarray_size(bestStartValues);
+		task.bestStartValue = 0;
+
+		if (task.recordCount) {
+			dyarray_last(bestStartValues, &task.bestStartValue);
+		}
+
+		bres = host_queue_push(reader->results, &task);
+		if CZ_NOEXPECT (!bres) { break; }
+	}
+
+	return NULL;
+
+err_send_failure:
+	// Otherwise the main thread would wait forever for the result of the task
+	memset(&task, 0, sizeof(task));
+	task.failed = true;
+
+	host_queue_push(reader->results, &task);
+	return NULL;
+}
+
+void* scan_outbuffers(void* ptr)
+{
+	const struct OutbufferScanner* scanner = (const struct OutbufferScanner*) ptr;
+
+	struct ScanTask task;
+
+	while (true) {
+		bool bres = host_queue_pop(scanner->tasks, &task);
+		if CZ_NOEXPECT (!bres) { goto err_send_failure; }
+
+		if (!task.stopTimes) { break; }
+
+		scan_outbuffer(task.stopTimes, task.maxStopTimes, task.valueCount, task.valuesPerChunk);
+
+		bres = host_queue_push(scanner->results, &task);
+		if CZ_NOEXPECT (!bres) { break; }
+	}
+
+	return NULL;
+
+err_send_failure:
+	// Otherwise the reader thread would wait forever for the result of the task
+	memset(&task, 0, sizeof(task));
+	task.failed = true;
+
+	host_queue_push(scanner->results, &task);
+	return NULL;
+}
+
 void write_inbuffer(
-	CzU128* restrict mappedInBuffer, CzU128* restrict firstStartValue, CzU32 valuesPerInout, CzU32 valuesPerHeap)
+	CzU128* restrict mappedInBuffer, CzU128* restrict firstStartValue, CzU64 valuesPerInout, CzU64 valuesPerHeap)
 {
 	CZ_ASSUME(*firstStartValue % 8 == 3);
 	CZ_ASSUME(valuesPerInout % 128 == 0);
@@ -3414,7 +7641,7 @@ void write_inbuffer(
 
 	CzU128 startValue = *firstStartValue;
 
-	for (CzU32 i = 0; i < valuesPerInout; i++) {
+	for (CzU64 i = 0; i < valuesPerInout; i++) {
 		mappedInBuffer[i] = startValue;
 		startValue += 4;
 	}
@@ -3427,7 +7654,7 @@ void read_outbuffer(
 	struct Position* restrict position,
 	DyArray bestStartValues,
 	DyArray bestStopTimes,
-	CzU32 valuesPerInout)
+	CzU64 valuesPerInout)
 {
 	CZ_ASSUME(position->curStartValue % 8 == 3);
 	CZ_ASSUME(valuesPerInout % 128 == 0);
@@ -3442,7 +7669,7 @@ void read_outbuffer(
 	CzU128 curValue = position->curStartValue - 2;
 	CzU16 bestTime = position->bestStopTime;
 
-	for (CzU32 i = 0; i < valuesPerInout; i++) {
+	for (CzU64 i = 0; i < valuesPerInout; i++) {
 		curValue++; // curValue % 8 == 2
 
 		if (curValue == val0mod1off[0] * 2) {
@@ -3574,6 +7801,133 @@ void read_outbuffer(
 	position->bestStopTime = bestTime;
 }
 
+void scan_outbuffer(
+	const CzU16* restrict stopTimes, CzU16* restrict maxStopTimes, CzU64 valueCount, CzU32 valuesPerChunk)
+{
+	CZ_ASSUME(valuesPerChunk != 0);
+
+	for (CzU64 i = 0, j = 0; i < valueCount; i += valuesPerChunk, j++) {
+		CzU64 lastValue = minu64(i + valuesPerChunk, valueCount);
+		CzU16 maxStopTime = 0;
+
+		for (CzU64 k = i; k < lastValue; k++) {
+			if (stopTimes[k] > maxStopTime) { maxStopTime = stopTimes[k]; }
+		}
+
+		maxStopTimes[j] = maxStopTime;
+	}
+}
+
+bool outbuffer_chunk_relevant(const struct Position* restrict position, CzU16 maxStopTime, CzU32 valueCount)
+{
+	// Odd starting values are only compared against bestStopTime, bestStopTime - 1, and bestStopTime - 2
+	if (maxStopTime + 2 >= position->bestStopTime) {
+		return true;
+	}
+
+	/*
+	 * Otherwise, the position can only change at a starting value derived from a value already in the position (as in
+	 * read_outbuffer). Checking every such value is conservative, as not all of them are checked in every case.
+	 */
+	CzU128 lowerValue = position->curStartValue - 2; // Exclusive
+	CzU128 upperValue = lowerValue + valueCount * 4; // Inclusive
+
+	for (CzU32 i = 0; i < CZ_COUNTOF(position->val0mod1off); i++) {
+		CzU128 val0mod1 = position->val0mod1off[i];
+		CzU128 val1mod6 = position->val1mod6off[i];
+
+		if (val0mod1) {
+			CzU128 derivedValues[] = {val0mod1 * 2, val0mod1 * 4, val0mod1 * 8, val0mod1 + 1};
+
+			for (CzU32 j = 0; j < CZ_COUNTOF(derivedValues); j++) {
+				if (derivedValues[j] > lowerValue && derivedValues[j] <= upperValue) { return true; }
+			}
+		}
+
+		if (val1mod6) {
+			CzU128 derivedValue = (val1mod6 * 4 - 1) / 3;
+			if (derivedValue > lowerValue && derivedValue <= upperValue) { return true; }
+		}
+	}
+
+	return false;
+}
+
+void merge_outbuffer(
+	const CzU16* restrict mappedOutBuffer,
+	const CzU16* restrict maxStopTimes,
+	struct Position* restrict position,
+	DyArray bestStartValues,
+	DyArray bestStopTimes,
+	CzU64 valuesPerInout,
+	CzU32 valuesPerChunk)
+{
+	CZ_ASSUME(valuesPerChunk % 128 == 0);
+	CZ_ASSUME(valuesPerChunk != 0);
+
+	for (CzU64 i = 0, j = 0; i < valuesPerInout; i += valuesPerChunk, j++) {
+		CzU32 valueCount = (CzU32) minu64(valuesPerChunk, valuesPerInout - i);
+		bool relevant = outbuffer_chunk_relevant(position, maxStopTimes[j], valueCount);
+
+		if (relevant) {
+			read_outbuffer(mappedOutBuffer + i, position, bestStartValues, bestStopTimes, valueCount);
+		}
+		else {
+			position->curStartValue += valueCount * 4;
+		}
+	}
+}
+
+void write_ringheader(
+	struct RingHeader* restrict ringHeader,
+	CzU128* restrict baseValue,
+	CzU16 bestStopTime,
+	CzU32 chunkCount,
+	CzU64 valuesPerHeap)
+{
+	CZ_ASSUME(*baseValue % 8 == 3);
+
+	/*
+	 * read_outbuffer only compares total stopping times against bestStopTime, bestStopTime - 1, and bestStopTime - 2.
+	 * bestStopTime never decreases, so any starting value with a lesser total stopping time cannot affect the result.
+	 */
+	ringHeader->candidateCount = 0;
+	ringHeader->chunkCount = chunkCount;
+	ringHeader->threshold = bestStopTime > 2 ? bestStopTime - 2U : 0;
+	ringHeader->baseValue = *baseValue;
+	ringHeader->stepSums[0] = 0;
+	ringHeader->stepSums[1] = 0;
+
+	*baseValue += valuesPerHeap * 4;
+}
+
+void read_ringbuffer(
+	const struct RingHeader* restrict ringHeader,
+	CzU16* restrict stopTimes,
+	struct Position* restrict position,
+	DyArray bestStartValues,
+	DyArray bestStopTimes,
+	CzU64 valuesPerInout)
+{
+	CZ_ASSUME(valuesPerInout % 128 == 0);
+	CZ_ASSUME(valuesPerInout != 0);
+
+	const struct RingCandidate* candidates = (const struct RingCandidate*) (ringHeader + 1);
+	CzU32 candidateCount = (CzU32) minu64(ringHeader->candidateCount, valuesPerInout);
+
+	// Starting values not appended as candidates are below the threshold, so treat them as having no steps
+	memset(stopTimes, 0, valuesPerInout * sizeof(CzU16));
+
+	for (CzU32 i = 0; i < candidateCount; i++) {
+		CzU32 index = candidates[i].index;
+		if CZ_NOEXPECT (index >= valuesPerInout) { continue; }
+
+		stopTimes[index] = (CzU16) candidates[i].stopTime;
+	}
+
+	read_outbuffer(stopTimes, position, bestStartValues, bestStopTimes, valuesPerInout);
+}
+
 void new_high(
 	const CzU128* restrict startValue,
 	CzU16* restrict curBestTime,
@@ -3597,4 +7951,6 @@ void new_high(
 
 	dyarray_append(bestStartValues, startValue);
 	dyarray_append(bestStopTimes, curBestTime);
+
+	CZ_PROBE(new_high, CZ_U128_UPPER(*startValue), CZ_U128_LOWER(*startValue), newBestTime);
 }
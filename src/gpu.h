@@ -20,6 +20,27 @@
 #include "common.h"
 #include "dynamic.h"
 
+struct Tuning
+{
+	CzU32 workgroupSize; // Greatest workgroup size, or zero for the device limit.
+	CzU32 valuesPerDispatch; // Greatest number of starting values per dispatch, or zero for the device limit.
+	CzU32 inoutsPerHeap; // Greatest number of inout-buffers, or zero to fill the usable heap memory.
+	CzU32 subgroupSize; // Required subgroup size, or zero to allow a varying subgroup size.
+};
+
+struct Position
+{
+	/* 
+	 * Suppose the current longest total stopping time is T. Then val-a-mod-m-off[k] gives the least starting value x
+	 * with total stopping time t such that (1) x ≡ a (mod m) and (2) t + k = T.
+	 */
+	CzU128 val0mod1off[3];
+	CzU128 val1mod6off[3];
+
+	CzU128 curStartValue; // First starting value being checked in the current dispatch.
+	CzU16 bestStopTime; // Current longest total stopping time.
+};
+
 struct Gpu
 {
 	DyRecord allocRecord;
@@ -33,15 +54,20 @@ struct Gpu
 	VkQueue computeQueue;
 	VkQueue transferQueue;
 
-	VkBuffer* restrict hostVisibleBuffers; // Count = buffersPerHeap
+	VkBuffer* restrict hostVisibleBuffers; // Count = buffersPerHeap, in-buffers (record ring buffers if continuous)
+	VkBuffer* restrict hostVisibleOutBuffers; // Count = buffersPerHeap, out-buffers (if not continuous)
 	VkBuffer* restrict deviceLocalBuffers; // Count = buffersPerHeap
 
 	VkDeviceMemory* restrict hostVisibleDeviceMemories; // Count = buffersPerHeap
+	VkDeviceMemory* restrict hostVisibleOutDeviceMemories; // Count = buffersPerHeap, if not continuous
 	VkDeviceMemory* restrict deviceLocalDeviceMemories; // Count = buffersPerHeap
 
+	VkBuffer statsBuffer; // Step counters of each dispatch, then divergence stats if instrumenting (not continuous).
+	VkDeviceMemory statsDeviceMemory;
+
 	VkDescriptorSetLayout descriptorSetLayout;
 	VkDescriptorPool descriptorPool;
-	VkDescriptorSet* restrict descriptorSets; // Count = inoutsPerHeap
+	VkDescriptorSet* restrict descriptorSets; // Count = inoutsPerHeap * dispatchesPerInout
 
 	VkShaderModule shaderModule;
 	VkPipelineCache pipelineCache;
@@ -49,41 +75,69 @@ struct Gpu
 	VkPipeline pipeline;
 
 	VkQueryPool queryPool;
+	VkQueryPool invocationQueryPool; // Compute shader invocations of each staging region, if using pipeline stats.
 
 	VkCommandPool initialCmdPool;
 	VkCommandPool computeCmdPool;
 	VkCommandPool transferCmdPool;
 
 	VkCommandBuffer initialCmdBuffer;
-	VkCommandBuffer* restrict computeCmdBuffers; // Count = inoutsPerHeap
-	VkCommandBuffer* restrict transferCmdBuffers; // Count = inoutsPerHeap
+	VkCommandBuffer* restrict computeCmdBuffers; // Count = inoutsPerHeap * stagesPerInout
+	VkCommandBuffer* restrict transferCmdBuffers; // Count = inoutsPerHeap * stagesPerInout
 
 	VkSemaphore* restrict semaphores; // Count = inoutsPerHeap
 
-	CzU128** restrict mappedInBuffers; // Count = inoutsPerHeap, valuesPerInout
-	CzU16** restrict mappedOutBuffers; // Count = inoutsPerHeap, valuesPerInout
+	CzU128** restrict mappedInBuffers; // Count = inoutsPerHeap * stagesPerInout, valuesPerInout
+	CzU16** restrict mappedOutBuffers; // Count = inoutsPerHeap * stagesPerInout, valuesPerInout
+	void** restrict hostImports; // Count = buffersPerHeap, null where a host visible device memory was not imported
+	void** restrict hostOutImports; // Count = buffersPerHeap, likewise for the out-buffers
+	void* mappedStats; // Count = inoutsPerHeap * dispatchesPerInout, bytesPerSteps (then bytesPerStats)
 
 	VkDeviceSize bytesPerIn;
 	VkDeviceSize bytesPerOut;
 	VkDeviceSize bytesPerInout;
+	VkDeviceSize bytesPerRing;
+	VkDeviceSize bytesPerClaim;
+	VkDeviceSize bytesPerSteps; // Per dispatch, if not continuous.
+	VkDeviceSize bytesPerStats; // Per dispatch, if instrumenting.
 	VkDeviceSize bytesPerBuffer;
 	VkDeviceSize bytesPerHostVisibleMemory;
+	VkDeviceSize bytesPerHostVisibleOutMemory; // If not continuous.
 	VkDeviceSize bytesPerDeviceLocalMemory;
-
-	CzU32 valuesPerInout;
-	CzU32 valuesPerBuffer;
-	CzU32 valuesPerHeap;
+	VkDeviceSize bytesPerHostImport; // Size of each host allocation imported as a host visible device memory.
+	VkDeviceSize bytesPerHostOutImport; // Likewise for the out-buffers.
+	VkDeviceSize hostImportAlignment;
+	VkDeviceSize hostVisibleHeapBudget; // Budget of the HV heap when the memory layout was planned.
+	VkDeviceSize hostVisibleOutHeapBudget; // Budget of the HV out-buffer heap when the memory layout was planned.
+	VkDeviceSize deviceLocalHeapBudget; // Budget of the DL heap when the memory layout was planned.
+	VkDeviceSize hostVisibleBytesReserved; // HV heap memory held by another memory layout while this one is planned.
+	VkDeviceSize hostVisibleOutBytesReserved; // Likewise for the HV out-buffer heap.
+	VkDeviceSize deviceLocalBytesReserved; // DL heap memory held by another memory layout while this one is planned.
+
+	CzU64 valuesPerInout;
+	CzU64 valuesPerBuffer;
+	CzU64 valuesPerHeap;
+	CzU32 valuesPerDispatch;
+	CzU32 dispatchesPerInout; // Dispatches spanned by each inout-buffer, each with its own descriptor set.
 	CzU32 inoutsPerBuffer;
 	CzU32 inoutsPerHeap;
 	CzU32 buffersPerHeap;
+	CzU32 stagesPerInout; // Generations staged in host visible memory per inout-buffer.
 
 	CzU32 workgroupSize;
-	CzU32 workgroupCount;
+	CzU32 workgroupCount; // Per dispatch.
+	CzU32 subgroupSize;
+	CzU32 minSubgroupSize;
+	CzU32 maxSubgroupSize;
 
 	CzU32 hostVisibleHeapIndex;
+	CzU32 hostVisibleOutHeapIndex;
 	CzU32 deviceLocalHeapIndex;
 	CzU32 hostVisibleTypeIndex;
+	CzU32 hostVisibleOutTypeIndex;
 	CzU32 deviceLocalTypeIndex;
+	CzU32 probedInTypeIndex; // HV memory type least costly for in-buffers, valid if memoryProbed.
+	CzU32 probedOutTypeIndex; // HV memory type least costly for out-buffers, valid if memoryProbed.
 
 	CzU32 computeFamilyIndex;
 	CzU32 transferFamilyIndex;
@@ -98,9 +152,37 @@ struct Gpu
 	CzU32 spvVerMinor;
 
 	float timestampPeriod;
+	double valuesPerSecond; // Speed of the most recent submission loop.
+	double hostWriteBandwidth; // Measured for the HV in-buffer memory type, in GB/s, or 0 if unmeasured.
+	double hostReadBandwidth; // Measured for the HV out-buffer memory type, in GB/s, or 0 if unmeasured.
+	double uploadBandwidth; // Measured from the HV in-buffer to the DL memory type, in GB/s, or 0 if unmeasured.
+	double downloadBandwidth; // Measured from the DL to the HV out-buffer memory type, in GB/s, or 0 if unmeasured.
+	bool memoryProbed; // Whether the HV memory types were benchmarked, which is done once per device.
+
+	struct Position position; // Progress of the run, kept while the inout-buffers are resized.
+	DyArray bestStartValues;
+	DyArray bestStopTimes;
+	CzU128 initialStartValue;
+	CzU128 totalTested;
+	CzU64 totalSteps;
+	double totalBmark;
+	CzU64 loopCount; // Number of main loop iterations completed, across resizes.
+	bool resizing; // Whether the submission loop stopped for the inout-buffers to be resized.
+	const atomic_bool* input; // Set once Enter/Return is pressed, to stop every later submission loop of the run.
+
+	const atomic_bool* rampUpDone; // Set once the full memory layout is created in the background, if ramping up.
+	bool rampingUp; // Whether the memory layout is a few inout-buffers, used until the full memory layout is created.
+	bool background; // Whether the memory layout is being created off the main thread, and so displays nothing.
+	bool instrumenting; // Whether the instrumented shader records the divergence of each dispatch.
+
+	struct Tuning tuning; // Limits placed on the memory layout, either from --tune or the tuning cache.
+	bool tuningTrial; // Whether the submission loop is a --tune trial, and so saves no progress.
 
 	bool hostNonCoherent;
+	bool hostOutNonCoherent;
 	bool using16BitStorage;
+	bool usingCalibratedTimestamps;
+	bool usingExternalMemoryHost;
 	bool usingMaintenance4;
 	bool usingMaintenance5;
 	bool usingMaintenance7;
@@ -108,25 +190,123 @@ struct Gpu
 	bool usingMaintenance9;
 	bool usingMemoryBudget;
 	bool usingMemoryPriority;
+	bool usingPipelineBinary;
 	bool usingPipelineCreationCacheControl;
 	bool usingPipelineExecutableProperties;
+	bool usingPipelineStatistics;
 	bool usingPortabilitySubset;
+	bool usingShaderClock;
 	bool usingShaderInt16;
 	bool usingShaderInt64;
 	bool usingSubgroupSizeControl;
 };
 
-struct Position
+struct RingHeader
 {
-	/* 
-	 * Suppose the current longest total stopping time is T. Then val-a-mod-m-off[k] gives the least starting value x
-	 * with total stopping time t such that (1) x ≡ a (mod m) and (2) t + k = T.
-	 */
-	CzU128 val0mod1off[3];
-	CzU128 val1mod6off[3];
+	CzU32 candidateCount; // Number of candidates appended by the device.
+	CzU32 chunkCount; // Number of chunks of workgroupSize starting values to claim.
+	CzU32 threshold; // Least total stopping time appended as a candidate.
+	CzU32 reserved0;
+
+	CzU128 baseValue; // First starting value of the first chunk.
+	CzU32 stepSums[2]; // Low and high words of the total steps taken by the device.
+	CzU32 reserved1[54];
+};
 
-	CzU128 curStartValue; // First starting value being checked in the current dispatch.
-	CzU16 bestStopTime; // Current longest total stopping time.
+struct RingCandidate
+{
+	CzU32 index; // Index of the starting value relative to baseValue, in steps of 4.
+	CzU32 stopTime; // Total stopping time of the starting value.
+};
+
+struct StepCounters
+{
+	CzU32 stepSums[16]; // Low and high words of the total steps taken by each staging region, never reset.
+};
+
+struct StatsHeader
+{
+	CzU32 histogram[16]; // Invocations by the most significant bit of their total stopping time.
+};
+
+struct StatsRecord
+{
+	CzU32 minCount; // Least total stopping time of the workgroup.
+	CzU32 maxCount; // Greatest total stopping time of the workgroup.
+	CzU32 countSum; // Sum of the total stopping times of the workgroup.
+	CzU32 busyCount; // Sum over each subgroup of its greatest total stopping time times its size.
+	CzU32 spreadSum; // Sum over each subgroup of its greatest minus least total stopping time.
+	CzU32 subgroupCount; // Number of subgroups in the workgroup.
+	CzU32 cycles; // Greatest subgroup clock cycles of the workgroup, or 0 if not recorded.
+	CzU32 reserved;
+};
+
+struct HostTask
+{
+	CzU32 inout; // Index of the inout-buffer, or UINT32_MAX to stop the worker thread.
+	CzU32 staging; // Index of the staging region in the mapped in/out-buffer arrays.
+	double bmark; // Time taken by the worker thread to complete the task.
+	CzU128 curStartValue; // First starting value of the next unread dispatch, once read.
+	CzU16 bestStopTime; // Longest total stopping time found, once read.
+	CzU64 recordCount; // Number of longest total stopping times found, once read.
+	CzU128 bestStartValue; // Starting value of the latest longest total stopping time found, once read.
+	bool failed; // Whether the worker thread failed, in which case it has stopped.
+};
+
+struct HostQueue
+{
+	DyRing ring; // Lock-free ring of tasks, with one producer thread and one consumer thread.
+	pthread_mutex_t mutex; // Only locked to sleep on an empty or full ring, or to wake the thread asleep on one.
+	pthread_cond_t notEmpty;
+	pthread_cond_t notFull;
+	atomic_bool consumerWaiting; // Set while the consumer thread is asleep, or about to sleep, on an empty ring.
+	atomic_bool producerWaiting; // Set while the producer thread is asleep, or about to sleep, on a full ring.
+};
+
+struct InbufferWriter
+{
+	struct HostQueue* tasks; // Sent by main thread.
+	struct HostQueue* results; // Sent back to main thread.
+
+	CzU128* const* mappedInBuffers;
+	CzU128* testedValues;
+
+	CzU64 valuesPerInout;
+	CzU64 valuesPerHeap;
+};
+
+struct ScanTask
+{
+	const CzU16* stopTimes; // First total stopping time to scan, or null to stop the scanner thread.
+	CzU16* maxStopTimes; // Greatest total stopping time of each chunk, once scanned.
+	CzU64 valueCount; // Number of total stopping times to scan.
+	CzU32 valuesPerChunk; // Number of total stopping times per chunk.
+	bool failed; // Whether the scanner thread failed, in which case it has stopped.
+};
+
+struct OutbufferScanner
+{
+	struct HostQueue* tasks; // Sent by reader thread.
+	struct HostQueue* results; // Sent back to reader thread.
+};
+
+struct OutbufferReader
+{
+	struct HostQueue* tasks; // Sent by main thread.
+	struct HostQueue* results; // Sent back to main thread.
+
+	const struct OutbufferScanner* scanners; // Count = scannerCount
+	CzU16* maxStopTimes; // Count = ceil(valuesPerInout / valuesPerChunk)
+
+	CzU16* const* mappedOutBuffers;
+	struct Position* position;
+
+	DyArray bestStartValues;
+	DyArray bestStopTimes;
+
+	CzU64 valuesPerInout;
+	CzU32 valuesPerChunk;
+	CzU32 scannerCount;
 };
 
 // If the return type is bool, then the function returns true on success and false elsewise
@@ -140,18 +320,33 @@ bool create_device(struct Gpu* gpu);
 CZ_NONNULL_ARGS()
 bool manage_memory(struct Gpu* gpu);
 CZ_NONNULL_ARGS()
+bool create_descriptor_layout(struct Gpu* gpu);
+CZ_NONNULL_ARGS()
 bool create_buffers(struct Gpu* gpu);
 CZ_NONNULL_ARGS()
 bool create_descriptors(struct Gpu* gpu);
 CZ_NONNULL_ARGS()
+bool select_variant(struct Gpu* gpu);
+CZ_NONNULL_ARGS()
 bool create_pipeline(struct Gpu* gpu);
 CZ_NONNULL_ARGS()
+bool create_query_pools(struct Gpu* gpu);
+CZ_NONNULL_ARGS()
 bool create_commands(struct Gpu* gpu);
 CZ_NONNULL_ARGS()
+bool create_continuous_commands(struct Gpu* gpu);
+CZ_NONNULL_ARGS()
 bool submit_commands(struct Gpu* gpu);
 CZ_NONNULL_ARGS()
+bool submit_continuous(struct Gpu* gpu);
+CZ_NONNULL_ARGS()
+bool release_memory(struct Gpu* gpu);
+CZ_NONNULL_ARGS()
 bool destroy_gpu(struct Gpu* gpu);
 
+CZ_NONNULL_ARGS()
+bool save_tuning(const struct Gpu* gpu);
+
 CZ_NONNULL_ARGS()
 bool capture_pipeline(VkDevice device, VkPipeline pipeline);
 
@@ -159,7 +354,23 @@ CZ_NONNULL_ARGS()
 void* wait_for_input(void* ptr);
 
 CZ_NONNULL_ARGS()
-void write_inbuffer(CzU128* mappedInBuffer, CzU128* firstStartValue, CzU32 valuesPerInout, CzU32 valuesPerHeap);
+bool host_queue_init(struct HostQueue* queue, size_t size, size_t count);
+CZ_NONNULL_ARGS()
+void host_queue_fini(struct HostQueue* queue);
+CZ_NONNULL_ARGS()
+bool host_queue_push(struct HostQueue* queue, const void* task);
+CZ_NONNULL_ARGS()
+bool host_queue_pop(struct HostQueue* queue, void* task);
+
+CZ_NONNULL_ARGS()
+void* write_inbuffers(void* ptr);
+CZ_NONNULL_ARGS()
+void* read_outbuffers(void* ptr);
+CZ_NONNULL_ARGS()
+void* scan_outbuffers(void* ptr);
+
+CZ_NONNULL_ARGS()
+void write_inbuffer(CzU128* mappedInBuffer, CzU128* firstStartValue, CzU64 valuesPerInout, CzU64 valuesPerHeap);
 
 CZ_NONNULL_ARGS()
 void read_outbuffer(
@@ -167,7 +378,36 @@ void read_outbuffer(
 	struct Position* position,
 	DyArray bestStartValues,
 	DyArray bestStopTimes,
-	CzU32 valuesPerInout);
+	CzU64 valuesPerInout);
+
+CZ_NONNULL_ARGS()
+void scan_outbuffer(const CzU16* stopTimes, CzU16* maxStopTimes, CzU64 valueCount, CzU32 valuesPerChunk);
+
+CZ_NONNULL_ARGS()
+bool outbuffer_chunk_relevant(const struct Position* position, CzU16 maxStopTime, CzU32 valueCount);
+
+CZ_NONNULL_ARGS()
+void merge_outbuffer(
+	const CzU16* mappedOutBuffer,
+	const CzU16* maxStopTimes,
+	struct Position* position,
+	DyArray bestStartValues,
+	DyArray bestStopTimes,
+	CzU64 valuesPerInout,
+	CzU32 valuesPerChunk);
+
+CZ_NONNULL_ARGS()
+void write_ringheader(
+	struct RingHeader* ringHeader, CzU128* baseValue, CzU16 bestStopTime, CzU32 chunkCount, CzU64 valuesPerHeap);
+
+CZ_NONNULL_ARGS()
+void read_ringbuffer(
+	const struct RingHeader* ringHeader,
+	CzU16* stopTimes,
+	struct Position* position,
+	DyArray bestStartValues,
+	DyArray bestStopTimes,
+	CzU64 valuesPerInout);
 
 CZ_NONNULL_ARGS()
 void new_high(
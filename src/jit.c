@@ -0,0 +1,418 @@
+/* 
+ * Copyright (C) 2025 Seth McDonald
+ * 
+ * This file is part of Collatz Conjecture Simulator.
+ * 
+ * Collatz Conjecture Simulator is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ * 
+ * Collatz Conjecture Simulator is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE. See the GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License along with Collatz Conjecture
+ * Simulator. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "jit.h"
+#include "config.h"
+
+#if CZ_RUNTIME_SHADERS
+
+struct IncludeData
+{
+	const char* kernelCode;
+	size_t kernelSize;
+
+	glsl_include_result_t result;
+};
+
+static void glslang_shader_delete_stub(void* shader)
+{
+	glslang_shader_delete(shader);
+}
+
+static void glslang_program_delete_stub(void* program)
+{
+	glslang_program_delete(program);
+}
+
+static void spvOptimizerDestroy_stub(void* optimizer)
+{
+	spvOptimizerDestroy(optimizer);
+}
+
+static void spvOptimizerOptionsDestroy_stub(void* options)
+{
+	spvOptimizerOptionsDestroy(options);
+}
+
+static void spvBinaryDestroy_stub(void* binary)
+{
+	spvBinaryDestroy(binary);
+}
+
+// Only kernel.h is included by the shader, and it is read before compilation begins
+static glsl_include_result_t* include_local(
+	void* ctx, const char* headerName, const char* includerName, size_t includeDepth)
+{
+	(void) includerName;
+	(void) includeDepth;
+
+	struct IncludeData* data = ctx;
+
+	if (strcmp(headerName, "kernel.h")) {
+		return NULL;
+	}
+
+	data->result.header_name = headerName;
+	data->result.header_data = data->kernelCode;
+	data->result.header_length = data->kernelSize;
+
+	return &data->result;
+}
+
+static int free_include_result(void* ctx, glsl_include_result_t* result)
+{
+	(void) ctx;
+	(void) result;
+
+	return 0;
+}
+
+// FNV-1a, so that edits to the shader source invalidate cached compilations
+static CzU64 hash_source(CzU64 hash, const char* source, size_t size)
+{
+	for (size_t i = 0; i < size; i++) {
+		hash ^= (unsigned char) source[i];
+		hash *= UINT64_C(0x100000001B3);
+	}
+
+	return hash;
+}
+
+// A cached compilation may be truncated or foreign, so is only used if it looks like a SPIR-V module
+static bool check_spirv(const CzU32* code, size_t size)
+{
+	if (size < sizeof(CzU32))            { return false; }
+	if (size % sizeof(CzU32))            { return false; }
+	if (code[0] != UINT32_C(0x07230203)) { return false; }
+
+	return true;
+}
+
+static bool read_source(DyRecord record, const char* filename, char** source, size_t* size)
+{
+	size_t sourceSize;
+	struct CzFileFlags fileFlags = {0};
+	fileFlags.relativeToExe = true;
+
+	enum CzResult czres = czFileSize(filename, &sourceSize, fileFlags);
+	if CZ_NOEXPECT (czres) {
+		if (czres == CZ_RESULT_NO_FILE) {
+			log_error(stderr, "Shader source '%s' not found", filename);
+		}
+		return false;
+	}
+
+	// NUL-terminated for glslang
+	char* sourceCode = dyrecord_malloc(record, sourceSize + 1);
+	if CZ_NOEXPECT (!sourceCode) { return false; }
+
+	size_t sourceOffset = 0;
+	czres = czReadFile(filename, sourceCode, sourceSize, sourceOffset, fileFlags);
+	if CZ_NOEXPECT (czres) { return false; }
+
+	sourceCode[sourceSize] = '\0';
+
+	*source = sourceCode;
+	*size = sourceSize;
+	return true;
+}
+
+static bool compile_source(
+	const struct Gpu* restrict gpu,
+	DyRecord record,
+	const char* restrict shaderCode,
+	struct IncludeData* restrict includeData,
+	CzU32** restrict code,
+	size_t* restrict size)
+{
+	CzU32 spvVerMajor = gpu->spvVerMajor;
+	CzU32 spvVerMinor = gpu->spvVerMinor;
+
+	DyRecord localRecord = dyrecord_create();
+	if CZ_NOEXPECT (!localRecord) { return false; }
+
+	char preamble[256];
+	sprintf(
+		preamble,
+		"#define SPV_VER %" PRIu32 "%" PRIu32 "\n"
+		"#define LITTLE_ENDIAN %d\n"
+		"#define ITER_SIZE %lu\n"
+		"#define STO16 %d\n"
+		"#define INT16 %d\n"
+		"#define INT64 %d\n"
+		"#define CONTINUOUS %d\n"
+		"#define INSTRUMENT %d\n"
+		"#define SHADER_CLOCK %d\n",
+		spvVerMajor, spvVerMinor,
+		get_endianness() == CZ_ENDIANNESS_LITTLE,
+		czgConfig.iterSize,
+		gpu->using16BitStorage,
+		gpu->usingShaderInt16,
+		gpu->usingShaderInt64,
+		czgConfig.continuous,
+		gpu->instrumenting,
+		gpu->usingShaderClock);
+
+	glslang_messages_t messages = GLSLANG_MSG_DEFAULT_BIT | GLSLANG_MSG_SPV_RULES_BIT | GLSLANG_MSG_VULKAN_RULES_BIT;
+
+	glslang_input_t input = {0};
+	input.language = GLSLANG_SOURCE_GLSL;
+	input.stage = GLSLANG_STAGE_COMPUTE;
+	input.client = GLSLANG_CLIENT_VULKAN;
+	input.client_version = (glslang_target_client_version_t) VK_API_VERSION_1_4;
+	input.target_language = GLSLANG_TARGET_SPV;
+	input.target_language_version = (glslang_target_language_version_t) ((spvVerMajor << 16) | (spvVerMinor << 8));
+	input.code = shaderCode;
+	input.default_version = 460;
+	input.default_profile = GLSLANG_CORE_PROFILE;
+	input.messages = messages;
+	input.resource = glslang_default_resource();
+	input.callbacks.include_local = include_local;
+	input.callbacks.free_include_result = free_include_result;
+	input.callbacks_ctx = includeData;
+
+	glslang_shader_t* shader = glslang_shader_create(&input);
+	if CZ_NOEXPECT (!shader) { dyrecord_destroy(localRecord); return false; }
+
+	bool bres = dyrecord_add(localRecord, shader, glslang_shader_delete_stub);
+	if CZ_NOEXPECT (!bres) { glslang_shader_delete(shader); dyrecord_destroy(localRecord); return false; }
+
+	glslang_shader_set_preamble(shader, preamble);
+
+	int ires = glslang_shader_preprocess(shader, &input);
+	if CZ_NOEXPECT (!ires) {
+		log_error(stderr, "Failed to preprocess shader\n%s", glslang_shader_get_info_log(shader));
+		dyrecord_destroy(localRecord);
+		return false;
+	}
+
+	ires = glslang_shader_parse(shader, &input);
+	if CZ_NOEXPECT (!ires) {
+		log_error(stderr, "Failed to parse shader\n%s", glslang_shader_get_info_log(shader));
+		dyrecord_destroy(localRecord);
+		return false;
+	}
+
+	glslang_program_t* program = glslang_program_create();
+	if CZ_NOEXPECT (!program) { dyrecord_destroy(localRecord); return false; }
+
+	bres = dyrecord_add(localRecord, program, glslang_program_delete_stub);
+	if CZ_NOEXPECT (!bres) { glslang_program_delete(program); dyrecord_destroy(localRecord); return false; }
+
+	glslang_program_add_shader(program, shader);
+
+	ires = glslang_program_link(program, (int) messages);
+	if CZ_NOEXPECT (!ires) {
+		log_error(stderr, "Failed to link shader\n%s", glslang_program_get_info_log(program));
+		dyrecord_destroy(localRecord);
+		return false;
+	}
+
+	glslang_spv_options_t spvOptions = {0};
+	spvOptions.disable_optimizer = true; // Optimised below, with the same passes as the build
+	spvOptions.validate = true;
+
+	glslang_program_SPIRV_generate_with_options(program, GLSLANG_STAGE_COMPUTE, &spvOptions);
+
+	const char* spvMessages = glslang_program_SPIRV_get_messages(program);
+	if (spvMessages) {
+		log_warning(stdout, "SPIR-V generation: %s", spvMessages);
+	}
+
+	size_t wordCount = glslang_program_SPIRV_get_size(program);
+	CzU32* spvCode = dyrecord_malloc(localRecord, wordCount * sizeof(CzU32));
+	if CZ_NOEXPECT (!spvCode) { dyrecord_destroy(localRecord); return false; }
+
+	glslang_program_SPIRV_get(program, spvCode);
+
+	// Same passes as those given to spirv-opt when linking the prebuilt shaders
+	spv_target_env targetEnv;
+	switch (spvVerMinor) {
+		case 3:  targetEnv = SPV_ENV_UNIVERSAL_1_3; break;
+		case 4:  targetEnv = SPV_ENV_UNIVERSAL_1_4; break;
+		case 5:  targetEnv = SPV_ENV_UNIVERSAL_1_5; break;
+		default: targetEnv = SPV_ENV_UNIVERSAL_1_6; break;
+	}
+
+	spv_optimizer_t* optimizer = spvOptimizerCreate(targetEnv);
+	if CZ_NOEXPECT (!optimizer) { dyrecord_destroy(localRecord); return false; }
+
+	bres = dyrecord_add(localRecord, optimizer, spvOptimizerDestroy_stub);
+	if CZ_NOEXPECT (!bres) { spvOptimizerDestroy(optimizer); dyrecord_destroy(localRecord); return false; }
+
+	const char* optimiserFlags[] = {
+		"--strip-debug",
+		"--strip-nonsemantic",
+		"--remove-unused-interface-variables",
+		"-O",
+		"--unify-const",
+		"--trim-capabilities",
+		"--compact-ids",
+	};
+
+	bres = spvOptimizerRegisterPassesFromFlags(optimizer, optimiserFlags, CZ_COUNTOF(optimiserFlags));
+	if CZ_NOEXPECT (!bres) { dyrecord_destroy(localRecord); return false; }
+
+	spv_optimizer_options optimiserOptions = spvOptimizerOptionsCreate();
+	if CZ_NOEXPECT (!optimiserOptions) { dyrecord_destroy(localRecord); return false; }
+
+	bres = dyrecord_add(localRecord, optimiserOptions, spvOptimizerOptionsDestroy_stub);
+	if CZ_NOEXPECT (!bres) { spvOptimizerOptionsDestroy(optimiserOptions); dyrecord_destroy(localRecord); return false; }
+
+	spv_binary optimisedBinary = NULL;
+	spv_result_t spvres = spvOptimizerRun(optimizer, spvCode, wordCount, &optimisedBinary, optimiserOptions);
+	if CZ_NOEXPECT (spvres != SPV_SUCCESS) {
+		log_error(stderr, "Failed to optimise shader (spv_result_t %d)", (int) spvres);
+		dyrecord_destroy(localRecord);
+		return false;
+	}
+
+	bres = dyrecord_add(localRecord, optimisedBinary, spvBinaryDestroy_stub);
+	if CZ_NOEXPECT (!bres) { spvBinaryDestroy(optimisedBinary); dyrecord_destroy(localRecord); return false; }
+
+	size_t optimisedSize = optimisedBinary->wordCount * sizeof(CzU32);
+	CzU32* optimisedCode = dyrecord_malloc(record, optimisedSize);
+	if CZ_NOEXPECT (!optimisedCode) { dyrecord_destroy(localRecord); return false; }
+
+	memcpy(optimisedCode, optimisedBinary->code, optimisedSize);
+
+	*code = optimisedCode;
+	*size = optimisedSize;
+
+	dyrecord_destroy(localRecord);
+	return true;
+}
+
+bool jit_shader(const struct Gpu* restrict gpu, DyRecord record, CzU32** restrict code, size_t* restrict size)
+{
+	VkPhysicalDevice physicalDevice = gpu->physicalDevice;
+
+	CzU32 spvVerMajor = gpu->spvVerMajor;
+	CzU32 spvVerMinor = gpu->spvVerMinor;
+
+	DyRecord localRecord = dyrecord_create();
+	if CZ_NOEXPECT (!localRecord) { return false; }
+
+	char* shaderCode;
+	size_t shaderSize;
+	bool bres = read_source(localRecord, CZ_SHADER_SOURCE_NAME, &shaderCode, &shaderSize);
+	if CZ_NOEXPECT (!bres) { dyrecord_destroy(localRecord); return false; }
+
+	struct IncludeData includeData = {0};
+	char* kernelCode;
+	bres = read_source(localRecord, CZ_KERNEL_SOURCE_NAME, &kernelCode, &includeData.kernelSize);
+	if CZ_NOEXPECT (!bres) { dyrecord_destroy(localRecord); return false; }
+	includeData.kernelCode = kernelCode;
+
+	// Cached compilations are keyed by device, shader variant, and shader source
+	VkPhysicalDeviceIDProperties deviceIdProperties = {0};
+	deviceIdProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_ID_PROPERTIES;
+
+	VkPhysicalDeviceProperties2 deviceProperties = {0};
+	deviceProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+	deviceProperties.pNext = &deviceIdProperties;
+
+	VK_CALL(vkGetPhysicalDeviceProperties2, physicalDevice, &deviceProperties);
+
+	char deviceUuid[VK_UUID_SIZE * 2 + 1];
+	for (CzU32 i = 0; i < VK_UUID_SIZE; i++) {
+		sprintf(&deviceUuid[i * 2], "%02" PRIx8, deviceIdProperties.deviceUUID[i]);
+	}
+
+	CzU64 sourceHash = UINT64_C(0xCBF29CE484222325);
+	sourceHash = hash_source(sourceHash, shaderCode, shaderSize);
+	sourceHash = hash_source(sourceHash, kernelCode, includeData.kernelSize);
+
+	char cacheName[128];
+	sprintf(
+		cacheName,
+		"./jit-%s-%016" PRIx64 "-v%" PRIu32 "%" PRIu32 "%s%s%s%s-%s-%lu.spv",
+		deviceUuid, sourceHash, spvVerMajor, spvVerMinor,
+		gpu->using16BitStorage ? "-sto16" : "",
+		gpu->usingShaderInt16  ? "-int16" : "",
+		gpu->usingShaderInt64  ? "-int64" : "",
+		gpu->usingShaderClock  ? "-clock" : "",
+		czgConfig.continuous ? "cont" : gpu->instrumenting ? "inst" : "main",
+		czgConfig.iterSize);
+
+	size_t cacheSize = 0;
+	struct CzFileFlags cacheFileFlags = {0};
+	cacheFileFlags.relativeToExe = true;
+
+	enum CzResult czres = czFileSize(cacheName, &cacheSize, cacheFileFlags);
+	if CZ_NOEXPECT (czres && czres != CZ_RESULT_NO_FILE) { dyrecord_destroy(localRecord); return false; }
+
+	CzU32* cacheCode = NULL;
+	if (cacheSize && cacheSize % sizeof(CzU32) == 0) {
+		cacheCode = dyrecord_malloc(record, cacheSize);
+		if CZ_NOEXPECT (!cacheCode) { dyrecord_destroy(localRecord); return false; }
+
+		size_t cacheOffset = 0;
+		czres = czReadFile(cacheName, cacheCode, cacheSize, cacheOffset, cacheFileFlags);
+		if CZ_NOEXPECT (czres) { dyrecord_destroy(localRecord); return false; }
+	}
+
+	if (cacheCode && check_spirv(cacheCode, cacheSize)) {
+		if (czgConfig.outputLevel > CZ_OUTPUT_LEVEL_QUIET) {
+			printf("Loaded compiled shader: %s\n", cacheName);
+		}
+
+		*code = cacheCode;
+		*size = cacheSize;
+
+		dyrecord_destroy(localRecord);
+		return true;
+	}
+
+	if (cacheSize && czgConfig.outputLevel > CZ_OUTPUT_LEVEL_DEFAULT) {
+		printf("Discarding invalid compiled shader: %s\n", cacheName);
+	}
+
+	int ires = glslang_initialize_process();
+	if CZ_NOEXPECT (!ires) { dyrecord_destroy(localRecord); return false; }
+
+	double compileBmStart = wall_time();
+	bres = compile_source(gpu, record, shaderCode, &includeData, code, size);
+	double compileBmEnd = wall_time();
+
+	glslang_finalize_process();
+	if CZ_NOEXPECT (!bres) { dyrecord_destroy(localRecord); return false; }
+
+	if (czgConfig.outputLevel > CZ_OUTPUT_LEVEL_QUIET) {
+		double compileBmark = compileBmEnd - compileBmStart;
+		printf("Compiled shader: %s (%.0fms)\n", cacheName, compileBmark);
+	}
+
+	// Replaced atomically, so a crash mid-write never leaves a truncated compilation behind
+	bres = replace_file(cacheName, *code, *size);
+	if CZ_NOEXPECT (!bres) { dyrecord_destroy(localRecord); return false; }
+
+	dyrecord_destroy(localRecord);
+	return true;
+}
+#else
+bool jit_shader(const struct Gpu* restrict gpu, DyRecord record, CzU32** restrict code, size_t* restrict size)
+{
+	(void) gpu;
+	(void) record;
+	(void) code;
+	(void) size;
+
+	log_error(stderr, "Runtime shader compilation requires a build with CZ_RUNTIME_SHADERS enabled");
+	return false;
+}
+#endif
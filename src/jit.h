@@ -0,0 +1,29 @@
+/* 
+ * Copyright (C) 2025 Seth McDonald
+ * 
+ * This file is part of Collatz Conjecture Simulator.
+ * 
+ * Collatz Conjecture Simulator is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ * 
+ * Collatz Conjecture Simulator is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE. See the GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License along with Collatz Conjecture
+ * Simulator. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "common.h"
+#include "dynamic.h"
+#include "gpu.h"
+
+// Runtime compilation of the shader via the glslang library, for builds with CZ_RUNTIME_SHADERS enabled
+
+// Compile the shader variant suited to the selected device, or load it from a previous compilation if cached
+// On success, *code is allocated via record and *size is its size in bytes
+CZ_NONNULL_ARGS()
+bool jit_shader(const struct Gpu* gpu, DyRecord record, CzU32** code, size_t* size);
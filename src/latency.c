@@ -0,0 +1,197 @@
+/* 
+ * Copyright (C) 2025 Seth McDonald
+ * 
+ * This file is part of Collatz Conjecture Simulator.
+ * 
+ * Collatz Conjecture Simulator is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ * 
+ * Collatz Conjecture Simulator is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE. See the GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License along with Collatz Conjecture
+ * Simulator. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "latency.h"
+
+/*
+ * Benchmarks are kept in microseconds. Values less than 2^LATENCY_SUB_BITS are kept exactly, and each greater power of
+ * two is split into 2^LATENCY_SUB_BITS equal buckets, so every value is kept to within about 3% of itself. Values of
+ * 2^LATENCY_MAX_BITS microseconds (about 12 days) or more are kept in the last bucket.
+ */
+#define LATENCY_SUB_BITS     5
+#define LATENCY_SUB_COUNT    (UINT32_C(1) << LATENCY_SUB_BITS)
+#define LATENCY_MAX_BITS     40
+#define LATENCY_BUCKET_COUNT ((LATENCY_MAX_BITS - LATENCY_SUB_BITS + 1) * LATENCY_SUB_COUNT)
+
+enum LatencyTiming
+{
+	LATENCY_TIMING_READ,
+	LATENCY_TIMING_WRITE,
+	LATENCY_TIMING_COMPUTE,
+	LATENCY_TIMING_TRANSFER,
+	LATENCY_TIMING_IDLE_COMPUTE,
+	LATENCY_TIMING_IDLE_TRANSFER,
+	LATENCY_TIMING_COUNT,
+};
+
+struct LatencyHistogram
+{
+	CzU64 buckets[LATENCY_BUCKET_COUNT];
+	CzU64 count;
+	CzU64 max; // Greatest value added, in microseconds.
+};
+
+static const char* const gTimingNames[LATENCY_TIMING_COUNT] = {
+	"Reading buffers",
+	"Writing buffers",
+	"Compute execution",
+	"Transfer execution",
+	"Idle (compute)",
+	"Idle (transfer)",
+};
+
+static struct LatencyHistogram gIntervalHistograms[LATENCY_TIMING_COUNT];
+static struct LatencyHistogram gTotalHistograms[LATENCY_TIMING_COUNT];
+
+static CzU32 latency_bucket(CzU64 value)
+{
+	if (value < LATENCY_SUB_COUNT) {
+		return (CzU32) value;
+	}
+
+	CzU32 msb = 0;
+	for (CzU64 x = value; x >>= 1;) { msb++; }
+
+	if (msb >= LATENCY_MAX_BITS) {
+		return LATENCY_BUCKET_COUNT - 1;
+	}
+
+	// Each power of two from 2^LATENCY_SUB_BITS up takes the next LATENCY_SUB_COUNT buckets
+	CzU32 shift = msb - LATENCY_SUB_BITS;
+	CzU32 sub = (CzU32) (value >> shift) - LATENCY_SUB_COUNT;
+
+	return (shift + 1) * LATENCY_SUB_COUNT + sub;
+}
+
+// Greatest value kept in a bucket, in microseconds
+static CzU64 latency_bucket_max(CzU32 bucket)
+{
+	if (bucket < LATENCY_SUB_COUNT) {
+		return bucket;
+	}
+
+	CzU32 shift = bucket / LATENCY_SUB_COUNT - 1;
+	CzU64 sub = bucket % LATENCY_SUB_COUNT;
+
+	return ((LATENCY_SUB_COUNT + sub + 1) << shift) - 1;
+}
+
+static void latency_add(struct LatencyHistogram* restrict histogram, double ms)
+{
+	CzU64 value = (CzU64) (ms * 1000 + .5);
+
+	histogram->buckets[latency_bucket(value)]++;
+	histogram->count++;
+	histogram->max = maxu64(histogram->max, value);
+}
+
+// Least value, in ms, not exceeded by the given percentage of the values added
+static double latency_percentile(const struct LatencyHistogram* restrict histogram, CzU32 percentage)
+{
+	CzU64 rank = (histogram->count * percentage + 99) / 100;
+	rank = maxu64(rank, 1);
+
+	CzU64 count = 0;
+	CzU32 bucket = 0;
+
+	for (; bucket < LATENCY_BUCKET_COUNT - 1; bucket++) {
+		count += histogram->buckets[bucket];
+
+		if (count >= rank) {
+			break;
+		}
+	}
+
+	CzU64 value = minu64(latency_bucket_max(bucket), histogram->max);
+	return (double) value / 1000;
+}
+
+static void latency_print(const struct LatencyHistogram* restrict histograms)
+{
+	printf("|      Benchmark     |  p50 (ms) |  p90 (ms) |  p99 (ms) |  Max (ms) |\n");
+
+	for (CzU32 i = 0; i < LATENCY_TIMING_COUNT; i++) {
+		const struct LatencyHistogram* histogram = &histograms[i];
+
+		// Benchmarks not measured (such as without timestamp queries or in continuous mode) are always zero
+		if (!histogram->count || !histogram->max) {
+			continue;
+		}
+
+		double p50 = latency_percentile(histogram, 50);
+		double p90 = latency_percentile(histogram, 90);
+		double p99 = latency_percentile(histogram, 99);
+		double max = (double) histogram->max / 1000;
+
+		printf("| %18s | %9.1f | %9.1f | %9.1f | %9.1f |\n", gTimingNames[i], p50, p90, p99, max);
+	}
+}
+
+static void latency_merge(void)
+{
+	for (CzU32 i = 0; i < LATENCY_TIMING_COUNT; i++) {
+		struct LatencyHistogram* interval = &gIntervalHistograms[i];
+		struct LatencyHistogram* total = &gTotalHistograms[i];
+
+		for (CzU32 j = 0; j < LATENCY_BUCKET_COUNT; j++) {
+			total->buckets[j] += interval->buckets[j];
+		}
+
+		total->count += interval->count;
+		total->max = maxu64(total->max, interval->max);
+	}
+
+	memset(gIntervalHistograms, 0, sizeof(gIntervalHistograms));
+}
+
+void latency_inout(const struct InoutMetrics* metrics)
+{
+	latency_add(&gIntervalHistograms[LATENCY_TIMING_READ], metrics->read);
+	latency_add(&gIntervalHistograms[LATENCY_TIMING_WRITE], metrics->write);
+	latency_add(&gIntervalHistograms[LATENCY_TIMING_COMPUTE], metrics->compute);
+	latency_add(&gIntervalHistograms[LATENCY_TIMING_TRANSFER], metrics->transfer);
+	latency_add(&gIntervalHistograms[LATENCY_TIMING_IDLE_COMPUTE], metrics->idleCompute);
+	latency_add(&gIntervalHistograms[LATENCY_TIMING_IDLE_TRANSFER], metrics->idleTransfer);
+}
+
+void latency_interval(CzU64 loopCount)
+{
+	CzU64 sampleCount = gIntervalHistograms[LATENCY_TIMING_READ].count;
+
+	printf(
+		"Percentiles of the last %" PRIu64 " main loop iterations (%" PRIu64 " inout-buffers)\n",
+		loopCount, sampleCount);
+
+	latency_print(gIntervalHistograms);
+	CZ_NEWLINE();
+
+	latency_merge();
+}
+
+void latency_total(void)
+{
+	latency_merge();
+
+	CzU64 sampleCount = gTotalHistograms[LATENCY_TIMING_READ].count;
+
+	if (!sampleCount) {
+		return;
+	}
+
+	printf("\nPercentiles of the run (%" PRIu64 " inout-buffers)\n", sampleCount);
+	latency_print(gTotalHistograms);
+}
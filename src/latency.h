@@ -0,0 +1,38 @@
+/* 
+ * Copyright (C) 2025 Seth McDonald
+ * 
+ * This file is part of Collatz Conjecture Simulator.
+ * 
+ * Collatz Conjecture Simulator is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ * 
+ * Collatz Conjecture Simulator is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE. See the GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License along with Collatz Conjecture
+ * Simulator. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "common.h"
+
+#include "metrics.h"
+
+// Distributions of the benchmarks of each inout-buffer, kept in log-linear histograms to display their percentiles
+
+// Add the benchmarks of an inout-buffer to the histograms of the current interval
+// Must be called from the main thread
+CZ_NONNULL_ARGS() CZ_RD_ACCESS(1)
+void latency_inout(const struct InoutMetrics* metrics);
+
+// Display the percentiles of the benchmarks added over the last loopCount main loop iterations, then add them to the
+// histograms of the whole run
+// Must be called from the main thread
+void latency_interval(CzU64 loopCount);
+
+// Display the percentiles of every benchmark added during the run
+// Must be called from the main thread
+void latency_total(void);
@@ -18,6 +18,10 @@
 #include "gpu.h"
 #include "cli.h"
 #include "config.h"
+#include "exporter.h"
+#include "metrics.h"
+#include "stats.h"
+#include "trace.h"
 
 static bool version_option_callback(void* data, void* arg)
 {
@@ -70,27 +74,94 @@ static bool help_option_callback(void* data, void* arg)
 		"                              appropriate.\n"
 		"  -I --int64                  Prefer shaders using 64-bit integers where\n"
 		"                              appropriate.\n"
+		"  -a --auto-variant           Benchmark each shader variant supported by the\n"
+		"                              selected device and use the fastest. The choice\n"
+		"                              is cached per device.\n"
+		"  -t --tune                   Time short runs of several memory layouts and\n"
+		"                              workgroup sizes, then use the fastest. The choice\n"
+		"                              is cached per device and driver version, and is\n"
+		"                              used by later runs.\n"
 		"\n"
 		"  -r --restart                Restart the simulation. Do not save progress nor\n"
 		"                              overwrite previous progress.\n"
 		"  -b --no-query-benchmarks    Do not benchmark GPU operations via Vulkan\n"
 		"                              queries.\n"
+		"  -g --continuous             Iterate starting values in GPU-resident batches\n"
+		"                              which claim value ranges on the device and\n"
+		"                              return only record candidates to the host.\n"
+		"  -j --jit                    Compile the shader for the selected device at\n"
+		"                              runtime rather than loading prebuilt SPIR-V.\n"
+		"                              Requires a build with CZ_RUNTIME_SHADERS.\n"
+		"  -u --ramp-up                Begin computing on a few inout-buffers while the\n"
+		"                              rest are created in the background, shortening\n"
+		"                              the time to the first results. Ignored in\n"
+		"                              continuous mode.\n"
+		"  -H --huge-pages             Stage starting values and total stopping times in\n"
+		"                              host memory backed by huge pages, and import it\n"
+		"                              via the VK_EXT_external_memory_host extension,\n"
+		"                              if present.\n"
+		"  -m --instrument             Use a shader variant recording the divergence of\n"
+		"                              total stopping times within each subgroup, and\n"
+		"                              summarise it per main loop iteration. Cycles are\n"
+		"                              also recorded if --jit is used and the\n"
+		"                              VK_KHR_shader_clock extension is present. Ignored\n"
+		"                              in continuous mode.\n"
+		"  -P --pipeline-stats         Count the compute shader invocations of each\n"
+		"                              dispatch via Vulkan pipeline statistics queries,\n"
+		"                              if supported. Ignored in continuous mode.\n"
 		"\n"
 		"  --log-allocations <path>    Log all memory allocations performed by Vulkan to\n"
 		"                              the file located at <path>.\n"
 		"  --capture-pipelines <path>  Output pipeline data captured via the\n"
 		"                              VK_KHR_pipeline_executable_properties extension,\n"
 		"                              if present, to the file located at <path>.\n"
+		"  --trace <path>              Output a timeline of every wait, read, write,\n"
+		"                              submission, copy, and dispatch to the file\n"
+		"                              located at <path>, in the JSON trace event\n"
+		"                              format read by Perfetto and Chrome.\n"
+		"  --metrics <path>            Append the benchmarks of each main loop\n"
+		"                              iteration, and of each inout-buffer if verbose,\n"
+		"                              to the file located at <path>, as JSON Lines.\n"
+		"  --prometheus <address>      Serve live benchmarks and progress over HTTP in\n"
+		"                              the Prometheus text format, on the localhost TCP\n"
+		"                              port or Unix domain socket path <address>.\n"
+		"  --stats <name>              Publish live benchmarks and progress in the POSIX\n"
+		"                              shared memory object <name>, such as /cltz, to be\n"
+		"                              displayed by cltz-top.\n"
 		"\n"
 		"  --iter-size <size>          Set the bit precision of the iterating value in\n"
 		"                              shaders to <size>. Higher precision decreases the\n"
 		"                              chance of integer overflow, but also decreases\n"
-		"                              performance. Must be 128 or 256. Defaults to 128.\n"
+		"                              performance. Must be 128, 192, or 256. Defaults\n"
+		"                              to 128.\n"
 		"  --max-loops <count>         Set the maximum number of main loop iterations to\n"
 		"                              <count>. More iterations increase the number of\n"
 		"                              tested starting values, but also increase\n"
 		"                              execution time. Must be a nonnegative integer.\n"
 		"                              Defaults to 2^64-1 (UINT64_MAX).\n"
+		"  --pipeline-depth <depth>    Set the number of generations of starting values\n"
+		"                              staged in host visible memory per inout-buffer\n"
+		"                              to <depth>. Deeper pipelines let the host fall\n"
+		"                              further behind the GPU without stalling it, but\n"
+		"                              also increase memory usage. Must be within the\n"
+		"                              interval [1, 8]. Defaults to 1.\n"
+		"  --read-threads <count>      Set the number of threads reading total stopping\n"
+		"                              times from out-buffers to <count>. More threads\n"
+		"                              let the host keep up with faster GPUs, but also\n"
+		"                              increase CPU usage. Must be within the interval\n"
+		"                              [1, 64]. Defaults to 4.\n"
+		"  --inout-dispatches <count>  Set the number of compute dispatches spanned by\n"
+		"                              each inout-buffer to <count>. More dispatches\n"
+		"                              allow larger and fewer inout-buffers, beyond the\n"
+		"                              limits of a single dispatch. Ignored in\n"
+		"                              continuous mode. Must be within the interval\n"
+		"                              [1, 64]. Defaults to 1.\n"
+		"  --latency-interval <count>  Display percentiles of the benchmarks of each\n"
+		"                              inout-buffer over every <count> main loop\n"
+		"                              iterations. Percentiles over the whole run are\n"
+		"                              displayed at exit regardless. Must be a\n"
+		"                              nonnegative integer. Defaults to 0 (only at\n"
+		"                              exit).\n"
 		"  --max-memory <prop>         Limit the usable proportion of GPU heap memory to\n"
 		"                              <prop>. Larger proportions may increase\n"
 		"                              concurrency, but also increase execution time and\n"
@@ -199,6 +270,24 @@ static bool int64_option_callback(void* data, void* arg)
 	return true;
 }
 
+static bool auto_variant_option_callback(void* data, void* arg)
+{
+	(void) arg;
+
+	struct CzConfig* config = (struct CzConfig*) data;
+	config->autoVariant = true;
+	return true;
+}
+
+static bool tune_option_callback(void* data, void* arg)
+{
+	(void) arg;
+
+	struct CzConfig* config = (struct CzConfig*) data;
+	config->tune = true;
+	return true;
+}
+
 static bool restart_option_callback(void* data, void* arg)
 {
 	(void) arg;
@@ -217,6 +306,66 @@ static bool no_query_benchmarks_option_callback(void* data, void* arg)
 	return true;
 }
 
+static bool continuous_option_callback(void* data, void* arg)
+{
+	(void) arg;
+
+	struct CzConfig* config = (struct CzConfig*) data;
+	config->continuous = true;
+	return true;
+}
+
+static bool jit_option_callback(void* data, void* arg)
+{
+	(void) arg;
+
+#if CZ_RUNTIME_SHADERS
+	struct CzConfig* config = (struct CzConfig*) data;
+	config->jit = true;
+#else
+	(void) data;
+	log_warning(stdout, "Ignoring --jit option, as runtime shader compilation was not enabled at build time");
+#endif
+
+	return true;
+}
+
+static bool ramp_up_option_callback(void* data, void* arg)
+{
+	(void) arg;
+
+	struct CzConfig* config = (struct CzConfig*) data;
+	config->rampUp = true;
+	return true;
+}
+
+static bool huge_pages_option_callback(void* data, void* arg)
+{
+	(void) arg;
+
+	struct CzConfig* config = (struct CzConfig*) data;
+	config->hugePages = true;
+	return true;
+}
+
+static bool instrument_option_callback(void* data, void* arg)
+{
+	(void) arg;
+
+	struct CzConfig* config = (struct CzConfig*) data;
+	config->instrument = true;
+	return true;
+}
+
+static bool pipeline_stats_option_callback(void* data, void* arg)
+{
+	(void) arg;
+
+	struct CzConfig* config = (struct CzConfig*) data;
+	config->pipelineStats = true;
+	return true;
+}
+
 static bool log_allocations_option_callback(void* data, void* arg)
 {
 	struct CzConfig* config = (struct CzConfig*) data;
@@ -235,12 +384,48 @@ static bool capture_pipelines_option_callback(void* data, void* arg)
 	return true;
 }
 
+static bool trace_option_callback(void* data, void* arg)
+{
+	struct CzConfig* config = (struct CzConfig*) data;
+	const char* tracePath = *(const char**) arg;
+
+	config->tracePath = tracePath;
+	return true;
+}
+
+static bool metrics_option_callback(void* data, void* arg)
+{
+	struct CzConfig* config = (struct CzConfig*) data;
+	const char* metricsPath = *(const char**) arg;
+
+	config->metricsPath = metricsPath;
+	return true;
+}
+
+static bool prometheus_option_callback(void* data, void* arg)
+{
+	struct CzConfig* config = (struct CzConfig*) data;
+	const char* prometheusAddress = *(const char**) arg;
+
+	config->prometheusAddress = prometheusAddress;
+	return true;
+}
+
+static bool stats_option_callback(void* data, void* arg)
+{
+	struct CzConfig* config = (struct CzConfig*) data;
+	const char* statsName = *(const char**) arg;
+
+	config->statsName = statsName;
+	return true;
+}
+
 static bool iter_size_option_callback(void* data, void* arg)
 {
 	struct CzConfig* config = (struct CzConfig*) data;
 	unsigned long iterSize = *(unsigned long*) arg;
 
-	if (iterSize != 128 && iterSize != 256) {
+	if (iterSize != 128 && iterSize != 192 && iterSize != 256) {
 		log_warning(stdout, "Ignoring invalid --iter-size argument %lu", iterSize);
 		return true;
 	}
@@ -258,6 +443,57 @@ static bool max_loops_option_callback(void* data, void* arg)
 	return true;
 }
 
+static bool pipeline_depth_option_callback(void* data, void* arg)
+{
+	struct CzConfig* config = (struct CzConfig*) data;
+	unsigned long pipelineDepth = *(unsigned long*) arg;
+
+	if (pipelineDepth < 1 || pipelineDepth > 8) {
+		log_warning(stdout, "Ignoring invalid --pipeline-depth argument %lu", pipelineDepth);
+		return true;
+	}
+
+	config->pipelineDepth = pipelineDepth;
+	return true;
+}
+
+static bool read_threads_option_callback(void* data, void* arg)
+{
+	struct CzConfig* config = (struct CzConfig*) data;
+	unsigned long readThreads = *(unsigned long*) arg;
+
+	if (readThreads < 1 || readThreads > 64) {
+		log_warning(stdout, "Ignoring invalid --read-threads argument %lu", readThreads);
+		return true;
+	}
+
+	config->readThreads = readThreads;
+	return true;
+}
+
+static bool inout_dispatches_option_callback(void* data, void* arg)
+{
+	struct CzConfig* config = (struct CzConfig*) data;
+	unsigned long inoutDispatches = *(unsigned long*) arg;
+
+	if (inoutDispatches < 1 || inoutDispatches > 64) {
+		log_warning(stdout, "Ignoring invalid --inout-dispatches argument %lu", inoutDispatches);
+		return true;
+	}
+
+	config->inoutDispatches = inoutDispatches;
+	return true;
+}
+
+static bool latency_interval_option_callback(void* data, void* arg)
+{
+	struct CzConfig* config = (struct CzConfig*) data;
+	unsigned long latencyInterval = *(unsigned long*) arg;
+
+	config->latencyInterval = latencyInterval;
+	return true;
+}
+
 static bool max_memory_option_callback(void* data, void* arg)
 {
 	struct CzConfig* config = (struct CzConfig*) data;
@@ -274,7 +510,7 @@ static bool max_memory_option_callback(void* data, void* arg)
 
 static bool init_config(int argc, char** argv)
 {
-	size_t optCount = 20;
+	size_t optCount = 36;
 	CzCli cli = czCliCreate(&czgConfig, optCount);
 	if CZ_NOEXPECT (!cli) { return false; }
 
@@ -293,18 +529,34 @@ static bool init_config(int argc, char** argv)
 	czCliAdd(cli, 'p', "profile-layers", CZ_CLI_DATATYPE_NONE, profile_layers_option_callback);
 	czCliAdd(cli, 'd', "validation",     CZ_CLI_DATATYPE_NONE, validation_option_callback);
 
-	czCliAdd(cli, 'i', "int16", CZ_CLI_DATATYPE_NONE, int16_option_callback);
-	czCliAdd(cli, 'I', "int64", CZ_CLI_DATATYPE_NONE, int64_option_callback);
+	czCliAdd(cli, 'i', "int16",        CZ_CLI_DATATYPE_NONE, int16_option_callback);
+	czCliAdd(cli, 'I', "int64",        CZ_CLI_DATATYPE_NONE, int64_option_callback);
+	czCliAdd(cli, 'a', "auto-variant", CZ_CLI_DATATYPE_NONE, auto_variant_option_callback);
+	czCliAdd(cli, 't', "tune",         CZ_CLI_DATATYPE_NONE, tune_option_callback);
 
 	czCliAdd(cli, 'r',  "restart",             CZ_CLI_DATATYPE_NONE, restart_option_callback);
 	czCliAdd(cli, 'b',  "no-query-benchmarks", CZ_CLI_DATATYPE_NONE, no_query_benchmarks_option_callback);
+	czCliAdd(cli, 'g',  "continuous",          CZ_CLI_DATATYPE_NONE, continuous_option_callback);
+	czCliAdd(cli, 'j',  "jit",                 CZ_CLI_DATATYPE_NONE, jit_option_callback);
+	czCliAdd(cli, 'u',  "ramp-up",             CZ_CLI_DATATYPE_NONE, ramp_up_option_callback);
+	czCliAdd(cli, 'H',  "huge-pages",          CZ_CLI_DATATYPE_NONE, huge_pages_option_callback);
+	czCliAdd(cli, 'm',  "instrument",          CZ_CLI_DATATYPE_NONE, instrument_option_callback);
+	czCliAdd(cli, 'P',  "pipeline-stats",      CZ_CLI_DATATYPE_NONE, pipeline_stats_option_callback);
 
 	czCliAdd(cli, 0, "log-allocations",   CZ_CLI_DATATYPE_STRING, log_allocations_option_callback);
 	czCliAdd(cli, 0, "capture-pipelines", CZ_CLI_DATATYPE_STRING, capture_pipelines_option_callback);
-
-	czCliAdd(cli, 0, "iter-size",  CZ_CLI_DATATYPE_ULONG,  iter_size_option_callback);
-	czCliAdd(cli, 0, "max-loops",  CZ_CLI_DATATYPE_ULLONG, max_loops_option_callback);
-	czCliAdd(cli, 0, "max-memory", CZ_CLI_DATATYPE_FLOAT,  max_memory_option_callback);
+	czCliAdd(cli, 0, "trace",             CZ_CLI_DATATYPE_STRING, trace_option_callback);
+	czCliAdd(cli, 0, "metrics",           CZ_CLI_DATATYPE_STRING, metrics_option_callback);
+	czCliAdd(cli, 0, "prometheus",        CZ_CLI_DATATYPE_STRING, prometheus_option_callback);
+	czCliAdd(cli, 0, "stats",             CZ_CLI_DATATYPE_STRING, stats_option_callback);
+
+	czCliAdd(cli, 0, "iter-size",        CZ_CLI_DATATYPE_ULONG,  iter_size_option_callback);
+	czCliAdd(cli, 0, "max-loops",        CZ_CLI_DATATYPE_ULLONG, max_loops_option_callback);
+	czCliAdd(cli, 0, "pipeline-depth",   CZ_CLI_DATATYPE_ULONG,  pipeline_depth_option_callback);
+	czCliAdd(cli, 0, "read-threads",     CZ_CLI_DATATYPE_ULONG,  read_threads_option_callback);
+	czCliAdd(cli, 0, "inout-dispatches", CZ_CLI_DATATYPE_ULONG,  inout_dispatches_option_callback);
+	czCliAdd(cli, 0, "latency-interval", CZ_CLI_DATATYPE_ULONG,  latency_interval_option_callback);
+	czCliAdd(cli, 0, "max-memory",       CZ_CLI_DATATYPE_FLOAT,  max_memory_option_callback);
 
 	bool bres = czCliParse(cli, argc, argv);
 	if CZ_NOEXPECT (!bres) { czCliDestroy(cli); return false; }
@@ -349,8 +601,98 @@ static bool init_env(void)
 	return true;
 }
 
+// Time taken by each stage of GPU initialisation (ms)
+struct InitBmarks
+{
+	double device; // Instance and device creation.
+	double memory; // Planning the memory layout.
+	double buffers;
+	double descriptors;
+	double pipeline; // Including shader variant selection, if enabled.
+	double commands;
+	double total; // Less than the sum of the stages when the pipeline is built in parallel.
+};
+
+struct PipelineStage
+{
+	struct Gpu* gpu;
+	double bmark;
+	bool result;
+};
+
+static void* pipeline_thread(void* arg)
+{
+	struct PipelineStage* stage = (struct PipelineStage*) arg;
+
+	double start = wall_time();
+	stage->result = create_pipeline(stage->gpu);
+	stage->bmark = wall_time() - start;
+	return NULL;
+}
+
+// Create the pipeline, its descriptor set layout, and every object sized by the memory layout, except command buffers
+static bool create_layout_objects(struct Gpu* gpu, struct InitBmarks* bmarks, bool selectVariant)
+{
+	struct PipelineStage stage = {0};
+	stage.gpu = gpu;
+
+	pthread_t thread;
+	int ires;
+
+	bool bres = create_descriptor_layout(gpu);
+	if CZ_NOEXPECT (!bres) { return false; }
+
+	/*
+	 * The pipeline depends on only the descriptor set layout, so is built on another thread while the buffers and
+	 * descriptor sets are created. Shader variants are benchmarked using the buffers and descriptor sets, so selecting
+	 * a variant instead builds the pipeline afterwards.
+	 */
+	if (!selectVariant) {
+		ires = pthread_create(&thread, NULL, pipeline_thread, &stage);
+		if CZ_NOEXPECT (ires) { PCREATE_FAILURE(ires); return false; }
+	}
+
+	double start = wall_time();
+	bres = create_buffers(gpu);
+	bmarks->buffers = wall_time() - start;
+
+	if (bres) {
+		start = wall_time();
+		bres = create_descriptors(gpu);
+		bmarks->descriptors = wall_time() - start;
+	}
+
+	if (selectVariant) {
+		if CZ_NOEXPECT (!bres) { return false; }
+
+		start = wall_time();
+		bres = select_variant(gpu);
+		if CZ_NOEXPECT (!bres) { return false; }
+
+		pipeline_thread(&stage);
+		bmarks->pipeline = wall_time() - start;
+	}
+	else {
+		ires = pthread_join(thread, NULL);
+		if CZ_NOEXPECT (ires) { PJOIN_FAILURE(ires); return false; }
+
+		bmarks->pipeline = stage.bmark;
+	}
+
+	if CZ_NOEXPECT (!bres || !stage.result) { return false; }
+
+	// Created last, as selecting a variant uses a query pool of its own
+	bres = create_query_pools(gpu);
+	return bres;
+}
+
 static bool init_gpu(struct Gpu* gpu)
 {
+	struct InitBmarks bmarks = {0};
+
+	double initStart = wall_time();
+	double start = initStart;
+
 	bool bres = create_instance(gpu);
 	if CZ_NOEXPECT (!bres) { return false; }
 
@@ -360,16 +702,58 @@ static bool init_gpu(struct Gpu* gpu)
 	bres = create_device(gpu);
 	if CZ_NOEXPECT (!bres) { return false; }
 
+	bmarks.device = wall_time() - start;
+	start = wall_time();
+
 	bres = manage_memory(gpu);
 	if CZ_NOEXPECT (!bres) { return false; }
 
-	bres = create_buffers(gpu);
+	bmarks.memory = wall_time() - start;
+
+	bres = create_layout_objects(gpu, &bmarks, czgConfig.autoVariant);
+	if CZ_NOEXPECT (!bres) { return false; }
+
+	start = wall_time();
+
+	if (czgConfig.continuous) {
+		bres = create_continuous_commands(gpu);
+	}
+	else {
+		bres = create_commands(gpu);
+	}
+
+	if CZ_NOEXPECT (!bres) { return false; }
+
+	bmarks.commands = wall_time() - start;
+	bmarks.total = wall_time() - initStart;
+
+	if (czgConfig.outputLevel > CZ_OUTPUT_LEVEL_QUIET) {
+		printf(
+			"Initialisation times:\n"
+			"\tInstance and device: %.3fms\n"
+			"\tMemory layout:       %.3fms\n"
+			"\tBuffers:             %.3fms\n"
+			"\tDescriptors:         %.3fms\n"
+			"\tPipeline:            %.3fms\n"
+			"\tCommands:            %.3fms\n"
+			"\tTotal:               %.3fms\n\n",
+			bmarks.device, bmarks.memory, bmarks.buffers, bmarks.descriptors, bmarks.pipeline, bmarks.commands,
+			bmarks.total);
+	}
+
+	return true;
+}
+
+// Create every object sized by the memory layout, reusing the existing descriptor set layout and pipeline
+static bool create_sized_objects(struct Gpu* gpu)
+{
+	bool bres = create_buffers(gpu);
 	if CZ_NOEXPECT (!bres) { return false; }
 
 	bres = create_descriptors(gpu);
 	if CZ_NOEXPECT (!bres) { return false; }
 
-	bres = create_pipeline(gpu);
+	bres = create_query_pools(gpu);
 	if CZ_NOEXPECT (!bres) { return false; }
 
 	bres = create_commands(gpu);
@@ -378,9 +762,300 @@ static bool init_gpu(struct Gpu* gpu)
 	return true;
 }
 
+static bool resize_gpu(struct Gpu* gpu)
+{
+	bool bres = release_memory(gpu);
+	if CZ_NOEXPECT (!bres) { return false; }
+
+	bres = manage_memory(gpu);
+	if CZ_NOEXPECT (!bres) { return false; }
+
+	bres = create_sized_objects(gpu);
+	if CZ_NOEXPECT (!bres) { return false; }
+
+	return true;
+}
+
+struct RampUp
+{
+	struct Gpu gpu; // Full memory layout, created in the background.
+	pthread_t thread;
+	atomic_bool done;
+	bool result;
+};
+
+static void* ramp_up_thread(void* arg)
+{
+	struct RampUp* rampUp = (struct RampUp*) arg;
+	bool bres = create_sized_objects(&rampUp->gpu);
+
+	// The main loop stops to join the full memory layout even on failure, so the failure is reported
+	rampUp->result = bres;
+	atomic_store(&rampUp->done, true);
+	return NULL;
+}
+
+static bool start_ramp_up(struct Gpu* gpu, struct RampUp* rampUp)
+{
+	// The full memory layout shares the instance, device, descriptor set layout, and pipeline, but has its own objects
+	// and allocations
+	struct Gpu* full = &rampUp->gpu;
+	*full = *gpu;
+
+	full->allocRecord = dyrecord_create();
+	if CZ_NOEXPECT (!full->allocRecord) { return false; }
+
+	bool bres = dyrecord_add(gpu->allocRecord, full->allocRecord, dyrecord_destroy_stub);
+	if CZ_NOEXPECT (!bres) { dyrecord_destroy(full->allocRecord); return false; }
+
+	full->rampingUp = false;
+	full->rampUpDone = NULL;
+
+	// The ramp-up memory layout stays allocated until the full memory layout is created, so is planned around
+	VkDeviceSize bytesPerStatsMemory = (gpu->bytesPerSteps + gpu->bytesPerStats) * gpu->inoutsPerHeap *
+		gpu->dispatchesPerInout;
+
+	full->hostVisibleBytesReserved = gpu->bytesPerHostVisibleMemory * gpu->buffersPerHeap;
+	full->hostVisibleOutBytesReserved = gpu->bytesPerHostVisibleOutMemory * gpu->buffersPerHeap + bytesPerStatsMemory;
+	full->deviceLocalBytesReserved = gpu->bytesPerDeviceLocalMemory * gpu->buffersPerHeap;
+
+	// Plan on the main thread, so the full memory layout is displayed before the main loop begins
+	bres = manage_memory(full);
+	if CZ_NOEXPECT (!bres) { return false; }
+
+	full->hostVisibleBytesReserved = 0;
+	full->hostVisibleOutBytesReserved = 0;
+	full->deviceLocalBytesReserved = 0;
+
+	full->background = true;
+
+	atomic_init(&rampUp->done, false);
+	gpu->rampUpDone = &rampUp->done;
+
+	int ires = pthread_create(&rampUp->thread, NULL, ramp_up_thread, rampUp);
+	if CZ_NOEXPECT (ires) { PCREATE_FAILURE(ires); return false; }
+
+	return true;
+}
+
+static bool join_ramp_up(struct Gpu* gpu, struct RampUp* rampUp)
+{
+	struct Gpu* full = &rampUp->gpu;
+
+	int ires = pthread_join(rampUp->thread, NULL);
+	if CZ_NOEXPECT (ires) { PJOIN_FAILURE(ires); return false; }
+
+	gpu->rampingUp = false;
+
+	// If the main loop ended before the full memory layout was needed, it is freed unused
+	if (!gpu->resizing || !rampUp->result) {
+		release_memory(full);
+		return rampUp->result;
+	}
+
+	bool bres = release_memory(gpu);
+	if CZ_NOEXPECT (!bres) { release_memory(full); return false; }
+
+	// Carry the progress of the run over to the full memory layout
+	full->allocRecord = gpu->allocRecord;
+	full->position = gpu->position;
+	full->bestStartValues = gpu->bestStartValues;
+	full->bestStopTimes = gpu->bestStopTimes;
+	full->initialStartValue = gpu->initialStartValue;
+	full->totalTested = gpu->totalTested;
+	full->totalSteps = gpu->totalSteps;
+	full->totalBmark = gpu->totalBmark;
+	full->loopCount = gpu->loopCount;
+	full->resizing = gpu->resizing;
+	full->background = false;
+
+	*gpu = *full;
+	return true;
+}
+
+// Thread waiting for Enter/Return, shared by every submission loop of the run
+struct Input
+{
+	pthread_t thread;
+	atomic_bool pressed; // Also set once the run ends, before the thread is cancelled.
+	bool started;
+};
+
+static bool start_input(struct Input* input)
+{
+	int ires = pthread_create(&input->thread, NULL, wait_for_input, &input->pressed);
+	if CZ_NOEXPECT (ires) { PCREATE_FAILURE(ires); return false; }
+
+	input->started = true;
+	return true;
+}
+
+static bool stop_input(struct Input* input)
+{
+	int ires;
+
+	if (!input->started) { return true; }
+
+	input->started = false;
+
+	// The thread only returns by itself once Enter/Return is pressed, so is otherwise cancelled mid-wait
+	if (!atomic_exchange(&input->pressed, true)) {
+		ires = pthread_cancel(input->thread);
+		if CZ_NOEXPECT (ires) { PCANCEL_FAILURE(ires); return false; }
+	}
+
+	ires = pthread_join(input->thread, NULL);
+	if CZ_NOEXPECT (ires) { PJOIN_FAILURE(ires); return false; }
+
+	return true;
+}
+
+static bool run_tuning_trial(struct Gpu* gpu)
+{
+	// Trials are brief, so are not stopped by Enter/Return
+	atomic_bool input;
+	atomic_init(&input, false);
+
+	gpu->input = &input;
+	gpu->tuningTrial = true;
+
+	bool bres = init_gpu(gpu);
+	if CZ_NOEXPECT (!bres) { destroy_gpu(gpu); return false; }
+
+	if (czgConfig.continuous) {
+		bres = submit_continuous(gpu);
+	}
+	else {
+		bres = submit_commands(gpu);
+	}
+
+	destroy_gpu(gpu);
+	return bres;
+}
+
+static void print_tuning_trial(const struct Tuning* tuning, double valuesPerSecond)
+{
+	printf(
+		"Tuning trial: workgroup size %" PRIu32 ", values per dispatch %" PRIu32 ", inout-buffers %" PRIu32
+		", subgroup size %" PRIu32 ": %.3f/s\n",
+		tuning->workgroupSize, tuning->valuesPerDispatch, tuning->inoutsPerHeap, tuning->subgroupSize, valuesPerSecond);
+}
+
+static bool tune_gpu(struct Tuning* tuning)
+{
+	enum CzOutputLevel outputLevel = czgConfig.outputLevel;
+	unsigned long long maxLoops = czgConfig.maxLoops;
+
+	// Trials run briefly and output nothing themselves
+	czgConfig.outputLevel = CZ_OUTPUT_LEVEL_SILENT;
+	czgConfig.maxLoops = CZ_TUNING_LOOP_COUNT;
+
+	// The first trial uses the default memory layout, which every later trial only shrinks
+	struct Gpu trial = {0};
+	bool bres = run_tuning_trial(&trial);
+
+	struct Tuning best;
+	best.workgroupSize = trial.workgroupSize;
+	best.valuesPerDispatch = trial.valuesPerDispatch;
+	best.inoutsPerHeap = trial.inoutsPerHeap;
+	best.subgroupSize = trial.subgroupSize;
+
+	double bestSpeed = trial.valuesPerSecond;
+	CzU32 minSubgroupSize = trial.minSubgroupSize;
+	CzU32 maxSubgroupSize = trial.maxSubgroupSize;
+
+	if (bres && outputLevel > CZ_OUTPUT_LEVEL_QUIET) {
+		print_tuning_trial(&best, bestSpeed);
+	}
+
+	// Sweep one parameter at a time, starting each sweep from the fastest trial so far
+	for (CzU32 i = 0; i < 4 && bres; i++) {
+		struct Tuning candidates[8];
+		CzU32 candidateCount = 0;
+
+		switch (i) {
+		case 0: // Smaller workgroups
+			for (CzU32 size = best.workgroupSize / 2; size >= 128 && candidateCount < 3; size /= 2) {
+				candidates[candidateCount] = best;
+				candidates[candidateCount].workgroupSize = size;
+				candidateCount++;
+			}
+			break;
+
+		case 1: // Smaller dispatches, and so more inout-buffers
+			for (CzU32 size = best.valuesPerDispatch / 2; size >= best.workgroupSize && candidateCount < 2; size /= 2) {
+				candidates[candidateCount] = best;
+				candidates[candidateCount].valuesPerDispatch = size;
+				candidates[candidateCount].inoutsPerHeap = 0;
+				candidateCount++;
+			}
+			break;
+
+		case 2: // Fewer inout-buffers, and so less pipelining
+			for (CzU32 count = best.inoutsPerHeap / 2; count >= 2 && candidateCount < 3; count /= 2) {
+				candidates[candidateCount] = best;
+				candidates[candidateCount].inoutsPerHeap = count;
+				candidateCount++;
+			}
+			break;
+
+		case 3: // Each subgroup size the compute stage supports
+			for (CzU32 size = minSubgroupSize; size && size <= maxSubgroupSize && candidateCount < 8; size *= 2) {
+				candidates[candidateCount] = best;
+				candidates[candidateCount].subgroupSize = size;
+				candidateCount++;
+			}
+			break;
+
+		default:
+			break;
+		}
+
+		for (CzU32 j = 0; j < candidateCount && bres; j++) {
+			memset(&trial, 0, sizeof(trial));
+			trial.tuning = candidates[j];
+
+			bres = run_tuning_trial(&trial);
+			if CZ_NOEXPECT (!bres) { break; }
+
+			struct Tuning result;
+			result.workgroupSize = trial.workgroupSize;
+			result.valuesPerDispatch = trial.valuesPerDispatch;
+			result.inoutsPerHeap = trial.inoutsPerHeap;
+			result.subgroupSize = trial.subgroupSize;
+
+			if (outputLevel > CZ_OUTPUT_LEVEL_QUIET) {
+				print_tuning_trial(&result, trial.valuesPerSecond);
+			}
+
+			if (trial.valuesPerSecond > bestSpeed) {
+				best = result;
+				bestSpeed = trial.valuesPerSecond;
+			}
+		}
+	}
+
+	czgConfig.outputLevel = outputLevel;
+	czgConfig.maxLoops = maxLoops;
+
+	if CZ_NOEXPECT (!bres) { return false; }
+
+	if (outputLevel > CZ_OUTPUT_LEVEL_QUIET) {
+		printf(
+			"Selected tuning: workgroup size %" PRIu32 ", values per dispatch %" PRIu32 ", inout-buffers %" PRIu32
+			", subgroup size %" PRIu32 "\n\n",
+			best.workgroupSize, best.valuesPerDispatch, best.inoutsPerHeap, best.subgroupSize);
+	}
+
+	*tuning = best;
+	return true;
+}
+
 int main(int argc, char** argv)
 {
 	struct Gpu gpu = {0};
+	struct RampUp rampUp = {0};
+	struct Input input = {0};
 
 	bool bres = init_env();
 	if CZ_NOEXPECT (!bres) { return EXIT_FAILURE; }
@@ -391,16 +1066,115 @@ int main(int argc, char** argv)
 	bres = init_colour_level(czgConfig.colourLevel);
 	if CZ_NOEXPECT (!bres) { return EXIT_FAILURE; }
 
+	if (czgConfig.tune) {
+		bres = tune_gpu(&gpu.tuning);
+		if CZ_NOEXPECT (!bres) { return EXIT_FAILURE; }
+	}
+
+	gpu.rampingUp = czgConfig.rampUp && !czgConfig.continuous;
+	gpu.instrumenting = czgConfig.instrument && !czgConfig.continuous;
+
+	atomic_init(&input.pressed, false);
+	gpu.input = &input.pressed;
+
+	// Tuning trials are neither traced, recorded in the metrics, served, nor published
+	if (czgConfig.tracePath) {
+		bres = trace_init(czgConfig.tracePath);
+		if CZ_NOEXPECT (!bres) { return EXIT_FAILURE; }
+	}
+
+	if (czgConfig.metricsPath) {
+		bres = metrics_init(czgConfig.metricsPath);
+		if CZ_NOEXPECT (!bres) { trace_fini(); return EXIT_FAILURE; }
+	}
+
+	if (czgConfig.prometheusAddress) {
+		bres = exporter_init(czgConfig.prometheusAddress);
+		if CZ_NOEXPECT (!bres) { trace_fini(); metrics_fini(); return EXIT_FAILURE; }
+	}
+
+	if (czgConfig.statsName) {
+		bres = stats_init(czgConfig.statsName);
+		if CZ_NOEXPECT (!bres) { exporter_fini(); trace_fini(); metrics_fini(); return EXIT_FAILURE; }
+	}
+
 	bres = init_gpu(&gpu);
 	if CZ_NOEXPECT (!bres) { goto err_destroy_gpu; }
 
-	bres = submit_commands(&gpu);
-	if CZ_NOEXPECT (!bres) { goto err_destroy_gpu; }
+	// Create the full memory layout in the background, while the main loop begins on the ramp-up memory layout
+	if (gpu.rampingUp) {
+		bres = start_ramp_up(&gpu, &rampUp);
+		if CZ_NOEXPECT (!bres) { goto err_destroy_gpu; }
+	}
+
+	if (czgConfig.tune) {
+		bres = save_tuning(gpu.rampingUp ? &rampUp.gpu : &gpu);
+		if CZ_NOEXPECT (!bres) { goto err_join_ramp_up; }
+	}
+
+	// Wait for Enter/Return across every submission loop, so the prompt is displayed once
+	bres = start_input(&input);
+	if CZ_NOEXPECT (!bres) { goto err_join_ramp_up; }
+
+	if (czgConfig.continuous) {
+		bres = submit_continuous(&gpu);
+	}
+	else {
+		bres = submit_commands(&gpu);
+	}
+
+	/*
+	 * Join the full memory layout once it has been created in the background, and recreate the inout-buffers to fit
+	 * the memory budget whenever it changes mid-run.
+	 */
+	while (bres && gpu.resizing) {
+		if (gpu.rampingUp) {
+			bres = join_ramp_up(&gpu, &rampUp);
+		}
+		else {
+			bres = resize_gpu(&gpu);
+		}
+
+		if CZ_NOEXPECT (!bres) { goto err_destroy_gpu; }
+
+		bres = submit_commands(&gpu);
+	}
+
+	if CZ_NOEXPECT (!bres) { goto err_join_ramp_up; }
+
+	bres = stop_input(&input);
+	if CZ_NOEXPECT (!bres) { goto err_join_ramp_up; }
+
+	// The run may end before the full memory layout is ever joined
+	if (gpu.rampingUp) {
+		bres = join_ramp_up(&gpu, &rampUp);
+		if CZ_NOEXPECT (!bres) { goto err_destroy_gpu; }
+	}
 
 	destroy_gpu(&gpu);
+	exporter_fini();
+	stats_fini();
+
+	bres = trace_fini();
+	if CZ_NOEXPECT (!bres) { metrics_fini(); return EXIT_FAILURE; }
+
+	bres = metrics_fini();
+	if CZ_NOEXPECT (!bres) { return EXIT_FAILURE; }
+
 	return EXIT_SUCCESS;
 
+err_join_ramp_up:
+	if (gpu.rampingUp) {
+		gpu.resizing = false;
+		join_ramp_up(&gpu, &rampUp);
+	}
+
 err_destroy_gpu:
+	stop_input(&input);
 	destroy_gpu(&gpu);
+	exporter_fini();
+	stats_fini();
+	trace_fini();
+	metrics_fini();
 	return EXIT_FAILURE;
 }
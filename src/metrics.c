@@ -0,0 +1,154 @@
+/* 
+ * Copyright (C) 2025 Seth McDonald
+ * 
+ * This file is part of Collatz Conjecture Simulator.
+ * 
+ * Collatz Conjecture Simulator is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ * 
+ * Collatz Conjecture Simulator is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE. See the GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License along with Collatz Conjecture
+ * Simulator. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "metrics.h"
+
+static FILE* gMetricsFile = NULL;
+
+bool metrics_init(const char* filename)
+{
+	const char* mode = "a";
+
+	FILE* file = fopen(filename, mode);
+	if CZ_NOEXPECT (!file) { FOPEN_FAILURE(file, filename, mode); return false; }
+
+	// Records are buffered until the end of each main loop iteration, so the loop is not held up by file I/O
+	size_t bufferSize = 64 * CZ_KIB_SIZE;
+	setvbuf(file, NULL, _IOFBF, bufferSize);
+
+	gMetricsFile = file;
+	return true;
+}
+
+bool metrics_fini(void)
+{
+	FILE* file = gMetricsFile;
+	gMetricsFile = NULL;
+
+	if (!file) {
+		return true;
+	}
+
+	int ires = fclose(file);
+	if CZ_NOEXPECT (ires) { return false; }
+
+	return true;
+}
+
+// Stop recording metrics rather than fail the run
+static void metrics_failure(int res, const char* fmt)
+{
+	FPRINTF_FAILURE(res, gMetricsFile, fmt);
+	fclose(gMetricsFile);
+	gMetricsFile = NULL;
+}
+
+void metrics_inout(const struct InoutMetrics* metrics)
+{
+	FILE* file = gMetricsFile;
+
+	if (!file) {
+		return;
+	}
+
+	const char* fmt =
+		"{\"record\":\"inout\",\"loop\":%" PRIu64 ",\"inout\":%" PRIu32 ","
+		"\"readMs\":%.3f,\"writeMs\":%.3f,\"computeMs\":%.3f,\"transferMs\":%.3f,"
+		"\"idleComputeMs\":%.3f,\"idleTransferMs\":%.3f}\n";
+
+	int ires = fprintf(
+		file, fmt, metrics->loop, metrics->inout, metrics->read, metrics->write, metrics->compute, metrics->transfer,
+		metrics->idleCompute, metrics->idleTransfer);
+
+	if CZ_NOEXPECT (ires < 0) { metrics_failure(ires, fmt); }
+}
+
+void metrics_divergence(CzU64 loop, const struct DivergenceMetrics* metrics)
+{
+	FILE* file = gMetricsFile;
+
+	if (!file || !metrics->invocationCount) {
+		return;
+	}
+
+	double meanStopTime = (double) metrics->stopTimeSum / (double) metrics->invocationCount;
+	double meanSpread = (double) metrics->spreadSum / (double) metrics->subgroupCount;
+	double meanCycles = (double) metrics->cycleSum / (double) metrics->workgroupCount;
+	double laneEfficiency = (double) metrics->stopTimeSum / (double) metrics->busyStopTimeSum;
+
+	const char* fmt =
+		"{\"record\":\"divergence\",\"loop\":%" PRIu64 ","
+		"\"workgroups\":%" PRIu64 ",\"subgroups\":%" PRIu64 ",\"invocations\":%" PRIu64 ","
+		"\"minStopTime\":%" PRIu32 ",\"meanStopTime\":%.3f,\"maxStopTime\":%" PRIu32 ","
+		"\"laneEfficiency\":%.4f,\"meanSubgroupSpread\":%.3f,\"meanWorkgroupCycles\":%.0f,\"histogram\":[";
+
+	int ires = fprintf(
+		file, fmt, loop, metrics->workgroupCount, metrics->subgroupCount, metrics->invocationCount,
+		metrics->minStopTime, meanStopTime, metrics->maxStopTime, laneEfficiency, meanSpread, meanCycles);
+
+	if CZ_NOEXPECT (ires < 0) { metrics_failure(ires, fmt); return; }
+
+	// Bin i holds the invocations whose total stopping time has its most significant bit at bit i
+	for (CzU32 i = 0; i < CZ_COUNTOF(metrics->histogram); i++) {
+		fmt = i ? ",%" PRIu64 : "%" PRIu64;
+
+		ires = fprintf(file, fmt, metrics->histogram[i]);
+		if CZ_NOEXPECT (ires < 0) { metrics_failure(ires, fmt); return; }
+	}
+
+	fmt = "]}\n";
+
+	ires = fputs(fmt, file);
+	if CZ_NOEXPECT (ires < 0) { metrics_failure(ires, fmt); }
+}
+
+void metrics_loop(const struct LoopMetrics* metrics)
+{
+	FILE* file = gMetricsFile;
+
+	if (!file) {
+		return;
+	}
+
+	// Starting values exceed the integers exactly representable in JSON, so are written as hexadecimal strings
+	const char* fmt =
+		"{\"record\":\"loop\",\"time\":%" PRIu64 ",\"loop\":%" PRIu64 ","
+		"\"mainLoopMs\":%.3f,\"valuesPerSecond\":%.0f,\"stepsPerSecond\":%.0f,"
+		"\"readMs\":%.3f,\"writeMs\":%.3f,\"computeMs\":%.3f,\"transferMs\":%.3f,"
+		"\"idleComputeMs\":%.3f,\"idleTransferMs\":%.3f,"
+		"\"initialValue\":\"0x%016" PRIx64 "%016" PRIx64 "\",\"currentValue\":\"0x%016" PRIx64 "%016" PRIx64 "\","
+		"\"values\":%" PRIu64 ",\"steps\":%" PRIu64 ",\"invocations\":%" PRIu64 ","
+		"\"records\":%" PRIu64 ",\"bestStopTime\":%" PRIu16 ","
+		"\"inoutsPerHeap\":%" PRIu32 ",\"stagesPerInout\":%" PRIu32 ",\"dispatchesPerInout\":%" PRIu32 ","
+		"\"valuesPerInout\":%" PRIu64 ",\"hostVisibleTypeIndex\":%" PRIu32 ",\"hostVisibleOutTypeIndex\":%" PRIu32 ","
+		"\"deviceLocalTypeIndex\":%" PRIu32 "}\n";
+
+	int ires = fprintf(
+		file, fmt, (CzU64) time(NULL), metrics->loop, metrics->mainLoop, metrics->valuesPerSecond,
+		metrics->stepsPerSecond, metrics->read, metrics->write, metrics->compute, metrics->transfer,
+		metrics->idleCompute, metrics->idleTransfer,
+		CZ_U128_UPPER(metrics->initialValue), CZ_U128_LOWER(metrics->initialValue),
+		CZ_U128_UPPER(metrics->currentValue), CZ_U128_LOWER(metrics->currentValue), metrics->valueCount,
+		metrics->stepCount, metrics->invocationCount, metrics->recordCount, metrics->bestStopTime,
+		metrics->inoutsPerHeap, metrics->stagesPerInout, metrics->dispatchesPerInout, metrics->valuesPerInout,
+		metrics->hostVisibleTypeIndex, metrics->hostVisibleOutTypeIndex, metrics->deviceLocalTypeIndex);
+
+	if CZ_NOEXPECT (ires < 0) { metrics_failure(ires, fmt); return; }
+
+	ires = fflush(file);
+	if CZ_NOEXPECT (ires) { metrics_failure(ires, "fflush"); }
+}
@@ -0,0 +1,104 @@
+/* 
+ * Copyright (C) 2025 Seth McDonald
+ * 
+ * This file is part of Collatz Conjecture Simulator.
+ * 
+ * Collatz Conjecture Simulator is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ * 
+ * Collatz Conjecture Simulator is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE. See the GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License along with Collatz Conjecture
+ * Simulator. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "common.h"
+
+// Machine-readable statistics of the submission loop, appended for --metrics as JSON Lines
+
+// Benchmarks of an inout-buffer during a main loop iteration, in ms
+struct InoutMetrics
+{
+	CzU64 loop;
+	CzU32 inout;
+
+	double read;
+	double write;
+	double compute;
+	double transfer;
+	double idleCompute;
+	double idleTransfer;
+};
+
+// Benchmarks of a main loop iteration, summed over its inout-buffers, in ms
+struct LoopMetrics
+{
+	CzU128 initialValue; // First starting value tested by the iteration.
+	CzU128 currentValue; // First starting value yet to be tested.
+	CzU64 loop;
+	CzU64 valueCount; // Starting values tested by the iteration.
+	CzU64 stepCount; // Collatz steps taken by the device during the iteration.
+	CzU64 invocationCount; // Compute shader invocations of the iteration, or 0 if not queried.
+	CzU64 recordCount; // Starting values found with a longer total stopping time than all before them.
+	CzU16 bestStopTime;
+
+	double mainLoop;
+	double valuesPerSecond;
+	double stepsPerSecond;
+	double read;
+	double write;
+	double compute;
+	double transfer;
+	double idleCompute;
+	double idleTransfer;
+
+	CzU64 valuesPerInout;
+	CzU32 inoutsPerHeap;
+	CzU32 stagesPerInout;
+	CzU32 dispatchesPerInout;
+	CzU32 hostVisibleTypeIndex;
+	CzU32 hostVisibleOutTypeIndex;
+	CzU32 deviceLocalTypeIndex;
+};
+
+// Divergence of the instrumented dispatches of a main loop iteration, summed over its inout-buffers
+struct DivergenceMetrics
+{
+	CzU64 workgroupCount;
+	CzU64 subgroupCount;
+	CzU64 invocationCount;
+	CzU64 stopTimeSum; // Sum of the total stopping times of every invocation.
+	CzU64 busyStopTimeSum; // Sum over each subgroup of its greatest total stopping time times its size.
+	CzU64 spreadSum; // Sum over each subgroup of its greatest minus least total stopping time.
+	CzU64 cycleSum; // Sum over each workgroup of its greatest subgroup clock cycles, or 0 if not recorded.
+	CzU64 histogram[16]; // Invocations by the most significant bit of their total stopping time.
+	CzU32 minStopTime;
+	CzU32 maxStopTime;
+};
+
+// Open the metrics file at filename, appending to any existing records
+CZ_NONNULL_ARGS() CZ_NULTERM_ARG(1) CZ_RD_ACCESS(1)
+bool metrics_init(const char* filename);
+
+// Close the metrics file, if any
+bool metrics_fini(void);
+
+// Append a record of an inout-buffer to the metrics file, if any
+// Must be called from the main thread
+CZ_NONNULL_ARGS() CZ_RD_ACCESS(1)
+void metrics_inout(const struct InoutMetrics* metrics);
+
+// Append a record of the divergence of a main loop iteration to the metrics file, if any
+// Must be called from the main thread
+CZ_NONNULL_ARGS() CZ_RD_ACCESS(2)
+void metrics_divergence(CzU64 loop, const struct DivergenceMetrics* metrics);
+
+// Append a record of a main loop iteration to the metrics file, if any, and flush the records buffered since the last
+// Must be called from the main thread
+CZ_NONNULL_ARGS() CZ_RD_ACCESS(1)
+void metrics_loop(const struct LoopMetrics* metrics);
@@ -0,0 +1,39 @@
+/* 
+ * Copyright (C) 2025 Seth McDonald
+ * 
+ * This file is part of Collatz Conjecture Simulator.
+ * 
+ * Collatz Conjecture Simulator is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ * 
+ * Collatz Conjecture Simulator is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE. See the GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License along with Collatz Conjecture
+ * Simulator. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "common.h"
+
+// Static tracepoints for perf, bpftrace, and SystemTap, compiled in if built with CZ_USDT_PROBES
+// Each probe is a single nop until a tracer attaches, and its arguments are not evaluated if compiled out
+
+// Queue passed to the wait and submit probes
+enum CzProbeQueue
+{
+	CZ_PROBE_QUEUE_COMPUTE,
+	CZ_PROBE_QUEUE_TRANSFER,
+};
+
+#if CZ_USDT_PROBES
+#define CZ_PROBE(name, ...) STAP_PROBEV(cltz, name, __VA_ARGS__)
+#else
+#define CZ_PROBE(name, ...) ((void) 0)
+#endif
+
+// Convert a duration (ms, as returned by wall_time) to an integer probe argument (ns)
+#define CZ_PROBE_NS(ms) ( (CzU64) ((ms) * 1000000) )
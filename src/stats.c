@@ -0,0 +1,196 @@
+/* 
+ * Copyright (C) 2025 Seth McDonald
+ * 
+ * This file is part of Collatz Conjecture Simulator.
+ * 
+ * Collatz Conjecture Simulator is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ * 
+ * Collatz Conjecture Simulator is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE. See the GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License along with Collatz Conjecture
+ * Simulator. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "stats.h"
+
+// Attempts at a consistent copy, before assuming the publisher stopped mid-update, such as by being killed
+#define STATS_READ_ATTEMPTS 4096
+
+static struct Stats* gStats = NULL;
+static const char* gStatsName = NULL;
+
+bool stats_init(const char* name)
+{
+#if CZ_UNIX
+	// Replace any object left behind by an earlier run, so readers still mapping it are unaffected
+	shm_unlink(name);
+
+	int fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+	if CZ_NOEXPECT (fd < 0) { log_error(stderr, "Failed to create shared memory object '%s'", name); return false; }
+
+	size_t size = sizeof(struct Stats);
+
+	int ires = ftruncate(fd, (off_t) size);
+	if CZ_NOEXPECT (ires) { log_error(stderr, "Failed to size shared memory object '%s'", name); goto err_unlink; }
+
+	void* map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	if CZ_NOEXPECT (map == MAP_FAILED) {
+		log_error(stderr, "Failed to map shared memory object '%s'", name);
+		goto err_unlink;
+	}
+
+	close(fd);
+
+	// The object is zero-filled, so the header is written last to mark the object as ready
+	struct Stats* stats = (struct Stats*) map;
+	stats->version = CZ_STATS_VERSION;
+	stats->size = (CzU32) size;
+	stats->pid = (CzU64) getpid();
+
+	atomic_thread_fence(memory_order_release);
+	stats->magic = CZ_STATS_MAGIC;
+
+	gStats = stats;
+	gStatsName = name;
+	return true;
+
+err_unlink:
+	close(fd);
+	shm_unlink(name);
+	return false;
+#else
+	log_error(stderr, "Cannot create '%s', as shared memory statistics are only supported on Unix-like systems", name);
+	return false;
+#endif
+}
+
+void stats_fini(void)
+{
+	if (!gStats) {
+		return;
+	}
+
+#if CZ_UNIX
+	munmap(gStats, sizeof(struct Stats));
+	shm_unlink(gStatsName);
+#endif
+
+	gStats = NULL;
+	gStatsName = NULL;
+}
+
+// Mark the start of an update, after which readers retry until the update ends
+static CzU64 begin_update(struct Stats* restrict stats)
+{
+	CzU64 sequence = atomic_load_explicit(&stats->sequence, memory_order_relaxed);
+	atomic_store_explicit(&stats->sequence, sequence + 1, memory_order_relaxed);
+	atomic_thread_fence(memory_order_release);
+	return sequence;
+}
+
+static void end_update(struct Stats* restrict stats, CzU64 sequence)
+{
+	atomic_store_explicit(&stats->sequence, sequence + 2, memory_order_release);
+}
+
+void stats_inout(const struct InoutMetrics* metrics, const struct StatsProgress* progress)
+{
+	struct Stats* stats = gStats;
+
+	if (!stats) {
+		return;
+	}
+
+	double timings[STATS_TIMING_COUNT];
+	timings[STATS_TIMING_READ] = metrics->read;
+	timings[STATS_TIMING_WRITE] = metrics->write;
+	timings[STATS_TIMING_COMPUTE] = metrics->compute;
+	timings[STATS_TIMING_TRANSFER] = metrics->transfer;
+	timings[STATS_TIMING_IDLE_COMPUTE] = metrics->idleCompute;
+	timings[STATS_TIMING_IDLE_TRANSFER] = metrics->idleTransfer;
+
+	CzU64 sequence = begin_update(stats);
+
+	for (CzU32 i = 0; i < STATS_TIMING_COUNT; i++) {
+		double average = atomic_load_explicit(&stats->timings[i], memory_order_relaxed);
+		average += (timings[i] - average) / 8;
+		atomic_store_explicit(&stats->timings[i], average, memory_order_relaxed);
+	}
+
+	atomic_store_explicit(&stats->inout, metrics->inout, memory_order_relaxed);
+	atomic_store_explicit(&stats->currentValue[0], CZ_U128_LOWER(progress->currentValue), memory_order_relaxed);
+	atomic_store_explicit(&stats->currentValue[1], CZ_U128_UPPER(progress->currentValue), memory_order_relaxed);
+	atomic_store_explicit(&stats->bestStartValue[0], CZ_U128_LOWER(progress->bestStartValue), memory_order_relaxed);
+	atomic_store_explicit(&stats->bestStartValue[1], CZ_U128_UPPER(progress->bestStartValue), memory_order_relaxed);
+	atomic_store_explicit(&stats->bestStopTime, progress->bestStopTime, memory_order_relaxed);
+	atomic_store_explicit(&stats->recordCount, progress->recordCount, memory_order_relaxed);
+
+	end_update(stats, sequence);
+}
+
+void stats_loop(const struct LoopMetrics* metrics)
+{
+	struct Stats* stats = gStats;
+
+	if (!stats) {
+		return;
+	}
+
+	CzU64 sequence = begin_update(stats);
+
+	CzU64 valuesTested = atomic_load_explicit(&stats->valuesTested, memory_order_relaxed);
+
+	atomic_store_explicit(&stats->loopCount, metrics->loop, memory_order_relaxed);
+	atomic_store_explicit(&stats->inoutsPerHeap, metrics->inoutsPerHeap, memory_order_relaxed);
+	atomic_store_explicit(&stats->valuesTested, valuesTested + metrics->valueCount, memory_order_relaxed);
+	atomic_store_explicit(&stats->valuesPerSecond, metrics->valuesPerSecond, memory_order_relaxed);
+	atomic_store_explicit(&stats->mainLoop, metrics->mainLoop, memory_order_relaxed);
+
+	end_update(stats, sequence);
+}
+
+bool stats_read(const struct Stats* stats, struct StatsSnapshot* snapshot)
+{
+	// The header is written before the object is shared, so needs no retries
+	snapshot->pid = stats->pid;
+
+	for (CzU32 attempt = 0; attempt < STATS_READ_ATTEMPTS; attempt++) {
+		CzU64 sequence = atomic_load_explicit(&stats->sequence, memory_order_acquire);
+
+		if (sequence & 1) {
+			continue;
+		}
+
+		CzU64 currentLower = atomic_load_explicit(&stats->currentValue[0], memory_order_relaxed);
+		CzU64 currentUpper = atomic_load_explicit(&stats->currentValue[1], memory_order_relaxed);
+		CzU64 bestLower = atomic_load_explicit(&stats->bestStartValue[0], memory_order_relaxed);
+		CzU64 bestUpper = atomic_load_explicit(&stats->bestStartValue[1], memory_order_relaxed);
+
+		snapshot->currentValue = CZ_U128(currentUpper, currentLower);
+		snapshot->bestStartValue = CZ_U128(bestUpper, bestLower);
+		snapshot->loopCount = atomic_load_explicit(&stats->loopCount, memory_order_relaxed);
+		snapshot->inout = atomic_load_explicit(&stats->inout, memory_order_relaxed);
+		snapshot->inoutsPerHeap = atomic_load_explicit(&stats->inoutsPerHeap, memory_order_relaxed);
+		snapshot->valuesTested = atomic_load_explicit(&stats->valuesTested, memory_order_relaxed);
+		snapshot->recordCount = atomic_load_explicit(&stats->recordCount, memory_order_relaxed);
+		snapshot->bestStopTime = (CzU16) atomic_load_explicit(&stats->bestStopTime, memory_order_relaxed);
+		snapshot->valuesPerSecond = atomic_load_explicit(&stats->valuesPerSecond, memory_order_relaxed);
+		snapshot->mainLoop = atomic_load_explicit(&stats->mainLoop, memory_order_relaxed);
+
+		for (CzU32 i = 0; i < STATS_TIMING_COUNT; i++) {
+			snapshot->timings[i] = atomic_load_explicit(&stats->timings[i], memory_order_relaxed);
+		}
+
+		atomic_thread_fence(memory_order_acquire);
+
+		if (atomic_load_explicit(&stats->sequence, memory_order_relaxed) == sequence) {
+			return true;
+		}
+	}
+
+	return false;
+}
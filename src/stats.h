@@ -0,0 +1,117 @@
+/* 
+ * Copyright (C) 2025 Seth McDonald
+ * 
+ * This file is part of Collatz Conjecture Simulator.
+ * 
+ * Collatz Conjecture Simulator is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ * 
+ * Collatz Conjecture Simulator is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE. See the GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License along with Collatz Conjecture
+ * Simulator. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "common.h"
+
+#include "metrics.h"
+
+// Live statistics of the submission loop, published for --stats in a POSIX shared memory object read by cltz-top
+
+#define CZ_STATS_MAGIC   UINT32_C(0x7A746C63) // "cltz" in little-endian
+#define CZ_STATS_VERSION UINT32_C(1)
+
+// Timings of inout-buffers, each an exponential moving average over roughly the latest eight, in ms
+enum StatsTiming
+{
+	STATS_TIMING_READ,
+	STATS_TIMING_WRITE,
+	STATS_TIMING_COMPUTE,
+	STATS_TIMING_TRANSFER,
+	STATS_TIMING_IDLE_COMPUTE,
+	STATS_TIMING_IDLE_TRANSFER,
+	STATS_TIMING_COUNT,
+};
+
+/*
+ * Layout of the shared memory object. Any change to the layout must increment CZ_STATS_VERSION. The header is written
+ * once before the object is shared. Every other member is updated under a sequence lock, which is odd while an update
+ * is in progress. A reader copies the members and retries if the sequence changed meanwhile, so the publisher never
+ * waits on a reader.
+ */
+struct Stats
+{
+	CzU32 magic;
+	CzU32 version;
+	CzU32 size; // sizeof(struct Stats)
+	CzU32 reserved;
+	CzU64 pid; // Process publishing the statistics.
+
+	_Atomic CzU64 sequence;
+	_Atomic CzU64 loopCount; // Main loop iterations completed, across resizes.
+	_Atomic CzU64 inout; // Index of the latest inout-buffer read.
+	_Atomic CzU64 inoutsPerHeap;
+	_Atomic CzU64 valuesTested;
+	_Atomic CzU64 currentValue[2]; // Lower and upper halves, of the first starting value yet to be tested.
+	_Atomic CzU64 bestStartValue[2]; // Lower and upper halves, of the latest record found.
+	_Atomic CzU64 bestStopTime;
+	_Atomic CzU64 recordCount;
+
+	_Atomic double valuesPerSecond; // Of the latest main loop iteration.
+	_Atomic double mainLoop; // Of the latest main loop iteration, in ms.
+	_Atomic double timings[STATS_TIMING_COUNT];
+};
+
+// Copy of the shared memory object, taken consistently by stats_read
+struct StatsSnapshot
+{
+	CzU128 currentValue;
+	CzU128 bestStartValue;
+	CzU64 pid;
+	CzU64 loopCount;
+	CzU64 inout;
+	CzU64 inoutsPerHeap;
+	CzU64 valuesTested;
+	CzU64 recordCount;
+	CzU16 bestStopTime;
+
+	double valuesPerSecond;
+	double mainLoop;
+	double timings[STATS_TIMING_COUNT];
+};
+
+// Progress of the run as of the latest inout-buffer read
+struct StatsProgress
+{
+	CzU128 currentValue;
+	CzU128 bestStartValue;
+	CzU64 recordCount;
+	CzU16 bestStopTime;
+};
+
+// Create and map the shared memory object of the given name, such as "/cltz"
+CZ_NONNULL_ARGS() CZ_NULTERM_ARG(1) CZ_RD_ACCESS(1)
+bool stats_init(const char* name);
+
+// Unmap and remove the shared memory object, if any
+void stats_fini(void);
+
+// Publish an inout-buffer and the progress after reading it, if publishing
+// Must be called from the main thread
+CZ_NONNULL_ARGS() CZ_RD_ACCESS(1) CZ_RD_ACCESS(2)
+void stats_inout(const struct InoutMetrics* metrics, const struct StatsProgress* progress);
+
+// Publish a main loop iteration, if publishing
+// Must be called from the main thread
+CZ_NONNULL_ARGS() CZ_RD_ACCESS(1)
+void stats_loop(const struct LoopMetrics* metrics);
+
+// Consistently copy the shared memory object, retrying while it is being updated
+// Returns false if it stays mid-update, in which case only the pid is copied
+CZ_NONNULL_ARGS() CZ_RD_ACCESS(1) CZ_WR_ACCESS(2)
+bool stats_read(const struct Stats* stats, struct StatsSnapshot* snapshot);
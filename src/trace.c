@@ -0,0 +1,116 @@
+/* 
+ * Copyright (C) 2025 Seth McDonald
+ * 
+ * This file is part of Collatz Conjecture Simulator.
+ * 
+ * Collatz Conjecture Simulator is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ * 
+ * Collatz Conjecture Simulator is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE. See the GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License along with Collatz Conjecture
+ * Simulator. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "trace.h"
+
+static FILE* gTraceFile = NULL;
+static pthread_mutex_t gTraceMutex = PTHREAD_MUTEX_INITIALIZER;
+static double gTraceStart = 0;
+static bool gTracing = false;
+
+static const char* const gTrackNames[] = {
+	"Main thread", "Writer thread", "Reader thread", "Compute queue", "Transfer queue"};
+
+bool trace_init(const char* filename)
+{
+	const char* mode = "w";
+
+	FILE* file = fopen(filename, mode);
+	if CZ_NOEXPECT (!file) { FOPEN_FAILURE(file, filename, mode); return false; }
+
+	// Every event is followed by a comma, so the array is closed by a final metadata event in trace_fini
+	int ires = fprintf(file, "[\n");
+	if CZ_NOEXPECT (ires < 0) { FPRINTF_FAILURE(ires, file, "[\n"); fclose(file); return false; }
+
+	for (CzU32 i = 0; i < CZ_COUNTOF(gTrackNames); i++) {
+		ires = fprintf(
+			file, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%" PRIu32 ",\"args\":{\"name\":\"%s\"}},\n",
+			i, gTrackNames[i]);
+
+		if CZ_NOEXPECT (ires < 0) { FPRINTF_FAILURE(ires, file, "thread_name"); fclose(file); return false; }
+	}
+
+	gTraceFile = file;
+	gTraceStart = wall_time();
+	gTracing = true;
+	return true;
+}
+
+bool trace_fini(void)
+{
+	if (!gTracing) {
+		return true;
+	}
+
+	gTracing = false;
+
+	FILE* file = gTraceFile;
+	gTraceFile = NULL;
+
+	// The trace file was already closed, and the failure logged, if writing an event failed
+	if (!file) {
+		return true;
+	}
+
+	const char* fmt = "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"%s\"}}\n]\n";
+
+	int ires = fprintf(file, fmt, CZ_EXECUTABLE);
+	if CZ_NOEXPECT (ires < 0) { FPRINTF_FAILURE(ires, file, fmt); fclose(file); return false; }
+
+	ires = fclose(file);
+	if CZ_NOEXPECT (ires) { return false; }
+
+	return true;
+}
+
+void trace_event(const char* name, enum CzTraceTrack track, CzU32 inout, double start, double end)
+{
+	if (!gTracing) {
+		return;
+	}
+
+	// Trace event timestamps are in microseconds
+	double ts = (start - gTraceStart) * 1000;
+	double dur = (end - start) * 1000;
+
+	pthread_mutex_lock(&gTraceMutex);
+
+	FILE* file = gTraceFile;
+	int ires = 0;
+
+	if (file && inout == UINT32_MAX) {
+		ires = fprintf(
+			file, "{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f},\n",
+			name, (int) track, ts, dur);
+	}
+	else if (file) {
+		ires = fprintf(
+			file,
+			"{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f,"
+			"\"args\":{\"inout\":%" PRIu32 "}},\n",
+			name, (int) track, ts, dur, inout);
+	}
+
+	// Stop tracing rather than fail the run
+	if CZ_NOEXPECT (ires < 0) {
+		FPRINTF_FAILURE(ires, file, name);
+		fclose(file);
+		gTraceFile = NULL;
+	}
+
+	pthread_mutex_unlock(&gTraceMutex);
+}
@@ -0,0 +1,45 @@
+/* 
+ * Copyright (C) 2025 Seth McDonald
+ * 
+ * This file is part of Collatz Conjecture Simulator.
+ * 
+ * Collatz Conjecture Simulator is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ * 
+ * Collatz Conjecture Simulator is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE. See the GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License along with Collatz Conjecture
+ * Simulator. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "common.h"
+
+// Timeline of the submission loop, written for --trace in the JSON trace event format read by Perfetto and Chrome
+
+// Track of the timeline on which an event is placed
+enum CzTraceTrack
+{
+	CZ_TRACE_TRACK_MAIN,
+	CZ_TRACE_TRACK_WRITER,
+	CZ_TRACE_TRACK_READER,
+	CZ_TRACE_TRACK_COMPUTE,
+	CZ_TRACE_TRACK_TRANSFER,
+};
+
+// Create the trace file at filename, and begin the timeline at the current wall_time
+CZ_NONNULL_ARGS() CZ_NULTERM_ARG(1) CZ_RD_ACCESS(1)
+bool trace_init(const char* filename);
+
+// Complete the trace file, if any
+bool trace_fini(void);
+
+// Add an event spanning start to end (ms, as returned by wall_time) to the trace, if any
+// inout is the index of the inout-buffer the event concerns, or UINT32_MAX if none
+// May be called from any thread
+CZ_NONNULL_ARGS() CZ_NULTERM_ARG(1) CZ_RD_ACCESS(1)
+void trace_event(const char* name, enum CzTraceTrack track, CzU32 inout, double start, double end);
@@ -0,0 +1,154 @@
+/* 
+ * Copyright (C) 2025 Seth McDonald
+ * 
+ * This file is part of Collatz Conjecture Simulator.
+ * 
+ * Collatz Conjecture Simulator is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ * 
+ * Collatz Conjecture Simulator is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE. See the GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License along with Collatz Conjecture
+ * Simulator. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "stats.h"
+
+// Map the shared memory object of the given name read-only, or return NULL if it does not exist or is not yet ready
+static void* map_stats(const char* restrict name, bool* restrict mismatch)
+{
+	int fd = shm_open(name, O_RDONLY, 0);
+	if (fd < 0) { return NULL; }
+
+	struct stat fileInfo;
+	int ires = fstat(fd, &fileInfo);
+
+	// The object may have been created but not yet sized
+	if (ires || (size_t) fileInfo.st_size < sizeof(struct Stats)) {
+		close(fd);
+		return NULL;
+	}
+
+	void* map = mmap(NULL, sizeof(struct Stats), PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+
+	if (map == MAP_FAILED) { return NULL; }
+
+	const struct Stats* stats = (const struct Stats*) map;
+
+	if (stats->magic != CZ_STATS_MAGIC) {
+		munmap(map, sizeof(struct Stats));
+		return NULL;
+	}
+
+	atomic_thread_fence(memory_order_acquire);
+
+	if (stats->version != CZ_STATS_VERSION || stats->size != sizeof(struct Stats)) {
+		*mismatch = true;
+		munmap(map, sizeof(struct Stats));
+		return NULL;
+	}
+
+	return map;
+}
+
+// Clear the terminal and display the snapshot
+static void print_snapshot(const char* restrict name, const struct StatsSnapshot* restrict snapshot)
+{
+	printf(
+		"\033[H\033[2J"
+		"%s (pid %" PRIu64 ")\n"
+		"\n"
+		"Loop:           #%" PRIu64 ", inout-buffer %" PRIu64 "/%" PRIu64 "\n"
+		"Main loop:      %.0fms\n"
+		"Speed:          %.3f/s\n"
+		"Tested:         %" PRIu64 "\n"
+		"Current value:  0x %016" PRIx64 " %016" PRIx64 "\n"
+		"\n"
+		"Records:        %" PRIu64 "\n"
+		"Best value:     0x %016" PRIx64 " %016" PRIx64 "\n"
+		"Best time:      %" PRIu16 "\n"
+		"\n"
+		"Average per inout-buffer\n"
+		"\tReading buffers:    %8.1fms\n"
+		"\tWriting buffers:    %8.1fms\n"
+		"\tCompute execution:  %8.1fms\n"
+		"\tTransfer execution: %8.1fms\n"
+		"\tIdle (compute):     %8.1fms\n"
+		"\tIdle (transfer):    %8.1fms\n",
+		name, snapshot->pid,
+		snapshot->loopCount + 1, snapshot->inout + 1, snapshot->inoutsPerHeap,
+		snapshot->mainLoop,
+		snapshot->valuesPerSecond,
+		snapshot->valuesTested,
+		CZ_U128_UPPER(snapshot->currentValue), CZ_U128_LOWER(snapshot->currentValue),
+		snapshot->recordCount,
+		CZ_U128_UPPER(snapshot->bestStartValue), CZ_U128_LOWER(snapshot->bestStartValue),
+		snapshot->bestStopTime,
+		snapshot->timings[STATS_TIMING_READ],
+		snapshot->timings[STATS_TIMING_WRITE],
+		snapshot->timings[STATS_TIMING_COMPUTE],
+		snapshot->timings[STATS_TIMING_TRANSFER],
+		snapshot->timings[STATS_TIMING_IDLE_COMPUTE],
+		snapshot->timings[STATS_TIMING_IDLE_TRANSFER]);
+
+	fflush(stdout);
+}
+
+int main(int argc, char** argv)
+{
+	if (argc > 2 || (argc == 2 && (!strcmp(argv[1], "-h") || !strcmp(argv[1], "--help")))) {
+		printf(
+			"Usage: cltz-top [name]\n"
+			"\n"
+			"Display the statistics published by cltz --stats <name>, refreshed every\n"
+			"second, until cltz exits. The name defaults to /cltz.\n");
+
+		return argc > 2 ? EXIT_FAILURE : EXIT_SUCCESS;
+	}
+
+	const char* name = argc == 2 ? argv[1] : "/cltz";
+	bool waiting = false;
+
+	while (true) {
+		// The object is mapped anew each refresh, so a restarted cltz is picked up
+		bool mismatch = false;
+		void* map = map_stats(name, &mismatch);
+		const struct Stats* stats = map;
+
+		if (mismatch) {
+			log_error(stderr, "Statistics '%s' were published by an incompatible version of cltz", name);
+			return EXIT_FAILURE;
+		}
+
+		if (!stats && !waiting) {
+			printf("Waiting for statistics '%s'...\n", name);
+			waiting = true;
+		}
+
+		if (stats) {
+			struct StatsSnapshot snapshot;
+			bool consistent = stats_read(stats, &snapshot);
+			munmap(map, sizeof(struct Stats));
+
+			// A publisher killed mid-update leaves the statistics inconsistent, so only its liveness is checked
+			if (consistent) {
+				print_snapshot(name, &snapshot);
+				waiting = false;
+			}
+
+			// An object whose publisher has exited is left over from a crash
+			int ires = kill((pid_t) snapshot.pid, 0);
+
+			if (ires && errno == ESRCH) {
+				printf("\nProcess %" PRIu64 " has exited\n", snapshot.pid);
+				return EXIT_SUCCESS;
+			}
+		}
+
+		sleep(1);
+	}
+}